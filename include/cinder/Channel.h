@@ -27,6 +27,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Area.h"
+#include "cinder/SurfaceAllocator.h"
 
 #include <algorithm>
 
@@ -42,6 +43,8 @@ class CI_API ChannelT {
 	ChannelT();
 	//! Allocates and owns a contiguous block of memory that is sizeof(T) * width * height
 	ChannelT( int32_t width, int32_t height );
+	//! Allocates and owns a block of memory from \a allocator, with rows padded to a multiple of the allocator's alignment
+	ChannelT( int32_t width, int32_t height, const SurfaceAllocatorRef &allocator );
 	//! Does not allocate or own memory pointed to by \a data
 	ChannelT( int32_t width, int32_t height, ptrdiff_t rowBytes, uint8_t increment, T *data );
 	//! Does not allocate memory pointed to by \a data but holds a reference to \a dataStore
@@ -60,6 +63,10 @@ class CI_API ChannelT {
 	//! Allocates and owns a contiguous block of memory that is sizeof(T) * width * height
 	static std::shared_ptr<ChannelT<T>> create( int32_t width, int32_t height )
 	{ return std::make_shared<ChannelT<T>>( width, height ); }
+
+	//! Allocates and owns a block of memory from \a allocator, with rows padded to a multiple of the allocator's alignment
+	static std::shared_ptr<ChannelT<T>> create( int32_t width, int32_t height, const SurfaceAllocatorRef &allocator )
+	{ return std::make_shared<ChannelT<T>>( width, height, allocator ); }
 	
 	//! Does not allocate or own memory pointed to by \a data
 	static std::shared_ptr<ChannelT<T>> create( int32_t width, int32_t height, ptrdiff_t rowBytes, uint8_t increment, T *data )
@@ -82,6 +89,9 @@ class CI_API ChannelT {
 	ChannelT	clone( bool copyPixels = true ) const;
 	//! Returns a new Channel which is a duplicate of an Area \a area. If \a copyPixels the pixel values are copied, otherwise the clone's pixels remain uninitialized.
 	ChannelT	clone( const Area &area, bool copyPixels = true ) const;
+	/** \brief Returns a Channel which refers to the pixels of \a area in place, without copying. \a area is clipped to the bounds of the Channel.
+		The view shares and extends the lifetime of this Channel's data store; writes through either are visible in both. Copying the view (rather than moving it) creates an independent duplicate. **/
+	ChannelT	getView( const Area &area ) const;
 	
 	//! Returns the width of the Channel in pixels
 	int32_t		getWidth() const { return mWidth; }
@@ -121,7 +131,7 @@ class CI_API ChannelT {
 	//! Copies the Area \a srcArea of the Channel \a srcChannel to \a this Channel. The destination Area is \a srcArea offset by \a relativeOffset.
 	void		copyFrom( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &relativeOffset = ivec2() );
 
-	//! Returns an averaged value for the Area defined by \a area
+	//! Returns an averaged value for the Area defined by \a area. For many queries against the same pixels, ip::IntegralImageT answers each in constant time.
 	T			areaAverage( const Area &area ) const;
 
 	//! Returns the shared_ptr used to store the Channel's data. In general prefer getData() instead.
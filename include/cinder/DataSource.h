@@ -82,6 +82,28 @@ class CI_API DataSourcePath : public DataSource {
 	IStreamFileRef	mStream;	
 };
 
+typedef std::shared_ptr<class DataSourcePathMapped>	DataSourcePathMappedRef;
+
+/** \brief A DataSourcePath whose getBuffer() maps the file into memory rather than copying it into the heap.
+	The Buffer aliases a private, copy-on-write mapping of the file, so writing to it never modifies the file, and the mapping is released
+	along with the last reference to the Buffer. Pages are read from disk as they are first touched. Platforms without mmap() copy the file as DataSourcePath does. **/
+class CI_API DataSourcePathMapped : public DataSourcePath {
+  public:
+	//! Describes how the mapping will be read, so that the kernel can read ahead or not. Passed to madvise().
+	enum Access { ACCESS_NORMAL, ACCESS_SEQUENTIAL, ACCESS_RANDOM };
+
+	static DataSourcePathMappedRef	create( const fs::path &path, Access access = ACCESS_SEQUENTIAL );
+
+	Access	getAccess() const	{ return mAccess; }
+
+  protected:
+	DataSourcePathMapped( const fs::path &path, Access access );
+
+	void	createBuffer() override;
+
+	Access	mAccess;
+};
+
 
 #if defined( CINDER_ANDROID )
 typedef std::shared_ptr<class DataSourceAndroidAsset>	DataSourceAndroidAssetRef;
@@ -107,6 +129,8 @@ class DataSourceAndroidAsset : public DataSource {
 
 
 CI_API DataSourceRef loadFile( const fs::path &path );
+//! Returns a DataSource whose getBuffer() maps the file at \a path into memory rather than copying it, with \a access hinting how it will be read. \see DataSourcePathMapped
+CI_API DataSourceRef loadFileMapped( const fs::path &path, DataSourcePathMapped::Access access = DataSourcePathMapped::ACCESS_SEQUENTIAL );
 
 #if ! defined( CINDER_UWP )
 typedef std::shared_ptr<class DataSourceUrl>	DataSourceUrlRef;
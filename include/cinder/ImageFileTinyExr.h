@@ -24,6 +24,7 @@
 #pragma once
 
 #include "cinder/ImageIo.h"
+#include "cinder/Area.h"
 
 #define USE_PLANAR_CHANNELS 1
 
@@ -37,16 +38,47 @@ typedef std::shared_ptr<class ImageSourceFileTinyExr>	ImageSourceFileTinyExrRef;
 
 class ImageSourceFileTinyExr : public ImageSource {
 public:
+	//! Selects what is decoded from an OpenEXR file, and with how many threads
+	class Options : public ImageSource::Options {
+	  public:
+		Options() : mArea( Area::zero() ), mNumThreads( 0 ), mHalfAsFloat( false ) {}
+		Options( const ImageSource::Options &options ) : ImageSource::Options( options ), mArea( Area::zero() ), mNumThreads( 0 ), mHalfAsFloat( false ) {}
+
+		//! Names the channels to decode, such as \c { "R", "G", "B" }. One name results in a gray image, two in gray and alpha, three in RGB and four in RGBA. Other channels are skipped. Defaults to R, G, B and A when present, otherwise Y and A.
+		Options&	channels( const std::vector<std::string> &names )	{ mChannels = names; return *this; }
+		//! Decodes only \a area of the data window; rows outside of it are not decompressed. Defaults to the whole data window.
+		Options&	area( const Area &area )							{ mArea = area; return *this; }
+		//! Sets the number of threads which decode scanline blocks. Defaults to \c 0, one per hardware thread.
+		Options&	numThreads( int numThreads )						{ mNumThreads = numThreads; return *this; }
+		//! Expands half channels to 32-bit float while decoding instead of keeping them as FLOAT16. Defaults to \c false.
+		Options&	halfAsFloat( bool halfAsFloat = true )				{ mHalfAsFloat = halfAsFloat; return *this; }
+
+		const std::vector<std::string>&	getChannels() const		{ return mChannels; }
+		const Area&						getArea() const			{ return mArea; }
+		int								getNumThreads() const	{ return mNumThreads; }
+		bool							getHalfAsFloat() const	{ return mHalfAsFloat; }
+
+	  protected:
+		std::vector<std::string>	mChannels;
+		Area						mArea;
+		int							mNumThreads;
+		bool						mHalfAsFloat;
+	};
+
 	static ImageSourceRef	create( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
+	static ImageSourceRef	create( DataSourceRef dataSource, const Options &options );
+	~ImageSourceFileTinyExr();
 
 	void load( ImageTargetRef target ) override;
 
 	static void		registerSelf();
 
 protected:
-	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options );
+	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, const Options &options );
 
 	std::unique_ptr<EXRImage>	mExrImage;
+	std::vector<int>			mChannelIndices; // EXRImage channel of each component
+	int32_t						mOffsetX; // first column of the data window which is loaded
 };
 
 class ImageTargetFileTinyExr : public ImageTarget {
@@ -63,7 +95,7 @@ class ImageTargetFileTinyExr : public ImageTarget {
 	
 	uint8_t						mNumComponents;
 	fs::path					mFilePath;
-	std::vector<float>			mData;
+	std::vector<uint8_t>		mData; // interleaved, float or half_float
 	std::vector<std::string>	mChannelNames;
 };
 
@@ -159,6 +159,10 @@ class CI_API ImageTarget : public ImageIo {
 	virtual ~ImageTarget() {};
 
 	virtual void*	getRowPointer( int32_t row ) = 0;
+	/** Returns the first row of the target if all rows lie \a rowBytes apart within a single block of \a dataBytes bytes, which an ImageSource whose
+		data type and channel order match the target's may decode into directly rather than through getRowPointer(). The whole block may be overwritten,
+		including the bytes between rows. Returns nullptr by default. **/
+	virtual void*	getContiguousData( ptrdiff_t * /*rowBytes*/, size_t * /*dataBytes*/ ) { return nullptr; }
 	virtual void	setRow( int32_t /*row*/, const void * /*data*/ ) { throw; }
 	virtual void	finalize() { }
 	
@@ -203,6 +207,8 @@ CI_API void				writeImage( DataTargetRef dataTarget, const ImageSourceRef &image
 CI_API void				writeImage( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
 /** \brief Writes \a imageSource to \a imageTarget. **/
 CI_API void				writeImage( ImageTargetRef imageTarget, const ImageSourceRef &imageSource );
+//! Returns the ImageTarget writeImage() would write \a imageSource to \a dataTarget through, without loading the image into it. Throws ImageIoExceptionUnknownExtension if there is none.
+CI_API ImageTargetRef		createImageTarget( DataTargetRef dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
 
 class CI_API ImageIoException : public Exception {
   public:
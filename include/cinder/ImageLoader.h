@@ -0,0 +1,178 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Surface.h"
+#include "cinder/SurfacePool.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+
+//! Exception held by the future of an ImageLoader request which was canceled before it completed
+class CI_API ImageLoaderExceptionCanceled : public ImageIoException {
+  public:
+	ImageLoaderExceptionCanceled( const std::string &description = "" ) : ImageIoException( description ) {}
+};
+
+/** \brief Decodes images into Surfaces on a bounded pool of worker threads, keeping bulk asset loading off the main thread.
+	Waiting requests are served highest priority first, and in the order they were made among equal priorities. Each load() returns a Request
+	whose future holds the Surface, or the exception thrown while loading it. Completion callbacks run on whichever thread calls update(),
+	typically the main thread once per frame, where they may safely create textures. All methods are thread-safe. **/
+class CI_API ImageLoader : public std::enable_shared_from_this<ImageLoader>, private Noncopyable {
+  public:
+	class Request;
+	typedef std::shared_ptr<Request>	RequestRef;
+	//! Called by update() with a finished \a request, whose future is ready. Called for failed and canceled requests too.
+	typedef std::function<void( const RequestRef &request )>	CompletionFn;
+
+	class CI_API Options {
+	  public:
+		Options() : mNumThreads( 0 ) {}
+
+		//! Sets the number of worker threads. The default of \c 0 uses one fewer than the number of hardware cores, and at least one.
+		Options&	numThreads( size_t numThreads )							{ mNumThreads = numThreads; return *this; }
+		//! Decodes into Surfaces from \a pool, whose memory returns to it once they are released. The default of \c nullptr allocates each Surface.
+		Options&	surfacePool( const SurfacePoolRef &pool )				{ mSurfacePool = pool; return *this; }
+		//! Sets the options passed to loadImage()
+		Options&	imageOptions( const ImageSource::Options &options )	{ mImageOptions = options; return *this; }
+
+		size_t							getNumThreads() const		{ return mNumThreads; }
+		const SurfacePoolRef&			getSurfacePool() const		{ return mSurfacePool; }
+		const ImageSource::Options&		getImageOptions() const		{ return mImageOptions; }
+
+	  private:
+		size_t					mNumThreads;
+		SurfacePoolRef			mSurfacePool;
+		ImageSource::Options	mImageOptions;
+	};
+
+	//! A single image requested from an ImageLoader
+	class CI_API Request : private Noncopyable {
+	  public:
+		//! Returns a future holding the Surface, which shares the memory it was decoded into. get() rethrows the exception thrown while loading, or ImageLoaderExceptionCanceled.
+		const std::shared_future<Surface8uRef>&	getFuture() const	{ return mFuture; }
+		//! Returns whether the request has completed, successfully or not, so that getFuture().get() won't block
+		bool	isDone() const;
+
+		//! Cancels the request unless it has completed. An image already being decoded finishes in the background but is discarded.
+		void	cancel();
+		//! Returns whether cancel() was called before the request completed
+		bool	isCanceled() const		{ return mCanceled; }
+
+		//! Sets the priority of the request, which reorders it if it is still waiting for a worker. Higher priorities load first.
+		void	setPriority( int priority );
+		int		getPriority() const		{ return mPriority; }
+
+		//! Returns the path the image is loaded from, or an empty path if it was requested by DataSource
+		const fs::path&			getFilePath() const		{ return mFilePath; }
+		//! Returns the DataSource the image is loaded from, or \c nullptr if it was requested by path
+		const DataSourceRef&	getDataSource() const	{ return mDataSource; }
+
+	  private:
+		typedef enum State { PENDING, LOADING, DONE } State;
+
+		Request( const std::weak_ptr<ImageLoader> &loader, const fs::path &filePath, const DataSourceRef &dataSource, int priority, uint64_t sequence, const CompletionFn &completionFn );
+
+		std::weak_ptr<ImageLoader>		mLoader;
+		fs::path						mFilePath;
+		DataSourceRef					mDataSource;
+		CompletionFn					mCompletionFn;
+		std::promise<Surface8uRef>			mPromise;
+		std::shared_future<Surface8uRef>	mFuture;
+		uint64_t						mSequence;
+		std::atomic<int>				mPriority;
+		std::atomic<bool>				mCanceled;
+		State							mState; // guarded by the loader's mutex
+
+		friend class ImageLoader;
+	};
+
+	//! Creates an ImageLoader and starts its worker threads
+	static ImageLoaderRef	create( const Options &options = Options() );
+	//! Cancels the requests which haven't started and waits for those being decoded
+	~ImageLoader();
+
+	//! Requests the image at \a path, which is read and decoded on a worker thread. \a completionFn, if any, is called by update() once it completes.
+	RequestRef				load( const fs::path &path, int priority = 0, const CompletionFn &completionFn = CompletionFn() );
+	//! Requests the image in \a dataSource. \a completionFn, if any, is called by update() once it completes.
+	RequestRef				load( const DataSourceRef &dataSource, int priority = 0, const CompletionFn &completionFn = CompletionFn() );
+	//! Requests each of the images at \a paths, in order, with the same \a priority and \a completionFn
+	std::vector<RequestRef>	load( const std::vector<fs::path> &paths, int priority = 0, const CompletionFn &completionFn = CompletionFn() );
+
+	/** Calls the CompletionFn of requests which have completed since the last call, on the calling thread, and returns how many were called.
+		At most \a maxCompletions are called, which lets a frame budget the time it spends on them; the rest wait for the next call. **/
+	size_t	update( size_t maxCompletions = std::numeric_limits<size_t>::max() );
+	//! Cancels every request which hasn't completed. Images already being decoded finish in the background but are discarded.
+	void	cancelAll();
+	//! Blocks until every request made so far has completed. Doesn't call any CompletionFn.
+	void	waitAll();
+
+	//! Returns the number of worker threads
+	size_t	getNumThreads() const	{ return mWorkers.size(); }
+	//! Returns the number of requests waiting for a worker
+	size_t	getNumPending() const;
+	//! Returns the number of requests being decoded
+	size_t	getNumLoading() const;
+
+  protected:
+	ImageLoader( const Options &options );
+
+  private:
+	// orders waiting requests by descending priority, then by ascending sequence
+	typedef std::pair<int, uint64_t>	PendingKey;
+	static PendingKey	pendingKey( int priority, uint64_t sequence )	{ return PendingKey( -priority, sequence ); }
+
+	RequestRef	enqueue( const fs::path &path, const DataSourceRef &dataSource, int priority, const CompletionFn &completionFn );
+	void		workerLoop();
+	//! Marks \a request as done and queues its CompletionFn. Called with mMutex held.
+	void		complete( const RequestRef &request );
+	void		cancel( Request *request );
+	//! Cancels every request waiting for a worker. Called with mMutex held.
+	void		cancelPending();
+	void		setPriority( Request *request, int priority );
+
+	Options								mOptions;
+	std::vector<std::thread>			mWorkers;
+	std::map<PendingKey, RequestRef>	mPending;
+	std::vector<RequestRef>				mLoading;
+	std::deque<RequestRef>				mCompleted;
+	uint64_t							mNextSequence;
+	bool								mStop;
+	mutable std::mutex					mMutex;
+	std::condition_variable				mWorkCondition, mIdleCondition;
+};
+
+} // namespace cinder
@@ -0,0 +1,179 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Surface.h"
+#include "cinder/SurfacePool.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+
+/** \brief Plays back a sequence of image files, such as a PNG, EXR or Radiance render, decoding the frames ahead of the playhead on background threads.
+	Decoded frames are kept in a cache bounded in bytes, from which the least recently used are evicted. Frames may be requested in any order;
+	each request moves the playhead, and frames queued for decoding which fall outside of the new read-ahead window are abandoned.
+	The hit, late and dropped frame counters show whether the read-ahead and cache keep up with a frame budget. All methods are thread-safe.
+	\code
+	auto sequence = ImageSequence8u::create( getAssetPath( "render" ) );
+	Surface8uRef frame;
+	if( sequence->tryGetFrame( getElapsedFrames() % sequence->getNumFrames(), &frame ) )
+		mTexture = gl::Texture::create( *frame );
+	\endcode **/
+template<typename T>
+class CI_API ImageSequenceT : private Noncopyable {
+  public:
+	class CI_API Options {
+	  public:
+		Options() : mReadAhead( 4 ), mMaxCacheBytes( 256 * 1024 * 1024 ), mNumThreads( 0 ), mLoop( false ) {}
+
+		//! Sets the number of frames beyond the playhead which are decoded ahead of their request. Defaults to \c 4.
+		Options&	readAhead( size_t frames )							{ mReadAhead = frames; return *this; }
+		//! Sets the number of bytes of decoded frames the cache may hold. Defaults to 256MB.
+		Options&	maxCacheBytes( size_t maxBytes )					{ mMaxCacheBytes = maxBytes; return *this; }
+		//! Sets the number of decoding threads. The default of \c 0 uses one fewer than the number of hardware cores, and at least one.
+		Options&	numThreads( size_t numThreads )						{ mNumThreads = numThreads; return *this; }
+		//! Sets whether the read-ahead wraps around from the last frame to the first. Defaults to \c false.
+		Options&	loop( bool loop = true )							{ mLoop = loop; return *this; }
+		//! Decodes into Surfaces from \a pool, so that the memory of evicted frames is reused. The default of \c nullptr allocates each frame.
+		Options&	surfacePool( const SurfacePoolRef &pool )			{ mSurfacePool = pool; return *this; }
+		//! Sets the options passed to loadImage()
+		Options&	imageOptions( const ImageSource::Options &options )	{ mImageOptions = options; return *this; }
+
+		size_t							getReadAhead() const		{ return mReadAhead; }
+		size_t							getMaxCacheBytes() const	{ return mMaxCacheBytes; }
+		size_t							getNumThreads() const		{ return mNumThreads; }
+		bool							getLoop() const				{ return mLoop; }
+		const SurfacePoolRef&			getSurfacePool() const		{ return mSurfacePool; }
+		const ImageSource::Options&		getImageOptions() const		{ return mImageOptions; }
+
+	  private:
+		size_t					mReadAhead, mMaxCacheBytes, mNumThreads;
+		bool					mLoop;
+		SurfacePoolRef			mSurfacePool;
+		ImageSource::Options	mImageOptions;
+	};
+
+	/** Creates a sequence of the files in \a directory whose extensions ImageIo can load, ordered by name with runs of digits compared by value,
+		so that "frame9.png" precedes "frame10.png". Throws ImageIoException if there are none. **/
+	static std::shared_ptr<ImageSequenceT<T>>	create( const fs::path &directory, const Options &options = Options() );
+	//! Creates a sequence of the files at \a paths, in the given order. Throws ImageIoException if \a paths is empty.
+	static std::shared_ptr<ImageSequenceT<T>>	create( const std::vector<fs::path> &paths, const Options &options = Options() );
+	//! Abandons the frames queued for decoding and waits for those being decoded
+	~ImageSequenceT();
+
+	/** Returns frame \a index, waiting for it to be decoded if it isn't cached, and moves the playhead to it. A wait counts as a late frame.
+		The Surface is shared with the cache rather than copied, and should not be modified. Rethrows the exception thrown while loading the frame. **/
+	std::shared_ptr<SurfaceT<T>>	getFrame( size_t index );
+	/** Sets \a result to frame \a index if it's cached and returns \c true, or returns \c false without waiting, which counts as a dropped frame.
+		Either way the playhead moves to \a index. Rethrows the exception thrown while loading the frame. **/
+	bool							tryGetFrame( size_t index, std::shared_ptr<SurfaceT<T>> *result );
+	//! Moves the playhead to \a index, abandoning queued frames outside of the new read-ahead window and queuing those inside of it
+	void			seek( size_t index );
+	//! Returns the frame at the playhead
+	size_t			getPlayhead() const;
+
+	//! Returns the number of frames in the sequence
+	size_t					getNumFrames() const					{ return mPaths.size(); }
+	//! Returns the path of frame \a index
+	const fs::path&			getFilePath( size_t index ) const		{ return mPaths.at( index ); }
+	const std::vector<fs::path>&	getFilePaths() const			{ return mPaths; }
+
+	//! Returns the number of frames which were cached when requested
+	size_t		getNumHits() const;
+	//! Returns the number of frames getFrame() had to wait for
+	size_t		getNumLate() const;
+	//! Returns the number of frames tryGetFrame() couldn't return
+	size_t		getNumDropped() const;
+	//! Returns the total number of seconds getFrame() spent waiting for late frames
+	double		getLateSeconds() const;
+	//! Returns the number of frames decoded, including those decoded again after being evicted
+	size_t		getNumDecoded() const;
+	//! Returns the number of frames evicted from the cache
+	size_t		getNumEvicted() const;
+	//! Resets the hit, late, dropped, decoded and evicted counters and the late seconds
+	void		resetCounters();
+
+	//! Returns the number of decoded frames in the cache
+	size_t		getNumCached() const;
+	//! Returns the number of bytes of decoded frames in the cache
+	size_t		getCachedBytes() const;
+
+  protected:
+	ImageSequenceT( const std::vector<fs::path> &paths, const Options &options );
+
+  private:
+	typedef enum State { QUEUED, DECODING, CACHED, FAILED } State;
+
+	struct Frame {
+		State						mState;
+		std::shared_ptr<SurfaceT<T>>	mSurface;
+		std::exception_ptr			mError;
+		size_t						mBytes;
+		std::list<size_t>::iterator	mLruPosition;
+	};
+
+	//! Moves the playhead to \a index and updates the decoding queue. Called with mMutex held.
+	void	seekLocked( size_t index );
+	//! Returns the playhead followed by the frames it reads ahead. Called with mMutex held.
+	std::vector<size_t>	getWindow() const;
+	//! Returns how many frames \a index lies ahead of the playhead, or the maximum size_t if playback won't reach it. Called with mMutex held.
+	size_t	getDistance( size_t index ) const;
+	//! Marks \a frame as the most recently used. Called with mMutex held.
+	void	touch( Frame &frame );
+	//! Evicts frames other than the playhead's until the cache fits. Called with mMutex held.
+	void	evict();
+	void	workerLoop();
+
+	std::vector<fs::path>		mPaths;
+	Options						mOptions;
+	std::vector<std::thread>	mWorkers;
+	std::map<size_t, Frame>		mFrames;
+	std::deque<size_t>			mQueue;
+	std::list<size_t>			mLru; // cached frames, most recently used first
+	size_t						mPlayhead, mCachedBytes;
+	size_t						mNumHits, mNumLate, mNumDropped, mNumDecoded, mNumEvicted;
+	double						mLateSeconds;
+	bool						mStop;
+	mutable std::mutex			mMutex;
+	std::condition_variable		mWorkCondition, mFrameCondition;
+};
+
+typedef ImageSequenceT<uint8_t>				ImageSequence8u;
+typedef std::shared_ptr<ImageSequence8u>	ImageSequence8uRef;
+typedef ImageSequenceT<uint16_t>			ImageSequence16u;
+typedef std::shared_ptr<ImageSequence16u>	ImageSequence16uRef;
+typedef ImageSequenceT<float>				ImageSequence32f;
+typedef std::shared_ptr<ImageSequence32f>	ImageSequence32fRef;
+
+} // namespace cinder
@@ -39,14 +39,22 @@ class ImageSourceFileStbImage : public ImageSource {
 
 	static void		registerSelf();
 
+	//! Decodes straight into \a target when its data type and channel order match the image and it provides ImageTarget::getContiguousData()
 	void	load( ImageTargetRef target ) override;
 
   protected:
 	ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options options );
-	
-	uint8_t		*mData8u;
-	float		*mData32f;
-	size_t		mRowBytes;
+
+	//! Decodes the image, returning memory to be freed with stbi_image_free()
+	void*	decode();
+	//! Returns whether the image was decoded into \a target's memory. On false the caller copies the image rows, possibly already decoded into mData8u or mData32f.
+	bool	loadDirect( const ImageTargetRef &target );
+
+	DataSourceRef	mDataSource;
+	uint8_t			*mData8u;
+	float			*mData32f;
+	size_t			mRowBytes;
+	int				mComponents;
 };
 
 } // namespace cinder
@@ -41,6 +41,7 @@ class ImageSourcePng : public ImageSource {
 	static ImageSourceRef		createSourceRef( DataSourceRef dataSourceRef, ImageSource::Options options = ImageSource::Options() ) { return createRef( dataSourceRef, options ); }
 	~ImageSourcePng();
 
+	//! Decodes the image row by row from its DataSource's stream, holding only the current row unless the image is interlaced
 	virtual void	load( ImageTargetRef target );
 
 	static void		registerSelf();
@@ -52,6 +53,7 @@ class ImageSourcePng : public ImageSource {
 	std::shared_ptr<ci_png_info>	mCiInfoPtr;
 	png_struct_def					*mPngPtr;
 	png_info						*mInfoPtr;
+	bool							mInterlaced;
 };
 
 class ImageSourcePngException : public ImageIoException {
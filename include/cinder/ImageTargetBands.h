@@ -0,0 +1,74 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Surface.h"
+
+#include <functional>
+
+namespace cinder {
+
+/** \brief An ImageTarget which hands an image to a callback in horizontal bands of a fixed number of rows, rather than holding all of it.
+	Rows are decoded into a single band-sized Surface which is passed to the callback each time it fills, so memory scales with the band height
+	rather than the image height. This allows processing images too large to hold at once, as long as the ImageSource delivers rows top to bottom
+	without decoding the whole image first itself; ImageSourcePng streams non-interlaced PNGs this way, while stb_image holds the entire image.
+	\code ImageTargetBands8u::load( loadImage( "scan.png" ), 256, []( const Surface8u &band, int32_t y ) { writeTiles( band, y ); } ); \endcode **/
+template<typename T>
+class ImageTargetBandsT : public ImageTarget {
+  public:
+	//! Called with each band, whose first row is row \a y of the image. Every band is \a bandHeight rows tall except possibly the last. \a band is only valid during the call.
+	typedef std::function<void( const SurfaceT<T> &band, int32_t y )>	BandFn;
+
+	/** Creates a target for images of \a width pixels and an optional \a alpha channel, whose bands are \a bandHeight rows in \a channelOrder.
+		Pass it to ImageSource::load() followed by finalize(), which delivers the last band. **/
+	static std::shared_ptr<ImageTargetBandsT>	create( int32_t width, bool alpha, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED );
+	//! Loads \a imageSource, calling \a bandFn with each band of \a bandHeight rows. Unless \a channelOrder specifies otherwise, the bands have an alpha channel if the image does.
+	static void		load( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED );
+
+	bool	hasAlpha() const override		{ return mBand.hasAlpha(); }
+	//! Returns a pointer to \a row, first passing the band in progress to the callback if \a row lies beyond it. Throws ImageIoException if rows arrive out of order.
+	void*	getRowPointer( int32_t row ) override;
+	//! Passes the band in progress to the callback
+	void	finalize() override;
+
+	int32_t		getBandHeight() const	{ return mBand.getHeight(); }
+
+  protected:
+	ImageTargetBandsT( int32_t width, bool alpha, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder );
+
+	//! Calls the BandFn with the rows of the band up to \a endRow
+	void	flush( int32_t endRow );
+
+	SurfaceT<T>		mBand;
+	BandFn			mBandFn;
+	int32_t			mBandY, mEndRow; // the image rows of the band in progress, and one past the last row written to it
+	bool			mFillAlpha; // set by load() when the band has alpha but the image doesn't
+};
+
+typedef ImageTargetBandsT<uint8_t>		ImageTargetBands8u;
+typedef ImageTargetBandsT<uint16_t>		ImageTargetBands16u;
+typedef ImageTargetBandsT<float>		ImageTargetBands32f;
+
+} // namespace cinder
@@ -0,0 +1,88 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageTargetFilePng>	ImageTargetFilePngRef;
+
+/** \brief Writes PNG files using zlib, deflating horizontal bands of rows on the ip::ThreadPool, or serially when none is installed.
+	Each band after the first is primed with the last 32k of the one before it, so the result is a single ordinary zlib stream which
+	compresses nearly as well as a serial encoder would. Writes 16-bit PNGs for UINT16 sources and 8-bit PNGs for everything else. **/
+class CI_API ImageTargetFilePng : public ImageTarget {
+  public:
+	//! The PNG row filter applied before deflating
+	typedef enum Filter { FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_AVERAGE, FILTER_PAETH, FILTER_ADAPTIVE } Filter;
+	//! The zlib strategy used to deflate the filtered rows, see deflateInit2()
+	typedef enum Strategy { STRATEGY_DEFAULT, STRATEGY_FILTERED, STRATEGY_HUFFMAN_ONLY, STRATEGY_RLE } Strategy;
+
+	class CI_API Options : public ImageTarget::Options {
+	  public:
+		Options() : mLevel( 6 ), mFilter( FILTER_ADAPTIVE ), mStrategy( STRATEGY_DEFAULT ) {}
+		Options( const ImageTarget::Options &options ) : ImageTarget::Options( options ), mLevel( 6 ), mFilter( FILTER_ADAPTIVE ), mStrategy( STRATEGY_DEFAULT ) {}
+
+		//! Sets the zlib compression level, from \c 0 (stored) through \c 1 (fastest) to \c 9 (smallest). Defaults to \c 6.
+		Options&	level( int level )					{ mLevel = level; return *this; }
+		//! Sets the row filter. Defaults to FILTER_ADAPTIVE, which picks the filter with the smallest sum of absolute differences for each row.
+		Options&	filter( Filter filter )				{ mFilter = filter; return *this; }
+		//! Sets the zlib strategy. Defaults to STRATEGY_DEFAULT.
+		Options&	strategy( Strategy strategy )		{ mStrategy = strategy; return *this; }
+
+		int			getLevel() const		{ return mLevel; }
+		Filter		getFilter() const		{ return mFilter; }
+		Strategy	getStrategy() const		{ return mStrategy; }
+
+	  protected:
+		int			mLevel;
+		Filter		mFilter;
+		Strategy	mStrategy;
+	};
+
+	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, const Options &options );
+
+	void*	getRowPointer( int32_t row ) override;
+	//! Filters, deflates and writes the image to the DataTarget's stream
+	void	finalize() override;
+
+	static void		registerSelf();
+
+  protected:
+	ImageTargetFilePng( DataTargetRef dataTarget, ImageSourceRef imageSource, const Options &options );
+
+	//! Filters the rows [\a begin, \a end) into \a dest, each preceded by its filter type byte
+	void	filterRows( int32_t begin, int32_t end, uint8_t *dest ) const;
+
+	DataTargetRef			mDataTarget;
+	Options					mOptions;
+	uint8_t					mNumComponents, mBytesPerSample;
+	size_t					mRowBytes;
+	std::vector<uint8_t>	mData;
+};
+
+} // namespace cinder
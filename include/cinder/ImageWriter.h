@@ -0,0 +1,111 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageWriter>	ImageWriterRef;
+
+/** \brief Encodes and writes images on background threads, so that a loop saving frames doesn't wait for compression.
+	write() loads the image into an ImageTarget on the calling thread, after which the caller may reuse its Surface, and queues the
+	target's finalize(), where encoders such as ImageTargetFilePng compress and write the file, for a worker thread. With a single worker,
+	files are written in the order they were queued. All methods are thread-safe.
+	\code writer->write( "frames/" + toString( frame ) + ".png", surface ); \endcode **/
+class CI_API ImageWriter : private Noncopyable {
+  public:
+	class CI_API Options {
+	  public:
+		Options() : mNumThreads( 1 ), mMaxPending( 0 ) {}
+
+		//! Sets the number of worker threads. Defaults to \c 1, as encoders which are parallel themselves, like ImageTargetFilePng, gain little from more.
+		Options&	numThreads( size_t numThreads )		{ mNumThreads = numThreads; return *this; }
+		/** Limits the number of writes waiting for a worker, beyond which write() blocks until one starts. This bounds the memory held by
+			queued images when they are produced faster than they can be written. The default of \c 0 doesn't limit them. **/
+		Options&	maxPending( size_t maxPending )		{ mMaxPending = maxPending; return *this; }
+
+		size_t	getNumThreads() const	{ return mNumThreads; }
+		size_t	getMaxPending() const	{ return mMaxPending; }
+
+	  private:
+		size_t	mNumThreads, mMaxPending;
+	};
+
+	//! Creates an ImageWriter and starts its worker threads
+	static ImageWriterRef	create( const Options &options = Options() );
+	//! Waits for every queued write to complete
+	~ImageWriter();
+
+	//! Loads \a imageSource into a target for \a dataTarget as writeImage() does, and queues its encoding. The returned future holds any exception thrown by the encoder.
+	std::shared_future<void>	write( const DataTargetRef &dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
+	//! Loads \a imageSource into a target for the file at \a path, creating its directories, and queues its encoding. The returned future holds any exception thrown by the encoder.
+	std::shared_future<void>	write( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
+	//! Queues the finalize() of \a imageTarget, into which an image has already been loaded
+	std::shared_future<void>	write( const ImageTargetRef &imageTarget );
+
+	//! Blocks until every write queued so far has completed
+	void	waitAll();
+
+	//! Returns the number of worker threads
+	size_t	getNumThreads() const	{ return mWorkers.size(); }
+	//! Returns the number of writes waiting for a worker
+	size_t	getNumPending() const;
+	//! Returns the number of writes being encoded
+	size_t	getNumWriting() const;
+
+  protected:
+	ImageWriter( const Options &options );
+
+  private:
+	struct Job {
+		ImageTargetRef			mTarget;
+		std::promise<void>		mPromise;
+	};
+
+	void	workerLoop();
+
+	Options								mOptions;
+	std::vector<std::thread>			mWorkers;
+	std::deque<std::shared_ptr<Job>>	mPending;
+	size_t								mNumWriting;
+	bool								mStop;
+	mutable std::mutex					mMutex;
+	std::condition_variable				mWorkCondition, mSpaceCondition, mIdleCondition;
+};
+
+//! Writes \a imageSource to \a dataTarget like writeImage(), but returns once the image has been loaded, leaving its encoding to a shared ImageWriter with one worker thread
+CI_API std::shared_future<void>	writeImageAsync( DataTargetRef dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
+//! Writes \a imageSource to file path \a path like writeImage(), but returns once the image has been loaded, leaving its encoding to a shared ImageWriter with one worker thread
+CI_API std::shared_future<void>	writeImageAsync( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options = ImageTarget::Options(), std::string extension = "" );
+
+} // namespace cinder
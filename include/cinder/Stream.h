@@ -122,7 +122,13 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	void		read( fs::path *p );
 	void		readFixedString( char *t, size_t maxSize, bool nullTerminate );
 	void		readFixedString( std::string *t, size_t size );
+	//! Reads characters until a line terminator of "\n", "\r\n" or "\r", which is consumed but not returned
 	std::string	readLine();
+	/** Reads the next line without copying it where the stream allows. Sets \a line to its first character and \a length to its length, excluding the terminator.
+		The characters remain valid until the next read from or seek of the stream. Returns \c false once the stream is exhausted. **/
+	bool		readLine( const char **line, size_t *length ) { return IOReadLine( line, length ); }
+	//! Reads the next line into \a line, reusing its capacity. Returns \c false once the stream is exhausted.
+	bool		readLine( std::string *line );
 	
 	void			readData( void *dest, size_t size );
 	virtual size_t	readDataAvailable( void *dest, size_t maxSize ) = 0;
@@ -134,6 +140,10 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	IStreamCinder() = default;
 
 	virtual void		IORead( void *t, size_t size ) = 0;
+	//! Reads chunks with readDataAvailable() and seeks back over what follows the line. Streams with an internal buffer override this to scan it in place.
+	virtual bool		IOReadLine( const char **line, size_t *length );
+
+	std::string			mLineBuffer; // holds lines which aren't contiguous in the stream's own memory
 		
 	static const int	MINIMUM_BUFFER_SIZE = 8; // minimum bytes of random access a stream must offer relative to the file start
 };
@@ -171,7 +181,10 @@ class CI_API IStreamFile : public IStreamCinder {
 	IStreamFile( FILE *aFile, bool aOwnsFile = true, int32_t aDefaultBufferSize = 2048 );
 
 	virtual void		IORead( void *t, size_t size );
+	bool				IOReadLine( const char **line, size_t *length ) override;
 	size_t				readDataImpl( void *dest, size_t maxSize );
+	//! Refills the buffer from the current offset unless it already holds it. Returns the number of buffered bytes from there.
+	size_t				fillBuffer();
  
 	FILE						*mFile;
 	bool						mOwnsFile;
@@ -308,6 +321,7 @@ class CI_API IStreamMem : public IStreamCinder {
  	IStreamMem( const void *aData, size_t aDataSize );
 
 	virtual void	IORead( void *t, size_t size );
+	bool			IOReadLine( const char **line, size_t *length ) override;
  
 	const uint8_t	*mData;
 	size_t			mDataSize;
@@ -92,11 +92,33 @@ class CI_API SurfaceConstraints {
 
 	virtual SurfaceChannelOrder getChannelOrder( bool alpha ) const { return ( alpha ) ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB; }
 	virtual ptrdiff_t			getRowBytes( int32_t requestedWidth, const SurfaceChannelOrder &sco, int elementSize ) const { return requestedWidth * elementSize * sco.getPixelInc(); }
+	//! Returns the allocator of the Surface's pixel memory
+	virtual SurfaceAllocatorRef	getAllocator() const { return SurfaceAllocator::getDefault(); }
 };
 
 class CI_API SurfaceConstraintsDefault : public SurfaceConstraints {
 };
 
+//! Pads rows to a multiple of \a alignment bytes and allocates pixel memory aligned to it, so every row of the Surface starts aligned
+class CI_API SurfaceConstraintsAligned : public SurfaceConstraints {
+  public:
+	//! \a alignment must be a power of two. If \a allocator is nullptr a SurfaceAllocatorAligned is used, otherwise \a allocator must guarantee at least \a alignment.
+	SurfaceConstraintsAligned( size_t alignment = 64, const SurfaceAllocatorRef &allocator = nullptr )
+		: mAlignment( alignment ), mAllocator( allocator ? allocator : SurfaceAllocatorAligned::create( alignment ) )
+	{}
+
+	ptrdiff_t			getRowBytes( int32_t requestedWidth, const SurfaceChannelOrder &sco, int elementSize ) const override
+	{
+		const ptrdiff_t alignment = static_cast<ptrdiff_t>( mAlignment );
+		return ( requestedWidth * elementSize * sco.getPixelInc() + alignment - 1 ) & ~( alignment - 1 );
+	}
+	SurfaceAllocatorRef	getAllocator() const override { return mAllocator; }
+
+  private:
+	size_t					mAlignment;
+	SurfaceAllocatorRef		mAllocator;
+};
+
 typedef std::shared_ptr<class ImageSource> ImageSourceRef;
 typedef std::shared_ptr<class ImageTarget> ImageTargetRef;
 
@@ -112,6 +134,8 @@ class CI_API SurfaceT {
 	SurfaceT( int32_t width, int32_t height, bool alpha, const SurfaceConstraints &constraints );
 	//! Constructs a surface from the memory pointed to by \a data. Does not assume ownership of the memory in \a data, which consequently should not be freed while the Surface is still in use.
 	SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder );
+	//! Constructs a surface from the memory pointed to by \a data, which holds a reference to \a dataStore to keep the memory alive. \a data may point anywhere inside \a dataStore's block.
+	SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder, const std::shared_ptr<T> &dataStore );
 	//! Constructs a Surface from an \a imageSource and optional \a constraints. Includes alpha channel if one is present in the ImageSource.
 	SurfaceT( ImageSourceRef imageSource, const SurfaceConstraints &constraints = SurfaceConstraintsDefault() );
 	//! Constructs a Surface from an \a imageSource and optional \a constraints. Includes alpha channel based on \a alpha.
@@ -134,6 +158,10 @@ class CI_API SurfaceT {
 	static std::shared_ptr<SurfaceT<T>>	create( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder )
 	{ return std::make_shared<SurfaceT<T>>( data, width, height, rowBytes, channelOrder ); }
 
+	//! Creates a SurfaceRef from the memory pointed to by \a data, which holds a reference to \a dataStore to keep the memory alive.
+	static std::shared_ptr<SurfaceT<T>>	create( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder, const std::shared_ptr<T> &dataStore )
+	{ return std::make_shared<SurfaceT<T>>( data, width, height, rowBytes, channelOrder, dataStore ); }
+
 	//! Creates a SurfaceRef from an \a imageSource and optional \a constraints. Includes alpha channel if one is present in the ImageSource.
 	static std::shared_ptr<SurfaceT<T>>	create( ImageSourceRef imageSource, const SurfaceConstraints &constraints = SurfaceConstraintsDefault() )
 	{ return std::make_shared<SurfaceT<T>>( imageSource, constraints ); }
@@ -187,6 +215,9 @@ class CI_API SurfaceT {
 	SurfaceT			clone( bool copyPixels = true ) const;
 	//! Returns a new Surface which is a duplicate of an Area \a area. If \a copyPixels the pixel values are copied, otherwise the clone's pixels remain uninitialized
 	SurfaceT			clone( const Area &area, bool copyPixels = true ) const;
+	/** \brief Returns a Surface which refers to the pixels of \a area in place, without copying. \a area is clipped to the bounds of the Surface.
+		The view shares and extends the lifetime of this Surface's data store; writes through either are visible in both. Copying the view (rather than moving it) creates an independent duplicate. **/
+	SurfaceT			getView( const Area &area ) const;
 
 	//! Retuns the raw data of an image as a pointer to either uin8t_t values in the case of a Surface8u or floats in the case of a Surface32f
 	T*					getData() { return mData; }
@@ -255,15 +286,20 @@ class CI_API SurfaceT {
 	//! Copies the Area \a srcArea of the Surface \a srcSurface to \a this Surface. The destination Area is \a srcArea offset by \a relativeOffset.
 	void	copyFrom( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &relativeOffset = ivec2() );
 
-	//! Returns an averaged color for the Area defined by \a area
+	/** \brief Replaces the pixels of the Surface with those of \a imageSource, which must be the same size, reusing the Surface's memory rather than allocating.
+		Suits Surfaces from a SurfacePool or caller-provided memory. ImageSources which support it decode straight into the Surface when their data type and channel order match its own.
+		\a dataBytes may declare the size of the block at getData() which the Surface owns, including the padding between rows and any memory past the last row, for such decoders to use.
+		Otherwise they are only used when the rows are packed back to back, as a view's padding may hold another Surface's pixels. Throws ImageIoException if the sizes differ. **/
+	void	load( const ImageSourceRef &imageSource, size_t dataBytes = 0 );
+
+	//! Returns an averaged color for the Area defined by \a area. For many queries against the same pixels, ip::IntegralImageT answers each in constant time.
 	ColorT<T>	areaAverage( const Area &area ) const;
   private:
 	void init( ImageSourceRef imageSource, const SurfaceConstraints &constraints, bool alpha );
 
 	void	copyRawSameChannelOrder( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
-	void	copyRawRgba( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
-	void 	copyRawRgbFullAlpha( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
-	void	copyRawRgb( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
+	//! Copies between different channel orders with the ip::swizzleRow() kernels. Alpha missing from \a srcSurface, and padding, are set to the maximum.
+	void	copyRawSwizzle( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
 
 	void	initChannels();
 
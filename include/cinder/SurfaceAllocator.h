@@ -0,0 +1,84 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Export.h"
+
+#include <cstddef>
+#include <memory>
+
+namespace cinder {
+
+typedef std::shared_ptr<class SurfaceAllocator>	SurfaceAllocatorRef;
+
+/** \brief Base class for allocators of the pixel memory owned by Surfaces and Channels.
+	Memory is returned as a shared_ptr whose deleter runs once the last Surface, Channel or view referencing it is destroyed,
+	which lets an allocator recycle blocks or carve them out of an arena it owns. **/
+class CI_API SurfaceAllocator {
+  public:
+	virtual ~SurfaceAllocator() {}
+
+	//! Returns a block of at least \a numBytes bytes whose address is a multiple of getAlignment(). Throws std::bad_alloc on failure.
+	virtual std::shared_ptr<void>	allocate( size_t numBytes ) = 0;
+	//! Returns the alignment in bytes of the blocks returned by allocate()
+	virtual size_t					getAlignment() const = 0;
+
+	//! Returns a block of \a numBytes bytes from allocate() typed for use as the data store of a SurfaceT<T> or ChannelT<T>
+	template<typename T>
+	std::shared_ptr<T>	allocateData( size_t numBytes )
+	{
+		std::shared_ptr<void> block = allocate( numBytes );
+		return std::shared_ptr<T>( block, static_cast<T*>( block.get() ) );
+	}
+
+	//! Returns the allocator used by Surfaces and Channels which aren't given one explicitly. Never returns nullptr.
+	static SurfaceAllocatorRef	getDefault();
+	//! Sets the allocator used by Surfaces and Channels which aren't given one explicitly. Passing nullptr restores the heap allocator.
+	static void					setDefault( const SurfaceAllocatorRef &allocator );
+};
+
+//! Allocates from the free store with new[], which is the default
+class CI_API SurfaceAllocatorHeap : public SurfaceAllocator {
+  public:
+	static std::shared_ptr<SurfaceAllocatorHeap>	create() { return std::make_shared<SurfaceAllocatorHeap>(); }
+
+	std::shared_ptr<void>	allocate( size_t numBytes ) override;
+	size_t					getAlignment() const override;
+};
+
+//! Allocates blocks aligned to a power-of-two number of bytes, such as a cache line or the width of a SIMD register
+class CI_API SurfaceAllocatorAligned : public SurfaceAllocator {
+  public:
+	//! Creates an allocator whose blocks are aligned to \a alignment bytes, which must be a power of two
+	static std::shared_ptr<SurfaceAllocatorAligned>	create( size_t alignment = 64 ) { return std::make_shared<SurfaceAllocatorAligned>( alignment ); }
+
+	explicit SurfaceAllocatorAligned( size_t alignment = 64 );
+
+	std::shared_ptr<void>	allocate( size_t numBytes ) override;
+	size_t					getAlignment() const override	{ return mAlignment; }
+
+  private:
+	size_t		mAlignment;
+};
+
+} // namespace cinder
@@ -0,0 +1,95 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class SurfacePool>	SurfacePoolRef;
+
+/** \brief Recycles the pixel memory of identically sized Surfaces and Channels, such as the per-frame buffers of a capture or processing loop.
+	Surfaces and Channels returned by getSurface() and getChannel() own their memory as usual, but when the last Surface, Channel or view referencing it is destroyed
+	the memory returns to the pool rather than the heap, and the next request for the same width, height, channel order and row alignment reuses it.
+	Buffers outliving their pool are simply freed. All methods are thread-safe. **/
+class CI_API SurfacePool : public std::enable_shared_from_this<SurfacePool> {
+  public:
+	//! Creates a pool whose rows are padded to and start on a multiple of \a alignment bytes, a power of two. Memory is obtained from \a allocator, or a SurfaceAllocatorAligned if it is nullptr.
+	static SurfacePoolRef	create( size_t alignment = 64, const SurfaceAllocatorRef &allocator = nullptr );
+
+	//! Returns a Surface of size \a width X \a height, with an optional \a alpha channel, reusing idle memory of the same shape if the pool holds any. Its pixels are uninitialized.
+	template<typename T>
+	SurfaceT<T>		getSurface( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED );
+	/** Returns a Surface holding the pixels of \a imageSource, with an alpha channel if it has one, in memory reused from the pool if it holds any of the same shape.
+		ImageSources which support it decode straight into the pooled memory. \see SurfaceT::load() **/
+	template<typename T>
+	SurfaceT<T>		getSurface( const ImageSourceRef &imageSource );
+	//! Returns a planar Channel of size \a width X \a height, reusing idle memory of the same shape if the pool holds any. Its pixels are uninitialized.
+	template<typename T>
+	ChannelT<T>		getChannel( int32_t width, int32_t height );
+
+	//! Frees all idle memory held by the pool. Memory in use is unaffected and still returns to the pool when released.
+	void		clear();
+	//! Sets the maximum number of idle bytes the pool holds on to. Memory released beyond this is freed instead. Defaults to no limit.
+	void		setMaxBytesHeld( size_t maxBytes );
+	size_t		getMaxBytesHeld() const;
+
+	//! Returns the number of requests served from idle memory
+	size_t		getNumHits() const;
+	//! Returns the number of requests which required a new allocation
+	size_t		getNumMisses() const;
+	//! Returns the number of idle bytes held by the pool, waiting to be reused
+	size_t		getBytesHeld() const;
+	//! Returns the number of bytes handed out by the pool and still referenced
+	size_t		getBytesInUse() const;
+	//! Resets the hit and miss counters
+	void		resetCounters();
+
+  protected:
+	SurfacePool( size_t alignment, const SurfaceAllocatorRef &allocator );
+
+  private:
+	// width, height, SurfaceChannelOrder code (UNSPECIFIED for Channels), element size and rowBytes
+	typedef std::tuple<int32_t, int32_t, int, size_t, ptrdiff_t>	Key;
+
+	//! Returns a block for \a key, of \a numBytes bytes, which comes back to the pool when its last reference is released
+	std::shared_ptr<void>	acquire( const Key &key, size_t numBytes );
+	void					recycle( const Key &key, const std::shared_ptr<void> &block, size_t numBytes );
+	ptrdiff_t				alignRowBytes( ptrdiff_t rowBytes ) const;
+
+	struct Recycler;
+
+	size_t												mAlignment;
+	SurfaceAllocatorRef									mAllocator;
+	mutable std::mutex									mMutex;
+	std::map<Key, std::vector<std::shared_ptr<void>>>	mIdleBlocks;
+	size_t												mMaxBytesHeld;
+	size_t												mNumHits, mNumMisses, mBytesHeld, mBytesInUse;
+};
+
+} // namespace cinder
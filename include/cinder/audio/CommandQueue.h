@@ -0,0 +1,72 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Export.h"
+#include "cinder/Noncopyable.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace cinder { namespace audio {
+
+//! \brief Bounded queue that hands commands from user threads over to the audio thread.
+//!
+//! Any number of threads can push() commands, they are serialized amongst themselves with a mutex that the audio thread never takes.
+//! A single consumer thread (normally the audio thread) runs pending commands with process(), which is wait-free.
+//!
+//! Commands are never destroyed by process(). The storage of a processed command, along with anything it captured, is released
+//! by the next call to push() or releaseProcessed(), so that deallocation happens on the user thread.
+class CI_API CommandQueue : private Noncopyable {
+  public:
+	typedef std::function<void ()>	Command;
+
+	//! Constructs a CommandQueue that can hold up to \a capacity pending or unreleased commands.
+	explicit CommandQueue( size_t capacity = 1024 );
+
+	//! Pushes \a command to be run by the next call to process(). Returns false if the queue is full, in which case \a command is not pushed.
+	bool	push( const Command &command );
+	//! Runs all commands pushed before this call, in the order they were pushed. Returns the number of commands run. \note Only safe to call from the consumer thread.
+	size_t	process();
+	//! Releases the storage of commands that have already been run. Called automatically by push().
+	void	releaseProcessed();
+
+	//! Returns the maximum number of commands that can be pending or unreleased.
+	size_t	getCapacity() const		{ return mCommands.size(); }
+	//! Returns the number of commands waiting to be run by process().
+	size_t	getNumPending() const	{ return mWriteIndex.load( std::memory_order_acquire ) - mReadIndex.load( std::memory_order_acquire ); }
+
+  private:
+	void	releaseProcessedImpl();
+
+	std::vector<Command>	mCommands;
+	// monotonic counters, a command's slot is its index modulo capacity.
+	std::atomic<size_t>		mWriteIndex, mReadIndex;
+	size_t					mReleaseIndex;	// guarded by mPushMutex
+	std::mutex				mPushMutex;
+};
+
+} } // namespace cinder::audio
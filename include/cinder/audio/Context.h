@@ -23,6 +23,8 @@
 
 #pragma once
 
+#include "cinder/audio/CommandQueue.h"
+#include "cinder/audio/GraphScheduler.h"
 #include "cinder/audio/Node.h"
 #include "cinder/audio/InputNode.h"
 #include "cinder/audio/OutputNode.h"
@@ -81,7 +83,7 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	//! Returns whether or not this \a Context is current enabled and processing audio.
 	bool isEnabled() const		{ return mEnabled; }
 
-	//! Called by \a node when it's connections have changed. Default implementation is empty.
+	//! Called by \a node when it's connections have changed. Default implementation reschedules the graph for parallel rendering, if enabled with setNumRenderThreads().
 	virtual void connectionsDidChange( const NodeRef &node );
 
 	//! Returns the samplerate of this Context, which is governed by the current OutputNode.
@@ -116,20 +118,35 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	//! If \a \a callFuncBeforeProcess is true, then `func` will be called at the beginning of the processing block, if false will be called at the end.
 	//! \note Should be called from the user thread. Currently only one event can be scheduled on a node at a time. \a node is owned until the scheduled event completes.
 	void scheduleEvent( double when, const NodeRef &node, bool callFuncBeforeProcess, const std::function<void ()> &func );
-	//! Immediately cancels any events scheduled with scheduleEvent().
+	//! Cancels any events scheduled on \a node with scheduleEvent(), taking effect before the next processing block.
 	void cancelScheduledEvents( const NodeRef &node );
 	//! \deprecated  use scheduleEvent() instead.
 	void schedule( double when, const NodeRef &node, bool callFuncBeforeProcess, const std::function<void ()> &func )	{ scheduleEvent( when, node, callFuncBeforeProcess, func ); }
 
+	//! Runs \a command on the audio thread at the beginning of the next processing block, without the audio thread ever waiting on a lock. If called from the audio thread, \a command is run immediately.
+	//! Anything captured by \a command is released on a non-audio thread. Used internally by Param and scheduleEvent().
+	void enqueueCommand( const std::function<void ()> &command );
+
+	//! Sets the number of worker threads that render independent branches of the Node graph in parallel with the audio thread. Default is 0, which renders the whole graph on the audio thread.
+	//! Workers poll for work while audio is being rendered, so \a numThreads should be less than the number of available cores. \see GraphScheduler
+	void	setNumRenderThreads( size_t numThreads );
+	//! Returns the number of worker threads that render the Node graph in parallel with the audio thread.
+	size_t	getNumRenderThreads() const		{ return mGraphScheduler.getNumThreads(); }
+	//! Returns the GraphScheduler that renders the Node graph across worker threads. Used internally by Node and Param.
+	GraphScheduler*	getGraphScheduler()		{ return &mGraphScheduler; }
+
 	//! Returns the mutex used to synchronize the audio thread. This is also used internally by the Node class when making connections.
+	//! \note Param and event scheduling don't lock this mutex, they hand their changes to the audio thread with enqueueCommand().
 	std::mutex& getMutex() const			{ return mMutex; }
-	//! Returns true if the current thread is the thread used for audio processing, false otherwise.
+	//! Returns true if the current thread is the thread used for audio processing or one of the GraphScheduler's render threads, false otherwise.
 	bool isAudioThread() const;
 
 	//! OutputNode implementations should call this before each rendering block.
 	void preProcess();
 	//! OutputNode implementations should call this after each rendering block.
 	void postProcess();
+	//! OutputNode implementations which render on a user thread, such as OutputOfflineNode, should call this after postProcess(), so that the thread is no longer treated as the audio thread once the block is done.
+	void clearAudioThread();
 	//! Returns the time in seconds spent during the last process loop.
 	double getTimeDuringLastProcessLoop() const	{ return mTimeDuringLastProcessLoop; }
 
@@ -177,11 +194,15 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	BufferDynamic			mAutoPullBuffer;
 
 	mutable std::mutex		mMutex;
-	std::thread::id			mAudioThreadId;
+	std::atomic<std::thread::id>	mAudioThreadId;
+	CommandQueue			mCommandQueue;
+	GraphScheduler			mGraphScheduler;
 
 	// - Context is stored in Node classes as a weak_ptr, so it needs to (for now) be created as a shared_ptr
 	static std::shared_ptr<Context>			sMasterContext;
 	static std::unique_ptr<DeviceManager>	sDeviceManager; // TODO: consider turning DeviceManager into a HardwareContext class
+
+	friend class GraphScheduler;
 };
 
 template<typename NodeT>
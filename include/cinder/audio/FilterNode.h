@@ -36,7 +36,8 @@ typedef std::shared_ptr<class FilterLowPassNode>		FilterLowPassNodeRef;
 typedef std::shared_ptr<class FilterHighPassNode>		FilterHighPassNodeRef;
 typedef std::shared_ptr<class FilterBandPassNode>		FilterBandPassNodeRef;
 
-//! General class for filtering nodes based on a biquad (two pole, two zero) filter.
+//! General class for filtering nodes based on a biquad (two pole, two zero) filter. All channels are filtered together in a dsp::BiquadBankd,
+//! and parameter changes are ramped in over the next processed block.
 class CI_API FilterBiquadNode : public Node {
   public:
 	//! The modes that are available as 'preset' coefficients, which set the frequency response to a common type of filter.
@@ -70,7 +71,9 @@ class CI_API FilterBiquadNode : public Node {
 
 	void updateBiquadParams();
 
+	// computes the coefficients for each channel, which are then loaded into mBiquadBank
 	std::vector<dsp::Biquad> mBiquads;
+	dsp::BiquadBankd mBiquadBank;
 	std::atomic<bool> mCoeffsDirty;
 	BufferT<double> mBufferd;
 	size_t mNiquist;
@@ -0,0 +1,123 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio/Buffer.h"
+#include "cinder/Export.h"
+#include "cinder/Noncopyable.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace cinder { namespace audio {
+
+class Context;
+class Node;
+
+//! \brief Renders independent branches of a Context's Node graph on a pool of worker threads.
+//!
+//! Whenever connections change, the graph reachable from the Context's output and auto-pulled Node's is topologically sorted. An input of a
+//! summing Node is rendered in parallel when nothing outside of that input's upstream branch (including Param processors) consumes any Node
+//! within it, and the branch contains no feedback loops. The summing Node then adds up the rendered inputs in the same order as a serial
+//! pull would, so the results are identical.
+//!
+//! The audio thread never waits on a lock: it hands out work through atomic counters and renders branches itself alongside the workers.
+//! If no worker wakes up in time the audio thread renders every branch, but it does wait for the branches that workers have already taken,
+//! so a worker that is preempted in the middle of a branch delays the block. Parallel rendering is not nested, summing Node's within a branch
+//! that is rendered in parallel pull their inputs serially.
+//!
+//! The workers render on behalf of the audio thread, so Context::isAudioThread() returns true on them.
+//!
+//! Owned by the Context, see Context::setNumRenderThreads().
+class CI_API GraphScheduler : private Noncopyable {
+  public:
+	GraphScheduler( Context *context );
+	~GraphScheduler();
+
+	//! Sets the number of worker threads, 0 disables parallel rendering. \note Must be synchronized with the audio thread with Context::getMutex().
+	void	setNumThreads( size_t numThreads );
+	//! Returns the number of worker threads.
+	size_t	getNumThreads() const	{ return mNumThreads; }
+
+	//! Marks the current schedule as out of date, so that it isn't used until update() is called. Called whenever the topology of the graph changes.
+	void	invalidate();
+	//! Rebuilds the schedule and hands it to the audio thread with Context::enqueueCommand(). Does nothing if there are no worker threads or when called from the audio thread.
+	void	update();
+
+	//! Called from Node::sumInputs() on the audio thread. Renders the inputs of \a node that were scheduled in parallel and returns where the samples of each input ended up,
+	//! in the order of Node::getInputs(), with null for inputs that must still be pulled serially. Returns null if no inputs of \a node are scheduled in parallel.
+	const std::vector<const Buffer *>*	renderInputs( Node *node );
+
+	//! Returns true if called from one of the worker threads.
+	bool		isWorkerThread() const;
+	//! Returns the number of inputs of \a node that the current schedule renders in parallel, 0 if they are all pulled serially. \note Must be synchronized with the audio thread with Context::getMutex().
+	size_t		getNumParallelInputs( const Node *node ) const;
+	//! Returns the number of times that the inputs of a summing Node have been rendered in parallel, for debugging.
+	uint64_t	getNumParallelRenders() const	{ return mNumParallelRenders; }
+
+  private:
+	struct Task {
+		Task( Node *input, size_t inputIndex, size_t numFrames, size_t numChannels )
+			: mInput( input ), mInputIndex( inputIndex ), mBuffer( numFrames, numChannels )
+		{}
+
+		Node*	mInput;
+		size_t	mInputIndex;
+		Buffer	mBuffer;	// used if mInput processes in-place, sized like the summing Node's internal buffer
+	};
+
+	struct Entry {
+		std::vector<Node *>			mInputs;	// all inputs of the summing Node, in the order they are pulled
+		std::vector<Task>			mTasks;
+		std::vector<const Buffer *>	mRendered;
+	};
+
+	struct Schedule {
+		uint64_t								mGeneration;
+		std::unordered_map<const Node *, Entry>	mEntries;
+	};
+
+	void	runTasks( std::vector<Task> *tasks );
+	void	runAvailableTasks();
+	void	workerLoop();
+
+	Context*					mContext;
+	std::vector<std::thread>	mThreads;
+	std::atomic<size_t>			mNumThreads;
+	std::atomic<bool>			mThreadsShouldQuit;
+
+	std::atomic<uint64_t>		mGeneration;
+	std::shared_ptr<Schedule>	mSchedule;	// only accessed on the audio thread, or while synchronized with it
+
+	// state of the batch of tasks currently being rendered
+	std::vector<Task>*			mTasks;
+	std::atomic<bool>			mBatchActive;
+	std::atomic<size_t>			mNextTask, mNumTasksCompleted, mNumActiveWorkers;
+	std::atomic<uint64_t>		mNumParallelRenders;
+};
+
+} } // namespace cinder::audio
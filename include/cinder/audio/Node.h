@@ -36,6 +36,8 @@ namespace cinder { namespace audio {
 typedef std::shared_ptr<class Context>			ContextRef;
 typedef std::shared_ptr<class Node>				NodeRef;
 
+class Param;
+
 //! \brief Fundamental building block for creating an audio processing graph.
 //!
 //!	Node's allow for flexible combinations of synthesis, analysis, effects, file reading/writing, etc, and are designed so that
@@ -248,9 +250,11 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 
 	std::set<std::shared_ptr<Node> >	mInputs;
 	std::vector<std::weak_ptr<Node> >	mOutputs;
+	std::vector<Param *>				mParams; // registered by Param's constructor, so that a Param's processor can be found when scheduling the graph
 
 	friend class Context;
 	friend class Param;
+	friend class GraphScheduler;
 };
 
 //! Enable connection syntax: `input >> output`, which is equivelant to `input->connect( output )`. Enables chaining.  \return the connected \a output
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio/Context.h"
+#include "cinder/Timer.h"
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class OfflineContext>		OfflineContextRef;
+typedef std::shared_ptr<class OutputOfflineNode>	OutputOfflineNodeRef;
+
+class TargetFile;
+
+//! \brief OutputNode that is driven by OfflineContext::render() instead of a hardware clock.
+//!
+//! The samplerate and frames per block are fixed at construction. You do not construct an OutputOfflineNode directly, the OfflineContext creates it.
+class CI_API OutputOfflineNode : public OutputNode {
+  public:
+	OutputOfflineNode( size_t sampleRate, size_t framesPerBlock, const Format &format = Format() );
+
+	//! Returns the samplerate this Node was constructed with.
+	size_t getOutputSampleRate() override			{ return mSampleRate; }
+	//! Returns the frames per block this Node was constructed with.
+	size_t getOutputFramesPerBlock() override		{ return mFramesPerBlock; }
+
+  protected:
+	bool supportsProcessInPlace() const override	{ return false; }
+
+  private:
+	// Pulls one block through the graph into the internal buffer.
+	void renderInputs();
+
+	size_t		mSampleRate, mFramesPerBlock;
+
+	friend class OfflineContext;
+};
+
+//! \brief Context that renders the Node graph as fast as the CPU allows, without any audio hardware.
+//!
+//! Audio is only processed when one of the render() methods is called, on the calling thread, which then acts as the audio thread.
+//! Processing does not depend on whether the Context is enabled. Scheduled events and Param ramps are measured against the
+//! rendered frames, so a render is sample accurate and repeatable. This makes it suitable for bouncing audio to a Buffer or file,
+//! for running a graph where no sound server is available, and for benchmarking graphs. The graph always advances by whole blocks; when
+//! the number of frames requested isn't a multiple of getFramesPerBlock(), the remainder of the last block is discarded.
+//!
+//! An OfflineContext must be owned by a shared_ptr, since Node's keep a weak reference to their Context. Use create().
+//! \note Creating hardware device Node's is not supported and throws AudioContextExc.
+class CI_API OfflineContext : public Context {
+  public:
+	struct Format {
+		Format()
+			: mSampleRate( 44100 ), mFramesPerBlock( 512 ), mChannels( 2 )
+		{}
+
+		//! Sets the samplerate of the rendered audio. Default is 44100.
+		Format& sampleRate( size_t sampleRate )			{ mSampleRate = sampleRate; return *this; }
+		//! Sets the number of frames pulled through the graph in one block. Default is 512.
+		Format& framesPerBlock( size_t framesPerBlock )	{ mFramesPerBlock = framesPerBlock; return *this; }
+		//! Sets the number of channels of the OutputOfflineNode. Default is 2.
+		Format& channels( size_t channels )				{ mChannels = channels; return *this; }
+
+		size_t	getSampleRate() const			{ return mSampleRate; }
+		size_t	getFramesPerBlock() const		{ return mFramesPerBlock; }
+		size_t	getChannels() const				{ return mChannels; }
+
+	  private:
+		size_t	mSampleRate, mFramesPerBlock, mChannels;
+	};
+
+	//! Creates a new OfflineContext configured with \a format.
+	static OfflineContextRef create( const Format &format = Format() );
+
+	//! Not supported, throws AudioContextExc.
+	OutputDeviceNodeRef	createOutputDeviceNode( const DeviceRef &device = Device::getDefaultOutput(), const Node::Format &format = Node::Format() ) override;
+	//! Not supported, throws AudioContextExc.
+	InputDeviceNodeRef	createInputDeviceNode( const DeviceRef &device = Device::getDefaultInput(), const Node::Format &format = Node::Format() ) override;
+
+	//! Overridden to only accept an OutputOfflineNode, throws AudioContextExc for any other type of OutputNode.
+	void setOutput( const OutputNodeRef &output ) override;
+	//! Returns the OutputOfflineNode, which is created the first time this is called.
+	const OutputNodeRef& getOutput() override;
+
+	//! Renders one block of getFramesPerBlock() frames. The result is available in getOutput()->getInternalBuffer().
+	void renderBlock();
+	//! Renders enough blocks to fill \a destBuffer, which must have the same number of channels as the output.
+	void render( Buffer *destBuffer );
+	//! Renders \a numFrames frames and writes them to \a target, which must match the samplerate and number of channels of the output.
+	void render( TargetFile *target, size_t numFrames );
+
+	//! Returns the number of seconds of audio rendered per second of wall-clock time during the last call to render(), or 0 if nothing has been rendered yet.
+	double getRenderSpeed() const		{ return mRenderSpeed; }
+
+  protected:
+	OfflineContext( const Format &format );
+
+  private:
+	// Renders \a numFrames, handing each rendered block and the number of frames used from it to \a blockFn.
+	void renderFrames( size_t numFrames, const std::function<void ( const Buffer *, size_t, size_t )> &blockFn );
+
+	Format					mFormat;
+	OutputOfflineNodeRef	mOfflineOutput;
+	Timer					mRenderTimer;
+	double					mRenderSpeed;
+};
+
+} } // namespace cinder::audio
@@ -29,6 +29,7 @@
 #include <list>
 #include <atomic>
 #include <functional>
+#include <mutex>
 #include <string>
 
 namespace cinder { namespace audio {
@@ -89,7 +90,8 @@ class CI_API Event {
 //! You can also set a Node as the 'processor' with Param::setProcessor(), enabling you to control it with an arbitrary signal.
 //!
 //! A Param is owned by a parent Node, from which it gains access to the current Context.  This is a necessary step in making it sample
-//! accurate yet still controllable in a thread-safe manager on the user thread.
+//! accurate yet still controllable in a thread-safe manager on the user thread. Changes made on the user thread never lock the Context's mutex,
+//! they are handed over to the audio thread with Context::enqueueCommand() and take effect at the beginning of the next processing block.
 //!
 //! \note Ramp Events should not overlap, or you may get discontinuities in the evaluated curve. This could potentially happen when
 //! using multiple appendRamp() calls. Instead, use applyRamp() and set Options::beginTime() accordingly, which will remove any
@@ -150,7 +152,7 @@ class CI_API Param {
 	//! Sets this Param's input to be the processing performed by \a node. Any existing Event's are discarded. \note Forces \a node to be mono.
 	void	setProcessor( const NodeRef &node );
 	//! Returns this Param's processing Node, or an empty NodeRef if none is set.
-	NodeRef	getProcessor() const	{ return mProcessor; }
+	NodeRef	getProcessor() const;
 
 	//! Resets Param, blowing away any Event's or processing Node. \note Must be called from a non-audio thread.
 	void reset();
@@ -173,18 +175,29 @@ class CI_API Param {
 
   protected:
 
-	// non-locking protected methods
-	void		initInternalBuffer();
-	void		resetImpl();
+	// user thread methods that hand changes to the audio thread
+	void		applyEvent( const EventRef &event );
+	void		appendEvent( const EventRef &event );
+	void		resetImpl( const NodeRef &processor );
+	void		pruneUserEvents() const;
+	// audio thread methods
 	void		removeEventsAt( double time );
+
+	void		initInternalBuffer();
 	ContextRef	getContext() const;
 
+	// owned by the audio thread
 	std::list<EventRef>	mEvents;
 	std::atomic<float>	mValue;
 	bool				mIsVaryingThisBlock;
 	Node*				mParentNode;
 	NodeRef				mProcessor;
 	BufferDynamic		mInternalBuffer;
+
+	// the user thread's view of the scheduled Events and processor, guarded by mUserMutex
+	mutable std::list<EventRef>	mUserEvents;
+	NodeRef						mUserProcessor;
+	mutable std::mutex			mUserMutex;
 };
 
 } } // namespace cinder::audio
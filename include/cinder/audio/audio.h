@@ -28,6 +28,7 @@
 #include "cinder/audio/Context.h"
 #include "cinder/audio/Device.h"
 #include "cinder/audio/Exception.h"
+#include "cinder/audio/OfflineContext.h"
 #include "cinder/audio/Param.h"
 #include "cinder/audio/Source.h"
 #include "cinder/audio/Target.h"
@@ -77,16 +77,33 @@ void convert( const SourceT *sourceArray, DestT *destArray, size_t length )
 		destArray[i] = static_cast<DestT>( sourceArray[i] );
 }
 
-//! Converts a float or double array to int16_t
+namespace detail {
+
+// Scales and clamps like maxps( x, lo ) followed by minps( x, hi ), so that NaNs land on lo as they do in the SIMD kernels, then truncates
+template<typename FloatT>
+inline int32_t floatToInt( FloatT sample, FloatT normalizer, FloatT lo, FloatT hi )
+{
+	FloatT scaled = sample * normalizer;
+	scaled = scaled > lo ? scaled : lo;
+	scaled = scaled < hi ? scaled : hi;
+	return int32_t( scaled );
+}
+
+} // namespace detail
+
+//! Converts a float or double array to int16_t, saturating samples outside of [-1, 1)
 template<typename FloatT>
 void convert( const FloatT *sourceArray, int16_t *destArray, size_t length )
 {
 	const FloatT intNormalizer = 32768;
 
 	for( size_t i = 0; i < length; i++ )
-		destArray[i] = int16_t( sourceArray[i] * intNormalizer );
+		destArray[i] = int16_t( detail::floatToInt<FloatT>( sourceArray[i], intNormalizer, -32768, 32767 ) );
 }
 
+//! Converts a float array to int16_t, saturating samples outside of [-1, 1). Vectorized with SSE2, AVX2 or NEON where available.
+CI_API void convert( const float *sourceArray, int16_t *destArray, size_t length );
+
 //! Converts an int16_t array to float or double
 template<typename FloatT>
 void convert( const int16_t *sourceArray, FloatT *destArray, size_t length )
@@ -97,6 +114,9 @@ void convert( const int16_t *sourceArray, FloatT *destArray, size_t length )
 		destArray[i] = (FloatT)sourceArray[i] * floatNormalizer;
 }
 
+//! Converts an int16_t array to float. Vectorized with SSE2, AVX2 or NEON where available.
+CI_API void convert( const int16_t *sourceArray, float *destArray, size_t length );
+
 //! Converts between two BufferT's of different precision (ex. float to double).  The number of frames converted is the lesser of the two. The number of channels converted is the lesser of the two.
 template <typename SourceT, typename DestT>
 void convertBuffer( const BufferT<SourceT> *sourceBuffer, BufferT<DestT> *destBuffer )
@@ -115,26 +135,32 @@ void convertInt24ToFloat( const char *sourceArray, FloatT *destArray, size_t len
 	const FloatT floatNormalizer = (FloatT)1 / (FloatT)8388607;
 
 	for( size_t i = 0; i < length; i++ ) {
-		int32_t sample = (int32_t)( ( (int32_t)sourceArray[2] ) << 16 ) | ( ( (int32_t)(uint8_t)sourceArray[1] ) << 8 ) | ( (int32_t)(uint8_t)sourceArray[0] );
+		int32_t sample = (int32_t)( ( (int32_t)(int8_t)sourceArray[2] ) << 16 ) | ( ( (int32_t)(uint8_t)sourceArray[1] ) << 8 ) | ( (int32_t)(uint8_t)sourceArray[0] );
 		destArray[i] = (FloatT)sample * floatNormalizer;
 		sourceArray += 3;
 	}
 }
 
-//! Converts the floating point \a sourceArray to 24-bit int precision, placing the result in \a destArray. \a length samples are converted.
+//! Converts the 24-bit int \a sourceArray to float, placing the result in \a destArray. \a length samples are converted. Vectorized with AVX2 where available.
+CI_API void convertInt24ToFloat( const char *sourceArray, float *destArray, size_t length );
+
+//! Converts the floating point \a sourceArray to 24-bit int precision, saturating samples outside of [-1, 1], placing the result in \a destArray. \a length samples are converted.
 template<typename FloatT>
 void convertFloatToInt24( const FloatT *sourceArray, char *destArray, size_t length )
 {
 	const FloatT intNormalizer = 8388607;
 
 	for( size_t i = 0; i < length; i++ ) {
-		int32_t sample = int32_t( sourceArray[i] * intNormalizer );
+		int32_t sample = detail::floatToInt<FloatT>( sourceArray[i], intNormalizer, -8388608, 8388607 );
 		*(destArray++) = (char)( sample & 255 );
 		*(destArray++) = (char)( ( sample >> 8 ) & 255 );
 		*(destArray++) = (char)( ( sample >> 16 ) & 255 );
 	}
 }
 
+//! Converts the float \a sourceArray to 24-bit int precision, saturating samples outside of [-1, 1], placing the result in \a destArray. \a length samples are converted. Vectorized with AVX2 where available.
+CI_API void convertFloatToInt24( const float *sourceArray, char *destArray, size_t length );
+
 //! Interleaves \a numCopyFrames of \a nonInterleavedSourceArray, placing the result in \a interleavedDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
 template<typename T>
 void interleave( const T *nonInterleavedSourceArray, T *interleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
@@ -149,7 +175,10 @@ void interleave( const T *nonInterleavedSourceArray, T *interleavedDestArray, si
 	}
 }
 
-//! Interleaves \a numCopyFrames of \a nonInterleavedFloatSourceArray and converts from floating point to 16-bit int precision at the same time, placing the result in \a interleavedInt16DestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+//! Interleaves \a numCopyFrames of the float \a nonInterleavedSourceArray, placing the result in \a interleavedDestArray. Mono and stereo are vectorized with SSE2, AVX2 or NEON where available.
+CI_API void interleave( const float *nonInterleavedSourceArray, float *interleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
+//! Interleaves \a numCopyFrames of \a nonInterleavedFloatSourceArray and converts from floating point to 16-bit int precision at the same time, saturating samples outside of [-1, 1) and placing the result in \a interleavedInt16DestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
 template<typename FloatT>
 void interleave( const FloatT *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
 {
@@ -159,12 +188,15 @@ void interleave( const FloatT *nonInterleavedFloatSourceArray, int16_t *interlea
 		size_t x = ch;
 		const FloatT *sourceChannel = &nonInterleavedFloatSourceArray[ch * numFramesPerChannel];
 		for( size_t i = 0; i < numCopyFrames; i++ ) {
-			interleavedInt16DestArray[x] = int16_t( sourceChannel[i] * intNormalizer );
+			interleavedInt16DestArray[x] = int16_t( detail::floatToInt<FloatT>( sourceChannel[i], intNormalizer, -32768, 32767 ) );
 			x += numChannels;
 		}
 	}
 }
 
+//! Interleaves \a numCopyFrames of \a nonInterleavedFloatSourceArray and converts to 16-bit int, saturating samples outside of [-1, 1). Mono and stereo are vectorized with SSE2, AVX2 or NEON where available.
+CI_API void interleave( const float *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
 //! De-interleaves \a numCopyFrames of \a interleavedSourceArray, placing the result in \a nonInterleavedDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
 template<typename T>
 void deinterleave( const T *interleavedSourceArray, T *nonInterleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
@@ -179,6 +211,9 @@ void deinterleave( const T *interleavedSourceArray, T *nonInterleavedDestArray,
 	}
 }
 
+//! De-interleaves \a numCopyFrames of the float \a interleavedSourceArray, placing the result in \a nonInterleavedDestArray. Mono and stereo are vectorized with SSE2, AVX2 or NEON where available.
+CI_API void deinterleave( const float *interleavedSourceArray, float *nonInterleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
 //! De-interleaves \a numCopyFrames of \a interleavedInt16SourceArray and converts from 16-bit int to floating point precision at the same time, placing the result in \a nonInterleavedFloatDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
 template<typename FloatT>
 void deinterleave( const int16_t *interleavedInt16SourceArray, FloatT *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
@@ -195,6 +230,9 @@ void deinterleave( const int16_t *interleavedInt16SourceArray, FloatT *nonInterl
 	}
 }
 
+//! De-interleaves \a numCopyFrames of \a interleavedInt16SourceArray and converts to float. Mono and stereo are vectorized with SSE2, AVX2 or NEON where available.
+CI_API void deinterleave( const int16_t *interleavedInt16SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
 //! De-interleaves \a numCopyFrames of \a interleavedInt24SourceArray and converts from 24-bit int to floating point precision at the same time, placing the result in \a nonInterleavedFloatDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
 template<typename FloatT>
 void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, FloatT *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
@@ -205,12 +243,17 @@ void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, FloatT *
 		size_t x = ch;
 		FloatT *destChannel = &nonInterleavedFloatDestArray[ch * numFramesPerChannel];
 		for( size_t i = 0; i < numCopyFrames; i++ ) {
-			int32_t sample = (int32_t)( ( (int32_t)interleavedInt24SourceArray[2] ) << 16 ) | ( ( (int32_t)(uint8_t)interleavedInt24SourceArray[1] ) << 8 ) | ( (int32_t)(uint8_t)interleavedInt24SourceArray[0] );
+			const char *source = &interleavedInt24SourceArray[x * 3];
+			int32_t sample = (int32_t)( ( (int32_t)(int8_t)source[2] ) << 16 ) | ( ( (int32_t)(uint8_t)source[1] ) << 8 ) | ( (int32_t)(uint8_t)source[0] );
 			destChannel[i] = (FloatT)sample * floatNormalizer;
 			x += numChannels;
 		}
 	}
 }
+
+//! De-interleaves \a numCopyFrames of \a interleavedInt24SourceArray and converts to float. Mono is vectorized with AVX2 where available.
+CI_API void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
 //! Interleaves \a nonInterleavedSource, placing the result in \a interleavedDest.
 template<typename T>
 void interleaveBuffer( const BufferT<T> *nonInterleavedSource, BufferInterleavedT<T> *interleavedDest )
@@ -231,43 +274,24 @@ void deinterleaveBuffer( const BufferInterleavedT<T> *interleavedSource, BufferT
 	deinterleave( interleavedSource->getData(), nonInterleavedDest->getData(), nonInterleavedDest->getNumFrames(), nonInterleavedDest->getNumChannels(), nonInterleavedDest->getNumFrames() );
 }
 
-//! Interleaves \a nonInterleavedSource, placing the result in \a interleavedDest. This method is only slightly faster than interleaveBuffer(), which can handle an arbitrary number of channels.
+//! Interleaves the two channels of \a nonInterleavedSource, placing the result in \a interleavedDest. Float buffers use the vectorized stereo path of interleave().
 template<typename T>
 void interleaveStereoBuffer( const BufferT<T> *nonInterleavedSource, BufferInterleavedT<T> *interleavedDest )
 {
 	CI_ASSERT( interleavedDest->getNumChannels() == 2 && nonInterleavedSource->getNumChannels() == 2 );
 	CI_ASSERT( interleavedDest->getSize() <= nonInterleavedSource->getSize() );
 
-	size_t numFrames = interleavedDest->getNumFrames();
-	const T *left = nonInterleavedSource->getChannel( 0 );
-	const T *right = nonInterleavedSource->getChannel( 1 );
-
-	T *mixed = interleavedDest->getData();
-
-	size_t i, j;
-	for( i = 0, j = 0; i < numFrames; i++, j += 2 ) {
-		mixed[j] = left[i];
-		mixed[j + 1] = right[i];
-	}
+	interleave( nonInterleavedSource->getData(), interleavedDest->getData(), nonInterleavedSource->getNumFrames(), 2, interleavedDest->getNumFrames() );
 }
 
-//! De-interleaves \a interleavedSource, placing the result in \a nonInterleavedDest. This method is only slightly faster than deinterleaveStereoBuffer(), which can handle an arbitrary number of channels.
+//! De-interleaves the two channels of \a interleavedSource, placing the result in \a nonInterleavedDest. Float buffers use the vectorized stereo path of deinterleave().
 template<typename T>
 void deinterleaveStereoBuffer( const BufferInterleavedT<T> *interleavedSource, BufferT<T> *nonInterleavedDest )
 {
 	CI_ASSERT( interleavedSource->getNumChannels() == 2 && nonInterleavedDest->getNumChannels() == 2 );
 	CI_ASSERT( nonInterleavedDest->getSize() <= interleavedSource->getSize() );
 
-	size_t numFrames = nonInterleavedDest->getNumFrames();
-	T *left = nonInterleavedDest->getChannel( 0 );
-	T *right = nonInterleavedDest->getChannel( 1 );
-	const T *mixed = interleavedSource->getData();
-
-	size_t i, j;
-	for( i = 0, j = 0; i < numFrames; i++, j += 2 ) {
-		left[i] = mixed[j];
-		right[i] = mixed[j + 1];
-	}
+	deinterleave( interleavedSource->getData(), nonInterleavedDest->getData(), nonInterleavedDest->getNumFrames(), 2, nonInterleavedDest->getNumFrames() );
 }
 
 } } } // namespace cinder::audio::dsp
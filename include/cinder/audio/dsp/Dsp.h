@@ -56,7 +56,8 @@ enum class WindowType {
 //! fills \a window array with a windowing function specified by \a windowType
 CI_API void generateWindow( WindowType windowType, float *window, size_t length );
 
-// Vector based math routines.
+// Vector based math routines. These use vDSP on Cocoa, and elsewhere SSE2 or NEON, with AVX2 chosen at runtime when the CPU supports it.
+// Element-wise results match the scalar loops exactly; sum() and rms() accumulate in a different order and so may differ in the last bits.
 
 //! fills \a array with value \a value
 CI_API void fill( float value, float *array, size_t length );
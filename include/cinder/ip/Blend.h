@@ -30,10 +30,29 @@
 
 namespace cinder { namespace ip {
 
+/** Separable blend modes supported by blend(). Each is composited with the Porter-Duff "source over" operator, except
+	BLEND_ADD which is Porter-Duff "plus", the saturated sum of the premultiplied colors and alphas. **/
+typedef enum BlendMode {
+	//! The foreground color replaces the background color
+	BLEND_NORMAL,
+	//! The premultiplied colors and alphas are summed and clamped
+	BLEND_ADD,
+	//! The colors are multiplied, which darkens
+	BLEND_MULTIPLY,
+	//! The inverse colors are multiplied, which lightens
+	BLEND_SCREEN
+} BlendMode;
+
+//! Composites \a srcArea of \a foreground over \a background offset by \a dstRelativeOffset, respecting the alpha channel and premultiplication of each.
 CI_API void blend( Surface *background, const Surface &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset = ivec2() );
 CI_API inline void blend( Surface *background, const Surface &foreground ) { blend( background, foreground, background->getBounds(), ivec2() ); }
 CI_API void blend( Surface32f *background, const Surface32f &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset = ivec2() );
 CI_API inline void blend( Surface32f *background, const Surface32f &foreground ) { blend( background, foreground, background->getBounds(), ivec2() ); }
 
+//! Composites \a srcArea of \a foreground over \a background offset by \a dstRelativeOffset using the blend mode \a mode.
+CI_API void blend( Surface *background, const Surface &foreground, BlendMode mode, const Area &srcArea, const ivec2 &dstRelativeOffset = ivec2() );
+CI_API inline void blend( Surface *background, const Surface &foreground, BlendMode mode ) { blend( background, foreground, mode, background->getBounds(), ivec2() ); }
+CI_API void blend( Surface32f *background, const Surface32f &foreground, BlendMode mode, const Area &srcArea, const ivec2 &dstRelativeOffset = ivec2() );
+CI_API inline void blend( Surface32f *background, const Surface32f &foreground, BlendMode mode ) { blend( background, foreground, mode, background->getBounds(), ivec2() ); }
 
-} } // namespace cinder::ip
\ No newline at end of file
+} } // namespace cinder::ip
@@ -21,49 +21,133 @@
 */
 
 #include "cinder/Surface.h"
+#include "cinder/Noncopyable.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace cinder { namespace ip {
 
+/** \brief Working memory for the blur functions, which can be reused across calls so that they don't allocate.
+	Pass the same BlurScratch to repeated stackBlur() or gaussianBlur() calls, for example once per frame, and after the first
+	call no further memory is allocated for the same or smaller images. The blur functions borrow one buffer per band they process in
+	parallel, so a BlurScratch is safe to share between threads. Without a BlurScratch each call allocates its own working memory. **/
+class CI_API BlurScratch : private Noncopyable {
+  public:
+	BlurScratch() {}
+
+	//! A buffer borrowed from a BlurScratch by acquire(), which is returned to it when the Lease is destroyed
+	class CI_API Lease : private Noncopyable {
+	  public:
+		Lease( Lease &&rhs );
+		~Lease();
+
+		//! Returns the buffer, which is aligned to 64 bytes
+		template<typename T>
+		T*		get() const		{ return reinterpret_cast<T*>( mData ); }
+
+	  private:
+		Lease( BlurScratch *scratch, std::unique_ptr<uint8_t[]> &&storage, uint8_t *data, size_t size );
+
+		BlurScratch					*mScratch;
+		std::unique_ptr<uint8_t[]>	mStorage;
+		uint8_t						*mData;
+		size_t						mSize;
+
+		friend class BlurScratch;
+	};
+
+	//! Returns a buffer of at least \a numBytes, reusing a free one if possible.
+	Lease	acquire( size_t numBytes );
+	//! Frees the buffers which are not currently borrowed.
+	void	clear();
+	//! Returns the number of bytes held in buffers which are not currently borrowed.
+	size_t	getBytesHeld() const;
+
+  private:
+	struct Block {
+		std::unique_ptr<uint8_t[]>	mStorage;
+		uint8_t						*mData;
+		size_t						mSize;
+	};
+
+	void	release( std::unique_ptr<uint8_t[]> &&storage, uint8_t *data, size_t size );
+
+	std::vector<Block>		mFreeBlocks;
+	mutable std::mutex		mMutex;
+};
+
+// The stackBlur() functions accept an optional BlurScratch to reuse their working memory across calls.
+
 //! Blur \a surface in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface8u *surface, int radius );
+CI_API void			stackBlur( Surface8u *surface, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a surface in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface8u *surface, const Area &area, int radius );
+CI_API void			stackBlur( Surface8u *surface, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a surface using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Surface8u	stackBlurCopy( const Surface8u &surface, int radius );
+CI_API Surface8u	stackBlurCopy( const Surface8u &surface, int radius, BlurScratch *scratch = nullptr );
 
 //! Blur \a channel in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel8u *channel, int radius );
+CI_API void			stackBlur( Channel8u *channel, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a channel in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel8u *channel, const Area &area, int radius );
+CI_API void			stackBlur( Channel8u *channel, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Channel8u	stackBlurCopy( const Channel8u &channel, int radius );
+CI_API Channel8u	stackBlurCopy( const Channel8u &channel, int radius, BlurScratch *scratch = nullptr );
 
 //! Blur \a surface in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface16u *surface, int radius );
+CI_API void			stackBlur( Surface16u *surface, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a surface in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface16u *surface, const Area &area, int radius );
+CI_API void			stackBlur( Surface16u *surface, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a surface using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Surface16u	stackBlurCopy( const Surface16u &surface, int radius );
+CI_API Surface16u	stackBlurCopy( const Surface16u &surface, int radius, BlurScratch *scratch = nullptr );
 
 //! Blur \a channel in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel16u *channel, int radius );
+CI_API void			stackBlur( Channel16u *channel, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a channel in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel16u *channel, const Area &area, int radius );
+CI_API void			stackBlur( Channel16u *channel, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Channel16u	stackBlurCopy( const Channel16u &channel, int radius );
+CI_API Channel16u	stackBlurCopy( const Channel16u &channel, int radius, BlurScratch *scratch = nullptr );
 
 //! Blur \a surface in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface32f *surface, int radius );
+CI_API void			stackBlur( Surface32f *surface, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a surface in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Surface32f *surface, const Area &area, int radius );
+CI_API void			stackBlur( Surface32f *surface, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a surface using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Surface32f	stackBlurCopy( const Surface32f &surface, int radius );
+CI_API Surface32f	stackBlurCopy( const Surface32f &surface, int radius, BlurScratch *scratch = nullptr );
 
 //! Blur \a channel in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel32f *channel, int radius );
+CI_API void			stackBlur( Channel32f *channel, int radius, BlurScratch *scratch = nullptr );
 //! Blur \a channel in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API void			stackBlur( Channel32f *channel, const Area &area, int radius );
+CI_API void			stackBlur( Channel32f *channel, const Area &area, int radius, BlurScratch *scratch = nullptr );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
-CI_API Channel32f	stackBlurCopy( const Channel32f &channel, int radius );
+CI_API Channel32f	stackBlurCopy( const Channel32f &channel, int radius, BlurScratch *scratch = nullptr );
+
+//! Blur \a surface in-place by replacing each pixel with the average of the (2 * \a radius + 1)-pixel square around it. The cost per pixel is constant regardless of \a radius, as averages are read from an IntegralImageT. Near the edges only the part of the square inside \a surface is averaged.
+template<typename T>
+CI_API void			boxBlur( SurfaceT<T> *surface, int radius );
+//! Blur \a channel in-place by replacing each pixel with the average of the (2 * \a radius + 1)-pixel square around it, in constant time per pixel.
+template<typename T>
+CI_API void			boxBlur( ChannelT<T> *channel, int radius );
+//! Create a copy of \a surface blurred by boxBlur()
+template<typename T>
+CI_API SurfaceT<T>	boxBlurCopy( const SurfaceT<T> &surface, int radius );
+//! Create a copy of \a channel blurred by boxBlur()
+template<typename T>
+CI_API ChannelT<T>	boxBlurCopy( const ChannelT<T> &channel, int radius );
+
+/** Blur \a surface in-place with a Gaussian of standard deviation \a sigma, approximated by three successive "extended" box filters applied
+	separately to rows and columns. The cost per pixel is constant regardless of \a sigma. Edge pixels are repeated beyond the
+	bounds of \a surface. Pass \a scratch to reuse working memory across calls. **/
+template<typename T>
+CI_API void			gaussianBlur( SurfaceT<T> *surface, float sigma, BlurScratch *scratch = nullptr );
+//! Blur \a channel in-place with a Gaussian of standard deviation \a sigma, in constant time per pixel. See gaussianBlur( SurfaceT<T>* ).
+template<typename T>
+CI_API void			gaussianBlur( ChannelT<T> *channel, float sigma, BlurScratch *scratch = nullptr );
+//! Create a copy of \a surface blurred by gaussianBlur()
+template<typename T>
+CI_API SurfaceT<T>	gaussianBlurCopy( const SurfaceT<T> &surface, float sigma, BlurScratch *scratch = nullptr );
+//! Create a copy of \a channel blurred by gaussianBlur()
+template<typename T>
+CI_API ChannelT<T>	gaussianBlurCopy( const ChannelT<T> &channel, float sigma, BlurScratch *scratch = nullptr );
 
 } } // namespace cinder::ip
@@ -34,4 +34,9 @@ CI_API void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface );
 template<typename T>
 CI_API void grayscale( const SurfaceT<T> &srcSurface, ChannelT<T> *dstChannel );
 
+/** Converts the \a width pixels at \a src, laid out as \a srcChannelOrder, to grayscale and stores them in the red, green and blue of the pixels at \a dst,
+	laid out as \a dstChannelOrder, leaving their alpha untouched. \a src and \a dst may be the same row. Uses SIMD where the CPU supports it. **/
+template<typename T>
+CI_API void grayscaleRow( const T *src, T *dst, int32_t width, const SurfaceChannelOrder &srcChannelOrder, const SurfaceChannelOrder &dstChannelOrder );
+
 } } // namespace cinder::ip
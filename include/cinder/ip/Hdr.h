@@ -27,10 +27,13 @@
 
 namespace cinder { namespace ip {
 
-/** Normalizes \a surface by scaling the maximum and minimum values to lie in the range \c [0,1] **/
-CI_API void hdrNormalize( Surface32f *surface );
-/** Normalizes \a channel by scaling the maximum and minimum values to lie in the range \c [0,1] **/
-CI_API void hdrNormalize( Channel32f *channel );
+/** Normalizes \a surface by scaling the maximum and minimum values to lie in the range \c [0,1]. Optionally returns the values found in \a resultMin and
+	\a resultMax, which saves calling getMinMax() beforehand. Alpha is left untouched. **/
+CI_API void hdrNormalize( Surface32f *surface, float *resultMin = nullptr, float *resultMax = nullptr );
+/** Normalizes \a channel by scaling the maximum and minimum values to lie in the range \c [0,1]. Optionally returns the values found in \a resultMin and \a resultMax. **/
+CI_API void hdrNormalize( Channel32f *channel, float *resultMin = nullptr, float *resultMax = nullptr );
+/** Determines the minimum and maximum values of the red, green and blue of \a surface **/
+CI_API void getMinMax( const Surface32f &surface, float *resultMin, float *resultMax );
 /** Determines the minimum and maximum values of \a channel **/
 CI_API void getMinMax( const Channel32f &channel, float *resultMin, float *resultMax );
 
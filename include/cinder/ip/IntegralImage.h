@@ -0,0 +1,84 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+/** \brief A summed-area table of a Channel or Surface, which answers sum, average and variance queries over any Area in constant time.
+	Sums are accumulated in 64-bit integers for integral types and doubles for float, so they can't overflow for any realistic image size.
+	A Surface's red, green, blue and (if present) alpha channels are summed separately and are queried with a \a channel index of 0, 1, 2 and 3. **/
+template<typename T>
+class CI_API IntegralImageT {
+  public:
+	typedef typename std::conditional<std::is_integral<T>::value, uint64_t, double>::type	SumT;
+
+	IntegralImageT() : mSize( 0 ), mNumChannels( 0 ), mHasSquares( false ) {}
+	//! Builds the table for \a channel. If \a computeSquares is true, a second table of squared values is built so that areaVariance() is available.
+	explicit IntegralImageT( const ChannelT<T> &channel, bool computeSquares = false );
+	//! Builds tables for the color and alpha channels of \a surface. If \a computeSquares is true, tables of squared values are built so that areaVariance() is available.
+	explicit IntegralImageT( const SurfaceT<T> &surface, bool computeSquares = false );
+
+	//! Recomputes the table after the pixels of \a channel inside \a dirtyArea have changed. Only sums below and to the right of \a dirtyArea's upper-left corner are recomputed. \a channel must be the size the table was built with.
+	void	update( const ChannelT<T> &channel, const Area &dirtyArea );
+	//! Recomputes the tables after the pixels of \a surface inside \a dirtyArea have changed. \a surface must be the size and have the channels the tables were built with.
+	void	update( const SurfaceT<T> &surface, const Area &dirtyArea );
+
+	//! Returns the sum of \a channel's values over \a area, which is clipped to the bounds of the image.
+	SumT	areaSum( const Area &area, uint8_t channel = 0 ) const;
+	//! Returns the mean of \a channel's values over \a area, which is clipped to the bounds of the image. Returns \c 0 for an empty Area.
+	double	areaAverage( const Area &area, uint8_t channel = 0 ) const;
+	//! Returns the variance of \a channel's values over \a area, which is clipped to the bounds of the image. Requires the table to have been built with \a computeSquares.
+	double	areaVariance( const Area &area, uint8_t channel = 0 ) const;
+
+	//! Returns the size of the image the table was built from
+	ivec2	getSize() const				{ return mSize; }
+	//! Returns the number of channels summed, which is \c 1 for a Channel and \c 3 or \c 4 for a Surface
+	uint8_t	getNumChannels() const		{ return mNumChannels; }
+	//! Returns whether tables of squared values were built, which areaVariance() requires
+	bool	hasSquares() const			{ return mHasSquares; }
+
+  private:
+	void	allocate( const ivec2 &size, uint8_t numChannels, bool computeSquares );
+	//! Recomputes the sums for all table entries right of and below the pixel \a pixelUL, from the pixels at \a data
+	void	calculate( const T *data, ptrdiff_t rowBytes, uint8_t pixelInc, const uint8_t *channelOffsets, const ivec2 &pixelUL );
+	//! Returns the sum of the table \a table over the pixels of \a clipped
+	SumT	tableSum( const std::vector<SumT> &table, const Area &clipped, uint8_t channel ) const;
+
+	ivec2				mSize;
+	uint8_t				mNumChannels;
+	bool				mHasSquares;
+	// (width + 1) x (height + 1) entries per channel, interleaved; entry (x, y) holds the sum of the pixels above and left of it
+	std::vector<SumT>	mSums, mSquares;
+};
+
+typedef IntegralImageT<uint8_t>		IntegralImage8u;
+typedef IntegralImage8u				IntegralImage;
+typedef IntegralImageT<uint16_t>	IntegralImage16u;
+typedef IntegralImageT<float>		IntegralImage32f;
+
+} } // namespace cinder::ip
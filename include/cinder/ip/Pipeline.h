@@ -0,0 +1,109 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+
+#include <functional>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+/** \brief Records a chain of operations on a Surface or Channel and then runs them in as few passes over its pixels as possible.
+	Per-pixel operations, along with flips (which only move pixels), are fused into a single banded traversal, so each row
+	is brought into cache once for the whole chain rather than once per operation. Operations which read neighboring pixels,
+	such as stackBlur() and edgeDetectSobel(), act as barriers: everything recorded before them is completed first. Bands run on
+	the ip::ThreadPool if one has been set. Results are identical to calling the equivalent ip:: functions one after another.
+	\code ip::Pipeline( &surface ).grayscale().threshold( 128 ).premultiply().flipVertical().run(); \endcode **/
+template<typename T>
+class CI_API PipelineT {
+  public:
+	/** A custom per-pixel operation applied to \a width pixels starting at \a row, spaced \a pixelInc elements apart.
+		It must not depend on the position of the pixels, since rows may be visited in any order and before or after being flipped. **/
+	typedef std::function<void( T *row, int32_t width, uint8_t pixelInc )>	RowFn;
+
+	//! Creates a Pipeline which modifies \a surface in place. \a surface must outlive the Pipeline.
+	explicit PipelineT( SurfaceT<T> *surface );
+	//! Creates a Pipeline which modifies \a channel in place. \a channel must outlive the Pipeline.
+	explicit PipelineT( ChannelT<T> *channel );
+
+	//! Sets red, green and blue to the pixel's luminance, like ip::grayscale(). Does nothing to a Channel.
+	PipelineT&	grayscale();
+	//! Sets each color channel to its maximum if it is greater than \a value and to \c 0 otherwise, like ip::threshold().
+	PipelineT&	threshold( T value );
+	//! Multiplies the color channels by alpha, like ip::premultiply(). Does nothing without an alpha channel.
+	PipelineT&	premultiply();
+	//! Divides the color channels by alpha, like ip::unpremultiply(). Does nothing without an alpha channel.
+	PipelineT&	unpremultiply();
+	//! Flips the image top to bottom, like ip::flipVertical().
+	PipelineT&	flipVertical();
+	//! Flips the image left to right, like ip::flipHorizontal().
+	PipelineT&	flipHorizontal();
+	//! Appends the custom per-pixel operation \a fn, which is fused with its neighbors like the built-in ones.
+	PipelineT&	pointOp( const RowFn &fn );
+
+	//! Blurs by \a radius, like ip::stackBlur(). Completes the preceding operations first.
+	PipelineT&	stackBlur( int radius );
+	//! Replaces the image with its Sobel edges, like ip::edgeDetectSobel(). Completes the preceding operations first.
+	PipelineT&	edgeDetectSobel();
+
+	//! Runs and then clears the operations recorded since the last call to run().
+	void		run();
+	//! Returns the number of passes over the pixels the recorded operations will take, which is the number of fused point stages plus the number of barriers.
+	size_t		getNumPasses() const	{ return mStages.size(); }
+
+  private:
+	//! Either a run of fused point operations and flips, or a single operation which reads neighboring pixels
+	struct Stage {
+		enum Type { POINT, STACK_BLUR, EDGE_DETECT_SOBEL };
+
+		Stage( Type type = POINT, int radius = 0 )
+			: mType( type ), mRadius( radius ), mFlipVertical( false ), mFlipHorizontal( false ), mSetPremultiplied( -1 )
+		{}
+
+		Type				mType;
+		int					mRadius;
+		std::vector<RowFn>	mRowFns;
+		bool				mFlipVertical, mFlipHorizontal;
+		int					mSetPremultiplied; // -1 leaves the Surface's premultiplied flag alone
+	};
+
+	Stage&		getPointStage();
+	void		runPointStage( const Stage &stage );
+
+	SurfaceT<T>			*mSurface;
+	ChannelT<T>			*mChannel;
+	T					*mData;
+	int32_t				mWidth, mHeight;
+	ptrdiff_t			mRowBytes;
+	uint8_t				mPixelInc, mRedOffset, mGreenOffset, mBlueOffset, mAlphaOffset;
+	bool				mHasAlpha;
+	std::vector<Stage>	mStages;
+};
+
+typedef PipelineT<uint8_t>	Pipeline8u;
+typedef Pipeline8u			Pipeline;
+typedef PipelineT<uint16_t>	Pipeline16u;
+typedef PipelineT<float>	Pipeline32f;
+
+} } // namespace cinder::ip
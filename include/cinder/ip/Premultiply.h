@@ -35,4 +35,13 @@ CI_API void premultiply( SurfaceT<T> *surface );
 template<typename T>
 CI_API void unpremultiply( SurfaceT<T> *surface );
 
+/** Premultiplies \a width pixels starting at \a data, laid out as \a channelOrder which must have an alpha channel. Uses SSE2 or NEON where available. **/
+template<typename T>
+CI_API void premultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder );
+
+/** Unpremultiplies \a width pixels starting at \a data, laid out as \a channelOrder which must have an alpha channel. Pixels with zero alpha are unchanged.
+	Integer results are saturated, while 32f uses a refined reciprocal estimate of alpha and so may differ from a division in the last bits. **/
+template<typename T>
+CI_API void unpremultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder );
+
 } } // namespace cinder::ip
@@ -26,6 +26,9 @@
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 
+#include <type_traits>
+#include <vector>
+
 namespace cinder { namespace ip {
 
 template<typename T>
@@ -40,4 +43,54 @@ CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcAre
 template<typename T>
 CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
 
+/** \brief Precomputed filter weights for resizing a fixed source Area into a fixed destination Area.
+	Building the weight tables is a significant part of the cost of resize() for small images; a ResizePlanT can be
+	reused for any number of same-sized images. Destination rows are split into bands which are processed in parallel (on the
+	ip::ThreadPool if one has been set), and the results are identical to ip::resize() regardless of the number of threads. **/
+template<typename T>
+class CI_API ResizePlanT {
+  public:
+	typedef typename std::conditional<std::is_integral<T>::value, int32_t, float>::type	WeightT;
+
+	//! Creates a plan for resizing \a srcArea of an image sized \a srcSize into \a dstArea of an image sized \a dstSize. A \a numThreads of \c 0 uses one thread per hardware core.
+	ResizePlanT( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter = FilterTriangle(), int numThreads = 0 );
+	//! Creates a plan for resizing the entirety of an image sized \a srcSize to an image sized \a dstSize. A \a numThreads of \c 0 uses one thread per hardware core.
+	ResizePlanT( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter = FilterTriangle(), int numThreads = 0 );
+
+	//! Resizes \a srcSurface into \a dstSurface, which must be the sizes the plan was created with.
+	void		resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const;
+	//! Resizes \a srcChannel into \a dstChannel, which must be the sizes the plan was created with.
+	void		resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const;
+	//! Returns a new Surface of the plan's destination size containing \a srcSurface resized.
+	SurfaceT<T>	resizeCopy( const SurfaceT<T> &srcSurface ) const;
+
+	//! Returns the number of threads the destination rows are divided across.
+	int			getNumThreads() const { return mNumThreads; }
+	//! Sets the number of threads the destination rows are divided across. A value of \c 0 uses one thread per hardware core.
+	void		setNumThreads( int numThreads );
+
+	const ivec2&	getSrcSize() const { return mSrcSize; }
+	const ivec2&	getDstSize() const { return mDstSize; }
+
+  private:
+	void	resample( const std::vector<const ChannelT<T>*> &srcChannels, const std::vector<ChannelT<T>*> &dstChannels ) const;
+	void	resampleRows( const std::vector<const ChannelT<T>*> &srcChannels, const std::vector<ChannelT<T>*> &dstChannels, int32_t dstY1, int32_t dstY2 ) const;
+
+	ivec2		mSrcSize, mDstSize;
+	int			mNumThreads;
+
+	// the region actually written, and the integer origin of the source region it samples
+	Area		mClippedDstArea;
+	int32_t		mSrcOffsetX, mSrcOffsetY;
+	// maximum number of taps in the horizontal and vertical directions
+	int32_t		mFilterWidthX, mFilterWidthY;
+	// per destination column / row: the range of source samples [start, end) and their weights, mFilterWidth* apart
+	std::vector<int32_t>	mXStart, mXEnd, mYStart, mYEnd;
+	std::vector<WeightT>	mXWeights, mYWeights;
+};
+
+typedef ResizePlanT<uint8_t>	ResizePlan8u;
+typedef ResizePlan8u			ResizePlan;
+typedef ResizePlanT<float>		ResizePlan32f;
+
 } } // namespace cinder::ip
@@ -0,0 +1,58 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+
+#include <type_traits>
+
+namespace cinder { namespace ip {
+
+/** \brief Describes how each pixel of a destination row is assembled from the corresponding pixel of a source row.
+	Element \c i of a destination pixel is element \c mIndex[i] of the source pixel, or the channel maximum when \c mIndex[i] is negative. **/
+struct CI_API SwizzleMap {
+	SwizzleMap() : mSrcInc( 0 ), mDstInc( 0 ), mIndex{ -1, -1, -1, -1 } {}
+	//! \a srcInc and \a dstInc are the number of elements per source and destination pixel. \a dstInc can be at most \c 4.
+	SwizzleMap( uint8_t srcInc, uint8_t dstInc, int8_t index0, int8_t index1 = -1, int8_t index2 = -1, int8_t index3 = -1 )
+		: mSrcInc( srcInc ), mDstInc( dstInc ), mIndex{ index0, index1, index2, index3 } {}
+
+	//! Returns the map which copies red, green and blue from pixels in \a srcOrder to pixels in \a dstOrder, as well as alpha when both have it. Destination alpha or padding without a source is set to the maximum.
+	static SwizzleMap	fromChannelOrders( const SurfaceChannelOrder &srcOrder, const SurfaceChannelOrder &dstOrder );
+
+	uint8_t		mSrcInc, mDstInc;
+	int8_t		mIndex[4];
+};
+
+//! Whether swizzleRow() is implemented for source elements of type \a SD and destination elements of type \a TD: any of uint8_t, uint16_t and float to itself, and uint8_t to or from uint16_t and float.
+template<typename SD, typename TD>
+struct IsSwizzleRowSupported : std::integral_constant<bool,
+	( std::is_same<SD,uint8_t>::value || std::is_same<SD,uint16_t>::value || std::is_same<SD,float>::value ) &&
+	( std::is_same<TD,uint8_t>::value || std::is_same<TD,uint16_t>::value || std::is_same<TD,float>::value ) &&
+	( std::is_same<SD,TD>::value || std::is_same<SD,uint8_t>::value || std::is_same<TD,uint8_t>::value )> {};
+
+/** \brief Converts \a width pixels from \a src to \a dst as described by \a map, converting each element with CHANTRAIT<TD>::convert().
+	Uses SSSE3 (\c pshufb) or NEON (\c tbl) byte shuffles where the CPU supports them. \a src and \a dst must not overlap. **/
+template<typename SD, typename TD>
+CI_API void swizzleRow( const SD *src, TD *dst, int32_t width, const SwizzleMap &map );
+
+} } // namespace cinder::ip
@@ -0,0 +1,97 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Area.h"
+#include "cinder/Noncopyable.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+typedef std::shared_ptr<class ThreadPool>	ThreadPoolRef;
+
+/** \brief A pool of worker threads which ip:: operations split their work across.
+	Install one with ip::setThreadPool() to make fill(), flipVertical(), grayscale(), threshold(), premultiply(), blend(),
+	edgeDetectSobel(), hdrNormalize() and stackBlur() process row bands in parallel. Results are identical to serial execution. **/
+class CI_API ThreadPool : private Noncopyable {
+  public:
+	//! Creates a pool whose parallelFor() runs on \a numThreads threads, including the calling thread. A \a numThreads of \c 0 uses one thread per hardware core.
+	static ThreadPoolRef	create( size_t numThreads = 0 )	{ return ThreadPoolRef( new ThreadPool( numThreads ) ); }
+	~ThreadPool();
+
+	//! Returns the number of threads parallelFor() runs on, including the calling thread.
+	size_t	getNumThreads() const	{ return mWorkers.size() + 1; }
+
+	/** Calls \a fn( begin, end ) for consecutive ranges of at most \a grain items covering [0, \a count), and blocks until all have completed.
+		Idle workers and the calling thread claim ranges as they finish their previous ones, so uneven ranges balance out. It is safe to
+		call parallelFor() from within \a fn. The first exception thrown by \a fn is rethrown in the calling thread. **/
+	void	parallelFor( size_t count, size_t grain, const std::function<void( size_t, size_t )> &fn );
+
+  private:
+	ThreadPool( size_t numThreads );
+
+	struct Job {
+		Job( size_t count, size_t grain, const std::function<void( size_t, size_t )> &fn )
+			: mCount( count ), mGrain( grain ), mFn( fn ), mNext( 0 ), mRemaining( count )
+		{}
+
+		const size_t									mCount, mGrain;
+		const std::function<void( size_t, size_t )>		&mFn;
+		std::atomic<size_t>								mNext, mRemaining;
+		std::mutex										mMutex;
+		std::condition_variable							mDoneCondition;
+		std::exception_ptr								mException;
+	};
+
+	void	workerLoop();
+	void	runJob( Job *job );
+	void	removeJob( const std::shared_ptr<Job> &job );
+
+	std::vector<std::thread>			mWorkers;
+	std::deque<std::shared_ptr<Job>>	mJobs;
+	std::mutex							mMutex;
+	std::condition_variable				mCondition;
+	bool								mStop;
+};
+
+//! Sets the ThreadPool used by ip:: operations. The default of \c nullptr runs every operation serially on the calling thread.
+CI_API void				setThreadPool( const ThreadPoolRef &threadPool );
+//! Returns the ThreadPool used by ip:: operations, or \c nullptr if they run serially.
+CI_API ThreadPoolRef	getThreadPool();
+
+/** Calls \a fn for a series of horizontal bands which together cover \a area. Bands are sized so that about 64k of
+	\a bytesPerRow fit in cache, and are run on the current ThreadPool. Runs \a fn( \a area ) on the calling thread when there is
+	no ThreadPool or \a area is too small to be worth splitting. **/
+CI_API void		parallelRows( const Area &area, size_t bytesPerRow, const std::function<void( const Area &band )> &fn );
+//! Like parallelRows(), but splits \a area into vertical bands of columns, each \a bytesPerColumn in size.
+CI_API void		parallelColumns( const Area &area, size_t bytesPerColumn, const std::function<void( const Area &band )> &fn );
+
+} } // namespace cinder::ip
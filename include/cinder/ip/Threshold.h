@@ -24,6 +24,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Surface.h"
+#include "cinder/ip/IntegralImage.h"
 
 #include <vector>
 
@@ -41,6 +42,10 @@ CI_API void threshold( const SurfaceT<T> &srcSurface, T value, SurfaceT<T> *dstS
 //! Thresholds \a srcChannel setting any values below \a value to zero and any values above to unity and storing the result in \a dstChannel
 template<typename T>
 CI_API void threshold( const ChannelT<T> &srcSurface, T value, ChannelT<T> *dstSurface );
+/** Thresholds the red, green and blue of the \a width pixels at \a src, laid out as \a channelOrder, storing them in \a dst and leaving its alpha untouched.
+	\a src and \a dst may be the same row. Uses SIMD where the CPU supports it. **/
+template<typename T>
+CI_API void thresholdRow( const T *src, T *dst, int32_t width, const SurfaceChannelOrder &channelOrder, T value );
 //! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels and stores the result in \a dstChannel.
 /** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize and 0.15 is for \a percentageDelta **/
 template<typename T>
@@ -50,34 +55,34 @@ CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize
 template<typename T>
 CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta );
 //! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels. Equivalent to calling adaptiveThreshold with a 0 for percentageDelta
-/** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize **/
+/** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize.
+	Pixels above their window's average are set to CHANTRAIT<T>::max(), which is 255 for uint8_t, 65535 for uint16_t and 1 for float. **/
 template<typename T>
 CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize );
-
+//! Thresholds \a srcChannel like adaptiveThresholdZero() and stores the result in \a dstChannel.
 template<typename T>
 CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
 
+//! Adaptive thresholding of a fixed source Channel, which reuses the source's IntegralImageT across calls to calculate().
 template<typename T>
 class CI_API AdaptiveThresholdT {
   public:
-	AdaptiveThresholdT()	{}
+	AdaptiveThresholdT()	: mChannel( nullptr ) {}
 	//! Uses \a channel as source, but not assume ownership
 	AdaptiveThresholdT( const ChannelT<T> *channel );
 
+	//! Updates the integral image after the source Channel's pixels inside \a dirtyArea have changed, which is cheaper than constructing a new AdaptiveThresholdT.
+	void update( const Area &dirtyArea );
 	void calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
 
  private:
-	typedef typename CHANTRAIT<T>::Accum SUMT;
-
 	const ChannelT<T>*	mChannel;
-	int32_t				mImageWidth;
-	int32_t				mImageHeight;
-	uint8_t				mIncrement;
-	std::vector<SUMT>	mIntegralImage;
+	IntegralImageT<T>	mIntegralImage;
 };
 
 typedef AdaptiveThresholdT<uint8_t>		AdaptiveThreshold;
 typedef AdaptiveThresholdT<uint8_t>		AdaptiveThreshold8u;
+typedef AdaptiveThresholdT<uint16_t>	AdaptiveThreshold16u;
 typedef AdaptiveThresholdT<float>		AdaptiveThreshold32f;
 
 } } // namespace cinder::ip
@@ -25,10 +25,21 @@
 #include "cinder/Cinder.h"
 #include "cinder/Surface.h"
 
+#include <vector>
+
 namespace cinder { namespace ip {
 
-/** Finds the bounding rectangle of the area \a bounds inside of \a surface which contains non-zero alpha **/
+/** Finds the bounding rectangle of the area \a bounds inside of \a surface which contains non-zero alpha. Returns an empty Area at the bottom right
+	of \a bounds when it is entirely transparent, and \a bounds itself when \a surface has no alpha. Rows are scanned in a single pass using SIMD. **/
 template<typename T>
 CI_API Area findNonTransparentArea( const SurfaceT<T> &surface, const Area &bounds );
+/** Finds the non-transparent area of each of \a surfaces, as findNonTransparentArea() does for its bounds, and returns them in order.
+	The Surfaces are spread across the current ThreadPool, which suits the many small frames of a sprite atlas. **/
+template<typename T>
+CI_API std::vector<Area> findNonTransparentAreas( const std::vector<SurfaceT<T>> &surfaces );
+/** Returns a copy of each of \a surfaces cropped to its non-transparent area, processing them in parallel on the current ThreadPool. The area of
+	each Surface within the original is returned in \a resultAreas, where the trimmed frame needs to be placed to line up with the others. **/
+template<typename T>
+CI_API std::vector<SurfaceT<T>> trimTransparent( const std::vector<SurfaceT<T>> &surfaces, std::vector<Area> *resultAreas = nullptr );
 
 } } // namespace cinder::ip
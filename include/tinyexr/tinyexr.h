@@ -37,6 +37,8 @@ extern "C" {
 #define TINYEXR_PIXELTYPE_UINT (0)
 #define TINYEXR_PIXELTYPE_HALF (1)
 #define TINYEXR_PIXELTYPE_FLOAT (2)
+// requested_pixel_types value which skips loading a channel; its `images` entry is left NULL (cinder addition)
+#define TINYEXR_PIXELTYPE_NONE (-1)
 
 typedef struct _EXRImage {
   int num_channels;
@@ -53,6 +55,13 @@ typedef struct _EXRImage {
 
   int width;
   int height;
+
+  // cinder additions, zeroed by InitEXRImage()
+  int num_threads; // threads used to decode and encode scanline blocks; 0 for
+                   // one per hardware thread
+  int line_begin;  // when line_end > line_begin, LoadMultiChannelEXRFrom*()
+  int line_end;    // only loads the rows [line_begin, line_end) of the data
+                   // window and `height` becomes their count
 } EXRImage;
 
 typedef struct _DeepImage {
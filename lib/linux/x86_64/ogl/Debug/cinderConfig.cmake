@@ -0,0 +1,5 @@
+if( NOT TARGET cinder )
+    include( /tmp/bld/lib/linux/x86_64/ogl/Debug//cinderTargets.cmake )
+endif()
+
+
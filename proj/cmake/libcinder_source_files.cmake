@@ -29,9 +29,14 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/GeomIo.cpp
 	${CINDER_SRC_DIR}/cinder/ImageFileTinyExr.cpp
 	${CINDER_SRC_DIR}/cinder/ImageIo.cpp
+	${CINDER_SRC_DIR}/cinder/ImageLoader.cpp
+	${CINDER_SRC_DIR}/cinder/ImageSequence.cpp
+	${CINDER_SRC_DIR}/cinder/ImageTargetBands.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileRadiance.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileStbImage.cpp
 	${CINDER_SRC_DIR}/cinder/ImageTargetFileStbImage.cpp
+	${CINDER_SRC_DIR}/cinder/ImageTargetFilePng.cpp
+	${CINDER_SRC_DIR}/cinder/ImageWriter.cpp
 	${CINDER_SRC_DIR}/cinder/Json.cpp
 	${CINDER_SRC_DIR}/cinder/Log.cpp
 	${CINDER_SRC_DIR}/cinder/Matrix.cpp
@@ -48,6 +53,8 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Sphere.cpp
 	${CINDER_SRC_DIR}/cinder/Stream.cpp
 	${CINDER_SRC_DIR}/cinder/Surface.cpp
+	${CINDER_SRC_DIR}/cinder/SurfaceAllocator.cpp
+	${CINDER_SRC_DIR}/cinder/SurfacePool.cpp
 	${CINDER_SRC_DIR}/cinder/System.cpp
 	${CINDER_SRC_DIR}/cinder/Text.cpp
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
@@ -95,16 +102,19 @@ source_group( "cinder\\app" FILES   ${SRC_SET_CINDER_APP} )
 if( NOT CINDER_DISABLE_AUDIO )
 	list( APPEND SRC_SET_CINDER_AUDIO
 		${CINDER_SRC_DIR}/cinder/audio/ChannelRouterNode.cpp
+		${CINDER_SRC_DIR}/cinder/audio/CommandQueue.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Context.cpp
 		${CINDER_SRC_DIR}/cinder/audio/DelayNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Device.cpp
 		${CINDER_SRC_DIR}/cinder/audio/FileOggVorbis.cpp
 		${CINDER_SRC_DIR}/cinder/audio/FilterNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/GenNode.cpp
+		${CINDER_SRC_DIR}/cinder/audio/GraphScheduler.cpp
 		${CINDER_SRC_DIR}/cinder/audio/InputNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Node.cpp
 		${CINDER_SRC_DIR}/cinder/audio/NodeMath.cpp
 		${CINDER_SRC_DIR}/cinder/audio/MonitorNode.cpp
+		${CINDER_SRC_DIR}/cinder/audio/OfflineContext.cpp
 		${CINDER_SRC_DIR}/cinder/audio/OutputNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/PanNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Param.cpp
@@ -186,7 +196,11 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/EdgeDetect.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Flip.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Hdr.cpp
+	${CINDER_SRC_DIR}/cinder/ip/IntegralImage.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Pipeline.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Resize.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Swizzle.cpp
+	${CINDER_SRC_DIR}/cinder/ip/ThreadPool.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Trim.cpp
 )
 
@@ -33,15 +33,33 @@ namespace cinder {
 template<typename T>
 class ImageTargetChannel : public ImageTarget {
   public:
-	static shared_ptr<ImageTargetChannel<T> > createRef( ChannelT<T> *channel ) { return shared_ptr<ImageTargetChannel<T> >( new ImageTargetChannel<T>( channel ) ); }
+	//! \a dataBytes is the size of the block at \a channel's data which it owns, including any padding between rows, or 0 for exactly its rows
+	static shared_ptr<ImageTargetChannel<T> > createRef( ChannelT<T> *channel, size_t dataBytes = 0 ) { return shared_ptr<ImageTargetChannel<T> >( new ImageTargetChannel<T>( channel, dataBytes ) ); }
 
 	virtual bool hasAlpha() const { return false; }
 	
 	virtual void*	getRowPointer( int32_t row ) { return reinterpret_cast<void*>( mChannel->getData( ivec2( 0, row ) ) ); }
+
+	void*	getContiguousData( ptrdiff_t *rowBytes, size_t *dataBytes ) override
+	{
+		if( ! mChannel->isPlanar() || mChannel->getRowBytes() <= 0 )
+			return nullptr;
+
+		// see ImageTargetSurface::getContiguousData()
+		const size_t rowsBytes = mChannel->getHeight() * mChannel->getRowBytes();
+		if( mDataBytes == 0 && mChannel->getRowBytes() != (ptrdiff_t)( mChannel->getWidth() * sizeof(T) ) )
+			return nullptr;
+		if( mDataBytes != 0 && mDataBytes < rowsBytes )
+			return nullptr;
+
+		*rowBytes = mChannel->getRowBytes();
+		*dataBytes = ( mDataBytes != 0 ) ? mDataBytes : rowsBytes;
+		return mChannel->getData();
+	}
 	
   protected:
-	ImageTargetChannel( ChannelT<T> *channel )
-		: mChannel( channel )
+	ImageTargetChannel( ChannelT<T> *channel, size_t dataBytes )
+		: mChannel( channel ), mDataBytes( dataBytes )
 	{
 		if( std::is_same<T,float>::value )
 			setDataType( ImageIo::FLOAT32 );
@@ -57,6 +75,7 @@ class ImageTargetChannel : public ImageTarget {
 	}
 	
 	ChannelT<T>		*mChannel;
+	size_t			mDataBytes;
 };
 
 class ImageSourceChannel : public ImageSource {
@@ -117,7 +136,19 @@ ChannelT<T>::ChannelT( int32_t width, int32_t height )
 	mRowBytes = mWidth * sizeof(T);
 	mIncrement = 1;
 	
-	mDataStore = shared_ptr<T>( new T[mWidth * mHeight], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( mHeight * mRowBytes );
+	mData = mDataStore.get();
+}
+
+template<typename T>
+ChannelT<T>::ChannelT( int32_t width, int32_t height, const SurfaceAllocatorRef &allocator )
+	: mWidth( width ), mHeight( height )
+{
+	const ptrdiff_t alignment = static_cast<ptrdiff_t>( allocator->getAlignment() );
+	mRowBytes = ( mWidth * sizeof(T) + alignment - 1 ) & ~( alignment - 1 );
+	mIncrement = 1;
+
+	mDataStore = allocator->allocateData<T>( mHeight * mRowBytes );
 	mData = mDataStore.get();
 }
 
@@ -138,7 +169,7 @@ template<typename T>
 ChannelT<T>::ChannelT( const ChannelT &rhs )
 	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mRowBytes( mWidth * sizeof(T) ), mIncrement( 1 )
 {
-	mDataStore = shared_ptr<T>( new T[mWidth * mHeight], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( mHeight * mRowBytes );
 	mData = mDataStore.get();
 
 	copyFrom( rhs, Area( 0, 0, mWidth, mHeight ) );
@@ -160,10 +191,12 @@ ChannelT<T>::ChannelT( const ImageSourceRef &imageSource )
 	mRowBytes = mWidth * sizeof(T);
 	mIncrement = 1;
 
-	mDataStore = shared_ptr<T>( new T[mHeight * (mRowBytes/sizeof(T))], std::default_delete<T[]>() );
+	// one value past the last row lets decoders which overrun their output, such as stb_image's JPEG, decode in place
+	const size_t dataBytes = mHeight * mRowBytes + sizeof(T);
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( dataBytes );
 	mData = mDataStore.get();
 	
-	shared_ptr<ImageTargetChannel<T>> target = ImageTargetChannel<T>::createRef( this );
+	shared_ptr<ImageTargetChannel<T>> target = ImageTargetChannel<T>::createRef( this, dataBytes );
 	imageSource->load( target );
 }
 
@@ -174,7 +207,7 @@ ChannelT<T>& ChannelT<T>::operator=( const ChannelT &rhs )
 	mHeight = rhs.mHeight;
 	mRowBytes = mWidth * sizeof(T);
 	mIncrement = 1;
-	mDataStore = shared_ptr<T>( new T[mHeight * mWidth], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( mHeight * mRowBytes );
 	mData = mDataStore.get();
 	copyFrom( rhs, Area( 0, 0, mWidth, mHeight ) );
 	
@@ -223,6 +256,13 @@ ChannelT<T> ChannelT<T>::clone( const Area &area, bool copyPixels ) const
 	return result;
 }
 
+template<typename T>
+ChannelT<T> ChannelT<T>::getView( const Area &area ) const
+{
+	const Area clippedArea = area.getClipBy( getBounds() );
+	return ChannelT( clippedArea.getWidth(), clippedArea.getHeight(), mRowBytes, mIncrement, const_cast<T*>( getData( clippedArea.getUL() ) ), mDataStore );
+}
+
 
 template<typename T>
 void ChannelT<T>::copyFrom( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &relativeOffset )
@@ -27,6 +27,12 @@
   #include "cinder/app/android/AssetFileSystem.h"
   #include "cinder/app/android/PlatformAndroid.h"
 #endif
+#if defined( CINDER_POSIX )
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
 
 namespace cinder {
 
@@ -88,6 +94,77 @@ IStreamRef DataSourcePath::createStream()
 	return loadFileStream( mFilePath );
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// DataSourcePathMapped
+#if defined( CINDER_POSIX )
+namespace {
+
+// A Buffer aliasing a mapping of a file, which it unmaps when destroyed
+class BufferMapped : public Buffer {
+  public:
+	BufferMapped( void *data, size_t size )
+		: Buffer( data, size ), mMapping( data ), mMappingSize( size )
+	{}
+
+	~BufferMapped()
+	{
+		::munmap( mMapping, mMappingSize );
+	}
+
+  private:
+	void	*mMapping;
+	size_t	mMappingSize;
+};
+
+} // anonymous namespace
+#endif // defined( CINDER_POSIX )
+
+DataSourcePathMappedRef DataSourcePathMapped::create( const fs::path &path, Access access )
+{
+	return DataSourcePathMappedRef( new DataSourcePathMapped( path, access ) );
+}
+
+DataSourcePathMapped::DataSourcePathMapped( const fs::path &path, Access access )
+	: DataSourcePath( path ), mAccess( access )
+{
+}
+
+void DataSourcePathMapped::createBuffer()
+{
+#if defined( CINDER_POSIX )
+	int fd = ::open( mFilePath.c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw StreamExc( "Failed to open " + mFilePath.string() );
+
+	struct stat fileStat;
+	if( ::fstat( fd, &fileStat ) != 0 ) {
+		::close( fd );
+		throw StreamExc( "Failed to stat " + mFilePath.string() );
+	}
+
+	// mmap() rejects empty mappings
+	const size_t size = (size_t)fileStat.st_size;
+	if( size == 0 ) {
+		::close( fd );
+		mBuffer = std::make_shared<Buffer>();
+		return;
+	}
+
+	// private and writable so that consumers parsing in place get copy-on-write pages rather than modifying the file
+	void *data = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0 );
+	::close( fd ); // the mapping keeps its own reference to the file
+	if( data == MAP_FAILED )
+		throw StreamExc( "Failed to map " + mFilePath.string() );
+
+	const int advice = ( mAccess == ACCESS_SEQUENTIAL ) ? MADV_SEQUENTIAL : ( mAccess == ACCESS_RANDOM ) ? MADV_RANDOM : MADV_NORMAL;
+	::madvise( data, size, advice );
+
+	mBuffer = std::make_shared<BufferMapped>( data, size );
+#else
+	DataSourcePath::createBuffer();
+#endif
+}
+
 
 #if defined( CINDER_ANDROID )
 /////////////////////////////////////////////////////////////////////////////
@@ -136,6 +213,16 @@ DataSourceRef loadFile( const fs::path &path )
 #endif	
 }
 
+DataSourceRef loadFileMapped( const fs::path &path, DataSourcePathMapped::Access access )
+{
+#if defined( CINDER_ANDROID )
+	// assets live inside the APK rather than the file system
+	if( ci::app::PlatformAndroid::isAssetPath( path ) )
+		return DataSourceAndroidAsset::create( path );
+#endif
+	return DataSourcePathMapped::create( path, access );
+}
+
 
 #if ! defined( CINDER_UWP )
 /////////////////////////////////////////////////////////////////////////////
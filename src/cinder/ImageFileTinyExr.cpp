@@ -35,6 +35,11 @@ namespace cinder {
 // ----------------------------------------------------------------------------------------------------
 
 ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, ImageSource::Options options )
+{
+	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, Options( options ) ) );
+}
+
+ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, const Options &options )
 {
 	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options ) );
 }
@@ -45,120 +50,161 @@ void ImageSourceFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerSourceType( "exr", sourceFunc, 1 ); // lower is higher priority
 }
 
-ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/ )
+ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, const Options &options )
+	: mOffsetX( 0 )
 {
 	mExrImage.reset( new EXRImage );
 	const char *error;
 
 	InitEXRImage( mExrImage.get() );
 
+	BufferRef buffer;
 	int status = 0;
-	if( dataSource->isFilePath() ) {
+	if( dataSource->isFilePath() )
 		status = ParseMultiChannelEXRHeaderFromFile( mExrImage.get(), dataSource->getFilePath().string().c_str(), &error );
-		if( status != 0 )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
-		status = LoadMultiChannelEXRFromFile( mExrImage.get(), dataSource->getFilePath().string().c_str(), &error );
-		if( status != 0 )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
-	}
 	else {
-		BufferRef buffer = dataSource->getBuffer();
-		
+		buffer = dataSource->getBuffer();
 		status = ParseMultiChannelEXRHeaderFromMemory( mExrImage.get(), (const unsigned char*)buffer->getData(), &error );
-		if( status != 0 )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
-		status = LoadMultiChannelEXRFromMemory( mExrImage.get(), (const unsigned char*)buffer->getData(), &error );
-		if( status != 0 )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
 	}
+	if( status != 0 )
+		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
 
-	// verify that the channels are all the same size; currently we don't support variably sized channels
-	int pixelType = mExrImage->pixel_types[0];
-	for( int c = 1; c < mExrImage->num_channels; ++c ) {
-		if( pixelType != mExrImage->pixel_types[c] )
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: heterogneous channel data types not supported" );
+	// find the requested channels; everything else is skipped by the decoder
+	auto findChannel = [this]( const string &name ) {
+		for( int c = 0; c < mExrImage->num_channels; ++c ) {
+			if( name == mExrImage->channel_names[c] )
+				return c;
+		}
+		return -1;
+	};
+
+	if( ! options.getChannels().empty() ) {
+		if( options.getChannels().size() > 4 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unsupported number of channels (" + to_string( options.getChannels().size() ) + ")" );
+		for( const auto &name : options.getChannels() ) {
+			mChannelIndices.push_back( findChannel( name ) );
+			if( mChannelIndices.back() < 0 )
+				throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: No channel named \"" + name + "\"" );
+		}
+	}
+	else {
+		const int red = findChannel( "R" ), green = findChannel( "G" ), blue = findChannel( "B" ), alpha = findChannel( "A" ), luminance = findChannel( "Y" );
+		if( red >= 0 && green >= 0 && blue >= 0 )
+			mChannelIndices = { red, green, blue };
+		else if( luminance >= 0 )
+			mChannelIndices = { luminance };
+		else
+			throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for RGB" );
+		if( alpha >= 0 )
+			mChannelIndices.push_back( alpha );
 	}
 
-	switch( pixelType ) {
-		case TINYEXR_PIXELTYPE_HALF:
-			setDataType( ImageIo::FLOAT16 );
-		break;
-		case TINYEXR_PIXELTYPE_FLOAT:
-			setDataType( ImageIo::FLOAT32 );
-		break;
-		default:
+	// verify that the selected channels can share one data type; half is promoted to float when mixed with it
+	bool anyFloat = options.getHalfAsFloat();
+	for( int c : mChannelIndices ) {
+		if( mExrImage->pixel_types[c] == TINYEXR_PIXELTYPE_FLOAT )
+			anyFloat = true;
+		else if( mExrImage->pixel_types[c] != TINYEXR_PIXELTYPE_HALF )
 			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unknown data type" );
-		break;
 	}
 
-	setSize( mExrImage->width, mExrImage->height );
+	for( int c = 0; c < mExrImage->num_channels; ++c )
+		mExrImage->requested_pixel_types[c] = TINYEXR_PIXELTYPE_NONE;
+	for( int c : mChannelIndices )
+		mExrImage->requested_pixel_types[c] = anyFloat ? TINYEXR_PIXELTYPE_FLOAT : TINYEXR_PIXELTYPE_HALF;
+	setDataType( anyFloat ? ImageIo::FLOAT32 : ImageIo::FLOAT16 );
+
+	Area area( 0, 0, mExrImage->width, mExrImage->height );
+	if( options.getArea() != Area::zero() ) {
+		area = options.getArea().getClipBy( area );
+		if( area.getWidth() <= 0 || area.getHeight() <= 0 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Requested area is outside of the data window" );
+	}
+	mExrImage->line_begin = area.y1;
+	mExrImage->line_end = area.y2;
+	mExrImage->num_threads = options.getNumThreads();
+	mOffsetX = area.x1;
+
+	if( dataSource->isFilePath() )
+		status = LoadMultiChannelEXRFromFile( mExrImage.get(), dataSource->getFilePath().string().c_str(), &error );
+	else
+		status = LoadMultiChannelEXRFromMemory( mExrImage.get(), (const unsigned char*)buffer->getData(), &error );
+	if( status != 0 )
+		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+
+	setSize( area.getWidth(), area.getHeight() );
 
-	switch( mExrImage->num_channels ) {
+	switch( mChannelIndices.size() ) {
+		case 1:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::Y );
+		break;
+		case 2:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::YA );
+		break;
 		case 3:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGB );
 		break;
-		case 4:
+		default:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
-		break;
-		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unsupported number of channels (" + to_string( mExrImage->num_channels ) + ")" );
 	}
 }
 
-void ImageSourceFileTinyExr::load( ImageTargetRef target )
+ImageSourceFileTinyExr::~ImageSourceFileTinyExr()
 {
-	ImageSource::RowFunc rowFunc = setupRowFunc( target );
+	FreeEXRImage( mExrImage.get() );
+}
 
-	const size_t numChannels = mExrImage->num_channels;
-	const void *red = nullptr, *green = nullptr, *blue = nullptr, *alpha = nullptr;
-	
+namespace {
+
+// Interleaves one row of the planar \a channels into \a rowData
+template<typename T>
+void interleaveRow( T *rowData, const vector<const T*> &channels, int32_t width )
+{
+	const size_t numChannels = channels.size();
 	for( size_t c = 0; c < numChannels; ++c ) {
-		if( strcmp( mExrImage->channel_names[c], "R" ) == 0 )
-			red = mExrImage->images[c];
-		else if( strcmp( mExrImage->channel_names[c], "G" ) == 0 )
-			green = mExrImage->images[c];
-		else if( strcmp( mExrImage->channel_names[c], "B" ) == 0 )
-			blue = mExrImage->images[c];
-		else if( strcmp( mExrImage->channel_names[c], "A" ) == 0 )
-			alpha = mExrImage->images[c];
+		const T *src = channels[c];
+		T *dst = rowData + c;
+		for( int32_t col = 0; col < width; ++col, dst += numChannels )
+			*dst = src[col];
 	}
+}
 
-	if( ( ! red ) || ( ! green ) || ( ! blue ) )
-		throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for RGB" );
-	
-	// load one interleaved row at a time
+} // anonymous namespace
+
+void ImageSourceFileTinyExr::load( ImageTargetRef target )
+{
+	ImageSource::RowFunc rowFunc = setupRowFunc( target );
+
+	// the decoded channels are as wide as the data window; mOffsetX skips the columns left of the requested area
+	const size_t dataWidth = mExrImage->width;
 	if( getDataType() == ImageIo::FLOAT32 ) {
-		vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
+		vector<const float*> channels;
+		for( int c : mChannelIndices )
+			channels.push_back( reinterpret_cast<const float*>( mExrImage->images[c] ) + mOffsetX );
+		vector<float> rowData( mWidth * channels.size() );
 		for( int32_t row = 0; row < mHeight; row++ ) {
-			for( int32_t col = 0; col < mWidth; col++ ) {
-				rowData.at( col * numChannels + 0 ) = ((float*)red)[row * mWidth + col];
-				rowData.at( col * numChannels + 1 ) = ((float*)green)[row * mWidth + col];
-				rowData.at( col * numChannels + 2 ) = ((float*)blue)[row * mWidth + col];
-				if( alpha )
-					rowData.at( col * numChannels + 3 ) = ((float*)alpha)[row * mWidth + col];
-			}
-
+			interleaveRow( rowData.data(), channels, mWidth );
 			((*this).*rowFunc)( target, row, rowData.data() );
+			for( auto &channel : channels )
+				channel += dataWidth;
 		}
 	}
 	else { // float16
-		vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
+		vector<const uint16_t*> channels;
+		for( int c : mChannelIndices )
+			channels.push_back( reinterpret_cast<const uint16_t*>( mExrImage->images[c] ) + mOffsetX );
+		vector<uint16_t> rowData( mWidth * channels.size() );
 		for( int32_t row = 0; row < mHeight; row++ ) {
-			for( int32_t col = 0; col < mWidth; col++ ) {
-				rowData.at( col * numChannels + 0 ) = ((uint16_t*)red)[row * mWidth + col];
-				rowData.at( col * numChannels + 1 ) = ((uint16_t*)green)[row * mWidth + col];
-				rowData.at( col * numChannels + 2 ) = ((uint16_t*)blue)[row * mWidth + col];
-				if( alpha )
-					rowData.at( col * numChannels + 3 ) = ((uint16_t*)alpha)[row * mWidth + col];
-			}
-
+			interleaveRow( rowData.data(), channels, mWidth );
 			((*this).*rowFunc)( target, row, rowData.data() );
+			for( auto &channel : channels )
+				channel += dataWidth;
 		}
 	}
-	
-	FreeEXRImage( mExrImage.get() );
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -201,9 +247,9 @@ ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageS
 			setColorModel( ImageIo::ColorModel::CM_RGB );
 			setChannelOrder( ( mNumComponents == 3 ) ? ImageIo::ChannelOrder::BGR : ImageIo::ChannelOrder::ABGR );
 			if( mNumComponents == 3 )
-				mChannelNames = { "G", "B", "R" };
+				mChannelNames = { "B", "G", "R" };
 			else
-				mChannelNames = { "A", "G", "B", "R" };
+				mChannelNames = { "A", "B", "G", "R" };
 		break;
 		case ImageIo::ColorModel::CM_GRAY:
 			mNumComponents = ( imageSource->hasAlpha() ) ? 2 : 1;
@@ -218,44 +264,64 @@ ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageS
 			throw ImageIoExceptionIllegalColorModel();
 	}
 
-	// TODO: consider supporting half float and uint types as well
-	setDataType( ImageIo::DataType::FLOAT32 );
-	mData.resize( mHeight * imageSource->getWidth() * mNumComponents );
+	// half float sources are written as half, everything else as float
+	setDataType( ( imageSource->getDataType() == ImageIo::DataType::FLOAT16 ) ? ImageIo::DataType::FLOAT16 : ImageIo::DataType::FLOAT32 );
+	mData.resize( mHeight * imageSource->getWidth() * mNumComponents * ImageIo::dataTypeBytes( getDataType() ) );
 }
 
 void* ImageTargetFileTinyExr::getRowPointer( int32_t row )
 {
-	return &mData[row * getWidth() * mNumComponents];
+	return &mData[row * getWidth() * mNumComponents * ImageIo::dataTypeBytes( getDataType() )];
+}
+
+namespace {
+
+// Turns the interleaved \a data into a series of planar channels
+template<typename T>
+vector<vector<T>> deinterleave( const uint8_t *data, size_t numPixels, int numComponents )
+{
+	vector<vector<T>> result( numComponents, vector<T>( numPixels ) );
+	const T *src = reinterpret_cast<const T*>( data );
+	for( int c = 0; c < numComponents; ++c ) {
+		T *dst = result[c].data();
+		for( size_t i = 0; i < numPixels; ++i )
+			dst[i] = src[i * numComponents + c];
+	}
+	return result;
 }
 
+} // anonymous namespace
+
 void ImageTargetFileTinyExr::finalize()
 {
 	unique_ptr<EXRImage> exrImage( new EXRImage );
 	InitEXRImage( exrImage.get() ); // we intentionally do not call FreeEXRImage on this
 
 	const char *channelNames[4];
-	
-	// turn interleaved data into a series of planar channels
-	std::vector<Channel32f> channels;
-	float *srcData = mData.data();
-	for( int c = 0; c < mNumComponents; ++c ) {
-		channels.emplace_back( getWidth(), getHeight() );
-		Channel32f srcChannel( getWidth(), getHeight(), mNumComponents * getWidth() * sizeof(float), mNumComponents, srcData + c );
-		channels.back().copyFrom( srcChannel, srcChannel.getBounds() );
-	}
+	void *imagePtr[4];
+	int pixelTypes[4], requested_pixel_types[4];
+
+	const size_t numPixels = (size_t)getWidth() * getHeight();
+	const bool half = getDataType() == ImageIo::DataType::FLOAT16;
+	vector<vector<uint16_t>> channels16;
+	vector<vector<float>> channels32;
+	if( half )
+		channels16 = deinterleave<uint16_t>( mData.data(), numPixels, mNumComponents );
+	else
+		channels32 = deinterleave<float>( mData.data(), numPixels, mNumComponents );
+	mData.clear();
+	mData.shrink_to_fit();
 
 	exrImage->num_channels = mNumComponents;
 	exrImage->width = mWidth;
 	exrImage->height = mHeight;
 
-	float* imagePtr[4];
-	int pixelTypes[4], requested_pixel_types[4];
 	for( int i = 0; i < exrImage->num_channels; i++ ) {
-		pixelTypes[i] = TINYEXR_PIXELTYPE_FLOAT;
+		pixelTypes[i] = half ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT;
 		requested_pixel_types[i] = pixelTypes[i];
 		channelNames[i] = mChannelNames[i].c_str();
 
-		imagePtr[i] = channels[i].getData();
+		imagePtr[i] = half ? (void*)channels16[i].data() : (void*)channels32[i].data();
 	}
 
 	exrImage->channel_names = channelNames;
@@ -24,6 +24,7 @@
 
 #include "cinder/ImageIo.h"
 #include "cinder/Utilities.h"
+#include "cinder/ip/Swizzle.h"
 
 #include <iterator>
 #include <cctype>
@@ -165,6 +166,32 @@ size_t ImageSource::getRowBytes() const
 	return getWidth() * ImageIo::channelOrderNumChannels( getChannelOrder() ) * ImageIo::dataTypeBytes( getDataType() );
 }
 
+namespace {
+
+// Converts a row with ip::swizzleRow() when it supports SD and TD. Returns false otherwise.
+template<typename SD, typename TD>
+bool swizzleRowIfSupported( const SD *src, TD *dst, int32_t width, const ip::SwizzleMap &map, std::true_type /*supported*/ )
+{
+	if( map.mDstInc < 1 || map.mDstInc > 4 )
+		return false;
+	ip::swizzleRow( src, dst, width, map );
+	return true;
+}
+
+template<typename SD, typename TD>
+bool swizzleRowIfSupported( const SD *, TD *, int32_t, const ip::SwizzleMap &, std::false_type /*supported*/ )
+{
+	return false;
+}
+
+template<typename SD, typename TD>
+bool swizzleRowIfSupported( const SD *src, TD *dst, int32_t width, const ip::SwizzleMap &map )
+{
+	return swizzleRowIfSupported( src, dst, width, map, typename ip::IsSwizzleRowSupported<SD,TD>::type() );
+}
+
+} // anonymous namespace
+
 /* SD - source data type, TD - target data type, TCM - target color model */
 template<typename SD, typename TD, ImageIo::ColorModel TCM, bool ALPHA>
 void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data )
@@ -174,6 +201,18 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 	int32_t width = getWidth();
 	
 	if( TCM == CM_RGB ) {
+		// target alpha or padding without a source is set to the maximum
+		ip::SwizzleMap map( mRowFuncSourceInc, mRowFuncTargetInc, -1 );
+		if( mRowFuncTargetInc <= 4 ) {
+			map.mIndex[mRowFuncTargetRed] = mRowFuncSourceRed;
+			map.mIndex[mRowFuncTargetGreen] = mRowFuncSourceGreen;
+			map.mIndex[mRowFuncTargetBlue] = mRowFuncSourceBlue;
+			if( ALPHA )
+				map.mIndex[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+		}
+		if( swizzleRowIfSupported( sourceData, targetData, width, map ) )
+			return;
+
 		if( ALPHA ) {
 			for( int32_t c = 0; c < width; c++ ) {
 				targetData[mRowFuncTargetRed]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceRed] );
@@ -224,6 +263,24 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 	TD *targetData = reinterpret_cast<TD*>( target->getRowPointer( row ) );
 	int32_t width = getWidth();
 	
+	if( TCM == CM_RGB || TCM == CM_GRAY ) {
+		// gray is broadcast to red, green and blue. Target alpha or padding without a source is set to the maximum
+		ip::SwizzleMap map( mRowFuncSourceInc, mRowFuncTargetInc, -1 );
+		if( mRowFuncTargetInc <= 4 ) {
+			if( TCM == CM_RGB ) {
+				map.mIndex[mRowFuncTargetRed] = mRowFuncSourceGray;
+				map.mIndex[mRowFuncTargetGreen] = mRowFuncSourceGray;
+				map.mIndex[mRowFuncTargetBlue] = mRowFuncSourceGray;
+			}
+			else
+				map.mIndex[mRowFuncTargetGray] = mRowFuncSourceGray;
+			if( ALPHA )
+				map.mIndex[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+		}
+		if( swizzleRowIfSupported( sourceData, targetData, width, map ) )
+			return;
+	}
+
 	if( TCM == CM_RGB ) {
 		if( ALPHA ) {
 			for( int32_t c = 0; c < width; c++ ) {
@@ -250,7 +307,7 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 	else if( TCM == CM_GRAY ) {
 		if( ALPHA ) {
 			for( int32_t c = 0; c < width; c++ ) {
-				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncTargetGray] );
+				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGray] );
 				targetData[mRowFuncTargetAlpha]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceAlpha] );
 				targetData += mRowFuncTargetInc;
 				sourceData += mRowFuncSourceInc;
@@ -258,7 +315,7 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 		}
 		else {
 			for( int32_t c = 0; c < width; c++ ) {
-				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncTargetGray] );
+				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGray] );
 				targetData += mRowFuncTargetInc;
 				sourceData += mRowFuncSourceInc;
 			}			
@@ -451,6 +508,17 @@ void writeImage( DataTargetRef dataTarget, const ImageSourceRef &imageSource, Im
 	cocoa::SafeNsAutoreleasePool autorelease;
 #endif
 
+	writeImage( createImageTarget( dataTarget, imageSource, options, extension ), imageSource );
+}
+
+void writeImage( ImageTargetRef imageTarget, const ImageSourceRef &imageSource )
+{
+	imageSource->load( imageTarget );
+	imageTarget->finalize();
+}
+
+ImageTargetRef createImageTarget( DataTargetRef dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options, string extension )
+{
 	if( extension.empty() ) {
 #if ! defined( CINDER_UWP ) || ( _MSC_VER > 1800 )
 		extension = dataTarget->getFilePathHint().extension().string();
@@ -462,17 +530,10 @@ void writeImage( DataTargetRef dataTarget, const ImageSourceRef &imageSource, Im
 	}
 
 	ImageTargetRef imageTarget = ImageIoRegistrar::createTarget( dataTarget, imageSource, options, extension );
-	if( imageTarget ) {
-		writeImage( imageTarget, imageSource );
-	}
-	else
+	if( ! imageTarget )
 		throw ImageIoExceptionUnknownExtension( "Could not create target for image with extension: " + extension );
-}
 
-void writeImage( ImageTargetRef imageTarget, const ImageSourceRef &imageSource )
-{
-	imageSource->load( imageTarget );
-	imageTarget->finalize();
+	return imageTarget;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
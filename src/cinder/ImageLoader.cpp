@@ -0,0 +1,271 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageLoader.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+
+namespace cinder {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageLoader::Request
+ImageLoader::Request::Request( const std::weak_ptr<ImageLoader> &loader, const fs::path &filePath, const DataSourceRef &dataSource, int priority, uint64_t sequence, const CompletionFn &completionFn )
+	: mLoader( loader ), mFilePath( filePath ), mDataSource( dataSource ), mCompletionFn( completionFn ), mFuture( mPromise.get_future().share() ),
+		mSequence( sequence ), mPriority( priority ), mCanceled( false ), mState( PENDING )
+{
+}
+
+bool ImageLoader::Request::isDone() const
+{
+	return mFuture.wait_for( std::chrono::seconds( 0 ) ) == std::future_status::ready;
+}
+
+void ImageLoader::Request::cancel()
+{
+	// a request outliving its loader has already completed
+	ImageLoaderRef loader = mLoader.lock();
+	if( loader )
+		loader->cancel( this );
+}
+
+void ImageLoader::Request::setPriority( int priority )
+{
+	ImageLoaderRef loader = mLoader.lock();
+	if( loader )
+		loader->setPriority( this, priority );
+	else
+		mPriority = priority;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// ImageLoader
+ImageLoaderRef ImageLoader::create( const Options &options )
+{
+	return ImageLoaderRef( new ImageLoader( options ) );
+}
+
+ImageLoader::ImageLoader( const Options &options )
+	: mOptions( options ), mNextSequence( 0 ), mStop( false )
+{
+	// the registry of ImageSource types is created lazily and without synchronization, so make sure it exists before the workers use it
+	ImageIo::getLoadExtensions();
+
+	size_t numThreads = mOptions.getNumThreads();
+	if( numThreads == 0 )
+		numThreads = std::max<size_t>( std::thread::hardware_concurrency(), 2 ) - 1;
+	for( size_t t = 0; t < numThreads; ++t )
+		mWorkers.emplace_back( &ImageLoader::workerLoop, this );
+}
+
+ImageLoader::~ImageLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		cancelPending();
+		mStop = true;
+	}
+	mWorkCondition.notify_all();
+	for( auto &worker : mWorkers )
+		worker.join();
+}
+
+ImageLoader::RequestRef ImageLoader::load( const fs::path &path, int priority, const CompletionFn &completionFn )
+{
+	return enqueue( path, nullptr, priority, completionFn );
+}
+
+ImageLoader::RequestRef ImageLoader::load( const DataSourceRef &dataSource, int priority, const CompletionFn &completionFn )
+{
+	return enqueue( fs::path(), dataSource, priority, completionFn );
+}
+
+std::vector<ImageLoader::RequestRef> ImageLoader::load( const std::vector<fs::path> &paths, int priority, const CompletionFn &completionFn )
+{
+	std::vector<RequestRef> result;
+	result.reserve( paths.size() );
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		for( const auto &path : paths ) {
+			RequestRef request( new Request( shared_from_this(), path, nullptr, priority, mNextSequence++, completionFn ) );
+			mPending[pendingKey( priority, request->mSequence )] = request;
+			result.push_back( request );
+		}
+	}
+	mWorkCondition.notify_all();
+	return result;
+}
+
+ImageLoader::RequestRef ImageLoader::enqueue( const fs::path &path, const DataSourceRef &dataSource, int priority, const CompletionFn &completionFn )
+{
+	RequestRef request;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		request = RequestRef( new Request( shared_from_this(), path, dataSource, priority, mNextSequence++, completionFn ) );
+		mPending[pendingKey( priority, request->mSequence )] = request;
+	}
+	mWorkCondition.notify_one();
+	return request;
+}
+
+void ImageLoader::workerLoop()
+{
+	while( true ) {
+		RequestRef request;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mWorkCondition.wait( lock, [this] { return mStop || ! mPending.empty(); } );
+			if( mPending.empty() )
+				return;
+			request = mPending.begin()->second;
+			mPending.erase( mPending.begin() );
+			request->mState = Request::LOADING;
+			mLoading.push_back( request );
+		}
+
+		Surface8uRef surface;
+		std::exception_ptr exception;
+		try {
+			ThreadSetup threadSetup;
+			ImageSourceRef source = request->mDataSource ? loadImage( request->mDataSource, mOptions.getImageOptions() )
+														: loadImage( request->mFilePath, mOptions.getImageOptions() );
+			// moved rather than copied, so that the Surface keeps the pooled memory
+			if( mOptions.getSurfacePool() )
+				surface = std::make_shared<Surface8u>( mOptions.getSurfacePool()->getSurface<uint8_t>( source ) );
+			else
+				surface = Surface8u::create( source );
+		}
+		catch( ... ) {
+			exception = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mLoading.erase( std::find( mLoading.begin(), mLoading.end(), request ) );
+			if( request->mCanceled )
+				request->mPromise.set_exception( std::make_exception_ptr( ImageLoaderExceptionCanceled() ) );
+			else if( exception )
+				request->mPromise.set_exception( exception );
+			else
+				request->mPromise.set_value( std::move( surface ) );
+			complete( request );
+		}
+		mIdleCondition.notify_all();
+		// a canceled Surface is released here, outside of the lock
+	}
+}
+
+void ImageLoader::complete( const RequestRef &request )
+{
+	request->mState = Request::DONE;
+	if( request->mCompletionFn )
+		mCompleted.push_back( request );
+}
+
+size_t ImageLoader::update( size_t maxCompletions )
+{
+	size_t result = 0;
+	while( result < maxCompletions ) {
+		RequestRef request;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			if( mCompleted.empty() )
+				break;
+			request = mCompleted.front();
+			mCompleted.pop_front();
+		}
+		// called without the lock so that the callback may make further requests
+		request->mCompletionFn( request );
+		++result;
+	}
+
+	return result;
+}
+
+void ImageLoader::cancel( Request *request )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	if( request->mState == Request::DONE )
+		return;
+
+	request->mCanceled = true;
+	if( request->mState == Request::PENDING ) {
+		auto pendingIt = mPending.find( pendingKey( request->mPriority, request->mSequence ) );
+		RequestRef requestRef = pendingIt->second;
+		mPending.erase( pendingIt );
+		requestRef->mPromise.set_exception( std::make_exception_ptr( ImageLoaderExceptionCanceled() ) );
+		complete( requestRef );
+		mIdleCondition.notify_all();
+	}
+}
+
+void ImageLoader::cancelAll()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	cancelPending();
+	// these are discarded by the workers once decoded
+	for( auto &loading : mLoading )
+		loading->mCanceled = true;
+}
+
+void ImageLoader::cancelPending()
+{
+	for( auto &pending : mPending ) {
+		pending.second->mCanceled = true;
+		pending.second->mPromise.set_exception( std::make_exception_ptr( ImageLoaderExceptionCanceled() ) );
+		complete( pending.second );
+	}
+	mPending.clear();
+	mIdleCondition.notify_all();
+}
+
+void ImageLoader::setPriority( Request *request, int priority )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	if( request->mState == Request::PENDING && request->mPriority != priority ) {
+		auto pendingIt = mPending.find( pendingKey( request->mPriority, request->mSequence ) );
+		RequestRef requestRef = pendingIt->second;
+		mPending.erase( pendingIt );
+		mPending[pendingKey( priority, request->mSequence )] = requestRef;
+	}
+	request->mPriority = priority;
+}
+
+void ImageLoader::waitAll()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mIdleCondition.wait( lock, [this] { return mPending.empty() && mLoading.empty(); } );
+}
+
+size_t ImageLoader::getNumPending() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mPending.size();
+}
+
+size_t ImageLoader::getNumLoading() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mLoading.size();
+}
+
+} // namespace cinder
@@ -0,0 +1,417 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageSequence.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <set>
+#include <stdexcept>
+
+namespace cinder {
+
+namespace {
+
+// Compares \a a and \a b character by character, except that runs of digits are compared by value
+bool naturalLess( const std::string &a, const std::string &b )
+{
+	size_t i = 0, j = 0;
+	while( i < a.size() && j < b.size() ) {
+		if( isdigit( (unsigned char)a[i] ) && isdigit( (unsigned char)b[j] ) ) {
+			// skip leading zeros, after which the longer run is the larger number
+			size_t endA = i, endB = j;
+			while( endA < a.size() && isdigit( (unsigned char)a[endA] ) ) ++endA;
+			while( endB < b.size() && isdigit( (unsigned char)b[endB] ) ) ++endB;
+			size_t startA = i, startB = j;
+			while( startA + 1 < endA && a[startA] == '0' ) ++startA;
+			while( startB + 1 < endB && b[startB] == '0' ) ++startB;
+			if( endA - startA != endB - startB )
+				return endA - startA < endB - startB;
+			const int order = a.compare( startA, endA - startA, b, startB, endB - startB );
+			if( order != 0 )
+				return order < 0;
+			i = endA;
+			j = endB;
+		}
+		else {
+			if( a[i] != b[j] )
+				return a[i] < b[j];
+			++i;
+			++j;
+		}
+	}
+
+	return a.size() - i < b.size() - j;
+}
+
+} // anonymous namespace
+
+template<typename T>
+std::shared_ptr<ImageSequenceT<T>> ImageSequenceT<T>::create( const fs::path &directory, const Options &options )
+{
+	if( ! fs::is_directory( directory ) )
+		throw ImageIoException( "Not a directory: " + directory.string() );
+
+	const std::vector<std::string> loadExtensions = ImageIo::getLoadExtensions();
+	const std::set<std::string> extensions( loadExtensions.begin(), loadExtensions.end() );
+	std::vector<fs::path> paths;
+	for( fs::directory_iterator it( directory ), end; it != end; ++it ) {
+		if( ! fs::is_regular_file( it->path() ) )
+			continue;
+		std::string extension = it->path().extension().string();
+		if( extension.empty() )
+			continue;
+		extension = extension.substr( 1 );
+		std::transform( extension.begin(), extension.end(), extension.begin(), static_cast<int(*)(int)>(tolower) );
+		if( extensions.count( extension ) )
+			paths.push_back( it->path() );
+	}
+
+	std::sort( paths.begin(), paths.end(), []( const fs::path &a, const fs::path &b ) { return naturalLess( a.filename().string(), b.filename().string() ); } );
+	if( paths.empty() )
+		throw ImageIoException( "No images in " + directory.string() );
+
+	return create( paths, options );
+}
+
+template<typename T>
+std::shared_ptr<ImageSequenceT<T>> ImageSequenceT<T>::create( const std::vector<fs::path> &paths, const Options &options )
+{
+	if( paths.empty() )
+		throw ImageIoException( "An ImageSequence requires at least one frame" );
+
+	return std::shared_ptr<ImageSequenceT<T>>( new ImageSequenceT<T>( paths, options ) );
+}
+
+template<typename T>
+ImageSequenceT<T>::ImageSequenceT( const std::vector<fs::path> &paths, const Options &options )
+	: mPaths( paths ), mOptions( options ), mPlayhead( 0 ), mCachedBytes( 0 ), mNumHits( 0 ), mNumLate( 0 ), mNumDropped( 0 ),
+		mNumDecoded( 0 ), mNumEvicted( 0 ), mLateSeconds( 0 ), mStop( false )
+{
+	// the registry of ImageSource types is created lazily and without synchronization, so make sure it exists before the workers use it
+	ImageIo::getLoadExtensions();
+
+	size_t numThreads = mOptions.getNumThreads();
+	if( numThreads == 0 )
+		numThreads = std::max<size_t>( std::thread::hardware_concurrency(), 2 ) - 1;
+	for( size_t t = 0; t < numThreads; ++t )
+		mWorkers.emplace_back( &ImageSequenceT<T>::workerLoop, this );
+}
+
+template<typename T>
+ImageSequenceT<T>::~ImageSequenceT()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+		mQueue.clear();
+	}
+	mWorkCondition.notify_all();
+	for( auto &worker : mWorkers )
+		worker.join();
+}
+
+template<typename T>
+std::shared_ptr<SurfaceT<T>> ImageSequenceT<T>::getFrame( size_t index )
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	seekLocked( index );
+
+	auto frameIt = mFrames.find( index );
+	if( frameIt->second.mState == CACHED )
+		++mNumHits;
+	else {
+		++mNumLate;
+		const auto start = std::chrono::steady_clock::now();
+		while( frameIt->second.mState != CACHED && frameIt->second.mState != FAILED ) {
+			mFrameCondition.wait( lock );
+			frameIt = mFrames.find( index );
+			if( frameIt == mFrames.end() ) {
+				// another thread moved the playhead away, abandoning or evicting the frame; queue it ahead of the rest
+				mFrames[index] = Frame{ QUEUED, nullptr, nullptr, 0, mLru.end() };
+				mQueue.push_front( index );
+				mWorkCondition.notify_one();
+				frameIt = mFrames.find( index );
+			}
+		}
+		mLateSeconds += std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	if( frameIt->second.mState == FAILED ) {
+		// the next request for the frame tries again
+		std::exception_ptr error = frameIt->second.mError;
+		mFrames.erase( frameIt );
+		std::rethrow_exception( error );
+	}
+
+	touch( frameIt->second );
+	return frameIt->second.mSurface;
+}
+
+template<typename T>
+bool ImageSequenceT<T>::tryGetFrame( size_t index, std::shared_ptr<SurfaceT<T>> *result )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	seekLocked( index );
+
+	auto frameIt = mFrames.find( index );
+	if( frameIt->second.mState == FAILED ) {
+		std::exception_ptr error = frameIt->second.mError;
+		mFrames.erase( frameIt );
+		std::rethrow_exception( error );
+	}
+	else if( frameIt->second.mState != CACHED ) {
+		++mNumDropped;
+		return false;
+	}
+
+	++mNumHits;
+	touch( frameIt->second );
+	*result = frameIt->second.mSurface;
+	return true;
+}
+
+template<typename T>
+void ImageSequenceT<T>::seek( size_t index )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	seekLocked( index );
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getPlayhead() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mPlayhead;
+}
+
+template<typename T>
+void ImageSequenceT<T>::seekLocked( size_t index )
+{
+	if( index >= mPaths.size() )
+		throw std::out_of_range( "ImageSequence frame index out of range" );
+
+	mPlayhead = index;
+	const std::vector<size_t> window = getWindow();
+
+	// frames queued for an earlier playhead which the new window doesn't cover aren't worth decoding anymore
+	for( size_t queued : mQueue ) {
+		if( std::find( window.begin(), window.end(), queued ) == window.end() )
+			mFrames.erase( queued );
+	}
+
+	// the queue is rebuilt in the order the window will be played
+	mQueue.clear();
+	for( size_t frame : window ) {
+		auto frameIt = mFrames.find( frame );
+		if( frameIt == mFrames.end() )
+			mFrames[frame] = Frame{ QUEUED, nullptr, nullptr, 0, mLru.end() };
+		else if( frameIt->second.mState != QUEUED )
+			continue;
+		mQueue.push_back( frame );
+	}
+
+	if( ! mQueue.empty() )
+		mWorkCondition.notify_all();
+}
+
+template<typename T>
+std::vector<size_t> ImageSequenceT<T>::getWindow() const
+{
+	std::vector<size_t> result;
+	const size_t numFrames = mPaths.size();
+	const size_t length = std::min( mOptions.getReadAhead() + 1, mOptions.getLoop() ? numFrames : numFrames - mPlayhead );
+	for( size_t i = 0; i < length; ++i )
+		result.push_back( ( mPlayhead + i ) % numFrames );
+
+	return result;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getDistance( size_t index ) const
+{
+	if( index >= mPlayhead )
+		return index - mPlayhead;
+	else
+		return mOptions.getLoop() ? index + mPaths.size() - mPlayhead : std::numeric_limits<size_t>::max();
+}
+
+template<typename T>
+void ImageSequenceT<T>::touch( Frame &frame )
+{
+	mLru.splice( mLru.begin(), mLru, frame.mLruPosition );
+}
+
+template<typename T>
+void ImageSequenceT<T>::evict()
+{
+	// the least recently used frames outside of the read-ahead window go first, then those in it furthest from the playhead
+	while( mCachedBytes > mOptions.getMaxCacheBytes() ) {
+		auto victim = mLru.end();
+		size_t victimDistance = 0;
+		for( auto it = mLru.rbegin(); it != mLru.rend(); ++it ) {
+			const size_t distance = getDistance( *it );
+			if( distance > mOptions.getReadAhead() ) {
+				victim = std::prev( it.base() );
+				break;
+			}
+			else if( distance > victimDistance ) {
+				victim = std::prev( it.base() );
+				victimDistance = distance;
+			}
+		}
+		// the playhead's frame is kept even if it doesn't fit on its own
+		if( victim == mLru.end() )
+			break;
+
+		auto frameIt = mFrames.find( *victim );
+		mCachedBytes -= frameIt->second.mBytes;
+		mFrames.erase( frameIt );
+		mLru.erase( victim );
+		++mNumEvicted;
+	}
+}
+
+template<typename T>
+void ImageSequenceT<T>::workerLoop()
+{
+	while( true ) {
+		size_t index;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mWorkCondition.wait( lock, [this] { return mStop || ! mQueue.empty(); } );
+			if( mStop )
+				return;
+			index = mQueue.front();
+			mQueue.pop_front();
+			mFrames[index].mState = DECODING;
+		}
+
+		std::shared_ptr<SurfaceT<T>> surface;
+		std::exception_ptr error;
+		try {
+			ThreadSetup threadSetup;
+			ImageSourceRef source = loadImage( mPaths[index], mOptions.getImageOptions() );
+			// moved rather than copied, so that the cache holds the pooled memory
+			if( mOptions.getSurfacePool() )
+				surface = std::make_shared<SurfaceT<T>>( mOptions.getSurfacePool()->template getSurface<T>( source ) );
+			else
+				surface = SurfaceT<T>::create( source );
+		}
+		catch( ... ) {
+			error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			++mNumDecoded;
+			// frames being decoded are never abandoned, so the frame is still there
+			Frame &frame = mFrames[index];
+			if( error ) {
+				frame.mState = FAILED;
+				frame.mError = error;
+			}
+			else {
+				frame.mState = CACHED;
+				frame.mSurface = surface;
+				frame.mBytes = surface->getRowBytes() * surface->getHeight();
+				mLru.push_front( index );
+				frame.mLruPosition = mLru.begin();
+				mCachedBytes += frame.mBytes;
+				evict();
+			}
+		}
+		mFrameCondition.notify_all();
+	}
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumHits() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumHits;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumLate() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumLate;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumDropped() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumDropped;
+}
+
+template<typename T>
+double ImageSequenceT<T>::getLateSeconds() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mLateSeconds;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumDecoded() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumDecoded;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumEvicted() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumEvicted;
+}
+
+template<typename T>
+void ImageSequenceT<T>::resetCounters()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mNumHits = mNumLate = mNumDropped = mNumDecoded = mNumEvicted = 0;
+	mLateSeconds = 0;
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getNumCached() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mLru.size();
+}
+
+template<typename T>
+size_t ImageSequenceT<T>::getCachedBytes() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mCachedBytes;
+}
+
+template class CI_API ImageSequenceT<uint8_t>;
+template class CI_API ImageSequenceT<uint16_t>;
+template class CI_API ImageSequenceT<float>;
+
+} // namespace cinder
@@ -22,25 +22,113 @@
 */
 
 #include "cinder/ImageSourceFileStbImage.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Memory which ImageSourceFileStbImage::load() has asked stb_image to decode into on this thread, see stbiMalloc()
+struct DecodeTarget {
+	uint8_t		*mData;
+	size_t		mImageBytes, mDataBytes;
+	bool		mInUse;
+};
+
+thread_local DecodeTarget *sDecodeTarget = nullptr;
+
+// stb_image allocates each decoded image as one block of exactly its size, or one byte more in the case of JPEG,
+// while its working buffers differ in size. A block of that size is therefore handed the decode target's memory.
+void* stbiMalloc( size_t size )
+{
+	DecodeTarget *target = sDecodeTarget;
+	if( target && ! target->mInUse && ( size == target->mImageBytes || size == target->mImageBytes + 1 ) && size <= target->mDataBytes ) {
+		target->mInUse = true;
+		return target->mData;
+	}
+
+	return malloc( size );
+}
+
+void* stbiRealloc( void *p, size_t oldSize, size_t newSize )
+{
+	DecodeTarget *target = sDecodeTarget;
+	if( target && p && p == target->mData ) {
+		void *result = malloc( newSize );
+		if( result ) {
+			memcpy( result, p, std::min( oldSize, newSize ) );
+			target->mInUse = false;
+		}
+		return result;
+	}
+
+	return realloc( p, newSize );
+}
+
+void stbiFree( void *p )
+{
+	DecodeTarget *target = sDecodeTarget;
+	if( target && p && p == target->mData )
+		target->mInUse = false;
+	else
+		free( p );
+}
+
+} // anonymous namespace
+
+#define STBI_MALLOC(sz)						stbiMalloc( sz )
+#define STBI_REALLOC_SIZED(p,oldsz,newsz)	stbiRealloc( p, oldsz, newsz )
+#define STBI_FREE(p)						stbiFree( p )
 #define STBI_NO_PIC
 #define STBI_NO_PNM
 #define STB_IMAGE_IMPLEMENTATION
 #define STB_IMAGE_STATIC
+// the header is read through the stbi__ internals, which leaves public entry points like stbi_is_hdr() unused in this static build
+#if defined( __GNUC__ ) || defined( __clang__ )
+	#pragma GCC diagnostic push
+	#pragma GCC diagnostic ignored "-Wunused-function"
+#endif
 #include "stb/stb_image.h"
+#if defined( __GNUC__ ) || defined( __clang__ )
+	#pragma GCC diagnostic pop
+#endif
 
 namespace cinder {
 
+namespace {
+
+// stbi_info() reports the components of a gray or RGB PNG before its tRNS chunk, which stbi_load() turns into alpha
+bool pngHasTransparency( stbi__context *s )
+{
+	if( ! stbi__check_png_header( s ) )
+		return false;
+
+	while( ! stbi__at_eof( s ) ) {
+		stbi__pngchunk chunk = stbi__get_chunk_header( s );
+		if( chunk.type == STBI__PNG_TYPE('t','R','N','S') )
+			return true;
+		else if( chunk.type == STBI__PNG_TYPE('I','D','A','T') || chunk.type == STBI__PNG_TYPE('I','E','N','D') )
+			return false;
+		stbi__skip( s, chunk.length + 4 ); // data and CRC
+	}
+
+	return false;
+}
+
+} // anonymous namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // Registrar
 void ImageSourceFileStbImage::registerSelf()
 {
 	static bool alreadyRegistered = false;
 	static const int32_t SOURCE_PRIORITY = 3; // OS-default are 2; this is lower priority
-	
+
 	if( alreadyRegistered )
 		return;
 	alreadyRegistered = true;
-	
+
 	ImageIoRegistrar::SourceCreationFunc sourceFunc = ImageSourceFileStbImage::create;
 	ImageIoRegistrar::registerSourceType( "jpg", sourceFunc, SOURCE_PRIORITY );
 	ImageIoRegistrar::registerSourceType( "jpeg", sourceFunc, SOURCE_PRIORITY );
@@ -58,49 +146,50 @@ void ImageSourceFileStbImage::registerSelf()
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileStbImage
 ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 )
+	: mDataSource( dataSourceRef ), mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 ), mComponents( 0 )
 {
+	// only the header is read here; the pixels are decoded by load(), straight into the target when its layout allows
 	int width = 0, height = 0, components = 0;
+	bool isHdr = false, isPng = false;
+	stbi__context context;
+	FILE *file = nullptr;
 
 	if( dataSourceRef->isFilePath() ) {
-		if( stbi_is_hdr( dataSourceRef->getFilePath().string().c_str() ) ) {
-			mData32f = stbi_loadf( dataSourceRef->getFilePath().string().c_str(), &width, &height, &components, 0 /*any # of components*/ );
-			if( ! mData32f )
-				throw ImageIoException( stbi_failure_reason() );
-
-			mRowBytes = width * components * sizeof( float );
-		}
-		else {
-			mData8u = stbi_load( dataSourceRef->getFilePath().string().c_str(), &width, &height, &components, 0 /*any # of components*/ );
-			if( ! mData8u )
-				throw ImageIoException( stbi_failure_reason() );
-
-			mRowBytes = width * components;
-		}
+		file = stbi__fopen( dataSourceRef->getFilePath().string().c_str(), "rb" );
+		if( ! file )
+			throw ImageIoException( "Failed to open " + dataSourceRef->getFilePath().string() );
+		stbi__start_file( &context, file );
 	}
-	else { // we'll use a dataref from the buffer
+	else {
 		BufferRef buffer = dataSourceRef->getBuffer();
-		if( stbi_is_hdr_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize() ) ) {
-			mData32f = stbi_loadf_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, 0 /*any # of components*/ );
-			if( ! mData32f )
-				throw ImageIoException( stbi_failure_reason() );
-			
-			mRowBytes = width * components * sizeof(float);
-		}
-		else {
-			mData8u = stbi_load_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, 0 /*any # of components*/ );
-			if( ! mData8u )
-				throw ImageIoException( stbi_failure_reason() );
-				
-			mRowBytes = width * components;
-		}
+		stbi__start_mem( &context, (const stbi_uc*)buffer->getData(), (int)buffer->getSize() );
 	}
 
-	if( mData8u )
-		setDataType( ImageIo::UINT8 );
-	else if( mData32f )
+	const bool success = stbi__info_main( &context, &width, &height, &components ) != 0;
+	if( success ) {
+		stbi__rewind( &context );
+		isHdr = stbi__hdr_test( &context ) != 0;
+		stbi__rewind( &context );
+		isPng = stbi__png_test( &context ) != 0;
+		stbi__rewind( &context );
+		if( isPng && ( components == 1 || components == 3 ) && pngHasTransparency( &context ) )
+			++components;
+	}
+	if( file )
+		fclose( file );
+	if( ! success )
+		throw ImageIoException( stbi_failure_reason() );
+
+	if( isHdr ) {
 		setDataType( ImageIo::FLOAT32 );
+		mRowBytes = width * components * sizeof(float);
+	}
+	else {
+		setDataType( ImageIo::UINT8 );
+		mRowBytes = width * components;
+	}
 	setSize( width, height );
+	mComponents = components;
 
 	switch( components ) {
 		case 1:
@@ -133,8 +222,91 @@ ImageSourceFileStbImage::~ImageSourceFileStbImage()
 		stbi_image_free( (void*)mData32f );
 }
 
+void* ImageSourceFileStbImage::decode()
+{
+	// requesting the components reported by the constructor guarantees the decoded layout matches them
+	int width = 0, height = 0, components = 0;
+	void *result;
+	if( mDataSource->isFilePath() ) {
+		const std::string path = mDataSource->getFilePath().string();
+		if( getDataType() == ImageIo::FLOAT32 )
+			result = stbi_loadf( path.c_str(), &width, &height, &components, mComponents );
+		else
+			result = stbi_load( path.c_str(), &width, &height, &components, mComponents );
+	}
+	else {
+		BufferRef buffer = mDataSource->getBuffer();
+		if( getDataType() == ImageIo::FLOAT32 )
+			result = stbi_loadf_from_memory( (const stbi_uc*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, mComponents );
+		else
+			result = stbi_load_from_memory( (const stbi_uc*)buffer->getData(), (int)buffer->getSize(), &width, &height, &components, mComponents );
+	}
+
+	if( ! result )
+		throw ImageIoException( stbi_failure_reason() );
+	if( width != mWidth || height != mHeight ) {
+		stbiFree( result );
+		throw ImageIoException( "Image size changed since its header was read" );
+	}
+
+	return result;
+}
+
+bool ImageSourceFileStbImage::loadDirect( const ImageTargetRef &target )
+{
+	ptrdiff_t targetRowBytes = 0;
+	size_t dataBytes = 0;
+	if( target->getDataType() != getDataType() || target->getChannelOrder() != getChannelOrder() || target->getColorModel() != getColorModel() )
+		return false;
+	uint8_t *data = static_cast<uint8_t*>( target->getContiguousData( &targetRowBytes, &dataBytes ) );
+	if( ! data || targetRowBytes < (ptrdiff_t)mRowBytes )
+		return false;
+
+	DecodeTarget decodeTarget = { data, mHeight * mRowBytes, dataBytes, false };
+	sDecodeTarget = &decodeTarget;
+	void *result;
+	try {
+		result = decode();
+	}
+	catch( ... ) {
+		sDecodeTarget = nullptr;
+		throw;
+	}
+	sDecodeTarget = nullptr;
+
+	if( result != data ) {
+		// stb_image decoded elsewhere, most likely by way of a conversion; load() copies it as usual
+		if( getDataType() == ImageIo::FLOAT32 )
+			mData32f = static_cast<float*>( result );
+		else
+			mData8u = static_cast<uint8_t*>( result );
+		return false;
+	}
+
+	// the rows were decoded back to back; spread them out to the target's rowBytes, starting from the last so none is overwritten
+	if( targetRowBytes != (ptrdiff_t)mRowBytes ) {
+		for( int32_t row = mHeight - 1; row > 0; --row )
+			memmove( data + row * targetRowBytes, data + row * mRowBytes, mRowBytes );
+	}
+
+	return true;
+}
+
 void ImageSourceFileStbImage::load( ImageTargetRef target )
 {
+	if( ! mData8u && ! mData32f ) {
+		if( loadDirect( target ) )
+			return;
+		// loadDirect() may have left a decoded image behind
+		if( ! mData8u && ! mData32f ) {
+			void *data = decode();
+			if( getDataType() == ImageIo::FLOAT32 )
+				mData32f = static_cast<float*>( data );
+			else
+				mData8u = static_cast<uint8_t*>( data );
+		}
+	}
+
 	ImageSource::RowFunc func = setupRowFunc( target );
 	const uint8_t *data = ( mData8u ) ? mData8u : reinterpret_cast<uint8_t*>( mData32f );
 	for( int32_t row = 0; row < mHeight; ++row ) {
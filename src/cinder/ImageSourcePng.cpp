@@ -77,7 +77,7 @@ ImageSourcePngRef ImageSourcePng::createRef( DataSourceRef dataSourceRef, ImageS
 }
 
 ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: ImageSource(), mInfoPtr( 0 ), mPngPtr( 0 )
+	: ImageSource(), mInfoPtr( 0 ), mPngPtr( 0 ), mInterlaced( false )
 {
 	mPngPtr = png_create_read_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL );
 	if( ! mPngPtr ) {
@@ -152,6 +152,10 @@ bool ImageSourcePng::loadHeader()
 		png_set_expand_gray_1_2_4_to_8( mPngPtr );
 		png_set_palette_to_rgb( mPngPtr );
 		png_set_tRNS_to_alpha( mPngPtr );
+		if( interlaceType != PNG_INTERLACE_NONE ) {
+			png_set_interlace_handling( mPngPtr );
+			mInterlaced = true;
+		}
 		
 		png_read_update_info( mPngPtr, mInfoPtr );
 	}
@@ -176,11 +180,24 @@ void ImageSourcePng::load( ImageTargetRef target )
 	else {
 		// get a pointer to the ImageSource function appropriate for handling our data configuration
 		ImageSource::RowFunc func = setupRowFunc( target );
-		//int number_passes = png_set_interlace_handling( mPngPtr );
-		unique_ptr<png_byte[]> row_pointer( new png_byte[png_get_rowbytes( mPngPtr, mInfoPtr )] );
-		for( int32_t row = 0; row < mHeight; ++row ) {
-			png_read_row( mPngPtr, row_pointer.get(), NULL );
-			((*this).*func)( target, row, row_pointer.get() );
+		const size_t rowBytes = png_get_rowbytes( mPngPtr, mInfoPtr );
+		if( mInterlaced ) {
+			// each pass of an interlaced image touches every row, so the whole image must be held
+			unique_ptr<png_byte[]> image( new png_byte[rowBytes * mHeight] );
+			unique_ptr<png_bytep[]> rowPointers( new png_bytep[mHeight] );
+			for( int32_t row = 0; row < mHeight; ++row )
+				rowPointers[row] = image.get() + row * rowBytes;
+			png_read_image( mPngPtr, rowPointers.get() );
+			for( int32_t row = 0; row < mHeight; ++row )
+				((*this).*func)( target, row, rowPointers[row] );
+		}
+		else {
+			// rows are decoded one at a time as they're read from the stream, so only a single row is held
+			unique_ptr<png_byte[]> row_pointer( new png_byte[rowBytes] );
+			for( int32_t row = 0; row < mHeight; ++row ) {
+				png_read_row( mPngPtr, row_pointer.get(), NULL );
+				((*this).*func)( target, row, row_pointer.get() );
+			}
 		}
 	}
 	
@@ -0,0 +1,115 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageTargetBands.h"
+#include "cinder/ip/Fill.h"
+
+#include <algorithm>
+
+namespace cinder {
+
+template<typename T>
+std::shared_ptr<ImageTargetBandsT<T>> ImageTargetBandsT<T>::create( int32_t width, bool alpha, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder )
+{
+	return std::shared_ptr<ImageTargetBandsT<T>>( new ImageTargetBandsT<T>( width, alpha, bandHeight, bandFn, channelOrder ) );
+}
+
+template<typename T>
+void ImageTargetBandsT<T>::load( const ImageSourceRef &imageSource, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder )
+{
+	const bool alpha = channelOrder.getCode() == SurfaceChannelOrder::UNSPECIFIED ? imageSource->hasAlpha() : channelOrder.hasAlpha();
+	auto target = create( imageSource->getWidth(), alpha, std::min( bandHeight, imageSource->getHeight() ), bandFn, channelOrder );
+	// as in SurfaceT::load(), an image without alpha is made opaque
+	target->mFillAlpha = alpha && ! imageSource->hasAlpha();
+	imageSource->load( target );
+	target->finalize();
+}
+
+template<typename T>
+ImageTargetBandsT<T>::ImageTargetBandsT( int32_t width, bool alpha, int32_t bandHeight, const BandFn &bandFn, SurfaceChannelOrder channelOrder )
+	: ImageTarget(), mBand( width, std::max( bandHeight, 1 ), alpha, channelOrder ), mBandFn( bandFn ), mBandY( 0 ), mEndRow( 0 ), mFillAlpha( false )
+{
+	if( std::is_same<T,float>::value )
+		setDataType( ImageIo::FLOAT32 );
+	else if( std::is_same<T,uint16_t>::value )
+		setDataType( ImageIo::UINT16 );
+	else
+		setDataType( ImageIo::UINT8 );
+
+	setColorModel( ImageIo::CM_RGB );
+	switch( mBand.getChannelOrder().getCode() ) {
+		case SurfaceChannelOrder::RGBA: setChannelOrder( ImageIo::RGBA ); break;
+		case SurfaceChannelOrder::BGRA: setChannelOrder( ImageIo::BGRA ); break;
+		case SurfaceChannelOrder::ARGB: setChannelOrder( ImageIo::ARGB ); break;
+		case SurfaceChannelOrder::ABGR: setChannelOrder( ImageIo::ABGR ); break;
+		case SurfaceChannelOrder::RGBX: setChannelOrder( ImageIo::RGBX ); break;
+		case SurfaceChannelOrder::BGRX: setChannelOrder( ImageIo::BGRX ); break;
+		case SurfaceChannelOrder::XRGB: setChannelOrder( ImageIo::XRGB ); break;
+		case SurfaceChannelOrder::XBGR: setChannelOrder( ImageIo::XBGR ); break;
+		case SurfaceChannelOrder::RGB: setChannelOrder( ImageIo::RGB ); break;
+		case SurfaceChannelOrder::BGR: setChannelOrder( ImageIo::BGR ); break;
+		default: throw ImageIoException( "Unsupported channel order for ImageTargetBands" );
+	}
+}
+
+template<typename T>
+void* ImageTargetBandsT<T>::getRowPointer( int32_t row )
+{
+	const int32_t bandHeight = mBand.getHeight();
+	if( row < mBandY )
+		throw ImageIoException( "ImageTargetBands requires rows in top to bottom order" );
+	if( row >= mBandY + bandHeight ) {
+		flush( mEndRow );
+		mBandY = row - row % bandHeight;
+	}
+
+	mEndRow = std::max( mEndRow, row + 1 );
+	return mBand.getData( ivec2( 0, row - mBandY ) );
+}
+
+template<typename T>
+void ImageTargetBandsT<T>::finalize()
+{
+	flush( mEndRow );
+}
+
+template<typename T>
+void ImageTargetBandsT<T>::flush( int32_t endRow )
+{
+	if( endRow <= mBandY )
+		return;
+
+	const Area rows( 0, 0, mBand.getWidth(), endRow - mBandY );
+	if( mFillAlpha )
+		ip::fill( &mBand.getChannelAlpha(), CHANTRAIT<T>::max(), rows );
+	if( rows.getHeight() == mBand.getHeight() )
+		mBandFn( mBand, mBandY );
+	else
+		mBandFn( mBand.getView( rows ), mBandY );
+	mBandY = endRow;
+}
+
+template class ImageTargetBandsT<uint8_t>;
+template class ImageTargetBandsT<uint16_t>;
+template class ImageTargetBandsT<float>;
+
+} // namespace cinder
@@ -0,0 +1,314 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageTargetFilePng.h"
+#include "cinder/Stream.h"
+#include "cinder/ip/ThreadPool.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace cinder {
+
+namespace {
+
+// Bytes of filtered rows per band; the same block size pigz uses
+const size_t BAND_BYTES = 128 * 1024;
+// deflate's window, which primes each band with the end of the one before it
+const size_t DICTIONARY_BYTES = 32 * 1024;
+
+// Calls fn( i ) for every i in [0, count), spread across the ip::ThreadPool when one is installed and serially otherwise
+template<typename Func>
+void parallelFor( int32_t count, const Func &fn )
+{
+	const ip::ThreadPoolRef threadPool = ip::getThreadPool();
+	if( ! threadPool || count < 2 ) {
+		for( int32_t i = 0; i < count; ++i )
+			fn( i );
+		return;
+	}
+
+	threadPool->parallelFor( (size_t)count, 1, [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			fn( (int32_t)i );
+	} );
+}
+
+inline uint8_t paethPredictor( int a, int b, int c )
+{
+	const int p = a + b - c;
+	const int pa = std::abs( p - a ), pb = std::abs( p - b ), pc = std::abs( p - c );
+	if( pa <= pb && pa <= pc )
+		return (uint8_t)a;
+	else if( pb <= pc )
+		return (uint8_t)b;
+	else
+		return (uint8_t)c;
+}
+
+// Applies \a filter to \a row, whose \a prev is nullptr for the first row of the image, and returns the sum of the filtered bytes as signed magnitudes
+size_t filterRow( ImageTargetFilePng::Filter filter, const uint8_t *row, const uint8_t *prev, size_t rowBytes, size_t bpp, uint8_t *dest )
+{
+	// the bytes left of the first pixel, and the row above the first row, count as zero
+	const size_t first = std::min( bpp, rowBytes );
+	switch( filter ) {
+		case ImageTargetFilePng::FILTER_SUB:
+			memcpy( dest, row, first );
+			for( size_t i = first; i < rowBytes; ++i )
+				dest[i] = row[i] - row[i - bpp];
+		break;
+		case ImageTargetFilePng::FILTER_UP:
+			for( size_t i = 0; i < rowBytes; ++i )
+				dest[i] = row[i] - ( prev ? prev[i] : 0 );
+		break;
+		case ImageTargetFilePng::FILTER_AVERAGE:
+			for( size_t i = 0; i < first; ++i )
+				dest[i] = row[i] - ( prev ? prev[i] / 2 : 0 );
+			for( size_t i = first; i < rowBytes; ++i )
+				dest[i] = row[i] - (uint8_t)( ( row[i - bpp] + ( prev ? prev[i] : 0 ) ) / 2 );
+		break;
+		case ImageTargetFilePng::FILTER_PAETH:
+			if( ! prev ) { // the predictor reduces to the left neighbour, as with FILTER_SUB
+				memcpy( dest, row, first );
+				for( size_t i = first; i < rowBytes; ++i )
+					dest[i] = row[i] - row[i - bpp];
+			}
+			else {
+				for( size_t i = 0; i < first; ++i )
+					dest[i] = row[i] - prev[i];
+				for( size_t i = first; i < rowBytes; ++i )
+					dest[i] = row[i] - paethPredictor( row[i - bpp], prev[i], prev[i - bpp] );
+			}
+		break;
+		default:
+			memcpy( dest, row, rowBytes );
+	}
+
+	size_t sum = 0;
+	for( size_t i = 0; i < rowBytes; ++i )
+		sum += ( dest[i] < 128 ) ? dest[i] : 256 - dest[i];
+	return sum;
+}
+
+void writeChunk( OStream *stream, const char type[4], const uint8_t *data, size_t size )
+{
+	stream->writeBig( (uint32_t)size );
+	stream->writeData( type, 4 );
+	uLong crc = crc32( 0L, (const Bytef*)type, 4 );
+	if( size ) {
+		stream->writeData( data, size );
+		crc = crc32( crc, data, (uInt)size );
+	}
+	stream->writeBig( (uint32_t)crc );
+}
+
+} // anonymous namespace
+
+void ImageTargetFilePng::registerSelf()
+{
+	static bool alreadyRegistered = false;
+	const int32_t PRIORITY = 2;
+
+	if( alreadyRegistered )
+		return;
+	alreadyRegistered = true;
+
+	ImageIoRegistrar::TargetCreationFunc func = ImageTargetFilePng::create;
+	ImageIoRegistrar::registerTargetType( "png", func, PRIORITY, "png" );
+}
+
+ImageTargetRef ImageTargetFilePng::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+{
+	return ImageTargetRef( new ImageTargetFilePng( dataTarget, imageSource, Options( options ) ) );
+}
+
+ImageTargetRef ImageTargetFilePng::create( DataTargetRef dataTarget, ImageSourceRef imageSource, const Options &options )
+{
+	return ImageTargetRef( new ImageTargetFilePng( dataTarget, imageSource, options ) );
+}
+
+ImageTargetFilePng::ImageTargetFilePng( DataTargetRef dataTarget, ImageSourceRef imageSource, const Options &options )
+	: mDataTarget( dataTarget ), mOptions( options )
+{
+	if( options.getLevel() < 0 || options.getLevel() > 9 )
+		throw ImageIoExceptionFailedWrite( "PNG compression level must be between 0 and 9" );
+	if( imageSource->getWidth() <= 0 || imageSource->getHeight() <= 0 )
+		throw ImageIoExceptionFailedWrite( "PNG images can't be empty" );
+
+	setSize( imageSource->getWidth(), imageSource->getHeight() );
+	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
+
+	switch( cm ) {
+		case ImageIo::ColorModel::CM_RGB:
+			mNumComponents = ( imageSource->hasAlpha() ) ? 4 : 3;
+			setColorModel( ImageIo::ColorModel::CM_RGB );
+			setChannelOrder( ( mNumComponents == 4 ) ? ImageIo::ChannelOrder::RGBA : ImageIo::ChannelOrder::RGB );
+		break;
+		case ImageIo::ColorModel::CM_GRAY:
+			mNumComponents = ( imageSource->hasAlpha() ) ? 2 : 1;
+			setColorModel( ImageIo::ColorModel::CM_GRAY );
+			setChannelOrder( ( mNumComponents == 2 ) ? ImageIo::ChannelOrder::YA : ImageIo::ChannelOrder::Y );
+		break;
+		default:
+			throw ImageIoExceptionIllegalColorModel();
+	}
+
+	setDataType( ( imageSource->getDataType() == ImageIo::DataType::UINT16 ) ? ImageIo::DataType::UINT16 : ImageIo::DataType::UINT8 );
+	mBytesPerSample = ImageIo::dataTypeBytes( getDataType() );
+	mRowBytes = (size_t)mWidth * mNumComponents * mBytesPerSample;
+	mData.resize( mHeight * mRowBytes );
+}
+
+void* ImageTargetFilePng::getRowPointer( int32_t row )
+{
+	return &mData[row * mRowBytes];
+}
+
+void ImageTargetFilePng::filterRows( int32_t begin, int32_t end, uint8_t *dest ) const
+{
+	const size_t bpp = mNumComponents * mBytesPerSample;
+	std::vector<uint8_t> candidate, best;
+	if( mOptions.getFilter() == FILTER_ADAPTIVE ) {
+		candidate.resize( mRowBytes );
+		best.resize( mRowBytes );
+	}
+
+	for( int32_t y = begin; y < end; ++y, dest += mRowBytes + 1 ) {
+		const uint8_t *row = &mData[y * mRowBytes];
+		const uint8_t *prev = ( y > 0 ) ? row - mRowBytes : nullptr;
+		if( mOptions.getFilter() != FILTER_ADAPTIVE ) {
+			dest[0] = (uint8_t)mOptions.getFilter();
+			filterRow( mOptions.getFilter(), row, prev, mRowBytes, bpp, dest + 1 );
+		}
+		else {
+			size_t bestSum = std::numeric_limits<size_t>::max();
+			for( Filter filter : { FILTER_NONE, FILTER_SUB, FILTER_UP, FILTER_AVERAGE, FILTER_PAETH } ) {
+				const size_t sum = filterRow( filter, row, prev, mRowBytes, bpp, candidate.data() );
+				if( sum < bestSum ) {
+					bestSum = sum;
+					dest[0] = (uint8_t)filter;
+					best.swap( candidate );
+				}
+			}
+			memcpy( dest + 1, best.data(), mRowBytes );
+		}
+	}
+}
+
+void ImageTargetFilePng::finalize()
+{
+	OStreamRef stream = mDataTarget->getStream();
+	if( ! stream )
+		throw ImageIoExceptionFailedWrite( "No stream provided" );
+
+	// 16-bit samples are big endian in PNG
+	if( mBytesPerSample == 2 ) {
+		for( size_t i = 0; i < mData.size(); i += 2 )
+			std::swap( mData[i], mData[i + 1] );
+	}
+
+	const size_t filteredRowBytes = mRowBytes + 1;
+	const int32_t bandRows = (int32_t)std::max<size_t>( 1, BAND_BYTES / filteredRowBytes );
+	const int32_t numBands = ( mHeight + bandRows - 1 ) / bandRows;
+	std::vector<uint8_t> filtered( mHeight * filteredRowBytes );
+	parallelFor( numBands, [&]( int32_t band ) {
+		const int32_t begin = band * bandRows;
+		filterRows( begin, std::min( begin + bandRows, mHeight ), &filtered[begin * filteredRowBytes] );
+	} );
+
+	// each band is deflated as raw data which ends on a byte boundary, so that the bands concatenate into one stream
+	static const int strategies[] = { Z_DEFAULT_STRATEGY, Z_FILTERED, Z_HUFFMAN_ONLY, Z_RLE };
+	std::vector<std::vector<uint8_t>> deflated( numBands );
+	std::vector<uLong> adlers( numBands );
+	parallelFor( numBands, [&]( int32_t band ) {
+		const size_t begin = band * bandRows * filteredRowBytes;
+		const size_t size = std::min( filtered.size() - begin, bandRows * filteredRowBytes );
+		const bool last = band == numBands - 1;
+		uint8_t *input = &filtered[begin];
+
+		z_stream z;
+		memset( &z, 0, sizeof( z ) );
+		if( deflateInit2( &z, mOptions.getLevel(), Z_DEFLATED, -MAX_WBITS, 8, strategies[mOptions.getStrategy()] ) != Z_OK )
+			throw ImageIoExceptionFailedWrite( "Failed to initialize zlib" );
+		if( begin > 0 ) {
+			const size_t dictionarySize = std::min( begin, DICTIONARY_BYTES );
+			deflateSetDictionary( &z, input - dictionarySize, (uInt)dictionarySize );
+		}
+
+		std::vector<uint8_t> &out = deflated[band];
+		out.resize( deflateBound( &z, (uLong)size ) + 16 );
+		z.next_in = input;
+		z.avail_in = (uInt)size;
+		int result;
+		do {
+			if( z.total_out == out.size() )
+				out.resize( out.size() * 2 );
+			z.next_out = &out[z.total_out];
+			z.avail_out = (uInt)( out.size() - z.total_out );
+			result = deflate( &z, last ? Z_FINISH : Z_SYNC_FLUSH );
+		} while( ( last && result == Z_OK ) || ( ! last && z.avail_out == 0 ) );
+		out.resize( z.total_out );
+		deflateEnd( &z );
+		if( result == Z_STREAM_ERROR )
+			throw ImageIoExceptionFailedWrite( "Failed to deflate PNG data" );
+
+		adlers[band] = adler32( adler32( 0L, Z_NULL, 0 ), input, (uInt)size );
+	} );
+
+	// signature
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	stream->writeData( signature, sizeof( signature ) );
+
+	// IHDR: size, bit depth, color type, then deflate compression, adaptive filtering and no interlacing
+	static const uint8_t colorTypes[5] = { 0, 0, 4, 2, 6 };
+	uint8_t header[13] = { uint8_t( mWidth >> 24 ), uint8_t( mWidth >> 16 ), uint8_t( mWidth >> 8 ), uint8_t( mWidth ),
+							uint8_t( mHeight >> 24 ), uint8_t( mHeight >> 16 ), uint8_t( mHeight >> 8 ), uint8_t( mHeight ),
+							uint8_t( mBytesPerSample * 8 ), colorTypes[mNumComponents], 0, 0, 0 };
+	writeChunk( stream.get(), "IHDR", header, sizeof( header ) );
+
+	// one IDAT per band, the first led by the zlib header and the last followed by the Adler-32 of all of the filtered data
+	const int level = mOptions.getLevel();
+	const uint8_t cmf = 0x78, flevel = ( level < 2 ) ? 0 : ( level < 6 ) ? 1 : ( level == 6 ) ? 2 : 3;
+	const uint8_t flg = uint8_t( ( flevel << 6 ) + ( 31 - ( ( cmf << 8 ) + ( flevel << 6 ) ) % 31 ) % 31 );
+	uLong adler = adlers[0];
+	for( int32_t band = 1; band < numBands; ++band ) {
+		const size_t begin = band * bandRows * filteredRowBytes;
+		adler = adler32_combine( adler, adlers[band], (z_off_t)std::min( filtered.size() - begin, bandRows * filteredRowBytes ) );
+	}
+
+	for( int32_t band = 0; band < numBands; ++band ) {
+		std::vector<uint8_t> &data = deflated[band];
+		if( band == 0 )
+			data.insert( data.begin(), { cmf, flg } );
+		if( band == numBands - 1 )
+			data.insert( data.end(), { uint8_t( adler >> 24 ), uint8_t( adler >> 16 ), uint8_t( adler >> 8 ), uint8_t( adler ) } );
+		writeChunk( stream.get(), "IDAT", data.data(), data.size() );
+	}
+
+	writeChunk( stream.get(), "IEND", nullptr, 0 );
+}
+
+} // namespace cinder
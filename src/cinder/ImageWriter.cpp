@@ -0,0 +1,159 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageWriter.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+
+namespace cinder {
+
+ImageWriterRef ImageWriter::create( const Options &options )
+{
+	return ImageWriterRef( new ImageWriter( options ) );
+}
+
+ImageWriter::ImageWriter( const Options &options )
+	: mOptions( options ), mNumWriting( 0 ), mStop( false )
+{
+	// the registry of ImageTarget types is created lazily and without synchronization, so make sure it exists before the workers use it
+	ImageIo::getWriteExtensions();
+
+	const size_t numThreads = std::max<size_t>( mOptions.getNumThreads(), 1 );
+	for( size_t t = 0; t < numThreads; ++t )
+		mWorkers.emplace_back( &ImageWriter::workerLoop, this );
+}
+
+ImageWriter::~ImageWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+	}
+	mWorkCondition.notify_all();
+	for( auto &worker : mWorkers )
+		worker.join();
+}
+
+std::shared_future<void> ImageWriter::write( const DataTargetRef &dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
+{
+	ImageTargetRef imageTarget = createImageTarget( dataTarget, imageSource, options, extension );
+	imageSource->load( imageTarget );
+	return write( imageTarget );
+}
+
+std::shared_future<void> ImageWriter::write( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
+{
+	return write( (DataTargetRef)writeFile( path ), imageSource, options, extension );
+}
+
+std::shared_future<void> ImageWriter::write( const ImageTargetRef &imageTarget )
+{
+	auto job = std::make_shared<Job>();
+	job->mTarget = imageTarget;
+	std::shared_future<void> result = job->mPromise.get_future().share();
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		if( mOptions.getMaxPending() > 0 )
+			mSpaceCondition.wait( lock, [this] { return mPending.size() < mOptions.getMaxPending(); } );
+		mPending.push_back( job );
+	}
+	mWorkCondition.notify_one();
+
+	return result;
+}
+
+void ImageWriter::workerLoop()
+{
+	while( true ) {
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			// pending writes are finished before stopping
+			mWorkCondition.wait( lock, [this] { return mStop || ! mPending.empty(); } );
+			if( mPending.empty() )
+				return;
+			job = mPending.front();
+			mPending.pop_front();
+			++mNumWriting;
+		}
+		mSpaceCondition.notify_one();
+
+		try {
+			ThreadSetup threadSetup;
+			job->mTarget->finalize();
+			job->mTarget.reset();
+			job->mPromise.set_value();
+		}
+		catch( ... ) {
+			job->mTarget.reset();
+			job->mPromise.set_exception( std::current_exception() );
+		}
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			--mNumWriting;
+		}
+		mIdleCondition.notify_all();
+	}
+}
+
+void ImageWriter::waitAll()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mIdleCondition.wait( lock, [this] { return mPending.empty() && mNumWriting == 0; } );
+}
+
+size_t ImageWriter::getNumPending() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mPending.size();
+}
+
+size_t ImageWriter::getNumWriting() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumWriting;
+}
+
+namespace {
+
+ImageWriter* sharedWriter()
+{
+	// created on first use and destroyed at exit, once it has written everything still queued
+	static ImageWriterRef sWriter = ImageWriter::create();
+	return sWriter.get();
+}
+
+} // anonymous namespace
+
+std::shared_future<void> writeImageAsync( DataTargetRef dataTarget, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
+{
+	return sharedWriter()->write( dataTarget, imageSource, options, extension );
+}
+
+std::shared_future<void> writeImageAsync( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
+{
+	return sharedWriter()->write( path, imageSource, options, extension );
+}
+
+} // namespace cinder
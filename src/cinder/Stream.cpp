@@ -27,12 +27,26 @@
 #include "cinder/Utilities.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <iostream>
 using std::string;
 
 namespace cinder {
 
+namespace {
+
+// Returns the first '\n' or '\r' in [begin, end), or nullptr if there is none
+const char* findLineEnd( const char *begin, const char *end )
+{
+	const char *newline = static_cast<const char*>( memchr( begin, '\n', end - begin ) );
+	const char *carriageReturn = static_cast<const char*>( memchr( begin, '\r', ( newline ? newline : end ) - begin ) );
+	return carriageReturn ? carriageReturn : newline;
+}
+
+} // anonymous namespace
+
 #if defined( CINDER_UWP )
 	#pragma warning(push) 
 	#pragma warning(disable:4996) 
@@ -121,23 +135,61 @@ void IStreamCinder::readFixedString( std::string *t, size_t size )
 
 std::string IStreamCinder::readLine()
 {
-	string result;
-	int8_t ch;
-	while( ! isEof() ) {
-		read( &ch );
-		if( ch == 0x0A )
-			break;
-		else if( ch == 0x0D ) {
-			read( &ch );
-			if( ch != 0x0A )
-				seekRelative( -1 );
-			break;
+	const char *line;
+	size_t length;
+	if( IOReadLine( &line, &length ) )
+		return string( line, length );
+	else
+		return string();
+}
+
+bool IStreamCinder::readLine( std::string *line )
+{
+	const char *data;
+	size_t length;
+	if( ! IOReadLine( &data, &length ) ) {
+		line->clear();
+		return false;
+	}
+
+	line->assign( data, length );
+	return true;
+}
+
+bool IStreamCinder::IOReadLine( const char **line, size_t *length )
+{
+	mLineBuffer.clear();
+	bool readAny = false;
+	char chunk[512];
+	while( size_t chunkSize = readDataAvailable( chunk, sizeof( chunk ) ) ) {
+		readAny = true;
+		const char *end = findLineEnd( chunk, chunk + chunkSize );
+		if( ! end ) {
+			mLineBuffer.append( chunk, chunkSize );
+			continue;
+		}
+
+		mLineBuffer.append( chunk, end - chunk );
+		off_t consumed = static_cast<off_t>( end - chunk + 1 );
+		if( *end == 0x0D ) {
+			if( end + 1 < chunk + chunkSize ) {
+				if( end[1] == 0x0A )
+					++consumed;
+			}
+			else { // the terminator may continue past this chunk
+				char next;
+				if( readDataAvailable( &next, 1 ) == 1 && next != 0x0A )
+					seekRelative( -1 );
+			}
 		}
-		else
-			result += ch;
+		if( consumed < static_cast<off_t>( chunkSize ) )
+			seekRelative( consumed - static_cast<off_t>( chunkSize ) );
+		break;
 	}
 
-	return result;
+	*line = mLineBuffer.data();
+	*length = mLineBuffer.size();
+	return readAny;
 }
 
 void IStreamCinder::readData( void *t, size_t size )
@@ -207,12 +259,63 @@ size_t IStreamFile::readDataImpl( void *t, size_t size )
 		fseek( mFile, static_cast<long>( mBufferOffset ), SEEK_SET );
 		mBufferFileOffset = mBufferOffset;
 		mBufferSize = fread( mBuffer.get(), 1, mDefaultBufferSize, mFile );
+		size = std::min<size_t>( size, mBufferSize ); // near the end of the file
 		memcpy( t, mBuffer.get(), size );
 		mBufferOffset = mBufferFileOffset + size;
 		return size;
 	}
 }
 
+size_t IStreamFile::fillBuffer()
+{
+	if( ( mBufferOffset < mBufferFileOffset ) || ( mBufferOffset >= mBufferFileOffset + (off_t)mBufferSize ) ) {
+		fseek( mFile, static_cast<long>( mBufferOffset ), SEEK_SET );
+		mBufferFileOffset = mBufferOffset;
+		mBufferSize = fread( mBuffer.get(), 1, mDefaultBufferSize, mFile );
+	}
+
+	return static_cast<size_t>( mBufferFileOffset + (off_t)mBufferSize - mBufferOffset );
+}
+
+bool IStreamFile::IOReadLine( const char **line, size_t *length )
+{
+	// lines inside the buffer are returned in place; only those spanning a refill are gathered into mLineBuffer
+	mLineBuffer.clear();
+	bool readAny = false;
+	while( size_t available = fillBuffer() ) {
+		readAny = true;
+		const char *begin = reinterpret_cast<const char*>( mBuffer.get() ) + ( mBufferOffset - mBufferFileOffset );
+		const char *end = findLineEnd( begin, begin + available );
+		if( ! end ) {
+			mLineBuffer.append( begin, available );
+			mBufferOffset += available;
+			continue;
+		}
+
+		mBufferOffset += end - begin + 1;
+		// a "\r" ending the buffer may be the start of a "\r\n" whose "\n" is only visible after a refill
+		const bool splitTerminator = ( *end == 0x0D ) && ( end + 1 == begin + available );
+		if( *end == 0x0D && ! splitTerminator && end[1] == 0x0A )
+			++mBufferOffset;
+
+		if( mLineBuffer.empty() && ! splitTerminator ) {
+			*line = begin;
+			*length = end - begin;
+			return true;
+		}
+
+		// the refill below invalidates begin, so append first
+		mLineBuffer.append( begin, end );
+		if( splitTerminator && fillBuffer() > 0 && mBuffer.get()[mBufferOffset - mBufferFileOffset] == 0x0A )
+			++mBufferOffset;
+		break;
+	}
+
+	*line = mLineBuffer.data();
+	*length = mLineBuffer.size();
+	return readAny;
+}
+
 void IStreamFile::seekAbsolute( off_t absoluteOffset )
 {
 	int dir = ( absoluteOffset >= 0 ) ? SEEK_SET : SEEK_END;
@@ -326,6 +429,7 @@ size_t IStreamAndroidAsset::readDataImpl( void *t, size_t size )
 		afs_fseek( mAsset, static_cast<long>( mBufferOffset ), SEEK_SET );
 		mBufferFileOffset = mBufferOffset;
 		mBufferSize = afs_fread( mBuffer.get(), 1, mDefaultBufferSize, mAsset );
+		size = std::min<size_t>( size, mBufferSize ); // near the end of the file
 		memcpy( t, mBuffer.get(), size );
 		mBufferOffset = mBufferFileOffset + size;
 		return size;
@@ -533,6 +637,7 @@ size_t IoStreamFile::readDataImpl( void *t, size_t size )
 		fseek( mFile, static_cast<long>( mBufferOffset ), SEEK_SET );
 		mBufferFileOffset = mBufferOffset;
 		mBufferSize = (int32_t)fread( mBuffer.get(), 1, mDefaultBufferSize, mFile );
+		size = std::min<size_t>( size, mBufferSize ); // near the end of the file
 		memcpy( t, mBuffer.get(), size );
 		mBufferOffset = mBufferFileOffset + size;
 		return size;
@@ -578,6 +683,27 @@ size_t IStreamMem::readDataAvailable( void *dest, size_t maxSize )
 	return maxSize;	
 }
 
+bool IStreamMem::IOReadLine( const char **line, size_t *length )
+{
+	if( mOffset >= mDataSize )
+		return false;
+
+	const char *begin = reinterpret_cast<const char*>( mData ) + mOffset, *dataEnd = reinterpret_cast<const char*>( mData ) + mDataSize;
+	const char *end = findLineEnd( begin, dataEnd );
+	*line = begin;
+	if( ! end ) {
+		*length = dataEnd - begin;
+		mOffset = mDataSize;
+		return true;
+	}
+
+	*length = end - begin;
+	mOffset += *length + 1;
+	if( *end == 0x0D && end + 1 < dataEnd && end[1] == 0x0A )
+		++mOffset;
+	return true;
+}
+
 void IStreamMem::seekAbsolute( off_t absoluteOffset )
 {
 	if( absoluteOffset < 0 )
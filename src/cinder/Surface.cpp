@@ -39,7 +39,9 @@
 #include "cinder/ChanTraits.h"
 #include "cinder/ImageIo.h"
 #include "cinder/ip/Fill.h"
+#include "cinder/ip/Swizzle.h"
 
+#include <algorithm>
 #include <type_traits>
 
 namespace cinder {
@@ -47,16 +49,19 @@ namespace cinder {
 template<typename T>
 class ImageTargetSurface : public ImageTarget {
   public:
-	static std::shared_ptr<ImageTargetSurface<T> > createRef( SurfaceT<T> *surface ) { return std::shared_ptr<ImageTargetSurface<T> >( new ImageTargetSurface<T>( surface ) ); }
+	//! \a dataBytes is the size of the memory at \a surface's data, or 0 for exactly its rows
+	static std::shared_ptr<ImageTargetSurface<T> > createRef( SurfaceT<T> *surface, size_t dataBytes = 0 ) { return std::shared_ptr<ImageTargetSurface<T> >( new ImageTargetSurface<T>( surface, dataBytes ) ); }
 
 	virtual bool hasAlpha() const;
 	
 	virtual void*	getRowPointer( int32_t row );
+	void*			getContiguousData( ptrdiff_t *rowBytes, size_t *dataBytes ) override;
 	
   protected:
-	ImageTargetSurface( SurfaceT<T> *surface );
+	ImageTargetSurface( SurfaceT<T> *surface, size_t dataBytes );
 	
 	SurfaceT<T>		*mSurface;
+	size_t			mDataBytes;
 };
 
 class ImageSourceSurface : public ImageSource {
@@ -210,7 +215,7 @@ template<typename T>
 SurfaceT<T>::SurfaceT( const SurfaceT<T> &rhs )
 	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mChannelOrder( rhs.mChannelOrder ), mRowBytes( rhs.mRowBytes ), mPremultiplied( rhs.mPremultiplied )
 {
-	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( mHeight * mRowBytes );
 	mData = mDataStore.get();
 	initChannels();
 	copyFrom( rhs, Area( 0, 0, mWidth, mHeight ) );
@@ -221,8 +226,9 @@ SurfaceT<T>::SurfaceT( SurfaceT<T> &&rhs )
 	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mChannelOrder( rhs.mChannelOrder ), mRowBytes( rhs.mRowBytes ), mPremultiplied( rhs.mPremultiplied )
 {
 	mDataStore = rhs.mDataStore;
+	mData = rhs.mData;
 	rhs.mDataStore = nullptr;
-	mData = mDataStore.get();
+	rhs.mData = nullptr;
 	initChannels();
 }
 
@@ -234,7 +240,7 @@ SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, SurfaceChannel
 		mChannelOrder = ( alpha ) ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB;
 	mPremultiplied = false;
 	mRowBytes = width * sizeof(T) * mChannelOrder.getPixelInc();
-	mDataStore = std::shared_ptr<T>( new T[height * mRowBytes], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( height * mRowBytes );
 	mData = mDataStore.get();
 	initChannels();
 }
@@ -246,7 +252,7 @@ SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, const SurfaceC
 	mChannelOrder = constraints.getChannelOrder( alpha );
 	mPremultiplied = false;
 	mRowBytes = constraints.getRowBytes( width, mChannelOrder, sizeof(T) );
-	mDataStore = std::shared_ptr<T>( new T[height * mRowBytes], std::default_delete<T[]>() );
+	mDataStore = constraints.getAllocator()->allocateData<T>( height * mRowBytes );
 	mData = mDataStore.get();
 	initChannels();
 }
@@ -259,6 +265,14 @@ SurfaceT<T>::SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowByte
 	initChannels();
 }
 
+template<typename T>
+SurfaceT<T>::SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder, const std::shared_ptr<T> &dataStore )
+	: mWidth( width ), mHeight( height ), mRowBytes( rowBytes ), mData( data ), mDataStore( dataStore ), mChannelOrder( channelOrder )
+{
+	mPremultiplied = false;
+	initChannels();
+}
+
 template<typename T>
 SurfaceT<T>::SurfaceT( ImageSourceRef imageSource, const SurfaceConstraints &constraints )
 {
@@ -317,7 +331,7 @@ SurfaceT<T>& SurfaceT<T>::operator=( const SurfaceT<T> &rhs )
 	mChannelOrder = rhs.mChannelOrder;
 	mRowBytes = rhs.mRowBytes;
 	mPremultiplied = rhs.mPremultiplied;
-	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
+	mDataStore = SurfaceAllocator::getDefault()->allocateData<T>( mHeight * mRowBytes );
 	
 	mData = mDataStore.get();
 	initChannels();
@@ -377,6 +391,16 @@ SurfaceT<T> SurfaceT<T>::clone( const Area &area, bool copyPixels ) const
 	return result;
 }
 
+template<typename T>
+SurfaceT<T> SurfaceT<T>::getView( const Area &area ) const
+{
+	const Area clippedArea = area.getClipBy( getBounds() );
+	SurfaceT result( const_cast<T*>( getData( clippedArea.getUL() ) ), clippedArea.getWidth(), clippedArea.getHeight(), mRowBytes, mChannelOrder, mDataStore );
+	result.setPremultiplied( mPremultiplied );
+
+	return result;
+}
+
 template<typename T>
 void SurfaceT<T>::init( ImageSourceRef imageSource, const SurfaceConstraints &constraints, bool alpha )
 {
@@ -386,17 +410,28 @@ void SurfaceT<T>::init( ImageSourceRef imageSource, const SurfaceConstraints &co
 	mChannelOrder = constraints.getChannelOrder( alpha );
 	mRowBytes = constraints.getRowBytes( mWidth, mChannelOrder, sizeof(T) );
 	
-	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
+	// one pixel past the last row lets decoders which overrun their output by a pixel, such as stb_image's JPEG, decode in place
+	const size_t dataBytes = mHeight * mRowBytes + getPixelBytes();
+	mDataStore = constraints.getAllocator()->allocateData<T>( dataBytes );
 	mData = mDataStore.get();
 
+	initChannels();
+	load( imageSource, dataBytes );
+}
+
+template<typename T>
+void SurfaceT<T>::load( const ImageSourceRef &imageSource, size_t dataBytes )
+{
+	if( imageSource->getWidth() != mWidth || imageSource->getHeight() != mHeight )
+		throw ImageIoException( "ImageSource size does not match the Surface" );
+
 	mPremultiplied = imageSource->isPremultiplied();
-	
-	std::shared_ptr<ImageTargetSurface<T> > target = ImageTargetSurface<T>::createRef( this );
+
+	std::shared_ptr<ImageTargetSurface<T> > target = ImageTargetSurface<T>::createRef( this, dataBytes );
 	imageSource->load( target );
-	
-	initChannels();
+
 	// if the image doesn't have alpha but we do, set the alpha to 1.0
-	if( alpha && ( ! imageSource->hasAlpha() ) )
+	if( hasAlpha() && ( ! imageSource->hasAlpha() ) )
 		ip::fill( &getChannelAlpha(), CHANTRAIT<T>::max() );
 }
 
@@ -407,12 +442,8 @@ void SurfaceT<T>::copyFrom( const SurfaceT<T> &srcSurface, const Area &srcArea,
 	
 	if( getChannelOrder() == srcSurface.getChannelOrder() )
 		copyRawSameChannelOrder( srcSurface, srcDst.first, srcDst.second );
-	else if( hasAlpha() && srcSurface.hasAlpha() )
-		copyRawRgba( srcSurface, srcDst.first, srcDst.second );
-	else if( hasAlpha() && ( ! srcSurface.hasAlpha() ) )
-		copyRawRgbFullAlpha( srcSurface, srcDst.first, srcDst.second );
 	else
-		copyRawRgb( srcSurface, srcDst.first, srcDst.second );
+		copyRawSwizzle( srcSurface, srcDst.first, srcDst.second );
 }
 
 template<typename T>
@@ -430,92 +461,19 @@ void SurfaceT<T>::copyRawSameChannelOrder( const SurfaceT<T> &srcSurface, const
 }
 
 template<typename T>
-void SurfaceT<T>::copyRawRgba( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset )
-{
-	const ptrdiff_t srcRowBytes = srcSurface.getRowBytes();
-	uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
-	uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
-	uint8_t srcBlue = srcSurface.getChannelOrder().getBlueOffset();
-	uint8_t srcAlpha = srcSurface.getChannelOrder().getAlphaOffset();
-
-	uint8_t dstRed = getChannelOrder().getRedOffset();
-	uint8_t dstGreen = getChannelOrder().getGreenOffset();
-	uint8_t dstBlue = getChannelOrder().getBlueOffset();
-	uint8_t dstAlpha = getChannelOrder().getAlphaOffset();
-
-	int32_t width = srcArea.getWidth();
-
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const T *src = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		T *dst = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( getData() + absoluteOffset.x * 4 ) + ( y + absoluteOffset.y ) * getRowBytes() );
-		for( int x = 0; x < width; ++x ) {
-			dst[dstRed] = src[srcRed];
-			dst[dstGreen] = src[srcGreen];
-			dst[dstBlue] = src[srcBlue];
-			dst[dstAlpha] = src[srcAlpha];
-			src += 4;
-			dst += 4;
-		}
-	}
-}
-
-template<typename T>
-void SurfaceT<T>::copyRawRgbFullAlpha( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset )
-{
-	const ptrdiff_t srcRowBytes = srcSurface.getRowBytes();
-	const uint8_t srcPixelInc = srcSurface.getPixelInc();
-	uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
-	uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
-	uint8_t srcBlue = srcSurface.getChannelOrder().getBlueOffset();
-	const T fullAlpha = CHANTRAIT<T>::max();
-
-	uint8_t dstRed = getChannelOrder().getRedOffset();
-	uint8_t dstGreen = getChannelOrder().getGreenOffset();
-	uint8_t dstBlue = getChannelOrder().getBlueOffset();
-	uint8_t dstAlpha = getChannelOrder().getAlphaOffset();
-
-	int32_t width = srcArea.getWidth();
-
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const T *src = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		T *dst = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( getData() + absoluteOffset.x * 4 ) + ( y + absoluteOffset.y ) * getRowBytes() );
-		for( int x = 0; x < width; ++x ) {
-			dst[dstRed] = src[srcRed];
-			dst[dstGreen] = src[srcGreen];
-			dst[dstBlue] = src[srcBlue];
-			dst[dstAlpha] = fullAlpha;
-			src += srcPixelInc;
-			dst += 4;
-		}
-	}
-}
-
-template<typename T>
-void SurfaceT<T>::copyRawRgb( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset )
+void SurfaceT<T>::copyRawSwizzle( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset )
 {
 	const ptrdiff_t srcRowBytes = srcSurface.getRowBytes();
 	const uint8_t srcPixelInc = srcSurface.getPixelInc();
-	const uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
-	const uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
-	const uint8_t srcBlue = srcSurface.getChannelOrder().getBlueOffset();
-
 	const uint8_t dstPixelInc = getPixelInc();
-	const uint8_t dstRed = getChannelOrder().getRedOffset();
-	const uint8_t dstGreen = getChannelOrder().getGreenOffset();
-	const uint8_t dstBlue = getChannelOrder().getBlueOffset();
+	const ip::SwizzleMap map = ip::SwizzleMap::fromChannelOrders( srcSurface.getChannelOrder(), getChannelOrder() );
 
 	int32_t width = srcArea.getWidth();
 
 	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
 		const T *src = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + srcArea.x1 * srcPixelInc ) + ( srcArea.y1 + y ) * srcRowBytes );
 		T *dst = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( getData() + absoluteOffset.x * dstPixelInc ) + ( y + absoluteOffset.y ) * getRowBytes() );
-		for( int x = 0; x < width; ++x ) {
-			dst[dstRed] = src[srcRed];
-			dst[dstGreen] = src[srcGreen];
-			dst[dstBlue] = src[srcBlue];
-			src += srcPixelInc;
-			dst += dstPixelInc;
-		}
+		ip::swizzleRow( src, dst, width, map );
 	}
 }
 
@@ -549,8 +507,8 @@ ColorT<T> SurfaceT<T>::areaAverage( const Area &area ) const
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 // ImageTargetSurface
 template<typename T>
-ImageTargetSurface<T>::ImageTargetSurface( SurfaceT<T> *aSurface )
-	: ImageTarget(), mSurface( aSurface )
+ImageTargetSurface<T>::ImageTargetSurface( SurfaceT<T> *aSurface, size_t dataBytes )
+	: ImageTarget(), mSurface( aSurface ), mDataBytes( dataBytes )
 {
 	if( std::is_same<T,float>::value )
 		setDataType( ImageIo::FLOAT32 );
@@ -613,6 +571,26 @@ void* ImageTargetSurface<T>::getRowPointer( int32_t row )
 	return reinterpret_cast<void*>( mSurface->getData( ivec2( 0, row ) ) );
 }
 
+template<typename T>
+void* ImageTargetSurface<T>::getContiguousData( ptrdiff_t *rowBytes, size_t *dataBytes )
+{
+	// bottom-up views have negative rowBytes
+	const ptrdiff_t surfaceRowBytes = mSurface->getRowBytes();
+	if( surfaceRowBytes <= 0 || getChannelOrder() == ImageIo::CUSTOM )
+		return nullptr;
+
+	// without a declared block the memory between rows may belong to the Surface a view was taken from, so only packed rows are handed out
+	const size_t rowsBytes = mSurface->getHeight() * surfaceRowBytes;
+	if( mDataBytes == 0 && surfaceRowBytes != (ptrdiff_t)( mSurface->getWidth() * mSurface->getPixelInc() * sizeof(T) ) )
+		return nullptr;
+	if( mDataBytes != 0 && mDataBytes < rowsBytes )
+		return nullptr;
+
+	*rowBytes = surfaceRowBytes;
+	*dataBytes = ( mDataBytes != 0 ) ? mDataBytes : rowsBytes;
+	return mSurface->getData();
+}
+
 template class CI_API SurfaceT<uint8_t>;
 template class CI_API SurfaceT<uint16_t>;
 template class CI_API SurfaceT<float>;
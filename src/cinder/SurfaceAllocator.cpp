@@ -0,0 +1,93 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/SurfaceAllocator.h"
+#include "cinder/Cinder.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined( CINDER_MSW ) || defined( CINDER_UWP )
+	#include <malloc.h>
+#endif
+
+namespace cinder {
+
+namespace {
+
+SurfaceAllocatorRef& getDefaultAllocator()
+{
+	static SurfaceAllocatorRef sDefault = SurfaceAllocatorHeap::create();
+	return sDefault;
+}
+
+} // anonymous namespace
+
+SurfaceAllocatorRef SurfaceAllocator::getDefault()
+{
+	return std::atomic_load( &getDefaultAllocator() );
+}
+
+void SurfaceAllocator::setDefault( const SurfaceAllocatorRef &allocator )
+{
+	std::atomic_store( &getDefaultAllocator(), allocator ? allocator : SurfaceAllocatorRef( SurfaceAllocatorHeap::create() ) );
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SurfaceAllocatorHeap
+std::shared_ptr<void> SurfaceAllocatorHeap::allocate( size_t numBytes )
+{
+	return std::shared_ptr<void>( new uint8_t[numBytes], std::default_delete<uint8_t[]>() );
+}
+
+size_t SurfaceAllocatorHeap::getAlignment() const
+{
+	return alignof(std::max_align_t);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// SurfaceAllocatorAligned
+SurfaceAllocatorAligned::SurfaceAllocatorAligned( size_t alignment )
+	: mAlignment( std::max<size_t>( alignment, sizeof(void*) ) )
+{
+	CI_ASSERT_MSG( ( alignment & ( alignment - 1 ) ) == 0, "alignment must be a power of two" );
+}
+
+std::shared_ptr<void> SurfaceAllocatorAligned::allocate( size_t numBytes )
+{
+#if defined( CINDER_MSW ) || defined( CINDER_UWP )
+	void *block = _aligned_malloc( std::max<size_t>( numBytes, 1 ), mAlignment );
+	if( ! block )
+		throw std::bad_alloc();
+	return std::shared_ptr<void>( block, []( void *p ) { _aligned_free( p ); } );
+#else
+	void *block = nullptr;
+	if( posix_memalign( &block, mAlignment, std::max<size_t>( numBytes, 1 ) ) != 0 )
+		throw std::bad_alloc();
+	return std::shared_ptr<void>( block, []( void *p ) { free( p ); } );
+#endif
+}
+
+} // namespace cinder
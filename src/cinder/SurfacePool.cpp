@@ -0,0 +1,197 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/SurfacePool.h"
+#include "cinder/ImageIo.h"
+
+#include <limits>
+
+namespace cinder {
+
+// Deleter of the blocks handed out by a SurfacePool, which returns the underlying block to the pool if it still exists
+struct SurfacePool::Recycler {
+	void operator()( void * )
+	{
+		if( auto pool = mPool.lock() )
+			pool->recycle( mKey, mBlock, mNumBytes );
+	}
+
+	std::weak_ptr<SurfacePool>	mPool;
+	Key							mKey;
+	std::shared_ptr<void>		mBlock;
+	size_t						mNumBytes;
+};
+
+SurfacePoolRef SurfacePool::create( size_t alignment, const SurfaceAllocatorRef &allocator )
+{
+	return SurfacePoolRef( new SurfacePool( alignment, allocator ) );
+}
+
+SurfacePool::SurfacePool( size_t alignment, const SurfaceAllocatorRef &allocator )
+	: mAlignment( alignment ), mAllocator( allocator ? allocator : SurfaceAllocatorAligned::create( alignment ) ),
+		mMaxBytesHeld( std::numeric_limits<size_t>::max() ), mNumHits( 0 ), mNumMisses( 0 ), mBytesHeld( 0 ), mBytesInUse( 0 )
+{
+}
+
+template<typename T>
+SurfaceT<T> SurfacePool::getSurface( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder requestedOrder )
+{
+	const SurfaceChannelOrder channelOrder = ( requestedOrder == SurfaceChannelOrder::UNSPECIFIED ) ? SurfaceChannelOrder( alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB ) : requestedOrder;
+	const ptrdiff_t rowBytes = alignRowBytes( width * sizeof(T) * channelOrder.getPixelInc() );
+	const Key key( width, height, channelOrder.getCode(), sizeof(T), rowBytes );
+
+	std::shared_ptr<void> block = acquire( key, height * rowBytes );
+	std::shared_ptr<T> dataStore( block, static_cast<T*>( block.get() ) );
+	return SurfaceT<T>( dataStore.get(), width, height, rowBytes, channelOrder, dataStore );
+}
+
+template<typename T>
+SurfaceT<T> SurfacePool::getSurface( const ImageSourceRef &imageSource )
+{
+	SurfaceT<T> result = getSurface<T>( imageSource->getWidth(), imageSource->getHeight(), imageSource->hasAlpha() );
+	result.load( imageSource, result.getHeight() * result.getRowBytes() + mAlignment );
+	return result;
+}
+
+template<typename T>
+ChannelT<T> SurfacePool::getChannel( int32_t width, int32_t height )
+{
+	const ptrdiff_t rowBytes = alignRowBytes( width * sizeof(T) );
+	const Key key( width, height, SurfaceChannelOrder::UNSPECIFIED, sizeof(T), rowBytes );
+
+	std::shared_ptr<void> block = acquire( key, height * rowBytes );
+	std::shared_ptr<T> dataStore( block, static_cast<T*>( block.get() ) );
+	return ChannelT<T>( width, height, rowBytes, 1, dataStore.get(), dataStore );
+}
+
+std::shared_ptr<void> SurfacePool::acquire( const Key &key, size_t numBytes )
+{
+	std::shared_ptr<void> block;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto idleIt = mIdleBlocks.find( key );
+		if( idleIt != mIdleBlocks.end() && ! idleIt->second.empty() ) {
+			block = std::move( idleIt->second.back() );
+			idleIt->second.pop_back();
+			mBytesHeld -= numBytes;
+			++mNumHits;
+		}
+		else
+			++mNumMisses;
+		mBytesInUse += numBytes;
+	}
+
+	if( ! block ) {
+		try {
+			// the tail of one alignment past the rows is scratch for decoders writing in place, see getSurface( ImageSourceRef )
+			block = mAllocator->allocate( numBytes + mAlignment );
+		}
+		catch( ... ) {
+			std::lock_guard<std::mutex> lock( mMutex );
+			mBytesInUse -= numBytes;
+			throw;
+		}
+	}
+
+	void *data = block.get();
+	return std::shared_ptr<void>( data, Recycler{ shared_from_this(), key, std::move( block ), numBytes } );
+}
+
+void SurfacePool::recycle( const Key &key, const std::shared_ptr<void> &block, size_t numBytes )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mBytesInUse -= numBytes;
+	if( mBytesHeld + numBytes <= mMaxBytesHeld ) {
+		mIdleBlocks[key].push_back( block );
+		mBytesHeld += numBytes;
+	}
+}
+
+ptrdiff_t SurfacePool::alignRowBytes( ptrdiff_t rowBytes ) const
+{
+	const ptrdiff_t alignment = static_cast<ptrdiff_t>( mAlignment );
+	return ( rowBytes + alignment - 1 ) & ~( alignment - 1 );
+}
+
+void SurfacePool::clear()
+{
+	std::map<Key, std::vector<std::shared_ptr<void>>> idleBlocks;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		idleBlocks.swap( mIdleBlocks );
+		mBytesHeld = 0;
+	}
+	// idle blocks are freed here, outside of the lock
+}
+
+void SurfacePool::setMaxBytesHeld( size_t maxBytes )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mMaxBytesHeld = maxBytes;
+}
+
+size_t SurfacePool::getMaxBytesHeld() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mMaxBytesHeld;
+}
+
+size_t SurfacePool::getNumHits() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumHits;
+}
+
+size_t SurfacePool::getNumMisses() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumMisses;
+}
+
+size_t SurfacePool::getBytesHeld() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mBytesHeld;
+}
+
+size_t SurfacePool::getBytesInUse() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mBytesInUse;
+}
+
+void SurfacePool::resetCounters()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mNumHits = mNumMisses = 0;
+}
+
+#define SurfacePool_PROTOTYPES(T)\
+	template CI_API SurfaceT<T> SurfacePool::getSurface<T>( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder );\
+	template CI_API SurfaceT<T> SurfacePool::getSurface<T>( const ImageSourceRef &imageSource );\
+	template CI_API ChannelT<T> SurfacePool::getChannel<T>( int32_t width, int32_t height );
+
+SurfacePool_PROTOTYPES(uint8_t)
+SurfacePool_PROTOTYPES(uint16_t)
+SurfacePool_PROTOTYPES(float)
+
+} // namespace cinder
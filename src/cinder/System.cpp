@@ -65,6 +65,15 @@
 	#include <cxxabi.h>
 #endif
 
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+	#include <intrin.h>
+#endif
+
+// On Linux and Android we rely on the compiler's cpuid wrapper for x86 feature detection
+#if ( defined( CINDER_LINUX ) || defined( CINDER_ANDROID ) ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	#define CINDER_X86_GCC
+#endif
+
 #include <string>
 
 using namespace std;
@@ -261,6 +270,10 @@ bool System::hasSse2()
 		instance()->mHasSSE2 = ( instance()->mCPUID_EDX & 0x04000000 ) != 0;
 #elif defined( CINDER_UWP )
 		instance()->mHasSSE2 = IsProcessorFeaturePresent(PF_XMMI64_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasSSE2 = __builtin_cpu_supports( "sse2" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE2 = false;
 #else
 	throw Exception( "Not implemented" );
 #endif
@@ -281,6 +294,10 @@ bool System::hasSse3()
 		instance()->mHasSSE3 = ( instance()->mCPUID_ECX & 0x00000001 ) != 0;
 #elif defined( CINDER_UWP )
 		instance()->mHasSSE3 = IsProcessorFeaturePresent(PF_SSE3_INSTRUCTIONS_AVAILABLE) != 0;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasSSE3 = __builtin_cpu_supports( "sse3" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE3 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -290,6 +307,28 @@ bool System::hasSse3()
 	return instance()->mHasSSE3;
 }
 
+bool System::hasSsse3()
+{
+	if( ! instance()->mCachedValues[HAS_SSSE3] ) {
+#if defined( CINDER_COCOA )	
+		instance()->mHasSSSE3 = ( getSysCtlValue<int>( "hw.optional.supplementalsse3" ) == 1 );
+#elif defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+		int cpuInfo[4];
+		__cpuid( cpuInfo, 1 );
+		instance()->mHasSSSE3 = ( cpuInfo[2] & ( 1 << 9 ) ) != 0;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasSSSE3 = __builtin_cpu_supports( "ssse3" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID ) || defined( CINDER_MSW )
+		instance()->mHasSSSE3 = false;
+#else
+		throw Exception( "Not implemented" );
+#endif
+		instance()->mCachedValues[HAS_SSSE3] = true;
+	}
+	
+	return instance()->mHasSSSE3;
+}
+
 bool System::hasSse4_1()
 {
 	if( ! instance()->mCachedValues[HAS_SSE4_1] ) {
@@ -299,6 +338,10 @@ bool System::hasSse4_1()
 		instance()->mHasSSE4_1 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_1 = ( instance()->mCPUID_ECX & ( 1 << 19 ) ) != 0;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasSSE4_1 = __builtin_cpu_supports( "sse4.1" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE4_1 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -317,6 +360,10 @@ bool System::hasSse4_2()
 		instance()->mHasSSE4_2 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_2 = ( instance()->mCPUID_ECX & ( 1 << 20 ) ) != 0;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasSSE4_2 = __builtin_cpu_supports( "sse4.2" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+		instance()->mHasSSE4_2 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -326,6 +373,39 @@ bool System::hasSse4_2()
 	return instance()->mHasSSE4_2;
 }
 
+bool System::hasAvx2()
+{
+	if( ! instance()->mCachedValues[HAS_AVX2] ) {
+#if defined( CINDER_COCOA )	
+		instance()->mHasAVX2 = ( getSysCtlValue<int>( "hw.optional.avx2_0" ) == 1 );
+#elif defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+		// AVX2 is only usable when the OS saves the YMM registers (OSXSAVE + XCR0 bits 1 and 2)
+		int cpuInfo[4];
+		__cpuid( cpuInfo, 0 );
+		bool hasAvx2 = false;
+		if( cpuInfo[0] >= 7 ) {
+			__cpuid( cpuInfo, 1 );
+			const bool osUsesXsave = ( cpuInfo[2] & ( 1 << 27 ) ) != 0;
+			const bool hasAvx = ( cpuInfo[2] & ( 1 << 28 ) ) != 0;
+			if( osUsesXsave && hasAvx && ( _xgetbv( 0 ) & 0x6 ) == 0x6 ) {
+				__cpuidex( cpuInfo, 7, 0 );
+				hasAvx2 = ( cpuInfo[1] & ( 1 << 5 ) ) != 0;
+			}
+		}
+		instance()->mHasAVX2 = hasAvx2;
+#elif defined( CINDER_X86_GCC )
+		instance()->mHasAVX2 = __builtin_cpu_supports( "avx2" ) != 0;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID ) || defined( CINDER_MSW )
+		instance()->mHasAVX2 = false;
+#else
+		throw Exception( "Not implemented" );
+#endif
+		instance()->mCachedValues[HAS_AVX2] = true;
+	}
+	
+	return instance()->mHasAVX2;
+}
+
 bool System::hasArm()
 {
 	if( ! instance()->mCachedValues[HAS_ARM] ) {
@@ -333,7 +413,7 @@ bool System::hasArm()
 		SYSTEM_INFO info;
 		::GetNativeSystemInfo(&info);
 		instance()->mHasArm = info.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_ARM;
-#elif defined( CINDER_COCOA_TOUCH )
+#elif defined( CINDER_COCOA_TOUCH ) || defined( __arm__ ) || defined( __aarch64__ )
 		instance()->mHasArm = true;
 #else
 		instance()->mHasArm = false;
@@ -356,6 +436,12 @@ bool System::hasX86_64()
 		SYSTEM_INFO info;
 		::GetNativeSystemInfo(&info);
 		instance()->mHasX86_64 = info.wProcessorArchitecture == PROCESSOR_ARCHITECTURE_AMD64;
+#elif defined( CINDER_LINUX ) || defined( CINDER_ANDROID )
+	#if defined( __x86_64__ )
+		instance()->mHasX86_64 = true;
+	#else
+		instance()->mHasX86_64 = false;
+	#endif
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -29,6 +29,7 @@
 #include "cinder/ImageSourceFileRadiance.h"
 #include "cinder/ImageSourceFileStbImage.h"
 #include "cinder/ImageTargetFileStbImage.h"
+#include "cinder/ImageTargetFilePng.h"
 
 #include "cinder/android/app/CinderNativeActivity.h"
 #include "cinder/android/hardware/Camera.h"
@@ -55,6 +56,7 @@ PlatformAndroid::PlatformAndroid()
 	ImageSourceFileRadiance::registerSelf();
 	ImageSourceFileStbImage::registerSelf();
 	ImageTargetFileStbImage::registerSelf();
+	ImageTargetFilePng::registerSelf();
 
 	dbg_app_log( "PlatformAndroid::PlatformAndroid" );
 
@@ -0,0 +1,79 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio/CommandQueue.h"
+#include "cinder/CinderAssert.h"
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+CommandQueue::CommandQueue( size_t capacity )
+	: mCommands( capacity ), mWriteIndex( 0 ), mReadIndex( 0 ), mReleaseIndex( 0 )
+{
+	CI_ASSERT( capacity > 0 );
+}
+
+bool CommandQueue::push( const Command &command )
+{
+	lock_guard<mutex> lock( mPushMutex );
+
+	releaseProcessedImpl();
+
+	const size_t writeIndex = mWriteIndex.load( memory_order_relaxed );
+	if( writeIndex - mReleaseIndex >= mCommands.size() )
+		return false;
+
+	mCommands[writeIndex % mCommands.size()] = command;
+	mWriteIndex.store( writeIndex + 1, memory_order_release );
+	return true;
+}
+
+size_t CommandQueue::process()
+{
+	const size_t writeIndex = mWriteIndex.load( memory_order_acquire );
+	size_t readIndex = mReadIndex.load( memory_order_relaxed );
+	const size_t numCommands = writeIndex - readIndex;
+
+	while( readIndex != writeIndex ) {
+		mCommands[readIndex % mCommands.size()]();
+		mReadIndex.store( ++readIndex, memory_order_release );
+	}
+
+	return numCommands;
+}
+
+void CommandQueue::releaseProcessed()
+{
+	lock_guard<mutex> lock( mPushMutex );
+	releaseProcessedImpl();
+}
+
+void CommandQueue::releaseProcessedImpl()
+{
+	const size_t readIndex = mReadIndex.load( memory_order_acquire );
+	for( ; mReleaseIndex != readIndex; ++mReleaseIndex )
+		mCommands[mReleaseIndex % mCommands.size()] = nullptr;
+}
+
+} } // namespace cinder::audio
@@ -137,7 +137,8 @@ void Context::setMaster( Context *masterContext, DeviceManager *deviceManager )
 }
 
 Context::Context()
-	: mEnabled( false ), mAutoPullRequired( false ), mAutoPullCacheDirty( false ), mNumProcessedFrames( 0 ), mTimeDuringLastProcessLoop( -1.0 )
+	: mEnabled( false ), mAutoPullRequired( false ), mAutoPullCacheDirty( false ), mNumProcessedFrames( 0 ), mTimeDuringLastProcessLoop( -1.0 ),
+		mAudioThreadId( std::thread::id() ), mGraphScheduler( this )
 {
 }
 
@@ -184,6 +185,7 @@ void Context::setEnabled( bool b )
 
 void Context::connectionsDidChange( const NodeRef & /*node*/ )
 {
+	mGraphScheduler.update();
 }
 
 void Context::initializeAllNodes()
@@ -227,6 +229,7 @@ void Context::setOutput( const OutputNodeRef &output )
 	}
 
 	mOutput = output;
+	mGraphScheduler.invalidate();
 
 	if( mOutput )
 		initializeAllNodes();
@@ -291,7 +294,8 @@ void Context::uninitRecursive( const NodeRef &node, set<NodeRef> &traversedNodes
 
 bool Context::isAudioThread() const
 {
-	return mAudioThreadId == std::this_thread::get_id();
+	// the GraphScheduler's workers render on behalf of the audio thread while it waits for them
+	return mAudioThreadId.load() == std::this_thread::get_id() || mGraphScheduler.isWorkerThread();
 }
 
 void Context::preProcess()
@@ -299,6 +303,7 @@ void Context::preProcess()
 	mProcessTimer.start();
 	mAudioThreadId = std::this_thread::get_id();
 
+	mCommandQueue.process();
 	preProcessScheduledEvents();
 }
 
@@ -312,6 +317,40 @@ void Context::postProcess()
 	mTimeDuringLastProcessLoop = mProcessTimer.getSeconds();
 }
 
+void Context::clearAudioThread()
+{
+	mAudioThreadId = std::thread::id();
+}
+
+void Context::enqueueCommand( const std::function<void ()> &command )
+{
+	if( isAudioThread() ) {
+		command();
+		return;
+	}
+
+	if( mCommandQueue.push( command ) )
+		return;
+
+	// The queue is full, which normally means that audio isn't being processed. Run the pending commands here while
+	// synchronized with the audio thread, after which there is room again.
+	lock_guard<mutex> lock( mMutex );
+	mCommandQueue.process();
+
+	bool pushed = mCommandQueue.push( command );
+	CI_VERIFY( pushed );
+}
+
+void Context::setNumRenderThreads( size_t numThreads )
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mGraphScheduler.setNumThreads( numThreads );
+	}
+
+	mGraphScheduler.update();
+}
+
 void Context::incrementFrameCount()
 {
 	mNumProcessedFrames += getFramesPerBlock();
@@ -325,6 +364,7 @@ void Context::addAutoPulledNode( const NodeRef &node )
 {
 	mAutoPulledNodes.insert( node );
 	mAutoPullRequired = true;
+	mGraphScheduler.invalidate();
 	mAutoPullCacheDirty = true;
 
 	// if not done already, allocate a buffer for auto-pulling that is large enough for stereo processing
@@ -339,6 +379,7 @@ void Context::removeAutoPulledNode( const NodeRef &node )
 	CI_VERIFY( result );
 
 	mAutoPullCacheDirty = true;
+	mGraphScheduler.invalidate();
 	if( mAutoPulledNodes.empty() )
 		mAutoPullRequired = false;
 }
@@ -384,30 +425,41 @@ void Context::scheduleEvent( double when, const NodeRef &node, bool callFuncBefo
 		cancelScheduledEvents( node );
 	}
 
-	lock_guard<mutex> lock( mMutex );
 	node->mEventScheduled = true;
-	mScheduledEvents.push_back( ScheduledEvent( eventFrameThreshold, node, callFuncBeforeProcess, func ) );
+
+	// the list node is allocated here and spliced into mScheduledEvents on the audio thread
+	list<ScheduledEvent> pending;
+	pending.push_back( ScheduledEvent( eventFrameThreshold, node, callFuncBeforeProcess, func ) );
+
+	enqueueCommand( [this, pending]() mutable {
+		mScheduledEvents.splice( mScheduledEvents.end(), pending );
+	} );
 }
 
 void Context::cancelScheduledEvents( const NodeRef &node )
 {
-	lock_guard<mutex> lock( mMutex );
+	node->mEventScheduled = false;
 
-	for( auto eventIt = mScheduledEvents.begin(); eventIt != mScheduledEvents.end(); ++eventIt ) {
-		if( eventIt->mNode == node ) {
-			// reset process frame range to an entire block
-			auto &range = eventIt->mNode->mProcessFramesRange;
-			range.first = 0;
-			range.second = getFramesPerBlock();
+	// the canceled event is moved into the command, so that it is destroyed on this thread
+	NodeRef nodeRef = node;
+	list<ScheduledEvent> canceled;
 
-			eventIt->mNode->mEventScheduled = false;
-			mScheduledEvents.erase( eventIt );
-			break;
+	enqueueCommand( [this, nodeRef, canceled]() mutable {
+		for( auto eventIt = mScheduledEvents.begin(); eventIt != mScheduledEvents.end(); ++eventIt ) {
+			if( eventIt->mNode == nodeRef ) {
+				// reset process frame range to an entire block
+				auto &range = eventIt->mNode->mProcessFramesRange;
+				range.first = 0;
+				range.second = getFramesPerBlock();
+
+				canceled.splice( canceled.end(), mScheduledEvents, eventIt );
+				break;
+			}
 		}
-	}
+	} );
 }
 
-// note: we should be synchronized with mMutex by the OutputDeviceNode impl, so mScheduledEvents is safe to modify
+// note: mScheduledEvents is only modified on the audio thread, see scheduleEvent()
 void Context::preProcessScheduledEvents()
 {
 	const uint64_t framesPerBlock = (uint64_t)getFramesPerBlock();
@@ -39,14 +39,18 @@ void FilterBiquadNode::initialize()
 
 	mBufferd = BufferT<double>( getFramesPerBlock(), getNumChannels() );
 	mBiquads.resize( getNumChannels() );
+	mBiquadBank = dsp::BiquadBankd( getNumChannels() );
 
-	if( mCoeffsDirty )
-		updateBiquadParams();
+	// the Biquads and bank were just recreated, so the coefficients are needed even if the params haven't changed
+	updateBiquadParams();
+	// start from the coefficients rather than ramping to them
+	mBiquadBank.reset();
 }
 
 void FilterBiquadNode::uninitialize()
 {
 	mBiquads.clear();
+	mBiquadBank = dsp::BiquadBankd( 0 );
 }
 
 void FilterBiquadNode::process( Buffer *buffer )
@@ -54,12 +58,7 @@ void FilterBiquadNode::process( Buffer *buffer )
 	if( mCoeffsDirty )
 		updateBiquadParams();
 
-	size_t numFrames = buffer->getNumFrames();
-
-	for( size_t ch = 0; ch < getNumChannels(); ch++ ) {
-		float *channel = buffer->getChannel( ch );
-		mBiquads[ch].process( channel, channel, numFrames );
-	}
+	mBiquadBank.process( buffer );
 }
 
 void FilterBiquadNode::updateBiquadParams()
@@ -103,6 +102,9 @@ void FilterBiquadNode::updateBiquadParams()
 		default:
 			break;
 	}
+
+	for( size_t ch = 0; ch < getNumChannels(); ch++ )
+		mBiquadBank.setCoefficients( ch, 0, mBiquads[ch].getCoefficients() );
 }
 
 } } // namespace cinder::audio
@@ -0,0 +1,357 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio/GraphScheduler.h"
+#include "cinder/audio/Context.h"
+#include "cinder/audio/Param.h"
+
+#include <chrono>
+#include <functional>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#include <emmintrin.h>
+	#define CINDER_AUDIO_SPIN_PAUSE() _mm_pause()
+#elif defined( _MSC_VER ) && ( defined( _M_ARM ) || defined( _M_ARM64 ) )
+	#include <intrin.h>
+	#define CINDER_AUDIO_SPIN_PAUSE() __yield()
+#elif defined( __arm__ ) || defined( __aarch64__ )
+	#define CINDER_AUDIO_SPIN_PAUSE() __asm__ __volatile__( "yield" )
+#else
+	#define CINDER_AUDIO_SPIN_PAUSE() ( (void)0 )
+#endif
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+// the GraphScheduler that owns the current thread, if it is a worker
+thread_local const GraphScheduler *sWorkerScheduler = nullptr;
+
+// Snapshot of a Node and the Node's that it pulls, taken while synchronized with the audio thread.
+struct GraphNode {
+	GraphNode( const NodeRef &node )
+		: mNode( node ), mNumInputs( node->getNumConnectedInputs() ), mInCycle( false )
+	{}
+
+	NodeRef				mNode;
+	vector<size_t>		mUpstream;	// inputs in the order they are pulled, followed by Param processors
+	size_t				mNumInputs;
+	vector<size_t>		mConsumers;
+	bool				mInCycle;
+};
+
+typedef function<vector<NodeRef> ( const Node * )>	UpstreamFn;
+
+size_t addGraphNode( const NodeRef &node, const UpstreamFn &upstreamFn, vector<GraphNode> *graph, unordered_map<const Node *, size_t> *indices )
+{
+	auto indexIt = indices->find( node.get() );
+	if( indexIt != indices->end() )
+		return indexIt->second;
+
+	const size_t index = graph->size();
+	graph->push_back( GraphNode( node ) );
+	(*indices)[node.get()] = index;
+
+	for( const auto &upstreamNode : upstreamFn( node.get() ) ) {
+		size_t upstreamIndex = addGraphNode( upstreamNode, upstreamFn, graph, indices );
+		(*graph)[index].mUpstream.push_back( upstreamIndex );
+	}
+
+	return index;
+}
+
+// Depth-first topological sort that marks every Node that is part of a feedback loop, as those can't be rendered in isolation.
+void markCycles( vector<GraphNode> *graph )
+{
+	enum { UNVISITED, VISITING, VISITED };
+	vector<int> state( graph->size(), UNVISITED );
+	vector<pair<size_t, size_t> > stack; // node index, next upstream
+
+	for( size_t root = 0; root < graph->size(); root++ ) {
+		if( state[root] != UNVISITED )
+			continue;
+
+		state[root] = VISITING;
+		stack.push_back( make_pair( root, size_t( 0 ) ) );
+		while( ! stack.empty() ) {
+			auto &top = stack.back();
+			const auto &upstream = (*graph)[top.first].mUpstream;
+			if( top.second == upstream.size() ) {
+				state[top.first] = VISITED;
+				stack.pop_back();
+				continue;
+			}
+
+			size_t next = upstream[top.second++];
+			if( state[next] == UNVISITED ) {
+				state[next] = VISITING;
+				stack.push_back( make_pair( next, size_t( 0 ) ) );
+			}
+			else if( state[next] == VISITING ) {
+				// everything on the stack from next up to here forms a loop
+				for( auto it = stack.rbegin(); it != stack.rend(); ++it ) {
+					(*graph)[it->first].mInCycle = true;
+					if( it->first == next )
+						break;
+				}
+			}
+		}
+	}
+}
+
+// Returns true if nothing besides summingIndex consumes the branch upstream of (and including) inputIndex.
+bool isIndependentBranch( const vector<GraphNode> &graph, size_t summingIndex, size_t inputIndex, vector<size_t> *marks, size_t mark )
+{
+	vector<size_t> branch( 1, inputIndex );
+	(*marks)[inputIndex] = mark;
+	for( size_t i = 0; i < branch.size(); i++ ) {
+		for( size_t upstream : graph[branch[i]].mUpstream ) {
+			if( (*marks)[upstream] != mark ) {
+				(*marks)[upstream] = mark;
+				branch.push_back( upstream );
+			}
+		}
+	}
+
+	for( size_t index : branch ) {
+		if( graph[index].mInCycle )
+			return false;
+
+		for( size_t consumer : graph[index].mConsumers ) {
+			bool consumerInBranch = ( index == inputIndex ) ? ( consumer == summingIndex ) : ( (*marks)[consumer] == mark );
+			if( ! consumerInBranch )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+GraphScheduler::GraphScheduler( Context *context )
+	: mContext( context ), mNumThreads( 0 ), mThreadsShouldQuit( false ), mGeneration( 0 ), mTasks( nullptr ), mBatchActive( false ),
+		mNextTask( 0 ), mNumTasksCompleted( 0 ), mNumActiveWorkers( 0 ), mNumParallelRenders( 0 )
+{
+}
+
+GraphScheduler::~GraphScheduler()
+{
+	setNumThreads( 0 );
+}
+
+void GraphScheduler::setNumThreads( size_t numThreads )
+{
+	if( numThreads == mThreads.size() )
+		return;
+
+	mThreadsShouldQuit = true;
+	for( auto &worker : mThreads )
+		worker.join();
+
+	mThreads.clear();
+	mThreadsShouldQuit = false;
+
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.push_back( thread( &GraphScheduler::workerLoop, this ) );
+
+	mNumThreads = numThreads;
+	if( ! numThreads )
+		mSchedule.reset();
+}
+
+void GraphScheduler::invalidate()
+{
+	mGeneration++;
+}
+
+void GraphScheduler::update()
+{
+	// The audio thread already holds the Context's mutex, it will pull serially until the next update from a user thread.
+	if( ! mNumThreads || mContext->isAudioThread() || sWorkerScheduler )
+		return;
+
+	vector<GraphNode> graph;
+	auto schedule = make_shared<Schedule>();
+	{
+		lock_guard<mutex> lock( mContext->getMutex() );
+
+		// read the generation first, so a change made while the graph is being copied results in a schedule that is already out of date
+		schedule->mGeneration = mGeneration;
+
+		// a Node pulls its inputs and the processors of its Param's
+		auto upstreamFn = []( const Node *node ) {
+			vector<NodeRef> result( node->mInputs.begin(), node->mInputs.end() );
+			for( const Param *param : node->mParams ) {
+				auto processor = param->getProcessor();
+				if( processor )
+					result.push_back( processor );
+			}
+			return result;
+		};
+
+		unordered_map<const Node *, size_t> indices;
+		if( mContext->mOutput )
+			addGraphNode( mContext->mOutput, upstreamFn, &graph, &indices );
+		for( const auto &node : mContext->mAutoPulledNodes )
+			addGraphNode( node, upstreamFn, &graph, &indices );
+	}
+
+	markCycles( &graph );
+
+	for( size_t i = 0; i < graph.size(); i++ ) {
+		for( size_t upstream : graph[i].mUpstream )
+			graph[upstream].mConsumers.push_back( i );
+	}
+
+	vector<size_t> marks( graph.size(), 0 );
+	size_t mark = 0;
+
+	for( size_t summingIndex = 0; summingIndex < graph.size(); summingIndex++ ) {
+		const GraphNode &summing = graph[summingIndex];
+		if( summing.mNumInputs < 2 )
+			continue;
+
+		const Buffer *internalBuffer = summing.mNode->getInternalBuffer();
+
+		Entry entry;
+		for( size_t i = 0; i < summing.mNumInputs; i++ ) {
+			size_t inputIndex = summing.mUpstream[i];
+			entry.mInputs.push_back( graph[inputIndex].mNode.get() );
+
+			if( isIndependentBranch( graph, summingIndex, inputIndex, &marks, ++mark ) )
+				entry.mTasks.push_back( Task( graph[inputIndex].mNode.get(), i, internalBuffer->getNumFrames(), internalBuffer->getNumChannels() ) );
+		}
+
+		if( entry.mTasks.size() < 2 )
+			continue;
+
+		entry.mRendered.resize( entry.mInputs.size(), nullptr );
+		schedule->mEntries[summing.mNode.get()] = move( entry );
+	}
+
+	// The previous schedule is moved into the command, so that it is released on this thread.
+	mContext->enqueueCommand( [this, schedule]() mutable {
+		if( ! mSchedule || schedule->mGeneration >= mSchedule->mGeneration )
+			mSchedule.swap( schedule );
+	} );
+}
+
+const vector<const Buffer *>* GraphScheduler::renderInputs( Node *node )
+{
+	// summing Node's within a branch that is already being rendered in parallel pull serially
+	if( mBatchActive || ! mNumThreads || ! mSchedule || mSchedule->mGeneration != mGeneration )
+		return nullptr;
+
+	auto entryIt = mSchedule->mEntries.find( node );
+	if( entryIt == mSchedule->mEntries.end() )
+		return nullptr;
+
+	Entry &entry = entryIt->second;
+
+	// guard against channel count changes that didn't alter the graph's topology
+	const Buffer *internalBuffer = node->getInternalBuffer();
+	for( const auto &task : entry.mTasks ) {
+		if( task.mBuffer.getNumFrames() != internalBuffer->getNumFrames() || task.mBuffer.getNumChannels() != internalBuffer->getNumChannels() )
+			return nullptr;
+	}
+
+	runTasks( &entry.mTasks );
+	mNumParallelRenders++;
+
+	for( auto &task : entry.mTasks )
+		entry.mRendered[task.mInputIndex] = task.mInput->getProcessesInPlace() ? &task.mBuffer : task.mInput->getInternalBuffer();
+
+	return &entry.mRendered;
+}
+
+bool GraphScheduler::isWorkerThread() const
+{
+	return sWorkerScheduler == this;
+}
+
+size_t GraphScheduler::getNumParallelInputs( const Node *node ) const
+{
+	if( ! mSchedule )
+		return 0;
+
+	auto entryIt = mSchedule->mEntries.find( node );
+	return ( entryIt != mSchedule->mEntries.end() ) ? entryIt->second.mTasks.size() : 0;
+}
+
+void GraphScheduler::runTasks( vector<Task> *tasks )
+{
+	mTasks = tasks;
+	mNextTask = 0;
+	mNumTasksCompleted = 0;
+	mBatchActive = true;
+
+	// The audio thread renders tasks too, so the batch completes even if no workers are awake to help.
+	runAvailableTasks();
+
+	// the remaining tasks are being rendered by workers, which can't be handed back once started
+	while( mNumTasksCompleted != tasks->size() )
+		CINDER_AUDIO_SPIN_PAUSE();
+
+	// Wait for workers that joined after the last task was taken, so none of them picks up a task from the next batch.
+	mBatchActive = false;
+	while( mNumActiveWorkers != 0 )
+		CINDER_AUDIO_SPIN_PAUSE();
+}
+
+void GraphScheduler::runAvailableTasks()
+{
+	auto &tasks = *mTasks;
+	size_t i;
+	while( ( i = mNextTask++ ) < tasks.size() ) {
+		Task &task = tasks[i];
+		task.mInput->pullInputs( &task.mBuffer );
+		mNumTasksCompleted++;
+	}
+}
+
+void GraphScheduler::workerLoop()
+{
+	sWorkerScheduler = this;
+
+	// Workers poll so that the audio thread never has to signal them. They stay responsive while batches are coming in and back off once idle.
+	auto lastBatchTime = chrono::steady_clock::now();
+	while( ! mThreadsShouldQuit ) {
+		if( mBatchActive ) {
+			mNumActiveWorkers++;
+			if( mBatchActive )
+				runAvailableTasks();
+			mNumActiveWorkers--;
+
+			lastBatchTime = chrono::steady_clock::now();
+		}
+		else if( chrono::steady_clock::now() - lastBatchTime < chrono::milliseconds( 20 ) )
+			this_thread::yield();
+		else
+			this_thread::sleep_for( chrono::microseconds( 500 ) );
+	}
+}
+
+} } // namespace cinder::audio
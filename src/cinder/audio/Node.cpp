@@ -25,6 +25,7 @@
 #include "cinder/audio/Node.h"
 #include "cinder/audio/DelayNode.h"
 #include "cinder/audio/Context.h"
+#include "cinder/audio/GraphScheduler.h"
 #include "cinder/audio/dsp/Dsp.h"
 #include "cinder/audio/dsp/Converter.h"
 #include "cinder/CinderAssert.h"
@@ -124,6 +125,7 @@ void Node::connectInput( const NodeRef &input )
 		return;
 
 	lock_guard<mutex> lock( ctx->getMutex() );
+	ctx->getGraphScheduler()->invalidate();
 
 	mInputs.insert( input );
 	configureConnections();
@@ -136,6 +138,7 @@ void Node::disconnectInput( const NodeRef &input )
 		return;
 
 	lock_guard<mutex> lock( ctx->getMutex() );
+	ctx->getGraphScheduler()->invalidate();
 
 	for( auto inIt = mInputs.begin(); inIt != mInputs.end(); ++inIt ) {
 		if( *inIt == input ) {
@@ -152,6 +155,7 @@ void Node::disconnectOutput( const NodeRef &output )
 		return;
 
 	lock_guard<mutex> lock( ctx->getMutex() );
+	ctx->getGraphScheduler()->invalidate();
 
 	for( auto outIt = mOutputs.begin(); outIt != mOutputs.end(); ++outIt ) {
 		if( outIt->lock() == output ) {
@@ -451,11 +455,19 @@ void Node::process( Buffer * /*buffer*/ )
 
 void Node::sumInputs()
 {
+	// Inputs that the GraphScheduler rendered in parallel are summed from where they were rendered to, in the same order as the rest.
+	const vector<const Buffer *> *renderedInputs = getContext()->getGraphScheduler()->renderInputs( this );
+
 	// Pull all inputs, summing the results from the buffer that input used for processing.
 	// mInternalBuffer is not zero'ed before pulling inputs to allow for feedback.
+	size_t inputIndex = 0;
 	for( auto &input : mInputs ) {
-		input->pullInputs( &mInternalBuffer );
-		const Buffer *processedBuffer = input->getProcessesInPlace() ? &mInternalBuffer : input->getInternalBuffer();
+		const Buffer *processedBuffer = renderedInputs ? (*renderedInputs)[inputIndex++] : nullptr;
+		if( ! processedBuffer ) {
+			input->pullInputs( &mInternalBuffer );
+			processedBuffer = input->getProcessesInPlace() ? &mInternalBuffer : input->getInternalBuffer();
+		}
+
 		dsp::sumBuffers( processedBuffer, &mSummingBuffer );
 	}
 
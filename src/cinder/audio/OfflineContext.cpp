@@ -0,0 +1,169 @@
+/*
+ Copyright (c) 2014, The Cinder Project
+
+ This code is intended to be used with the Cinder C++ library, http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/Target.h"
+#include "cinder/audio/Exception.h"
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+// ----------------------------------------------------------------------------------------------------
+// OutputOfflineNode
+// ----------------------------------------------------------------------------------------------------
+
+OutputOfflineNode::OutputOfflineNode( size_t sampleRate, size_t framesPerBlock, const Format &format )
+	: OutputNode( format ), mSampleRate( sampleRate ), mFramesPerBlock( framesPerBlock )
+{
+	if( ! mSampleRate || ! mFramesPerBlock )
+		throw AudioFormatExc( "OutputOfflineNode requires a non-zero samplerate and frames per block." );
+
+	if( getChannelMode() != ChannelMode::SPECIFIED ) {
+		setChannelMode( ChannelMode::SPECIFIED );
+		setNumChannels( 2 );
+	}
+}
+
+void OutputOfflineNode::renderInputs()
+{
+	auto ctx = getContext();
+	CI_ASSERT( ctx );
+
+	lock_guard<mutex> lock( ctx->getMutex() );
+
+	ctx->preProcess();
+
+	auto internalBuffer = getInternalBuffer();
+	internalBuffer->zero();
+	pullInputs( internalBuffer );
+
+	if( checkNotClipping() )
+		internalBuffer->zero();
+
+	ctx->postProcess();
+
+	// between blocks the rendering thread is a user thread again, from which connection changes rebuild the GraphScheduler's schedule
+	ctx->clearAudioThread();
+}
+
+// ----------------------------------------------------------------------------------------------------
+// OfflineContext
+// ----------------------------------------------------------------------------------------------------
+
+// static
+OfflineContextRef OfflineContext::create( const Format &format )
+{
+	return OfflineContextRef( new OfflineContext( format ) );
+}
+
+OfflineContext::OfflineContext( const Format &format )
+	: mFormat( format ), mRenderSpeed( 0 )
+{
+}
+
+OutputDeviceNodeRef OfflineContext::createOutputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "OfflineContext does not support hardware output devices." );
+}
+
+InputDeviceNodeRef OfflineContext::createInputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "OfflineContext does not support hardware input devices." );
+}
+
+void OfflineContext::setOutput( const OutputNodeRef &output )
+{
+	auto offlineOutput = dynamic_pointer_cast<OutputOfflineNode>( output );
+	if( output && ! offlineOutput )
+		throw AudioContextExc( "OfflineContext requires an OutputOfflineNode as its output." );
+
+	mOfflineOutput = offlineOutput;
+	Context::setOutput( output );
+}
+
+const OutputNodeRef& OfflineContext::getOutput()
+{
+	if( ! mOfflineOutput )
+		setOutput( makeNode( new OutputOfflineNode( mFormat.getSampleRate(), mFormat.getFramesPerBlock(), Node::Format().channels( mFormat.getChannels() ) ) ) );
+
+	return Context::getOutput();
+}
+
+void OfflineContext::renderBlock()
+{
+	getOutput();
+
+	// output may not yet be initialized if no Node's are connected to it.
+	if( ! mOfflineOutput->isInitialized() )
+		initializeNode( mOfflineOutput );
+
+	mOfflineOutput->renderInputs();
+}
+
+void OfflineContext::render( Buffer *destBuffer )
+{
+	CI_ASSERT( destBuffer );
+
+	if( destBuffer->getNumChannels() != getOutput()->getNumChannels() )
+		throw AudioFormatExc( "destination Buffer must have the same number of channels as the OutputOfflineNode." );
+
+	renderFrames( destBuffer->getNumFrames(), [destBuffer]( const Buffer *block, size_t numFrames, size_t frameOffset ) {
+		destBuffer->copyOffset( *block, numFrames, frameOffset, 0 );
+	} );
+}
+
+void OfflineContext::render( TargetFile *target, size_t numFrames )
+{
+	CI_ASSERT( target );
+
+	const auto &output = getOutput();
+	if( target->getNumChannels() != output->getNumChannels() )
+		throw AudioFormatExc( "TargetFile must have the same number of channels as the OutputOfflineNode." );
+	if( target->getSampleRate() != getSampleRate() )
+		throw AudioFormatExc( "TargetFile must have the same samplerate as the OfflineContext." );
+
+	renderFrames( numFrames, [target]( const Buffer *block, size_t numFrames, size_t /*frameOffset*/ ) {
+		target->write( block, numFrames );
+	} );
+}
+
+void OfflineContext::renderFrames( size_t numFrames, const function<void ( const Buffer *, size_t, size_t )> &blockFn )
+{
+	const size_t framesPerBlock = getFramesPerBlock();
+
+	mRenderTimer.start();
+
+	for( size_t frame = 0; frame < numFrames; frame += framesPerBlock ) {
+		renderBlock();
+		blockFn( mOfflineOutput->getInternalBuffer(), std::min( framesPerBlock, numFrames - frame ), frame );
+	}
+
+	mRenderTimer.stop();
+
+	const double wallSeconds = mRenderTimer.getSeconds();
+	const double renderedSeconds = (double)numFrames / (double)getSampleRate();
+	mRenderSpeed = wallSeconds > 0 ? renderedSeconds / wallSeconds : 0;
+}
+
+} } // namespace cinder::audio
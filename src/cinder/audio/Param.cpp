@@ -67,13 +67,20 @@ Event::Event( double timeBegin, double timeEnd, float valueBegin, float valueEnd
 Param::Param( Node *parentNode, float initialValue )
 	: mParentNode( parentNode ), mValue( initialValue ), mIsVaryingThisBlock( false )
 {
+	if( mParentNode )
+		mParentNode->mParams.push_back( this );
 }
 
 void Param::setValue( float value )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	resetImpl();
+	resetImpl( nullptr );
 	mValue = value;
+
+	// also set on the audio thread, after any Events evaluated before the reset have stopped writing to mValue
+	NodeRef parent = mParentNode->shared_from_this();
+	getContext()->enqueueCommand( [this, parent, value] {
+		mValue = value;
+	} );
 }
 
 EventRef Param::applyRamp( float valueEnd, double rampSeconds, const Options &options )
@@ -89,13 +96,7 @@ EventRef Param::applyRamp( float valueEnd, double rampSeconds, const Options &op
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
+	applyEvent( event );
 	return event;
 }
 
@@ -112,13 +113,7 @@ EventRef Param::applyRamp( float valueBegin, float valueEnd, double rampSeconds,
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
+	applyEvent( event );
 	return event;
 }
 
@@ -126,7 +121,6 @@ EventRef Param::appendRamp( float valueEnd, double rampSeconds, const Options &o
 {
 	initInternalBuffer();
 
-	auto ctx = getContext();
 	auto endTimeAndValue = findEndTimeAndValue();
 	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
 	double timeEnd = timeBegin + rampSeconds;
@@ -136,8 +130,7 @@ EventRef Param::appendRamp( float valueEnd, double rampSeconds, const Options &o
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
+	appendEvent( event );
 	return event;
 }
 
@@ -145,7 +138,6 @@ EventRef Param::appendRamp( float valueBegin, float valueEnd, double rampSeconds
 {
 	initInternalBuffer();
 
-	auto ctx = getContext();
 	auto endTimeAndValue = findEndTimeAndValue();
 	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
 	double timeEnd = timeBegin + rampSeconds;
@@ -155,8 +147,7 @@ EventRef Param::appendRamp( float valueBegin, float valueEnd, double rampSeconds
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
+	appendEvent( event );
 	return event;
 }
 
@@ -167,40 +158,41 @@ void Param::setProcessor( const NodeRef &node )
 
 	initInternalBuffer();
 
-	lock_guard<mutex> lock( getContext()->getMutex() );
-
-	resetImpl();
-
-	// force node to be mono and initialize it
+	// force node to be mono and initialize it. It isn't pulled until the audio thread picks it up in resetImpl().
 	node->setNumChannels( 1 );
 	node->initializeImpl();
 
-	mProcessor = node;
-	mIsVaryingThisBlock = true; // stays true until there is no more processor and eval() sets this to false.
+	resetImpl( node );
 }
 
 void Param::reset()
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	resetImpl();
+	resetImpl( nullptr );
 }
 
+NodeRef Param::getProcessor() const
+{
+	lock_guard<mutex> lock( mUserMutex );
+	return mUserProcessor;
+}
 
 size_t Param::getNumEvents() const
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	return mEvents.size();
+	lock_guard<mutex> lock( mUserMutex );
+	pruneUserEvents();
+	return mUserEvents.size();
 }
 
 float Param::findDuration() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
+	lock_guard<mutex> lock( mUserMutex );
+	pruneUserEvents();
 
-	if( mEvents.empty() )
+	if( mUserEvents.empty() )
 		return 0;
 	else {
-		const EventRef &event = mEvents.back();
+		const EventRef &event = mUserEvents.back();
 		return static_cast<float>(event->mTimeEnd - ctx->getNumProcessedSeconds());
 	}
 }
@@ -208,12 +200,13 @@ float Param::findDuration() const
 pair<double, float> Param::findEndTimeAndValue() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
+	lock_guard<mutex> lock( mUserMutex );
+	pruneUserEvents();
 
-	if( mEvents.empty() )
+	if( mUserEvents.empty() )
 		return make_pair( ctx->getNumProcessedSeconds(), mValue.load() );
 	else {
-		const EventRef &event = mEvents.back();
+		const EventRef &event = mUserEvents.back();
 		return make_pair( event->mTimeEnd, event->mValueEnd );
 	}
 }
@@ -258,6 +251,9 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 			if( mEvents.size() == 1 && ! cancelled )
 				mValue = event.mValueEnd;
 
+			if( ! cancelled )
+				event.mIsComplete = true;
+
 			eventIt = mEvents.erase( eventIt );
 			continue;
 		}
@@ -331,16 +327,100 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 // Protected
 // ----------------------------------------------------------------------------------------------------
 
-void Param::resetImpl()
+// Param's user thread methods don't modify mEvents or mProcessor, which belong to the audio thread. Instead they keep a copy of
+// the Events they have scheduled in mUserEvents, and hand the changes over to the audio thread with Context::enqueueCommand().
+// Containers are filled before they are handed over and spliced or swapped in, so the audio thread doesn't allocate, and
+// anything it replaces is released with the command on the user thread.
+
+void Param::applyEvent( const EventRef &event )
+{
+	const double timeBegin = event->getTimeBegin();
+
+	{
+		lock_guard<mutex> lock( mUserMutex );
+
+		// Events that begin later are canceled right away, those that overlap are cut short by removeEventsAt() on the audio thread.
+		for( auto &userEvent : mUserEvents ) {
+			if( userEvent->getTimeBegin() >= timeBegin )
+				userEvent->cancel();
+		}
+
+		pruneUserEvents();
+		mUserEvents.push_back( event );
+		mUserProcessor.reset();
+	}
+
+	NodeRef parent = mParentNode->shared_from_this();
+	list<EventRef> pending( 1, event );
+	NodeRef processor;
+
+	getContext()->enqueueCommand( [this, parent, timeBegin, pending, processor]() mutable {
+		removeEventsAt( timeBegin );
+		mEvents.splice( mEvents.end(), pending );
+		mProcessor.swap( processor );
+	} );
+}
+
+void Param::appendEvent( const EventRef &event )
+{
+	{
+		lock_guard<mutex> lock( mUserMutex );
+		pruneUserEvents();
+		mUserEvents.push_back( event );
+	}
+
+	NodeRef parent = mParentNode->shared_from_this();
+	list<EventRef> pending( 1, event );
+
+	getContext()->enqueueCommand( [this, parent, pending]() mutable {
+		mEvents.splice( mEvents.end(), pending );
+	} );
+}
+
+void Param::resetImpl( const NodeRef &processor )
 {
-	if( ! mEvents.empty() ) {
-		for( auto &event : mEvents )
+	bool processorChanged;
+	{
+		lock_guard<mutex> lock( mUserMutex );
+		for( auto &event : mUserEvents )
 			event->cancel();
 
-		mEvents.clear();
+		mUserEvents.clear();
+		processorChanged = ( mUserProcessor != processor );
+		mUserProcessor = processor;
 	}
 
-	mProcessor.reset();
+	auto ctx = getContext();
+	auto scheduler = ctx->getGraphScheduler();
+
+	// The processor is part of the graph that the GraphScheduler renders. Its schedule is invalidated before the audio thread can
+	// pick up the new processor, and again after, so that a schedule built concurrently is only used if it comes later in the queue.
+	if( processorChanged )
+		scheduler->invalidate();
+
+	NodeRef parent = mParentNode->shared_from_this();
+	list<EventRef> events;
+	NodeRef processorSwap = processor;
+
+	ctx->enqueueCommand( [this, parent, events, processorSwap]() mutable {
+		mEvents.swap( events );
+		mProcessor.swap( processorSwap );
+
+		if( mProcessor )
+			mIsVaryingThisBlock = true; // stays true until there is no more processor and eval() sets this to false.
+	} );
+
+	if( processorChanged ) {
+		scheduler->invalidate();
+		scheduler->update();
+	}
+}
+
+void Param::pruneUserEvents() const
+{
+	mUserEvents.remove_if( []( const EventRef &event ) {
+		return event->isComplete() || event->mIsCanceled;
+	} );
 }
 
 void Param::removeEventsAt( double time )
@@ -57,10 +57,27 @@
 #include "cinder/Cinder.h"
 #include "cinder/CinderMath.h"
 
+#include "cinder/System.h"
+
 #if defined( CINDER_AUDIO_VDSP )
 	#include <Accelerate/Accelerate.h>
 #endif
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_AUDIO_BIQUAD_SSE
+	#include <immintrin.h>
+	// the 256-bit kernel is compiled for AVX2 explicitly and chosen at runtime, the 128-bit one only needs SSE2
+	#if defined( __AVX2__ ) || defined( _MSC_VER )
+		#define CINDER_AUDIO_BIQUAD_AVX2_TARGET
+	#else
+		#define CINDER_AUDIO_BIQUAD_AVX2_TARGET __attribute__(( target( "avx2" ) ))
+	#endif
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_AUDIO_BIQUAD_NEON
+	#include <arm_neon.h>
+#endif
+
+#include <algorithm>
 #include <complex>
 
 namespace cinder { namespace audio { namespace dsp {
@@ -534,4 +551,365 @@ void Biquad::processSliceVDsp( double *source, double *dest, double *coefficient
 
 #endif // defined( CINDER_AUDIO_VDSP )
 
+// ----------------------------------------------------------------------------------------------------
+// BiquadBankT
+// ----------------------------------------------------------------------------------------------------
+
+namespace {
+
+// The rows of a section: the current, target and per-frame step of each coefficient, followed by the filter memory
+enum SectionRow { B0, B1, B2, A1, A2, TARGET_B0, TARGET_B1, TARGET_B2, TARGET_A1, TARGET_A2, STEP_B0, STEP_B1, STEP_B2, STEP_A1, STEP_A2, X1, X2, Y1, Y2, NUM_SECTION_ROWS };
+
+const size_t kNumCoefficients = 5;
+// the number of frames of a group of channels that are interleaved and filtered at once
+const size_t kChunkSize = 256;
+
+// Loads, stores and arithmetic on the registers of one instruction set, or on single values for ScalarLanes
+template<typename T>
+struct ScalarLanes {
+	typedef T Scalar;
+	typedef T Vec;
+	static const size_t NUM_LANES = 1;
+
+	static Vec load( const T *p )				{ return *p; }
+	static void store( T *p, Vec v )			{ *p = v; }
+	static Vec add( Vec a, Vec b )				{ return a + b; }
+	static Vec sub( Vec a, Vec b )				{ return a - b; }
+	static Vec mul( Vec a, Vec b )				{ return a * b; }
+};
+
+#if defined( CINDER_AUDIO_BIQUAD_SSE )
+
+bool hasBiquadAvx2()
+{
+	static const bool sHasAvx2 = System::hasAvx2();
+	return sHasAvx2;
+}
+
+template<typename T>
+struct SseLanes;
+
+template<>
+struct SseLanes<float> {
+	typedef float Scalar;
+	typedef __m128 Vec;
+	static const size_t NUM_LANES = 4;
+
+	static Vec load( const float *p )			{ return _mm_loadu_ps( p ); }
+	static void store( float *p, Vec v )		{ _mm_storeu_ps( p, v ); }
+	static Vec add( Vec a, Vec b )				{ return _mm_add_ps( a, b ); }
+	static Vec sub( Vec a, Vec b )				{ return _mm_sub_ps( a, b ); }
+	static Vec mul( Vec a, Vec b )				{ return _mm_mul_ps( a, b ); }
+};
+
+template<>
+struct SseLanes<double> {
+	typedef double Scalar;
+	typedef __m128d Vec;
+	static const size_t NUM_LANES = 2;
+
+	static Vec load( const double *p )			{ return _mm_loadu_pd( p ); }
+	static void store( double *p, Vec v )		{ _mm_storeu_pd( p, v ); }
+	static Vec add( Vec a, Vec b )				{ return _mm_add_pd( a, b ); }
+	static Vec sub( Vec a, Vec b )				{ return _mm_sub_pd( a, b ); }
+	static Vec mul( Vec a, Vec b )				{ return _mm_mul_pd( a, b ); }
+};
+
+template<typename T>
+struct Avx2Lanes;
+
+template<>
+struct Avx2Lanes<float> {
+	typedef float Scalar;
+	typedef __m256 Vec;
+	static const size_t NUM_LANES = 8;
+
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec load( const float *p )		{ return _mm256_loadu_ps( p ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static void store( float *p, Vec v )	{ _mm256_storeu_ps( p, v ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec add( Vec a, Vec b )			{ return _mm256_add_ps( a, b ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec sub( Vec a, Vec b )			{ return _mm256_sub_ps( a, b ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec mul( Vec a, Vec b )			{ return _mm256_mul_ps( a, b ); }
+};
+
+template<>
+struct Avx2Lanes<double> {
+	typedef double Scalar;
+	typedef __m256d Vec;
+	static const size_t NUM_LANES = 4;
+
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec load( const double *p )		{ return _mm256_loadu_pd( p ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static void store( double *p, Vec v )	{ _mm256_storeu_pd( p, v ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec add( Vec a, Vec b )			{ return _mm256_add_pd( a, b ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec sub( Vec a, Vec b )			{ return _mm256_sub_pd( a, b ); }
+	CINDER_AUDIO_BIQUAD_AVX2_TARGET static Vec mul( Vec a, Vec b )			{ return _mm256_mul_pd( a, b ); }
+};
+
+#elif defined( CINDER_AUDIO_BIQUAD_NEON )
+
+template<typename T>
+struct NeonLanes;
+
+template<>
+struct NeonLanes<float> {
+	typedef float Scalar;
+	typedef float32x4_t Vec;
+	static const size_t NUM_LANES = 4;
+
+	static Vec load( const float *p )			{ return vld1q_f32( p ); }
+	static void store( float *p, Vec v )		{ vst1q_f32( p, v ); }
+	static Vec add( Vec a, Vec b )				{ return vaddq_f32( a, b ); }
+	static Vec sub( Vec a, Vec b )				{ return vsubq_f32( a, b ); }
+	static Vec mul( Vec a, Vec b )				{ return vmulq_f32( a, b ); }
+};
+
+template<>
+struct NeonLanes<double> {
+	typedef double Scalar;
+	typedef float64x2_t Vec;
+	static const size_t NUM_LANES = 2;
+
+	static Vec load( const double *p )			{ return vld1q_f64( p ); }
+	static void store( double *p, Vec v )		{ vst1q_f64( p, v ); }
+	static Vec add( Vec a, Vec b )				{ return vaddq_f64( a, b ); }
+	static Vec sub( Vec a, Vec b )				{ return vsubq_f64( a, b ); }
+	static Vec mul( Vec a, Vec b )				{ return vmulq_f64( a, b ); }
+};
+
+#endif
+
+// Runs one section over numFrames interleaved frames of L::NUM_LANES channels. The recurrence is evaluated in the same order as
+// Biquad::process(), and without fused multiply-adds, so each lane computes exactly what it does. When ramping, the coefficients are
+// advanced by their step before each frame. The body is shared by processSection() and processSectionAvx2(), as the latter has to be
+// compiled for AVX2 separately and a call from it into a template compiled without AVX2 could not be inlined.
+#define CINDER_AUDIO_BIQUAD_PROCESS_SECTION( L ) \
+	typedef typename L::Vec Vec; \
+	const size_t numLanes = L::NUM_LANES; \
+\
+	Vec b0 = L::load( section + B0 * stride ), b1 = L::load( section + B1 * stride ), b2 = L::load( section + B2 * stride ); \
+	Vec a1 = L::load( section + A1 * stride ), a2 = L::load( section + A2 * stride ); \
+	Vec x1 = L::load( section + X1 * stride ), x2 = L::load( section + X2 * stride ); \
+	Vec y1 = L::load( section + Y1 * stride ), y2 = L::load( section + Y2 * stride ); \
+\
+	if( ramp ) { \
+		const Vec stepB0 = L::load( section + STEP_B0 * stride ), stepB1 = L::load( section + STEP_B1 * stride ), stepB2 = L::load( section + STEP_B2 * stride ); \
+		const Vec stepA1 = L::load( section + STEP_A1 * stride ), stepA2 = L::load( section + STEP_A2 * stride ); \
+		for( size_t i = 0; i < numFrames; i++ ) { \
+			b0 = L::add( b0, stepB0 ); \
+			b1 = L::add( b1, stepB1 ); \
+			b2 = L::add( b2, stepB2 ); \
+			a1 = L::add( a1, stepA1 ); \
+			a2 = L::add( a2, stepA2 ); \
+\
+			const Vec x = L::load( frames + i * numLanes ); \
+			const Vec y = L::sub( L::sub( L::add( L::add( L::mul( b0, x ), L::mul( b1, x1 ) ), L::mul( b2, x2 ) ), L::mul( a1, y1 ) ), L::mul( a2, y2 ) ); \
+			L::store( frames + i * numLanes, y ); \
+			x2 = x1; \
+			x1 = x; \
+			y2 = y1; \
+			y1 = y; \
+		} \
+\
+		L::store( section + B0 * stride, b0 ); \
+		L::store( section + B1 * stride, b1 ); \
+		L::store( section + B2 * stride, b2 ); \
+		L::store( section + A1 * stride, a1 ); \
+		L::store( section + A2 * stride, a2 ); \
+	} \
+	else { \
+		for( size_t i = 0; i < numFrames; i++ ) { \
+			const Vec x = L::load( frames + i * numLanes ); \
+			const Vec y = L::sub( L::sub( L::add( L::add( L::mul( b0, x ), L::mul( b1, x1 ) ), L::mul( b2, x2 ) ), L::mul( a1, y1 ) ), L::mul( a2, y2 ) ); \
+			L::store( frames + i * numLanes, y ); \
+			x2 = x1; \
+			x1 = x; \
+			y2 = y1; \
+			y1 = y; \
+		} \
+	} \
+\
+	L::store( section + X1 * stride, x1 ); \
+	L::store( section + X2 * stride, x2 ); \
+	L::store( section + Y1 * stride, y1 ); \
+	L::store( section + Y2 * stride, y2 );
+
+template<typename LanesT>
+void processSection( typename LanesT::Scalar *frames, size_t numFrames, typename LanesT::Scalar *section, size_t stride, bool ramp )
+{
+	CINDER_AUDIO_BIQUAD_PROCESS_SECTION( LanesT )
+}
+
+#if defined( CINDER_AUDIO_BIQUAD_SSE )
+
+template<typename T>
+CINDER_AUDIO_BIQUAD_AVX2_TARGET
+void processSectionAvx2( T *frames, size_t numFrames, T *section, size_t stride, bool ramp )
+{
+	CINDER_AUDIO_BIQUAD_PROCESS_SECTION( Avx2Lanes<T> )
+}
+
+#endif
+
+#undef CINDER_AUDIO_BIQUAD_PROCESS_SECTION
+
+// Returns the widest group of channels that can be processed at once
+template<typename T>
+size_t getSimdLanes()
+{
+#if defined( CINDER_AUDIO_BIQUAD_SSE )
+	if( hasBiquadAvx2() )
+		return Avx2Lanes<T>::NUM_LANES;
+	return SseLanes<T>::NUM_LANES;
+#elif defined( CINDER_AUDIO_BIQUAD_NEON )
+	return NeonLanes<T>::NUM_LANES;
+#else
+	return 1;
+#endif
+}
+
+template<typename T>
+void processSectionSimd( T *frames, size_t numFrames, size_t numLanes, T *section, size_t stride, bool ramp )
+{
+#if defined( CINDER_AUDIO_BIQUAD_SSE )
+	if( numLanes == Avx2Lanes<T>::NUM_LANES )
+		processSectionAvx2( frames, numFrames, section, stride, ramp );
+	else
+		processSection<SseLanes<T> >( frames, numFrames, section, stride, ramp );
+#elif defined( CINDER_AUDIO_BIQUAD_NEON )
+	processSection<NeonLanes<T> >( frames, numFrames, section, stride, ramp );
+#else
+	processSection<ScalarLanes<T> >( frames, numFrames, section, stride, ramp );
+#endif
+}
+
+} // anonymous namespace
+
+template<typename T>
+BiquadBankT<T>::BiquadBankT( size_t numChannels, size_t numSections )
+	: mNumChannels( numChannels ), mNumSections( numSections ), mNumLanes( getSimdLanes<T>() ), mSmoothingEnabled( true ), mCoefficientsDirty( false )
+{
+	mNumGroups = ( mNumChannels + mNumLanes - 1 ) / mNumLanes;
+	mSections.resize( mNumGroups * mNumSections * NUM_SECTION_ROWS * MAX_LANES, 0 );
+	mFrames.resize( kChunkSize * mNumLanes );
+
+	// Initialize as pass-thru, leaving the lanes past the last channel at zero
+	for( size_t section = 0; section < mNumSections; section++ )
+		setCoefficients( section, Biquad::Coefficients{ 1, 0, 0, 0, 0 } );
+
+	applyTargets();
+}
+
+template<typename T>
+T* BiquadBankT<T>::getSection( size_t group, size_t section )
+{
+	return &mSections[( group * mNumSections + section ) * NUM_SECTION_ROWS * MAX_LANES];
+}
+
+template<typename T>
+void BiquadBankT<T>::setCoefficients( size_t channel, size_t section, const Biquad::Coefficients &coefficients )
+{
+	CI_ASSERT( channel < mNumChannels && section < mNumSections );
+
+	T *rows = getSection( channel / mNumLanes, section );
+	const size_t lane = channel % mNumLanes;
+	rows[TARGET_B0 * MAX_LANES + lane] = (T)coefficients.mB0;
+	rows[TARGET_B1 * MAX_LANES + lane] = (T)coefficients.mB1;
+	rows[TARGET_B2 * MAX_LANES + lane] = (T)coefficients.mB2;
+	rows[TARGET_A1 * MAX_LANES + lane] = (T)coefficients.mA1;
+	rows[TARGET_A2 * MAX_LANES + lane] = (T)coefficients.mA2;
+
+	mCoefficientsDirty = true;
+}
+
+template<typename T>
+void BiquadBankT<T>::setCoefficients( size_t section, const Biquad::Coefficients &coefficients )
+{
+	for( size_t ch = 0; ch < mNumChannels; ch++ )
+		setCoefficients( ch, section, coefficients );
+}
+
+template<typename T>
+void BiquadBankT<T>::applyTargets()
+{
+	for( size_t group = 0; group < mNumGroups; group++ ) {
+		for( size_t section = 0; section < mNumSections; section++ ) {
+			T *rows = getSection( group, section );
+			std::copy( rows + TARGET_B0 * MAX_LANES, rows + ( TARGET_B0 + kNumCoefficients ) * MAX_LANES, rows + B0 * MAX_LANES );
+		}
+	}
+
+	mCoefficientsDirty = false;
+}
+
+template<typename T>
+void BiquadBankT<T>::reset()
+{
+	for( size_t group = 0; group < mNumGroups; group++ ) {
+		for( size_t section = 0; section < mNumSections; section++ ) {
+			T *rows = getSection( group, section );
+			std::fill( rows + X1 * MAX_LANES, rows + NUM_SECTION_ROWS * MAX_LANES, (T)0 );
+		}
+	}
+
+	applyTargets();
+}
+
+template<typename T>
+void BiquadBankT<T>::process( Buffer *buffer, size_t numFrames )
+{
+	CI_ASSERT( buffer->getNumChannels() >= mNumChannels && buffer->getNumFrames() >= numFrames );
+
+	if( ! numFrames )
+		return;
+
+	// coefficient changes are ramped in so that they are reached on the last frame
+	const bool ramp = mCoefficientsDirty && mSmoothingEnabled;
+	if( ramp ) {
+		const T framesInverse = (T)1 / (T)numFrames;
+		for( size_t group = 0; group < mNumGroups; group++ ) {
+			for( size_t section = 0; section < mNumSections; section++ ) {
+				T *rows = getSection( group, section );
+				for( size_t i = 0; i < kNumCoefficients * MAX_LANES; i++ )
+					rows[STEP_B0 * MAX_LANES + i] = ( rows[TARGET_B0 * MAX_LANES + i] - rows[B0 * MAX_LANES + i] ) * framesInverse;
+			}
+		}
+	}
+	else if( mCoefficientsDirty )
+		applyTargets();
+
+	T *frames = mFrames.data();
+	for( size_t group = 0; group < mNumGroups; group++ ) {
+		const size_t firstChannel = group * mNumLanes;
+		const size_t numGroupChannels = std::min( mNumLanes, mNumChannels - firstChannel );
+
+		for( size_t offset = 0; offset < numFrames; offset += kChunkSize ) {
+			const size_t numChunkFrames = std::min( kChunkSize, numFrames - offset );
+
+			// interleave the channels of the group, leaving the unused lanes at zero
+			if( numGroupChannels < mNumLanes )
+				std::fill( frames, frames + numChunkFrames * mNumLanes, (T)0 );
+			for( size_t lane = 0; lane < numGroupChannels; lane++ ) {
+				const float *channel = buffer->getChannel( firstChannel + lane ) + offset;
+				for( size_t i = 0; i < numChunkFrames; i++ )
+					frames[i * mNumLanes + lane] = (T)channel[i];
+			}
+
+			for( size_t section = 0; section < mNumSections; section++ )
+				processSectionSimd( frames, numChunkFrames, mNumLanes, getSection( group, section ), (size_t)MAX_LANES, ramp );
+
+			for( size_t lane = 0; lane < numGroupChannels; lane++ ) {
+				float *channel = buffer->getChannel( firstChannel + lane ) + offset;
+				for( size_t i = 0; i < numChunkFrames; i++ )
+					channel[i] = (float)frames[i * mNumLanes + lane];
+			}
+		}
+	}
+
+	// the ramps can fall short of the targets by rounding errors, so land on them exactly
+	if( ramp )
+		applyTargets();
+}
+
+template class CI_API BiquadBankT<float>;
+template class CI_API BiquadBankT<double>;
+
 } } } // namespace cinder::audio::dsp
\ No newline at end of file
@@ -26,10 +26,26 @@
 #include "cinder/audio/dsp/ConverterR8brain.h"
 #include "cinder/CinderAssert.h"
 
+#include "cinder/System.h"
+
 #if defined( CINDER_COCOA )
 	#include "cinder/audio/cocoa/CinderCoreAudio.h"
 #endif
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_AUDIO_CONVERTER_SSE
+	#include <immintrin.h>
+	// the 256-bit kernels are compiled for AVX2 explicitly and chosen at runtime, the 128-bit ones only need SSE2
+	#if defined( __AVX2__ ) || defined( _MSC_VER )
+		#define CINDER_AUDIO_CONVERTER_AVX2_TARGET
+	#else
+		#define CINDER_AUDIO_CONVERTER_AVX2_TARGET __attribute__(( target( "avx2" ) ))
+	#endif
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_AUDIO_CONVERTER_NEON
+	#include <arm_neon.h>
+#endif
+
 #include <algorithm>
 
 using namespace ci;
@@ -134,4 +150,500 @@ void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer, size_t numFrame
 		CI_ASSERT_NOT_REACHABLE();
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Sample format conversions
+// ----------------------------------------------------------------------------------------------------
+
+namespace {
+
+const float sInt16Normalizer = 32768.0f;
+const float sFloatInt16Normalizer = 3.0517578125e-05f;	// 1.0 / 32768.0
+const float sInt24Normalizer = 8388607.0f;
+const float sFloatInt24Normalizer = 1.0f / 8388607.0f;
+
+inline int16_t floatToInt16( float sample )
+{
+	return (int16_t)detail::floatToInt( sample, sInt16Normalizer, -32768.0f, 32767.0f );
+}
+
+inline void floatToInt24( float sample, char *dest )
+{
+	const int32_t s = detail::floatToInt( sample, sInt24Normalizer, -8388608.0f, 8388607.0f );
+	dest[0] = (char)( s & 255 );
+	dest[1] = (char)( ( s >> 8 ) & 255 );
+	dest[2] = (char)( ( s >> 16 ) & 255 );
+}
+
+inline float int24ToFloat( const char *source )
+{
+	const int32_t s = ( (int32_t)(int8_t)source[2] << 16 ) | ( (int32_t)(uint8_t)source[1] << 8 ) | (int32_t)(uint8_t)source[0];
+	return (float)s * sFloatInt24Normalizer;
+}
+
+// The SIMD kernels below convert the leading blocks of samples or frames and return how many they converted, leaving the remainder to the
+// scalar loops. Each computes exactly what the scalar conversions above do.
+
+#if defined( CINDER_AUDIO_CONVERTER_SSE )
+
+bool hasConverterAvx2()
+{
+	static const bool sHasAvx2 = System::hasAvx2();
+	return sHasAvx2;
+}
+
+inline __m128i floatToInt32Sse( __m128 samples, __m128 normalizer, __m128 lo, __m128 hi )
+{
+	return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_mul_ps( samples, normalizer ), lo ), hi ) );
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+inline __m256i floatToInt32Avx2( __m256 samples, __m256 normalizer, __m256 lo, __m256 hi )
+{
+	return _mm256_cvttps_epi32( _mm256_min_ps( _mm256_max_ps( _mm256_mul_ps( samples, normalizer ), lo ), hi ) );
+}
+
+size_t convertFloatToInt16Sse( const float *source, int16_t *dest, size_t length )
+{
+	const __m128 normalizer = _mm_set1_ps( sInt16Normalizer ), lo = _mm_set1_ps( -32768.0f ), hi = _mm_set1_ps( 32767.0f );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m128i a = floatToInt32Sse( _mm_loadu_ps( source + i ), normalizer, lo, hi );
+		const __m128i b = floatToInt32Sse( _mm_loadu_ps( source + i + 4 ), normalizer, lo, hi );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( dest + i ), _mm_packs_epi32( a, b ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t convertFloatToInt16Avx2( const float *source, int16_t *dest, size_t length )
+{
+	const __m256 normalizer = _mm256_set1_ps( sInt16Normalizer ), lo = _mm256_set1_ps( -32768.0f ), hi = _mm256_set1_ps( 32767.0f );
+	size_t i = 0;
+	for( ; i + 16 <= length; i += 16 ) {
+		const __m256i a = floatToInt32Avx2( _mm256_loadu_ps( source + i ), normalizer, lo, hi );
+		const __m256i b = floatToInt32Avx2( _mm256_loadu_ps( source + i + 8 ), normalizer, lo, hi );
+		// packs works within 128-bit lanes, leaving the quarters in a0 b0 a1 b1 order
+		const __m256i packed = _mm256_permute4x64_epi64( _mm256_packs_epi32( a, b ), _MM_SHUFFLE( 3, 1, 2, 0 ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( dest + i ), packed );
+	}
+	return i;
+}
+
+size_t convertInt16ToFloatSse( const int16_t *source, float *dest, size_t length )
+{
+	const __m128 normalizer = _mm_set1_ps( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i *>( source + i ) );
+		// place each sample in the upper half of a 32-bit lane, then sign extend it with an arithmetic shift
+		const __m128i a = _mm_srai_epi32( _mm_unpacklo_epi16( s, s ), 16 );
+		const __m128i b = _mm_srai_epi32( _mm_unpackhi_epi16( s, s ), 16 );
+		_mm_storeu_ps( dest + i, _mm_mul_ps( _mm_cvtepi32_ps( a ), normalizer ) );
+		_mm_storeu_ps( dest + i + 4, _mm_mul_ps( _mm_cvtepi32_ps( b ), normalizer ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t convertInt16ToFloatAvx2( const int16_t *source, float *dest, size_t length )
+{
+	const __m256 normalizer = _mm256_set1_ps( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m256i s = _mm256_cvtepi16_epi32( _mm_loadu_si128( reinterpret_cast<const __m128i *>( source + i ) ) );
+		_mm256_storeu_ps( dest + i, _mm256_mul_ps( _mm256_cvtepi32_ps( s ), normalizer ) );
+	}
+	return i;
+}
+
+// 24-bit samples are gathered and scattered with byte shuffles, which need SSSE3. That is implied by AVX2, so they have no SSE2 version.
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t convertInt24ToFloatAvx2( const char *source, float *dest, size_t length )
+{
+	// moves the 3 bytes of each of 4 samples to the top of a 32-bit lane, from where an arithmetic shift sign extends them
+	const __m256i gather = _mm256_setr_epi8( -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11 );
+	const __m256 normalizer = _mm256_set1_ps( sFloatInt24Normalizer );
+	size_t i = 0;
+	// each block of 8 samples loads 16 bytes at an offset of 12 and so reads 4 bytes past its end, which must still be within the source
+	for( ; ( i + 8 ) * 3 + 4 <= length * 3; i += 8 ) {
+		const char *block = source + i * 3;
+		const __m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i *>( block ) );
+		const __m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i *>( block + 12 ) );
+		const __m256i s = _mm256_srai_epi32( _mm256_shuffle_epi8( _mm256_inserti128_si256( _mm256_castsi128_si256( lo ), hi, 1 ), gather ), 8 );
+		_mm256_storeu_ps( dest + i, _mm256_mul_ps( _mm256_cvtepi32_ps( s ), normalizer ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t convertFloatToInt24Avx2( const float *source, char *dest, size_t length )
+{
+	// drops the top byte of each 32-bit sample, then moves the 12 bytes left in the upper 128-bit lane down next to those of the lower one
+	const __m256i scatter = _mm256_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1, 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+	const __m256i compact = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 3, 7 );
+	const __m256 normalizer = _mm256_set1_ps( sInt24Normalizer ), lo = _mm256_set1_ps( -8388608.0f ), hi = _mm256_set1_ps( 8388607.0f );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m256i s = floatToInt32Avx2( _mm256_loadu_ps( source + i ), normalizer, lo, hi );
+		const __m256i packed = _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( s, scatter ), compact );
+		char *block = dest + i * 3;
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( block ), _mm256_castsi256_si128( packed ) );
+		_mm_storel_epi64( reinterpret_cast<__m128i *>( block + 16 ), _mm256_extracti128_si256( packed, 1 ) );
+	}
+	return i;
+}
+
+size_t interleaveStereoSse( const float *left, const float *right, float *dest, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const __m128 l = _mm_loadu_ps( left + i ), r = _mm_loadu_ps( right + i );
+		_mm_storeu_ps( dest + i * 2, _mm_unpacklo_ps( l, r ) );
+		_mm_storeu_ps( dest + i * 2 + 4, _mm_unpackhi_ps( l, r ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t interleaveStereoAvx2( const float *left, const float *right, float *dest, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 8 <= numFrames; i += 8 ) {
+		const __m256 l = _mm256_loadu_ps( left + i ), r = _mm256_loadu_ps( right + i );
+		// unpack works within 128-bit lanes, giving frames 0, 1, 4, 5 and 2, 3, 6, 7
+		const __m256 a = _mm256_unpacklo_ps( l, r ), b = _mm256_unpackhi_ps( l, r );
+		_mm256_storeu_ps( dest + i * 2, _mm256_permute2f128_ps( a, b, 0x20 ) );
+		_mm256_storeu_ps( dest + i * 2 + 8, _mm256_permute2f128_ps( a, b, 0x31 ) );
+	}
+	return i;
+}
+
+size_t deinterleaveStereoSse( const float *source, float *left, float *right, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const __m128 a = _mm_loadu_ps( source + i * 2 ), b = _mm_loadu_ps( source + i * 2 + 4 );
+		_mm_storeu_ps( left + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+		_mm_storeu_ps( right + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t deinterleaveStereoAvx2( const float *source, float *left, float *right, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 8 <= numFrames; i += 8 ) {
+		const __m256 a = _mm256_loadu_ps( source + i * 2 ), b = _mm256_loadu_ps( source + i * 2 + 8 );
+		// shuffle works within 128-bit lanes, giving frames 0, 1, 4, 5, 2, 3, 6, 7, which are put in order as pairs
+		const __m256 l = _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ), r = _mm256_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) );
+		_mm256_storeu_ps( left + i, _mm256_castpd_ps( _mm256_permute4x64_pd( _mm256_castps_pd( l ), _MM_SHUFFLE( 3, 1, 2, 0 ) ) ) );
+		_mm256_storeu_ps( right + i, _mm256_castpd_ps( _mm256_permute4x64_pd( _mm256_castps_pd( r ), _MM_SHUFFLE( 3, 1, 2, 0 ) ) ) );
+	}
+	return i;
+}
+
+// A stereo int16 frame is a 32-bit lane with the left sample in its lower half, so frames are built and taken apart with shifts.
+
+size_t interleaveStereoInt16Sse( const float *left, const float *right, int16_t *dest, size_t numFrames )
+{
+	const __m128 normalizer = _mm_set1_ps( sInt16Normalizer ), lo = _mm_set1_ps( -32768.0f ), hi = _mm_set1_ps( 32767.0f );
+	const __m128i lowHalf = _mm_set1_epi32( 0xFFFF );
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const __m128i l = floatToInt32Sse( _mm_loadu_ps( left + i ), normalizer, lo, hi );
+		const __m128i r = floatToInt32Sse( _mm_loadu_ps( right + i ), normalizer, lo, hi );
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( dest + i * 2 ), _mm_or_si128( _mm_and_si128( l, lowHalf ), _mm_slli_epi32( r, 16 ) ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t interleaveStereoInt16Avx2( const float *left, const float *right, int16_t *dest, size_t numFrames )
+{
+	const __m256 normalizer = _mm256_set1_ps( sInt16Normalizer ), lo = _mm256_set1_ps( -32768.0f ), hi = _mm256_set1_ps( 32767.0f );
+	const __m256i lowHalf = _mm256_set1_epi32( 0xFFFF );
+	size_t i = 0;
+	for( ; i + 8 <= numFrames; i += 8 ) {
+		const __m256i l = floatToInt32Avx2( _mm256_loadu_ps( left + i ), normalizer, lo, hi );
+		const __m256i r = floatToInt32Avx2( _mm256_loadu_ps( right + i ), normalizer, lo, hi );
+		_mm256_storeu_si256( reinterpret_cast<__m256i *>( dest + i * 2 ), _mm256_or_si256( _mm256_and_si256( l, lowHalf ), _mm256_slli_epi32( r, 16 ) ) );
+	}
+	return i;
+}
+
+size_t deinterleaveStereoInt16Sse( const int16_t *source, float *left, float *right, size_t numFrames )
+{
+	const __m128 normalizer = _mm_set1_ps( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i *>( source + i * 2 ) );
+		_mm_storeu_ps( left + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_srai_epi32( _mm_slli_epi32( s, 16 ), 16 ) ), normalizer ) );
+		_mm_storeu_ps( right + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_srai_epi32( s, 16 ) ), normalizer ) );
+	}
+	return i;
+}
+
+CINDER_AUDIO_CONVERTER_AVX2_TARGET
+size_t deinterleaveStereoInt16Avx2( const int16_t *source, float *left, float *right, size_t numFrames )
+{
+	const __m256 normalizer = _mm256_set1_ps( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 8 <= numFrames; i += 8 ) {
+		const __m256i s = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( source + i * 2 ) );
+		_mm256_storeu_ps( left + i, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_srai_epi32( _mm256_slli_epi32( s, 16 ), 16 ) ), normalizer ) );
+		_mm256_storeu_ps( right + i, _mm256_mul_ps( _mm256_cvtepi32_ps( _mm256_srai_epi32( s, 16 ) ), normalizer ) );
+	}
+	return i;
+}
+
+size_t convertFloatToInt16Simd( const float *source, int16_t *dest, size_t length )
+{
+	return hasConverterAvx2() ? convertFloatToInt16Avx2( source, dest, length ) : convertFloatToInt16Sse( source, dest, length );
+}
+
+size_t convertInt16ToFloatSimd( const int16_t *source, float *dest, size_t length )
+{
+	return hasConverterAvx2() ? convertInt16ToFloatAvx2( source, dest, length ) : convertInt16ToFloatSse( source, dest, length );
+}
+
+size_t convertInt24ToFloatSimd( const char *source, float *dest, size_t length )
+{
+	return hasConverterAvx2() ? convertInt24ToFloatAvx2( source, dest, length ) : 0;
+}
+
+size_t convertFloatToInt24Simd( const float *source, char *dest, size_t length )
+{
+	return hasConverterAvx2() ? convertFloatToInt24Avx2( source, dest, length ) : 0;
+}
+
+size_t interleaveStereoSimd( const float *left, const float *right, float *dest, size_t numFrames )
+{
+	return hasConverterAvx2() ? interleaveStereoAvx2( left, right, dest, numFrames ) : interleaveStereoSse( left, right, dest, numFrames );
+}
+
+size_t deinterleaveStereoSimd( const float *source, float *left, float *right, size_t numFrames )
+{
+	return hasConverterAvx2() ? deinterleaveStereoAvx2( source, left, right, numFrames ) : deinterleaveStereoSse( source, left, right, numFrames );
+}
+
+size_t interleaveStereoSimd( const float *left, const float *right, int16_t *dest, size_t numFrames )
+{
+	return hasConverterAvx2() ? interleaveStereoInt16Avx2( left, right, dest, numFrames ) : interleaveStereoInt16Sse( left, right, dest, numFrames );
+}
+
+size_t deinterleaveStereoSimd( const int16_t *source, float *left, float *right, size_t numFrames )
+{
+	return hasConverterAvx2() ? deinterleaveStereoInt16Avx2( source, left, right, numFrames ) : deinterleaveStereoInt16Sse( source, left, right, numFrames );
+}
+
+#elif defined( CINDER_AUDIO_CONVERTER_NEON )
+
+// vcvtq_s32_f32 truncates like the scalar cast, the clamp is done with selects so that NaNs land on lo as they do there
+inline int32x4_t floatToInt32Neon( float32x4_t samples, float32x4_t normalizer, float32x4_t lo, float32x4_t hi )
+{
+	float32x4_t scaled = vmulq_f32( samples, normalizer );
+	scaled = vbslq_f32( vcgtq_f32( scaled, lo ), scaled, lo );
+	scaled = vbslq_f32( vcltq_f32( scaled, hi ), scaled, hi );
+	return vcvtq_s32_f32( scaled );
+}
+
+size_t convertFloatToInt16Simd( const float *source, int16_t *dest, size_t length )
+{
+	const float32x4_t normalizer = vdupq_n_f32( sInt16Normalizer ), lo = vdupq_n_f32( -32768.0f ), hi = vdupq_n_f32( 32767.0f );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const int32x4_t a = floatToInt32Neon( vld1q_f32( source + i ), normalizer, lo, hi );
+		const int32x4_t b = floatToInt32Neon( vld1q_f32( source + i + 4 ), normalizer, lo, hi );
+		vst1q_s16( dest + i, vcombine_s16( vmovn_s32( a ), vmovn_s32( b ) ) );
+	}
+	return i;
+}
+
+size_t convertInt16ToFloatSimd( const int16_t *source, float *dest, size_t length )
+{
+	const float32x4_t normalizer = vdupq_n_f32( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const int16x8_t s = vld1q_s16( source + i );
+		vst1q_f32( dest + i, vmulq_f32( vcvtq_f32_s32( vmovl_s16( vget_low_s16( s ) ) ), normalizer ) );
+		vst1q_f32( dest + i + 4, vmulq_f32( vcvtq_f32_s32( vmovl_s16( vget_high_s16( s ) ) ), normalizer ) );
+	}
+	return i;
+}
+
+size_t convertInt24ToFloatSimd( const char *, float *, size_t )
+{
+	return 0;
+}
+
+size_t convertFloatToInt24Simd( const float *, char *, size_t )
+{
+	return 0;
+}
+
+size_t interleaveStereoSimd( const float *left, const float *right, float *dest, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		float32x4x2_t frames;
+		frames.val[0] = vld1q_f32( left + i );
+		frames.val[1] = vld1q_f32( right + i );
+		vst2q_f32( dest + i * 2, frames );
+	}
+	return i;
+}
+
+size_t deinterleaveStereoSimd( const float *source, float *left, float *right, size_t numFrames )
+{
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const float32x4x2_t frames = vld2q_f32( source + i * 2 );
+		vst1q_f32( left + i, frames.val[0] );
+		vst1q_f32( right + i, frames.val[1] );
+	}
+	return i;
+}
+
+size_t interleaveStereoSimd( const float *left, const float *right, int16_t *dest, size_t numFrames )
+{
+	const float32x4_t normalizer = vdupq_n_f32( sInt16Normalizer ), lo = vdupq_n_f32( -32768.0f ), hi = vdupq_n_f32( 32767.0f );
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		int16x4x2_t frames;
+		frames.val[0] = vmovn_s32( floatToInt32Neon( vld1q_f32( left + i ), normalizer, lo, hi ) );
+		frames.val[1] = vmovn_s32( floatToInt32Neon( vld1q_f32( right + i ), normalizer, lo, hi ) );
+		vst2_s16( dest + i * 2, frames );
+	}
+	return i;
+}
+
+size_t deinterleaveStereoSimd( const int16_t *source, float *left, float *right, size_t numFrames )
+{
+	const float32x4_t normalizer = vdupq_n_f32( sFloatInt16Normalizer );
+	size_t i = 0;
+	for( ; i + 4 <= numFrames; i += 4 ) {
+		const int16x4x2_t frames = vld2_s16( source + i * 2 );
+		vst1q_f32( left + i, vmulq_f32( vcvtq_f32_s32( vmovl_s16( frames.val[0] ) ), normalizer ) );
+		vst1q_f32( right + i, vmulq_f32( vcvtq_f32_s32( vmovl_s16( frames.val[1] ) ), normalizer ) );
+	}
+	return i;
+}
+
+#else
+
+size_t convertFloatToInt16Simd( const float *, int16_t *, size_t )					{ return 0; }
+size_t convertInt16ToFloatSimd( const int16_t *, float *, size_t )					{ return 0; }
+size_t convertInt24ToFloatSimd( const char *, float *, size_t )						{ return 0; }
+size_t convertFloatToInt24Simd( const float *, char *, size_t )						{ return 0; }
+size_t interleaveStereoSimd( const float *, const float *, float *, size_t )		{ return 0; }
+size_t deinterleaveStereoSimd( const float *, float *, float *, size_t )			{ return 0; }
+size_t interleaveStereoSimd( const float *, const float *, int16_t *, size_t )		{ return 0; }
+size_t deinterleaveStereoSimd( const int16_t *, float *, float *, size_t )			{ return 0; }
+
+#endif
+
+} // anonymous namespace
+
+void convert( const float *sourceArray, int16_t *destArray, size_t length )
+{
+	for( size_t i = convertFloatToInt16Simd( sourceArray, destArray, length ); i < length; i++ )
+		destArray[i] = floatToInt16( sourceArray[i] );
+}
+
+void convert( const int16_t *sourceArray, float *destArray, size_t length )
+{
+	for( size_t i = convertInt16ToFloatSimd( sourceArray, destArray, length ); i < length; i++ )
+		destArray[i] = (float)sourceArray[i] * sFloatInt16Normalizer;
+}
+
+void convertInt24ToFloat( const char *sourceArray, float *destArray, size_t length )
+{
+	for( size_t i = convertInt24ToFloatSimd( sourceArray, destArray, length ); i < length; i++ )
+		destArray[i] = int24ToFloat( &sourceArray[i * 3] );
+}
+
+void convertFloatToInt24( const float *sourceArray, char *destArray, size_t length )
+{
+	for( size_t i = convertFloatToInt24Simd( sourceArray, destArray, length ); i < length; i++ )
+		floatToInt24( sourceArray[i], &destArray[i * 3] );
+}
+
+void interleave( const float *nonInterleavedSourceArray, float *interleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 )
+		copy( nonInterleavedSourceArray, nonInterleavedSourceArray + numCopyFrames, interleavedDestArray );
+	else if( numChannels == 2 ) {
+		const float *left = nonInterleavedSourceArray;
+		const float *right = nonInterleavedSourceArray + numFramesPerChannel;
+		for( size_t i = interleaveStereoSimd( left, right, interleavedDestArray, numCopyFrames ); i < numCopyFrames; i++ ) {
+			interleavedDestArray[i * 2] = left[i];
+			interleavedDestArray[i * 2 + 1] = right[i];
+		}
+	}
+	else
+		interleave<float>( nonInterleavedSourceArray, interleavedDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+}
+
+void interleave( const float *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 )
+		convert( nonInterleavedFloatSourceArray, interleavedInt16DestArray, numCopyFrames );
+	else if( numChannels == 2 ) {
+		const float *left = nonInterleavedFloatSourceArray;
+		const float *right = nonInterleavedFloatSourceArray + numFramesPerChannel;
+		for( size_t i = interleaveStereoSimd( left, right, interleavedInt16DestArray, numCopyFrames ); i < numCopyFrames; i++ ) {
+			interleavedInt16DestArray[i * 2] = floatToInt16( left[i] );
+			interleavedInt16DestArray[i * 2 + 1] = floatToInt16( right[i] );
+		}
+	}
+	else {
+		for( size_t ch = 0; ch < numChannels; ch++ ) {
+			const float *sourceChannel = &nonInterleavedFloatSourceArray[ch * numFramesPerChannel];
+			for( size_t i = 0, x = ch; i < numCopyFrames; i++, x += numChannels )
+				interleavedInt16DestArray[x] = floatToInt16( sourceChannel[i] );
+		}
+	}
+}
+
+void deinterleave( const float *interleavedSourceArray, float *nonInterleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 )
+		copy( interleavedSourceArray, interleavedSourceArray + numCopyFrames, nonInterleavedDestArray );
+	else if( numChannels == 2 ) {
+		float *left = nonInterleavedDestArray;
+		float *right = nonInterleavedDestArray + numFramesPerChannel;
+		for( size_t i = deinterleaveStereoSimd( interleavedSourceArray, left, right, numCopyFrames ); i < numCopyFrames; i++ ) {
+			left[i] = interleavedSourceArray[i * 2];
+			right[i] = interleavedSourceArray[i * 2 + 1];
+		}
+	}
+	else
+		deinterleave<float>( interleavedSourceArray, nonInterleavedDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+}
+
+void deinterleave( const int16_t *interleavedInt16SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 )
+		convert( interleavedInt16SourceArray, nonInterleavedFloatDestArray, numCopyFrames );
+	else if( numChannels == 2 ) {
+		float *left = nonInterleavedFloatDestArray;
+		float *right = nonInterleavedFloatDestArray + numFramesPerChannel;
+		for( size_t i = deinterleaveStereoSimd( interleavedInt16SourceArray, left, right, numCopyFrames ); i < numCopyFrames; i++ ) {
+			left[i] = (float)interleavedInt16SourceArray[i * 2] * sFloatInt16Normalizer;
+			right[i] = (float)interleavedInt16SourceArray[i * 2 + 1] * sFloatInt16Normalizer;
+		}
+	}
+	else
+		deinterleave<float>( interleavedInt16SourceArray, nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+}
+
+void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 )
+		convertInt24ToFloat( interleavedInt24SourceArray, nonInterleavedFloatDestArray, numCopyFrames );
+	else
+		deinterleaveInt24ToFloat<float>( interleavedInt24SourceArray, nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+}
+
 } } } // namespace cinder::audio::dsp
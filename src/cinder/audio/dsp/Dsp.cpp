@@ -27,6 +27,22 @@
 
 #if defined( CINDER_AUDIO_VDSP )
 	#include <Accelerate/Accelerate.h>
+#else
+	#include "cinder/System.h"
+
+	#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+		#define CINDER_AUDIO_DSP_SSE
+		#include <immintrin.h>
+		// the 256-bit kernels are compiled for AVX2 explicitly and chosen at runtime, the 128-bit ones only need SSE2
+		#if defined( __AVX2__ ) || defined( _MSC_VER )
+			#define CINDER_AUDIO_DSP_AVX2_TARGET
+		#else
+			#define CINDER_AUDIO_DSP_AVX2_TARGET __attribute__(( target( "avx2" ) ))
+		#endif
+	#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+		#define CINDER_AUDIO_DSP_NEON
+		#include <arm_neon.h>
+	#endif
 #endif
 
 using namespace ci;
@@ -166,65 +182,413 @@ void addMul( const float *arrayA, const float *arrayB, float scalar, float *resu
 
 #else // ! defined( CINDER_AUDIO_VDSP )
 
+namespace {
+
+// Element-wise operations, applied to single samples and to SSE, AVX or NEON registers. Each lane computes exactly what the scalar version
+// does, so results don't depend on the instruction set that ran or on where the SIMD blocks ended.
+
+struct AddOp {
+	float operator()( float a, float b ) const	{ return a + b; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a, __m128 b ) const	{ return _mm_add_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a, __m256 b ) const	{ return _mm256_add_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a, float32x4_t b ) const	{ return vaddq_f32( a, b ); }
+#endif
+};
+
+struct SubOp {
+	float operator()( float a, float b ) const	{ return a - b; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a, __m128 b ) const	{ return _mm_sub_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a, __m256 b ) const	{ return _mm256_sub_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a, float32x4_t b ) const	{ return vsubq_f32( a, b ); }
+#endif
+};
+
+struct MulOp {
+	float operator()( float a, float b ) const	{ return a * b; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a, __m128 b ) const	{ return _mm_mul_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a, __m256 b ) const	{ return _mm256_mul_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a, float32x4_t b ) const	{ return vmulq_f32( a, b ); }
+#endif
+};
+
+struct DivideOp {
+	float operator()( float a, float b ) const	{ return a / b; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a, __m128 b ) const	{ return _mm_div_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a, __m256 b ) const	{ return _mm256_div_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a, float32x4_t b ) const	{ return vdivq_f32( a, b ); }
+#endif
+};
+
+// ( a + b ) * scalar, left unfused so that it rounds like the scalar version
+struct AddMulOp {
+	AddMulOp( float scalar ) : mScalar( scalar )	{}
+
+	float operator()( float a, float b ) const	{ return ( a + b ) * mScalar; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a, __m128 b ) const	{ return _mm_mul_ps( _mm_add_ps( a, b ), _mm_set1_ps( mScalar ) ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a, __m256 b ) const	{ return _mm256_mul_ps( _mm256_add_ps( a, b ), _mm256_set1_ps( mScalar ) ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a, float32x4_t b ) const	{ return vmulq_f32( vaddq_f32( a, b ), vdupq_n_f32( mScalar ) ); }
+#endif
+
+	float mScalar;
+};
+
+// Applies OpT to an array and a scalar, which is broadcast to every lane
+template<typename OpT>
+struct ScalarOp {
+	ScalarOp( float scalar ) : mScalar( scalar )	{}
+
+	float operator()( float a ) const	{ return OpT()( a, mScalar ); }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 a ) const	{ return OpT()( a, _mm_set1_ps( mScalar ) ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 a ) const	{ return OpT()( a, _mm256_set1_ps( mScalar ) ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t a ) const	{ return OpT()( a, vdupq_n_f32( mScalar ) ); }
+#endif
+
+	float mScalar;
+};
+
+// Reductions accumulate each element with operator() and merge partial results with combine(). All start from zero.
+
+struct SumOp {
+	float operator()( float acc, float x ) const	{ return acc + x; }
+	float combine( float a, float b ) const			{ return a + b; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 acc, __m128 x ) const	{ return _mm_add_ps( acc, x ); }
+	__m128 combine( __m128 a, __m128 b ) const		{ return _mm_add_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 acc, __m256 x ) const	{ return _mm256_add_ps( acc, x ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 combine( __m256 a, __m256 b ) const		{ return _mm256_add_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t acc, float32x4_t x ) const	{ return vaddq_f32( acc, x ); }
+	float32x4_t combine( float32x4_t a, float32x4_t b ) const		{ return vaddq_f32( a, b ); }
+#endif
+};
+
+struct SumSquaresOp : public SumOp {
+	float operator()( float acc, float x ) const	{ return acc + x * x; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 acc, __m128 x ) const	{ return _mm_add_ps( acc, _mm_mul_ps( x, x ) ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 acc, __m256 x ) const	{ return _mm256_add_ps( acc, _mm256_mul_ps( x, x ) ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t acc, float32x4_t x ) const	{ return vaddq_f32( acc, vmulq_f32( x, x ) ); }
+#endif
+};
+
+// The largest element, or zero if none are positive. NaNs are skipped: maxps returns its second operand when either is a NaN, and maxnm returns the number.
+struct MaxOp {
+	float operator()( float acc, float x ) const	{ return acc < x ? x : acc; }
+	float combine( float a, float b ) const			{ return a < b ? b : a; }
+#if defined( CINDER_AUDIO_DSP_SSE )
+	__m128 operator()( __m128 acc, __m128 x ) const	{ return _mm_max_ps( x, acc ); }
+	__m128 combine( __m128 a, __m128 b ) const		{ return _mm_max_ps( a, b ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 operator()( __m256 acc, __m256 x ) const	{ return _mm256_max_ps( x, acc ); }
+	CINDER_AUDIO_DSP_AVX2_TARGET
+	__m256 combine( __m256 a, __m256 b ) const		{ return _mm256_max_ps( a, b ); }
+#elif defined( CINDER_AUDIO_DSP_NEON )
+	float32x4_t operator()( float32x4_t acc, float32x4_t x ) const	{ return vmaxnmq_f32( acc, x ); }
+	float32x4_t combine( float32x4_t a, float32x4_t b ) const		{ return vmaxnmq_f32( a, b ); }
+#endif
+};
+
+// The SIMD kernels below process the leading blocks of 8 (AVX2) or 4 (SSE2, NEON) elements and return how many they processed,
+// leaving the remainder to the scalar loops. All loads and stores are unaligned, and results may alias the sources.
+
+#if defined( CINDER_AUDIO_DSP_SSE )
+
+bool hasDspAvx2()
+{
+	static const bool sHasAvx2 = System::hasAvx2();
+	return sHasAvx2;
+}
+
+size_t fillSse( float value, float *array, size_t length )
+{
+	const __m128 v = _mm_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( array + i, v );
+	return i;
+}
+
+CINDER_AUDIO_DSP_AVX2_TARGET
+size_t fillAvx2( float value, float *array, size_t length )
+{
+	const __m256 v = _mm256_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( array + i, v );
+	return i;
+}
+
+template<typename OpT>
+size_t transformSse( const float *array, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, op( _mm_loadu_ps( array + i ) ) );
+	return i;
+}
+
+template<typename OpT>
+CINDER_AUDIO_DSP_AVX2_TARGET
+size_t transformAvx2( const float *array, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, op( _mm256_loadu_ps( array + i ) ) );
+	return i;
+}
+
+template<typename OpT>
+size_t transformSse( const float *arrayA, const float *arrayB, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, op( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+	return i;
+}
+
+template<typename OpT>
+CINDER_AUDIO_DSP_AVX2_TARGET
+size_t transformAvx2( const float *arrayA, const float *arrayB, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, op( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+	return i;
+}
+
+// Folds the lanes of acc into result, in the same order on every instruction set
+template<typename OpT>
+float combineLanes( __m128 acc, const OpT &op )
+{
+	float lanes[4];
+	_mm_storeu_ps( lanes, acc );
+	return op.combine( op.combine( lanes[0], lanes[1] ), op.combine( lanes[2], lanes[3] ) );
+}
+
+template<typename OpT>
+size_t reduceSse( const float *array, size_t length, const OpT &op, float *result )
+{
+	// two accumulators hide the latency of the dependent adds
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		acc0 = op( acc0, _mm_loadu_ps( array + i ) );
+		acc1 = op( acc1, _mm_loadu_ps( array + i + 4 ) );
+	}
+	for( ; i + 4 <= length; i += 4 )
+		acc0 = op( acc0, _mm_loadu_ps( array + i ) );
+
+	*result = combineLanes( op.combine( acc0, acc1 ), op );
+	return i;
+}
+
+template<typename OpT>
+CINDER_AUDIO_DSP_AVX2_TARGET
+size_t reduceAvx2( const float *array, size_t length, const OpT &op, float *result )
+{
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 16 <= length; i += 16 ) {
+		acc0 = op( acc0, _mm256_loadu_ps( array + i ) );
+		acc1 = op( acc1, _mm256_loadu_ps( array + i + 8 ) );
+	}
+	for( ; i + 8 <= length; i += 8 )
+		acc0 = op( acc0, _mm256_loadu_ps( array + i ) );
+
+	acc0 = op.combine( acc0, acc1 );
+	*result = combineLanes( op.combine( _mm256_castps256_ps128( acc0 ), _mm256_extractf128_ps( acc0, 1 ) ), op );
+	return i;
+}
+
+size_t fillSimd( float value, float *array, size_t length )
+{
+	return hasDspAvx2() ? fillAvx2( value, array, length ) : fillSse( value, array, length );
+}
+
+template<typename OpT>
+size_t transformSimd( const float *array, float *result, size_t length, const OpT &op )
+{
+	return hasDspAvx2() ? transformAvx2( array, result, length, op ) : transformSse( array, result, length, op );
+}
+
+template<typename OpT>
+size_t transformSimd( const float *arrayA, const float *arrayB, float *result, size_t length, const OpT &op )
+{
+	return hasDspAvx2() ? transformAvx2( arrayA, arrayB, result, length, op ) : transformSse( arrayA, arrayB, result, length, op );
+}
+
+template<typename OpT>
+size_t reduceSimd( const float *array, size_t length, const OpT &op, float *result )
+{
+	return hasDspAvx2() ? reduceAvx2( array, length, op, result ) : reduceSse( array, length, op, result );
+}
+
+#elif defined( CINDER_AUDIO_DSP_NEON )
+
+size_t fillSimd( float value, float *array, size_t length )
+{
+	const float32x4_t v = vdupq_n_f32( value );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( array + i, v );
+	return i;
+}
+
+template<typename OpT>
+size_t transformSimd( const float *array, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, op( vld1q_f32( array + i ) ) );
+	return i;
+}
+
+template<typename OpT>
+size_t transformSimd( const float *arrayA, const float *arrayB, float *result, size_t length, const OpT &op )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, op( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ) );
+	return i;
+}
+
+template<typename OpT>
+size_t reduceSimd( const float *array, size_t length, const OpT &op, float *result )
+{
+	float32x4_t acc0 = vdupq_n_f32( 0 ), acc1 = vdupq_n_f32( 0 );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		acc0 = op( acc0, vld1q_f32( array + i ) );
+		acc1 = op( acc1, vld1q_f32( array + i + 4 ) );
+	}
+	for( ; i + 4 <= length; i += 4 )
+		acc0 = op( acc0, vld1q_f32( array + i ) );
+
+	float lanes[4];
+	vst1q_f32( lanes, op.combine( acc0, acc1 ) );
+	*result = op.combine( op.combine( lanes[0], lanes[1] ), op.combine( lanes[2], lanes[3] ) );
+	return i;
+}
+
+#else
+
+size_t fillSimd( float, float *, size_t )
+{
+	return 0;
+}
+
+template<typename OpT>
+size_t transformSimd( const float *, float *, size_t, const OpT & )
+{
+	return 0;
+}
+
+template<typename OpT>
+size_t transformSimd( const float *, const float *, float *, size_t, const OpT & )
+{
+	return 0;
+}
+
+template<typename OpT>
+size_t reduceSimd( const float *, size_t, const OpT &, float * )
+{
+	return 0;
+}
+
+#endif
+
+template<typename OpT>
+void transform( const float *array, float *result, size_t length, const OpT &op )
+{
+	for( size_t i = transformSimd( array, result, length, op ); i < length; i++ )
+		result[i] = op( array[i] );
+}
+
+template<typename OpT>
+void transform( const float *arrayA, const float *arrayB, float *result, size_t length, const OpT &op )
+{
+	for( size_t i = transformSimd( arrayA, arrayB, result, length, op ); i < length; i++ )
+		result[i] = op( arrayA[i], arrayB[i] );
+}
+
+template<typename OpT>
+float reduce( const float *array, size_t length, const OpT &op )
+{
+	float result = 0;
+	for( size_t i = reduceSimd( array, length, op, &result ); i < length; i++ )
+		result = op( result, array[i] );
+	return result;
+}
+
+} // anonymous namespace
+
 void fill( float value, float *array, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
+	for( size_t i = fillSimd( value, array, length ); i < length; i++ )
 		array[i] = value;
 }
 
 float sum( const float *array, size_t length )
 {
-	float result( 0.0f );
-	for( size_t i = 0; i < length; i++ )
-		result += array[i];
-	return result;
+	return reduce( array, length, SumOp() );
 }
 
 void add( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] + scalar;
+	transform( array, result, length, ScalarOp<AddOp>( scalar ) );
 }
 
 void add( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] + arrayB[i];
+	transform( arrayA, arrayB, result, length, AddOp() );
 }
 
 void sub( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] - scalar;
+	transform( array, result, length, ScalarOp<SubOp>( scalar ) );
 }
 
 void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] - arrayB[i];
+	transform( arrayA, arrayB, result, length, SubOp() );
 }
 
 float rms( const float *array, size_t length )
 {
-	float sumSquared( 0.0f );
-	for( size_t i = 0; i < length; i++ ) {
-		float val = array[i];
-		sumSquared += val * val;
-	}
-
+	const float sumSquared = reduce( array, length, SumSquaresOp() );
 	return math<float>::sqrt( sumSquared / (float)length );
 }
 
 void mul( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] * scalar;
+	transform( array, result, length, ScalarOp<MulOp>( scalar ) );
 }
 
 void mul( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] * arrayB[i];
+	transform( arrayA, arrayB, result, length, MulOp() );
 }
 
 void divide( const float *array, float scalar, float *result, size_t length )
@@ -234,25 +598,27 @@ void divide( const float *array, float scalar, float *result, size_t length )
 
 void divide( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] / arrayB[i];
+	transform( arrayA, arrayB, result, length, DivideOp() );
 }
 
 void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+	transform( arrayA, arrayB, result, length, AddMulOp( scalar ) );
 }
 
 #endif // ! defined( CINDER_AUDIO_VDSP )
 
 void normalize( float *array, size_t length, float maxValue )
 {
+#if defined( CINDER_AUDIO_VDSP )
 	float max = 0;
 	for( size_t i = 0; i < length; i++ ) {
 		if( max < array[i] )
 			max = array[i];
 	}
+#else
+	const float max = reduce( array, length, MaxOp() );
+#endif
 
 	if( max > 0.00001f ) {
 		mul( array, maxValue / max, array, length );
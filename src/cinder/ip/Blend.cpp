@@ -23,6 +23,19 @@
 
 #include "cinder/ip/Blend.h"
 #include "cinder/ip/Fill.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/System.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_BLEND_SSE2
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_BLEND_NEON
+	#include <arm_neon.h>
+#endif
 
 using namespace std;
 
@@ -33,206 +46,345 @@ namespace cinder { namespace ip {
 	αr×Cr =  [(1–αs)×αd×Cd]+[(1–αd)×αs×Cs]+[αd×αs×B(Cd,Cs)]			Unpremult * Unpremult
 	   Cr = [[(1–αs)×αd×Cd]+[(1–αd)×αs×Cs]+[αd×αs×B(Cd,Cs)]]/αr
 	αr×Cr = (1–αs)×Cd + (1–αd)×Cs + B(Cd, αd, Cs, αs)				Premult * Premult
+
+	Every mode is computed on premultiplied colors normalized to [0,1], where the alpha channel follows the same
+	formula as the color channels. Unpremultiplied inputs are premultiplied on load and unpremultiplied outputs are
+	divided by αr on store. The arithmetic is done by an "ops" struct, whose VecT holds one pixel: scalar ops for any
+	channel order, and SIMD ops when the foreground and background share a 4-channel layout.
 */
 
-template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
-void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Area &srcArea, ivec2 absOffset )
+namespace {
+
+template<BlendMode MODE, typename OPS>
+inline typename OPS::VecT blendPremultiplied( const OPS &ops, typename OPS::VecT s, typename OPS::VecT d )
 {
-	bool SRCALPHA = foreground.hasAlpha();
-	const ptrdiff_t srcRowBytes = foreground.getRowBytes();
-	const uint8_t sR = foreground.getChannelOrder().getRedOffset();
-	const uint8_t sG = foreground.getChannelOrder().getGreenOffset();
-	const uint8_t sB = foreground.getChannelOrder().getBlueOffset();
-	const uint8_t sA = SRCALPHA ? (foreground.getChannelOrder().getAlphaOffset()) : 0;	
-	const uint8_t srcInc = foreground.getPixelInc();
-	const ptrdiff_t dstRowBytes = background->getRowBytes();
-	const uint8_t dR = background->getChannelOrder().getRedOffset();
-	const uint8_t dG = background->getChannelOrder().getGreenOffset();
-	const uint8_t dB = background->getChannelOrder().getBlueOffset();
-	const uint8_t dA = DSTALPHA ? (background->getChannelOrder().getAlphaOffset()) : 0;
-	const uint8_t dstInc = background->getPixelInc();
-	const int32_t width = srcArea.getWidth();
-	
-	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
-		ivec2 relativeOffset = absOffset - srcArea.getUL();
-		background->copyFrom( foreground, srcArea, relativeOffset );
-		if( DSTALPHA )
-			ip::fill( &background->getChannelAlpha(), (uint8_t)255 );
-		return;
-	}
-	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const uint8_t *src = reinterpret_cast<const uint8_t*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		uint8_t *dst = reinterpret_cast<uint8_t*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const uint8_t alphaS = (SRCALPHA) ? src[sA] : 255;
-			const uint8_t invAlphaS = (SRCALPHA) ? CHANTRAIT<uint8_t>::inverse(src[sA]) : 0;
-			const uint8_t alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<uint8_t>::max();
-			const uint8_t invAlphaD = (DSTALPHA) ? CHANTRAIT<uint8_t>::inverse(dst[dA]) : 0;
-			if( DSTALPHA )
-				dst[dA] = 255 - invAlphaS * invAlphaD / 255;			
-			if( ( ! DSTALPHA ) || dst[dA] ) {
-				if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
-					dst[dR] = ( invAlphaS * dst[dR] + alphaS * src[sR] ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + alphaS * src[sG] ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + alphaS * src[sB] ) / 255;
-				}			
-				else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
-					dst[dR] = invAlphaS * dst[dR] / 255 + src[sR];
-					dst[dG] = invAlphaS * dst[dG] / 255 + src[sG];
-					dst[dB] = invAlphaS * dst[dB] / 255 + src[sB];
-				}
-				else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / ( 255 * dst[dA] );
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / ( 255 * dst[dA] );
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / ( 255 * dst[dA] );
-				}
-				else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] / 255 + invAlphaD * src[sR] + alphaD * src[sR] ) / dst[dA];
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] / 255 + invAlphaD * src[sG] + alphaD * src[sG] ) / dst[dA];
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] / 255 + invAlphaD * src[sB] + alphaD * src[sB] ) / dst[dA];
-				}
-				else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
-					dst[dR] = ( invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) / 255;
-				}
-				else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
-					dst[dR] = ( invAlphaS * dst[dR] + ( invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) / 255 ) / 255;
-					dst[dG] = ( invAlphaS * dst[dG] + ( invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) / 255 ) / 255;
-					dst[dB] = ( invAlphaS * dst[dB] + ( invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) / 255 ) / 255;
-				}
-			}
-			src += srcInc;
-			dst += dstInc;
-		}
+	switch( MODE ) {
+		case BLEND_ADD:
+			return ops.min( ops.add( s, d ), ops.one() );
+		case BLEND_MULTIPLY:
+			return ops.add( ops.add( ops.mul( s, ops.sub( ops.one(), ops.alpha( d ) ) ), ops.mul( d, ops.sub( ops.one(), ops.alpha( s ) ) ) ), ops.mul( s, d ) );
+		case BLEND_SCREEN:
+			return ops.sub( ops.add( s, d ), ops.mul( s, d ) );
+		case BLEND_NORMAL:
+		default:
+			return ops.add( s, ops.mul( d, ops.sub( ops.one(), ops.alpha( s ) ) ) );
 	}
 }
 
-template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
-void blendImpl_float( Surface32f *background, const Surface32f &foreground, const Area &srcArea, ivec2 absOffset )
+template<typename OPS, BlendMode MODE, bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
+void blendRow( const OPS &ops, const typename OPS::ElemT *src, typename OPS::ElemT *dst, int32_t width )
 {
-	bool SRCALPHA = foreground.hasAlpha();
-	const ptrdiff_t srcRowBytes = foreground.getRowBytes();
-	const uint8_t sR = foreground.getChannelOrder().getRedOffset();
-	const uint8_t sG = foreground.getChannelOrder().getGreenOffset();
-	const uint8_t sB = foreground.getChannelOrder().getBlueOffset();
-	const uint8_t sA = SRCALPHA ? (foreground.getChannelOrder().getAlphaOffset()) : 0;	
-	const uint8_t srcInc = foreground.getPixelInc();
-	const ptrdiff_t dstRowBytes = background->getRowBytes();
-	const uint8_t dR = background->getChannelOrder().getRedOffset();
-	const uint8_t dG = background->getChannelOrder().getGreenOffset();
-	const uint8_t dB = background->getChannelOrder().getBlueOffset();
-	const uint8_t dA = DSTALPHA ? (background->getChannelOrder().getAlphaOffset()) : 0;
-	const uint8_t dstInc = background->getPixelInc();	
-	const int32_t width = srcArea.getWidth();
-	
-	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
-		ivec2 relativeOffset = absOffset - srcArea.getUL();
-		background->copyFrom( foreground, srcArea, relativeOffset );
-		if( DSTALPHA )
-			ip::fill( &background->getChannelAlpha(), 1.0f );
-		return;
+	typedef typename OPS::VecT VecT;
+	for( int32_t x = 0; x < width; ++x ) {
+		VecT s = ops.loadSrc( src );
+		if( ! SRCPREMULT )
+			s = ops.premultiply( s );
+		VecT d = ops.loadDst( dst );
+		if( ! DSTALPHA )
+			d = ops.opaque( d );
+		else if( ! DSTPREMULT )
+			d = ops.premultiply( d );
+		VecT result = blendPremultiplied<MODE>( ops, s, d );
+		if( DSTALPHA && ! DSTPREMULT )
+			result = ops.unpremultiply( result );
+		ops.storeDst( dst, result );
+		src += ops.getSrcInc();
+		dst += ops.getDstInc();
 	}
-	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		float *dst = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const float alphaS = (SRCALPHA) ? src[sA] : 1;
-			const float invAlphaS = (SRCALPHA) ? CHANTRAIT<float>::inverse(src[sA]) : 0;
-			const float alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<float>::max();
-			const float invAlphaD = (DSTALPHA) ? CHANTRAIT<float>::inverse(dst[dA]) : 0;
-			if( DSTALPHA )
-				dst[dA] = 1 - invAlphaS * invAlphaD;
-			if( ( ! DSTALPHA ) || dst[dA] ) {
-				if( ! DSTALPHA && ! SRCPREMULT ) { // none * unpremult -> none
-					dst[dR] = invAlphaS * dst[dR] + alphaS * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + alphaS * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + alphaS * src[sB];
-				}			
-				else if( ! DSTALPHA && SRCPREMULT ) { // none * premult -> none
-					dst[dR] = invAlphaS * dst[dR] + src[sR];
-					dst[dG] = invAlphaS * dst[dG] + src[sG];
-					dst[dB] = invAlphaS * dst[dB] + src[sB];
-				}
-				else if( ! DSTPREMULT && ! SRCPREMULT ) { // unpremult * unpremult -> unpremult
-					float invDstA = 1.0f / dst[dA];
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR] ) * invDstA;
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG] ) * invDstA;
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB] ) * invDstA;
-				}
-				else if( ! DSTPREMULT && SRCPREMULT ) { // unpremult * premult -> unpremult
-					float invDstA = 1.0f / dst[dA];
-					dst[dR] = ( invAlphaS * alphaD * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR] ) * invDstA;
-					dst[dG] = ( invAlphaS * alphaD * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG] ) * invDstA;
-					dst[dB] = ( invAlphaS * alphaD * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB] ) * invDstA;
-				}
-				else if( DSTPREMULT && SRCPREMULT ) { // premult * premult -> premult
-					dst[dR] = invAlphaS * dst[dR] + invAlphaD * src[sR] + alphaD * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + invAlphaD * src[sG] + alphaD * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + invAlphaD * src[sB] + alphaD * src[sB];
-				}
-				else if( DSTPREMULT && ! SRCPREMULT ) { // premult * unpremult -> premult
-					dst[dR] = invAlphaS * dst[dR] + invAlphaD * alphaS * src[sR] + alphaD * alphaS * src[sR];
-					dst[dG] = invAlphaS * dst[dG] + invAlphaD * alphaS * src[sG] + alphaD * alphaS * src[sG];
-					dst[dB] = invAlphaS * dst[dB] + invAlphaD * alphaS * src[sB] + alphaD * alphaS * src[sB];
-				}
-			}
-			src += srcInc;
-			dst += dstInc;
-		}
+}
+
+template<typename OPS>
+struct BlendRowFn {
+	typedef void (*Fn)( const OPS &ops, const typename OPS::ElemT *src, typename OPS::ElemT *dst, int32_t width );
+};
+
+template<typename OPS, BlendMode MODE>
+typename BlendRowFn<OPS>::Fn selectBlendRow( bool dstAlpha, bool dstPremult, bool srcPremult )
+{
+	if( dstAlpha ) {
+		if( dstPremult )
+			return srcPremult ? &blendRow<OPS, MODE, true, true, true> : &blendRow<OPS, MODE, true, true, false>;
+		else
+			return srcPremult ? &blendRow<OPS, MODE, true, false, true> : &blendRow<OPS, MODE, true, false, false>;
 	}
+	else
+		return srcPremult ? &blendRow<OPS, MODE, false, false, true> : &blendRow<OPS, MODE, false, false, false>;
 }
 
-void blend( Surface8u *background, const Surface8u &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+template<typename OPS>
+typename BlendRowFn<OPS>::Fn selectBlendRow( BlendMode mode, bool dstAlpha, bool dstPremult, bool srcPremult )
 {
-	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );	
-	if( background->hasAlpha() ) {
-		if( background->isPremultiplied() ) {
-			if( foreground.isPremultiplied() )
-				blendImpl_u8<true, true, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_u8<true, true, false>( background, foreground, srcDst.first, srcDst.second );
-		}
-		else { // background unpremult
-			if( foreground.isPremultiplied() )
-				blendImpl_u8<true, false, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_u8<true, false, false>( background, foreground, srcDst.first, srcDst.second );
-		}
+	switch( mode ) {
+		case BLEND_ADD:			return selectBlendRow<OPS, BLEND_ADD>( dstAlpha, dstPremult, srcPremult );
+		case BLEND_MULTIPLY:	return selectBlendRow<OPS, BLEND_MULTIPLY>( dstAlpha, dstPremult, srcPremult );
+		case BLEND_SCREEN:		return selectBlendRow<OPS, BLEND_SCREEN>( dstAlpha, dstPremult, srcPremult );
+		case BLEND_NORMAL:
+		default:				return selectBlendRow<OPS, BLEND_NORMAL>( dstAlpha, dstPremult, srcPremult );
 	}
-	else { // background no alpha
-		if( foreground.isPremultiplied() )
-			blendImpl_u8<false, false, true>( background, foreground, srcDst.first, srcDst.second );
-		else
-			blendImpl_u8<false, false, false>( background, foreground, srcDst.first, srcDst.second );	
+}
+
+inline float toUnit( uint8_t v )	{ return v * ( 1.0f / 255.0f ); }
+inline float toUnit( float v )		{ return v; }
+inline void fromUnit( float v, uint8_t *result )	{ *result = static_cast<uint8_t>( std::min( std::max( v, 0.0f ), 1.0f ) * 255.0f + 0.5f ); }
+inline void fromUnit( float v, float *result )		{ *result = v; }
+
+// Handles any channel order, including a foreground without alpha and a 3-channel background
+template<typename T>
+struct BlendOpsScalar {
+	typedef T			ElemT;
+	struct VecT { float r, g, b, a; };
+
+	BlendOpsScalar( const SurfaceT<T> &src, const SurfaceT<T> &dst )
+		: mSrcR( src.getRedOffset() ), mSrcG( src.getGreenOffset() ), mSrcB( src.getBlueOffset() ), mSrcA( src.hasAlpha() ? src.getAlphaOffset() : -1 ),
+		mDstR( dst.getRedOffset() ), mDstG( dst.getGreenOffset() ), mDstB( dst.getBlueOffset() ), mDstA( dst.hasAlpha() ? dst.getAlphaOffset() : -1 ),
+		mSrcInc( src.getPixelInc() ), mDstInc( dst.getPixelInc() )
+	{}
+
+	VecT loadSrc( const T *p ) const		{ return VecT{ toUnit( p[mSrcR] ), toUnit( p[mSrcG] ), toUnit( p[mSrcB] ), ( mSrcA >= 0 ) ? toUnit( p[mSrcA] ) : 1.0f }; }
+	VecT loadDst( const T *p ) const		{ return VecT{ toUnit( p[mDstR] ), toUnit( p[mDstG] ), toUnit( p[mDstB] ), ( mDstA >= 0 ) ? toUnit( p[mDstA] ) : 1.0f }; }
+	void storeDst( T *p, const VecT &v ) const
+	{
+		fromUnit( v.r, &p[mDstR] );
+		fromUnit( v.g, &p[mDstG] );
+		fromUnit( v.b, &p[mDstB] );
+		if( mDstA >= 0 )
+			fromUnit( v.a, &p[mDstA] );
+	}
+
+	VecT one() const								{ return VecT{ 1, 1, 1, 1 }; }
+	VecT add( const VecT &a, const VecT &b ) const	{ return VecT{ a.r + b.r, a.g + b.g, a.b + b.b, a.a + b.a }; }
+	VecT sub( const VecT &a, const VecT &b ) const	{ return VecT{ a.r - b.r, a.g - b.g, a.b - b.b, a.a - b.a }; }
+	VecT mul( const VecT &a, const VecT &b ) const	{ return VecT{ a.r * b.r, a.g * b.g, a.b * b.b, a.a * b.a }; }
+	VecT min( const VecT &a, const VecT &b ) const	{ return VecT{ std::min( a.r, b.r ), std::min( a.g, b.g ), std::min( a.b, b.b ), std::min( a.a, b.a ) }; }
+	VecT alpha( const VecT &v ) const				{ return VecT{ v.a, v.a, v.a, v.a }; }
+	VecT opaque( const VecT &v ) const				{ return VecT{ v.r, v.g, v.b, 1 }; }
+	VecT premultiply( const VecT &v ) const			{ return VecT{ v.r * v.a, v.g * v.a, v.b * v.a, v.a }; }
+	VecT unpremultiply( const VecT &v ) const
+	{
+		const float invAlpha = ( v.a != 0 ) ? ( 1.0f / v.a ) : 0;
+		return VecT{ v.r * invAlpha, v.g * invAlpha, v.b * invAlpha, v.a };
+	}
+
+	int32_t getSrcInc() const		{ return mSrcInc; }
+	int32_t getDstInc() const		{ return mDstInc; }
+
+	int8_t		mSrcR, mSrcG, mSrcB, mSrcA, mDstR, mDstG, mDstB, mDstA;
+	int32_t		mSrcInc, mDstInc;
+};
+
+#if defined( CINDER_BLEND_SSE2 )
+// One pixel per __m128 in memory order, with alpha (or padding, for a background without alpha) in lane ALPHA
+template<typename T, int ALPHA>
+struct BlendOpsSse2 {
+	typedef T			ElemT;
+	typedef __m128		VecT;
+
+	BlendOpsSse2()
+		: mColorMask( _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? 0 : -1, -1, -1, ALPHA == 3 ? 0 : -1 ) ) ),
+		mAlphaOne( _mm_andnot_ps( mColorMask, _mm_set1_ps( 1.0f ) ) ), mOne( _mm_set1_ps( 1.0f ) )
+	{}
+
+	VecT loadSrc( const T *p ) const		{ return load( p ); }
+	VecT loadDst( const T *p ) const		{ return load( p ); }
+	void storeDst( T *p, VecT v ) const		{ store( p, v ); }
+
+	VecT one() const						{ return mOne; }
+	VecT add( VecT a, VecT b ) const		{ return _mm_add_ps( a, b ); }
+	VecT sub( VecT a, VecT b ) const		{ return _mm_sub_ps( a, b ); }
+	VecT mul( VecT a, VecT b ) const		{ return _mm_mul_ps( a, b ); }
+	VecT min( VecT a, VecT b ) const		{ return _mm_min_ps( a, b ); }
+	VecT alpha( VecT v ) const				{ return _mm_shuffle_ps( v, v, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ); }
+	VecT opaque( VecT v ) const				{ return _mm_or_ps( _mm_and_ps( v, mColorMask ), mAlphaOne ); }
+	VecT premultiply( VecT v ) const		{ return _mm_mul_ps( v, opaque( alpha( v ) ) ); }
+	// 1 / α is a reciprocal estimate refined by a Newton-Raphson step. Colors become 0 when α is 0
+	VecT unpremultiply( VecT v ) const
+	{
+		const __m128 a = alpha( v );
+		__m128 r = _mm_rcp_ps( a );
+		r = _mm_mul_ps( r, _mm_sub_ps( _mm_set1_ps( 2.0f ), _mm_mul_ps( a, r ) ) );
+		r = _mm_andnot_ps( _mm_cmpeq_ps( a, _mm_setzero_ps() ), r );
+		return _mm_mul_ps( v, opaque( r ) );
+	}
+
+	int32_t getSrcInc() const		{ return 4; }
+	int32_t getDstInc() const		{ return 4; }
+
+	static VecT load( const float *p )		{ return _mm_loadu_ps( p ); }
+	static void store( float *p, VecT v )	{ _mm_storeu_ps( p, v ); }
+
+	static VecT load( const uint8_t *p )
+	{
+		int32_t pixel;
+		memcpy( &pixel, p, 4 );
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i v32 = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( pixel ), zero ), zero );
+		return _mm_mul_ps( _mm_cvtepi32_ps( v32 ), _mm_set1_ps( 1.0f / 255.0f ) );
+	}
+
+	static void store( uint8_t *p, VecT v )
+	{
+		v = _mm_min_ps( _mm_max_ps( _mm_mul_ps( v, _mm_set1_ps( 255.0f ) ), _mm_setzero_ps() ), _mm_set1_ps( 255.0f ) );
+		const __m128i v32 = _mm_cvtps_epi32( v );
+		const __m128i v8 = _mm_packus_epi16( _mm_packs_epi32( v32, v32 ), v32 );
+		const int32_t pixel = _mm_cvtsi128_si32( v8 );
+		memcpy( p, &pixel, 4 );
+	}
+
+	__m128		mColorMask, mAlphaOne, mOne;
+};
+
+template<typename T, int ALPHA>
+using BlendOpsSimd = BlendOpsSse2<T, ALPHA>;
+
+#elif defined( CINDER_BLEND_NEON )
+// see BlendOpsSse2
+template<typename T, int ALPHA>
+struct BlendOpsNeon {
+	typedef T			ElemT;
+	typedef float32x4_t	VecT;
+
+	BlendOpsNeon()
+	{
+		const float alphaOne[4] = { ALPHA == 0 ? 1.0f : 0, 0, 0, ALPHA == 3 ? 1.0f : 0 };
+		mAlphaOne = vld1q_f32( alphaOne );
+		mColorMask = vceqq_f32( mAlphaOne, vdupq_n_f32( 0 ) );
+		mOne = vdupq_n_f32( 1.0f );
+	}
+
+	VecT loadSrc( const T *p ) const		{ return load( p ); }
+	VecT loadDst( const T *p ) const		{ return load( p ); }
+	void storeDst( T *p, VecT v ) const		{ store( p, v ); }
+
+	VecT one() const						{ return mOne; }
+	VecT add( VecT a, VecT b ) const		{ return vaddq_f32( a, b ); }
+	VecT sub( VecT a, VecT b ) const		{ return vsubq_f32( a, b ); }
+	VecT mul( VecT a, VecT b ) const		{ return vmulq_f32( a, b ); }
+	VecT min( VecT a, VecT b ) const		{ return vminq_f32( a, b ); }
+	VecT alpha( VecT v ) const				{ return vdupq_laneq_f32( v, ALPHA ); }
+	VecT opaque( VecT v ) const				{ return vbslq_f32( mColorMask, v, mAlphaOne ); }
+	VecT premultiply( VecT v ) const		{ return vmulq_f32( v, opaque( alpha( v ) ) ); }
+	VecT unpremultiply( VecT v ) const
+	{
+		const float32x4_t a = alpha( v );
+		float32x4_t r = vrecpeq_f32( a );
+		r = vmulq_f32( r, vrecpsq_f32( a, r ) );
+		r = vbslq_f32( vceqq_f32( a, vdupq_n_f32( 0 ) ), vdupq_n_f32( 0 ), r );
+		return vmulq_f32( v, opaque( r ) );
 	}
+
+	int32_t getSrcInc() const		{ return 4; }
+	int32_t getDstInc() const		{ return 4; }
+
+	static VecT load( const float *p )		{ return vld1q_f32( p ); }
+	static void store( float *p, VecT v )	{ vst1q_f32( p, v ); }
+
+	static VecT load( const uint8_t *p )
+	{
+		uint32_t pixel;
+		memcpy( &pixel, p, 4 );
+		const uint16x8_t v16 = vmovl_u8( vreinterpret_u8_u32( vdup_n_u32( pixel ) ) );
+		return vmulq_n_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( v16 ) ) ), 1.0f / 255.0f );
+	}
+
+	static void store( uint8_t *p, VecT v )
+	{
+		v = vminq_f32( vmaxq_f32( vmulq_n_f32( v, 255.0f ), vdupq_n_f32( 0 ) ), vdupq_n_f32( 255.0f ) );
+		const uint16x4_t v16 = vmovn_u32( vcvtnq_u32_f32( v ) );
+		const uint32_t pixel = vget_lane_u32( vreinterpret_u32_u8( vmovn_u16( vcombine_u16( v16, v16 ) ) ), 0 );
+		memcpy( p, &pixel, 4 );
+	}
+
+	float32x4_t		mAlphaOne, mOne;
+	uint32x4_t		mColorMask;
+};
+
+template<typename T, int ALPHA>
+using BlendOpsSimd = BlendOpsNeon<T, ALPHA>;
+
+#endif
+
+// Returns true when the SIMD ops are available on this machine
+bool hasBlendSimd()
+{
+#if defined( CINDER_BLEND_SSE2 )
+	static const bool sHasSse2 = System::hasSse2();
+	return sHasSse2;
+#elif defined( CINDER_BLEND_NEON )
+	return true;
+#else
+	return false;
+#endif
 }
 
-void blend( Surface32f *background, const Surface32f &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+template<typename T, typename OPS>
+void blendRows( const OPS &ops, BlendMode mode, SurfaceT<T> *background, const SurfaceT<T> &foreground, const Area &srcArea, const ivec2 &absOffset )
 {
-	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );
-	if( background->hasAlpha() ) {
-		if( background->isPremultiplied() ) {
-			if( foreground.isPremultiplied() )
-				blendImpl_float<true, true, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_float<true, true, false>( background, foreground, srcDst.first, srcDst.second );
-		}
-		else {
-			if( foreground.isPremultiplied() )
-				blendImpl_float<true, false, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_float<true, false, false>( background, foreground, srcDst.first, srcDst.second );
+	const typename BlendRowFn<OPS>::Fn rowFn = selectBlendRow<OPS>( mode, background->hasAlpha(), background->isPremultiplied(), foreground.isPremultiplied() );
+	const int32_t width = srcArea.getWidth();
+	const ptrdiff_t srcRowBytes = foreground.getRowBytes(), dstRowBytes = background->getRowBytes();
+	const uint8_t srcInc = foreground.getPixelInc(), dstInc = background->getPixelInc();
+
+	parallelRows( Area( 0, 0, width, srcArea.getHeight() ), width * ( srcInc + dstInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			const T *src = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * srcInc ) + ( srcArea.y1 + y ) * srcRowBytes );
+			T *dst = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * dstInc ) + ( y + absOffset.y ) * dstRowBytes );
+			rowFn( ops, src, dst, width );
 		}
+	} );
+}
+
+template<typename T>
+void blendImpl( SurfaceT<T> *background, const SurfaceT<T> &foreground, BlendMode mode, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );
+	const Area &area = srcDst.first;
+	const ivec2 &absOffset = srcDst.second;
+	if( area.getWidth() <= 0 || area.getHeight() <= 0 )
+		return;
+
+	if( mode == BLEND_NORMAL && ! foreground.hasAlpha() ) { // normal blend with no src alpha is a copy
+		background->copyFrom( foreground, area, absOffset - area.getUL() );
+		if( background->hasAlpha() )
+			ip::fill( &background->getChannelAlpha(), CHANTRAIT<T>::max(), Area( absOffset, absOffset + area.getSize() ) );
+		return;
 	}
-	else { // background no alpha
-		if( foreground.isPremultiplied() )
-			blendImpl_float<false, false, true>( background, foreground, srcDst.first, srcDst.second );
+
+	// the SIMD ops need matching 4-channel layouts, where the background's padding takes the place of alpha
+	const SurfaceChannelOrder &srcOrder = foreground.getChannelOrder(), &dstOrder = background->getChannelOrder();
+	const bool simdLayout = foreground.hasAlpha() && srcOrder.getPixelInc() == 4 && dstOrder.getPixelInc() == 4
+		&& srcOrder.getRedOffset() == dstOrder.getRedOffset() && srcOrder.getGreenOffset() == dstOrder.getGreenOffset() && srcOrder.getBlueOffset() == dstOrder.getBlueOffset();
+#if defined( CINDER_BLEND_SSE2 ) || defined( CINDER_BLEND_NEON )
+	if( simdLayout && hasBlendSimd() ) {
+		if( srcOrder.getAlphaOffset() == 0 )
+			blendRows( BlendOpsSimd<T, 0>(), mode, background, foreground, area, absOffset );
 		else
-			blendImpl_float<false, false, false>( background, foreground, srcDst.first, srcDst.second );	
+			blendRows( BlendOpsSimd<T, 3>(), mode, background, foreground, area, absOffset );
+		return;
 	}
+#endif
+	blendRows( BlendOpsScalar<T>( foreground, *background ), mode, background, foreground, area, absOffset );
+}
+
+} // anonymous namespace
+
+void blend( Surface8u *background, const Surface8u &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	blendImpl( background, foreground, BLEND_NORMAL, srcArea, dstRelativeOffset );
+}
+
+void blend( Surface32f *background, const Surface32f &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	blendImpl( background, foreground, BLEND_NORMAL, srcArea, dstRelativeOffset );
+}
+
+void blend( Surface8u *background, const Surface8u &foreground, BlendMode mode, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	blendImpl( background, foreground, mode, srcArea, dstRelativeOffset );
+}
+
+void blend( Surface32f *background, const Surface32f &foreground, BlendMode mode, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	blendImpl( background, foreground, mode, srcArea, dstRelativeOffset );
 }
 
 } } // namespace cinder::ip
@@ -21,9 +21,92 @@
 */
 
 #include "cinder/ip/Blur.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_BLUR_SSE2
+	#include <emmintrin.h>
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+	#define CINDER_BLUR_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip { 
 
+///////////////////////////////////////////////////////////////////////////////////
+// BlurScratch
+BlurScratch::Lease::Lease( BlurScratch *scratch, std::unique_ptr<uint8_t[]> &&storage, uint8_t *data, size_t size )
+	: mScratch( scratch ), mStorage( std::move( storage ) ), mData( data ), mSize( size )
+{
+}
+
+BlurScratch::Lease::Lease( Lease &&rhs )
+	: mScratch( rhs.mScratch ), mStorage( std::move( rhs.mStorage ) ), mData( rhs.mData ), mSize( rhs.mSize )
+{
+	rhs.mScratch = nullptr;
+}
+
+BlurScratch::Lease::~Lease()
+{
+	if( mScratch && mStorage )
+		mScratch->release( std::move( mStorage ), mData, mSize );
+}
+
+BlurScratch::Lease BlurScratch::acquire( size_t numBytes )
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		// borrow the smallest free block which is large enough
+		auto best = mFreeBlocks.end();
+		for( auto blockIt = mFreeBlocks.begin(); blockIt != mFreeBlocks.end(); ++blockIt ) {
+			if( blockIt->mSize >= numBytes && ( best == mFreeBlocks.end() || blockIt->mSize < best->mSize ) )
+				best = blockIt;
+		}
+		if( best != mFreeBlocks.end() ) {
+			Lease result( this, std::move( best->mStorage ), best->mData, best->mSize );
+			mFreeBlocks.erase( best );
+			return result;
+		}
+		// otherwise replace the largest free block, which is too small to be borrowed again for this size
+		if( ! mFreeBlocks.empty() ) {
+			auto largest = std::max_element( mFreeBlocks.begin(), mFreeBlocks.end(), []( const Block &a, const Block &b ) { return a.mSize < b.mSize; } );
+			mFreeBlocks.erase( largest );
+		}
+	}
+
+	const size_t alignment = 64;
+	std::unique_ptr<uint8_t[]> storage( new uint8_t[numBytes + alignment] );
+	uint8_t *data = reinterpret_cast<uint8_t*>( ( reinterpret_cast<uintptr_t>( storage.get() ) + alignment - 1 ) & ~uintptr_t( alignment - 1 ) );
+	return Lease( this, std::move( storage ), data, numBytes );
+}
+
+void BlurScratch::release( std::unique_ptr<uint8_t[]> &&storage, uint8_t *data, size_t size )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mFreeBlocks.push_back( Block{ std::move( storage ), data, size } );
+}
+
+void BlurScratch::clear()
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mFreeBlocks.clear();
+}
+
+size_t BlurScratch::getBytesHeld() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	size_t result = 0;
+	for( const auto &block : mFreeBlocks )
+		result += block.mSize;
+	return result;
+}
+
 namespace {
 
 template<typename T>
@@ -52,357 +135,939 @@ uint8_t getPixelDataOffset( const ChannelT<T> & /*surface*/ )
 	return 0;
 }
 
+// Scalar pixel operations for stackBlurLine(); a "vector" here is simply CHANNELS accumulators of type SUMT
+template<typename T, typename SUMT, uint8_t CHANNELS>
+struct StackBlurOpsScalar {
+	typedef T		ElemT;
+	struct VecT { SUMT v[CHANNELS]; };
+
+	StackBlurOpsScalar( SUMT divisor )
+		: mDivisor( divisor ), mInvDivisor( 1 / divisor )
+	{}
+
+	VecT zero() const							{ VecT r; for( int c = 0; c < CHANNELS; ++c ) r.v[c] = 0; return r; }
+	VecT load( const T *p ) const				{ VecT r; for( int c = 0; c < CHANNELS; ++c ) r.v[c] = p[c]; return r; }
+	VecT add( VecT a, const VecT &b ) const		{ for( int c = 0; c < CHANNELS; ++c ) a.v[c] += b.v[c]; return a; }
+	VecT sub( VecT a, const VecT &b ) const		{ for( int c = 0; c < CHANNELS; ++c ) a.v[c] -= b.v[c]; return a; }
+	VecT mulAdd( VecT a, const VecT &b, int32_t s ) const	{ for( int c = 0; c < CHANNELS; ++c ) a.v[c] += b.v[c] * s; return a; }
+
+	void store( T *p, const VecT &sum ) const
+	{
+		for( int c = 0; c < CHANNELS; ++c ) {
+			if( std::is_integral<SUMT>::value )
+				p[c] = (T)(sum.v[c] / mDivisor);
+			else
+				p[c] = (T)(sum.v[c] * mInvDivisor);
+		}
+	}
+
+	SUMT	mDivisor, mInvDivisor;
+};
+
+#if defined( CINDER_BLUR_SSE2 )
+// RGBA 8u: all four channels of a pixel live in the four int32 lanes of an __m128i. Division by the
+// (constant) divisor is done exactly via a reciprocal multiply + shift, which requires sums < 2^24, ie radius <= 255
+struct StackBlurOpsSse2_8u {
+	typedef uint8_t		ElemT;
+	typedef __m128i		VecT;
+
+	StackBlurOpsSse2_8u( int32_t divisor )
+	{
+		int log2Divisor = 0;
+		while( ( int64_t( 1 ) << log2Divisor ) < divisor )
+			++log2Divisor;
+		const int shift = 24 + log2Divisor;
+		mMagic = _mm_set1_epi32( (int32_t)( ( ( uint64_t( 1 ) << shift ) + divisor - 1 ) / divisor ) );
+		mShift = _mm_cvtsi32_si128( shift );
+	}
+
+	VecT zero() const							{ return _mm_setzero_si128(); }
+	VecT add( VecT a, VecT b ) const			{ return _mm_add_epi32( a, b ); }
+	VecT sub( VecT a, VecT b ) const			{ return _mm_sub_epi32( a, b ); }
+	// lanes are <= 255 and s <= 256, so a 16-bit multiply-add against a zero high half is exact
+	VecT mulAdd( VecT a, VecT b, int32_t s ) const	{ return _mm_add_epi32( a, _mm_madd_epi16( b, _mm_set1_epi32( s ) ) ); }
+
+	VecT load( const uint8_t *p ) const
+	{
+		int32_t rgba;
+		memcpy( &rgba, p, 4 );
+		const __m128i zero = _mm_setzero_si128();
+		return _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( rgba ), zero ), zero );
+	}
+
+	void store( uint8_t *p, VecT sum ) const
+	{
+		const __m128i even = _mm_srl_epi64( _mm_mul_epu32( sum, mMagic ), mShift );
+		const __m128i odd = _mm_srl_epi64( _mm_mul_epu32( _mm_srli_epi64( sum, 32 ), mMagic ), mShift );
+		const __m128i q = _mm_or_si128( even, _mm_slli_epi64( odd, 32 ) );
+		const __m128i packed = _mm_packus_epi16( _mm_packs_epi32( q, q ), _mm_setzero_si128() );
+		const int32_t rgba = _mm_cvtsi128_si32( packed );
+		memcpy( p, &rgba, 4 );
+	}
+
+	__m128i		mMagic, mShift;
+};
+
+// RGBA 32f: one pixel per __m128
+struct StackBlurOpsSse2_32f {
+	typedef float		ElemT;
+	typedef __m128		VecT;
+
+	StackBlurOpsSse2_32f( float divisor )
+		: mInvDivisor( _mm_set1_ps( 1 / divisor ) )
+	{}
+
+	VecT zero() const							{ return _mm_setzero_ps(); }
+	VecT load( const float *p ) const			{ return _mm_loadu_ps( p ); }
+	VecT add( VecT a, VecT b ) const			{ return _mm_add_ps( a, b ); }
+	VecT sub( VecT a, VecT b ) const			{ return _mm_sub_ps( a, b ); }
+	VecT mulAdd( VecT a, VecT b, int32_t s ) const	{ return _mm_add_ps( a, _mm_mul_ps( b, _mm_set1_ps( (float)s ) ) ); }
+	void store( float *p, VecT sum ) const		{ _mm_storeu_ps( p, _mm_mul_ps( sum, mInvDivisor ) ); }
+
+	__m128		mInvDivisor;
+};
+
+typedef StackBlurOpsSse2_8u		StackBlurOpsSimd_8u;
+typedef StackBlurOpsSse2_32f	StackBlurOpsSimd_32f;
+
+#elif defined( CINDER_BLUR_NEON )
+// RGBA 8u, see StackBlurOpsSse2_8u
+struct StackBlurOpsNeon_8u {
+	typedef uint8_t		ElemT;
+	typedef uint32x4_t	VecT;
+
+	StackBlurOpsNeon_8u( int32_t divisor )
+	{
+		int log2Divisor = 0;
+		while( ( int64_t( 1 ) << log2Divisor ) < divisor )
+			++log2Divisor;
+		const int shift = 24 + log2Divisor;
+		mMagic = vdup_n_u32( (uint32_t)( ( ( uint64_t( 1 ) << shift ) + divisor - 1 ) / divisor ) );
+		mShift = vdupq_n_s64( -shift );
+	}
+
+	VecT zero() const							{ return vdupq_n_u32( 0 ); }
+	VecT add( VecT a, VecT b ) const			{ return vaddq_u32( a, b ); }
+	VecT sub( VecT a, VecT b ) const			{ return vsubq_u32( a, b ); }
+	VecT mulAdd( VecT a, VecT b, int32_t s ) const	{ return vmlaq_n_u32( a, b, (uint32_t)s ); }
+
+	VecT load( const uint8_t *p ) const
+	{
+		uint32_t rgba;
+		memcpy( &rgba, p, 4 );
+		return vmovl_u16( vget_low_u16( vmovl_u8( vreinterpret_u8_u32( vdup_n_u32( rgba ) ) ) ) );
+	}
+
+	void store( uint8_t *p, VecT sum ) const
+	{
+		const uint32x2_t lo = vmovn_u64( vshlq_u64( vmull_u32( vget_low_u32( sum ), mMagic ), mShift ) );
+		const uint32x2_t hi = vmovn_u64( vshlq_u64( vmull_u32( vget_high_u32( sum ), mMagic ), mShift ) );
+		const uint16x4_t q16 = vmovn_u32( vcombine_u32( lo, hi ) );
+		const uint8x8_t q8 = vmovn_u16( vcombine_u16( q16, q16 ) );
+		const uint32_t rgba = vget_lane_u32( vreinterpret_u32_u8( q8 ), 0 );
+		memcpy( p, &rgba, 4 );
+	}
+
+	uint32x2_t	mMagic;
+	int64x2_t	mShift;
+};
+
+// RGBA 32f: one pixel per float32x4_t
+struct StackBlurOpsNeon_32f {
+	typedef float		ElemT;
+	typedef float32x4_t	VecT;
+
+	StackBlurOpsNeon_32f( float divisor )
+		: mInvDivisor( vdupq_n_f32( 1 / divisor ) )
+	{}
+
+	VecT zero() const							{ return vdupq_n_f32( 0 ); }
+	VecT load( const float *p ) const			{ return vld1q_f32( p ); }
+	VecT add( VecT a, VecT b ) const			{ return vaddq_f32( a, b ); }
+	VecT sub( VecT a, VecT b ) const			{ return vsubq_f32( a, b ); }
+	VecT mulAdd( VecT a, VecT b, int32_t s ) const	{ return vaddq_f32( a, vmulq_n_f32( b, (float)s ) ); }
+	void store( float *p, VecT sum ) const		{ vst1q_f32( p, vmulq_f32( sum, mInvDivisor ) ); }
+
+	float32x4_t	mInvDivisor;
+};
+
+typedef StackBlurOpsNeon_8u		StackBlurOpsSimd_8u;
+typedef StackBlurOpsNeon_32f	StackBlurOpsSimd_32f;
+
+#endif
+
+// Returns true when the SIMD kernels are available on this machine
+bool hasBlurSimd()
+{
+#if defined( CINDER_BLUR_SSE2 )
+	static const bool sHasSse2 = System::hasSse2();
+	return sHasSse2;
+#elif defined( CINDER_BLUR_NEON )
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Blurs a single row or column of \a length pixels. \a src and \a dst may alias, as every source pixel is read
+// into the stack before the corresponding destination pixel is written.
+template<typename OPS>
+void stackBlurLine( const OPS &ops, const typename OPS::ElemT *src, ptrdiff_t srcInc, typename OPS::ElemT *dst, ptrdiff_t dstInc,
+					int32_t length, int radius, typename OPS::VecT *stack )
+{
+	typedef typename OPS::VecT VecT;
+	const int32_t lengthMinusOne = length - 1;
+	const int32_t div = radius + radius + 1;
+	const int32_t radiusPlusOne = radius + 1;
+
+	VecT inSum = ops.zero(), outSum = ops.zero(), sum = ops.zero();
+	for( int32_t i = -radius; i <= radius; i++ ) {
+		const VecT sir = ops.load( src + std::min( lengthMinusOne, std::max( i, 0 ) ) * srcInc );
+		stack[i + radius] = sir;
+		sum = ops.mulAdd( sum, sir, radiusPlusOne - abs( i ) );
+		if( i > 0 )
+			inSum = ops.add( inSum, sir );
+		else
+			outSum = ops.add( outSum, sir );
+	}
+
+	// stackStart trails stackPointer by radius (mod div); both wrap without a division per pixel
+	int stackPointer = radius;
+	int stackStart = ( radius + radiusPlusOne ) % div;
+	for( int32_t x = 0; x < length; x++ ) {
+		ops.store( dst + x * dstInc, sum );
+		sum = ops.sub( sum, outSum );
+
+		VecT *sir = &stack[stackStart];
+		outSum = ops.sub( outSum, *sir );
+		*sir = ops.load( src + std::min( x + radiusPlusOne, lengthMinusOne ) * srcInc );
+		inSum = ops.add( inSum, *sir );
+		sum = ops.add( sum, inSum );
+
+		if( ++stackStart == div )
+			stackStart = 0;
+		if( ++stackPointer == div )
+			stackPointer = 0;
+		sir = &stack[stackPointer];
+		outSum = ops.add( outSum, *sir );
+		inSum = ops.sub( inSum, *sir );
+	}
+}
+
 // Core implementation of stackBlur algorithm due to Mario Klingemann.
 // http://incubator.quasimondo.com/processing/fast_blur_deluxe.php
-template<typename T, typename SUMT, typename IMAGET, uint8_t CHANNELS>
-void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &area, int radius )
+// The horizontal pass writes directly into \a dstSurface and the vertical pass then blurs it in-place,
+// so no intermediate buffer is needed; the per-pixel results are identical to a separate temporary.
+template<typename OPS, uint8_t CHANNELS, typename IMAGET, typename SUMT>
+void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &area, int radius, SUMT divisor, BlurScratch *scratch )
 {
+	typedef typename OPS::ElemT T;
+	typedef typename OPS::VecT VecT;
+
 	const int32_t width = area.getWidth();
 	const int32_t height = area.getHeight();
-	const int32_t widthMinusOne = width - 1;
-	const int32_t heightMinusOne = height - 1;
+	if( width <= 0 || height <= 0 )
+		return;
+
 	const int32_t div = radius + radius + 1;
-	const int32_t radiusPlusOne = radius + 1;
-	const SUMT divisor = (SUMT)(((div+1)>>1)*((div+1)>>1));
-	const SUMT invDivisor = 1 / divisor;
 	const uint8_t srcPixelInc = ( CHANNELS == 4 ) ? 4 : getPixelIncrement( srcSurface );
 	const uint8_t dstPixelInc = ( CHANNELS == 4 ) ? 4 : getPixelIncrement( *dstSurface );
 	const ptrdiff_t srcRowInc = srcSurface.getRowBytes() / sizeof(T);
 	const ptrdiff_t dstRowInc = dstSurface->getRowBytes() / sizeof(T);
 
-	const T *srcPixelData = srcSurface.getData( area.getUL() );
-	T *dstPixelData = dstSurface->getData( area.getUL() );
-	srcPixelData += getPixelDataOffset( srcSurface );
-	dstPixelData += getPixelDataOffset( *dstSurface );
-
-	std::unique_ptr<SUMT[]> stack( new SUMT[div*CHANNELS] );
-	SUMT *tempPixelData = (SUMT*)malloc(width * height * sizeof(SUMT) * CHANNELS);
-	SUMT *channelData = tempPixelData;
-
-	SUMT *sir;
-	SUMT inSum[CHANNELS], outSum[CHANNELS], sum[CHANNELS];
-	int32_t p, yp;
-	int stackPointer, rbs;
-    
-	int yi = 0;
-	for( int32_t y = 0; y < height; y++ ) {
-		for( int c = 0; c < CHANNELS; ++c )
-			inSum[c] = outSum[c] = sum[c] = 0;
-		
-		for( int32_t i = -radius;i <= radius; i++ ) {
-			sir = &stack[(i + radius)*CHANNELS];
-			size_t offset = y * srcRowInc + std::min(widthMinusOne, std::max(i, 0)) * srcPixelInc;
-			rbs = radiusPlusOne - abs(i);
-			for( int c = 0; c < CHANNELS; ++c )
-				sir[c] = srcPixelData[offset + c];
-		
-			for( int c = 0; c < CHANNELS; ++c )
-				sum[c] += sir[c] * rbs;
-			if( i > 0 )
-				for( int c = 0; c < CHANNELS; ++c )
-					inSum[c] += sir[c];
-			else
-				for( int c = 0; c < CHANNELS; ++c )
-					outSum[c] += sir[c];
-		}
-		stackPointer = radius;
-		
-		for( int32_t x = 0; x < width; x++ ) {
-			for( int c = 0; c < CHANNELS; ++c ) {
-				if( std::is_integral<SUMT>::value )
-					channelData[c+yi*CHANNELS] = sum[c] / divisor;
-				else
-					channelData[c+yi*CHANNELS] = sum[c] * invDivisor;
-				sum[c] -= outSum[c];
-			}
-			
-			int stackStart = stackPointer - radius + div;
-			sir = &stack[(stackStart % div)*CHANNELS];
-			
-			for( int c = 0; c < CHANNELS; ++c )
-				outSum[c] -= sir[c];
-			
-			size_t offset = y * srcRowInc + std::min(x + radius + 1, widthMinusOne) * srcPixelInc;
-			for( int c = 0; c < CHANNELS; ++c ) {
-				sir[c] = srcPixelData[offset+c];
-				inSum[c] += sir[c];
-				sum[c] += inSum[c];
-			}
-			
-			stackPointer = (stackPointer + 1) % div;
-			sir = &stack[stackPointer*CHANNELS];
+	// with 4 channels every channel is blurred, so the pixel starts at its first byte regardless of order
+	const T *srcPixelData = srcSurface.getData( area.getUL() ) + ( ( CHANNELS == 4 ) ? 0 : getPixelDataOffset( srcSurface ) );
+	T *dstPixelData = dstSurface->getData( area.getUL() ) + ( ( CHANNELS == 4 ) ? 0 : getPixelDataOffset( *dstSurface ) );
 
-			for( int c = 0; c < CHANNELS; ++c ) {
-				outSum[c] += sir[c];
-				inSum[c] -= sir[c];
-			}
-			
-			yi++;
-		}
-	}
-    
-	for( int32_t x = 0; x < width; x++ ) {
-		for( int c = 0; c < CHANNELS; ++c )
-			inSum[c] = outSum[c] = sum[c] = 0;
-
-		yp = -radius * width;
-		for( int i = -radius; i <= radius; i++ ) {
-			yi = std::max(0, yp) + x;
-			
-			sir = &stack[(i + radius)*CHANNELS];
-			
-			for( int c = 0; c < CHANNELS; ++c )
-				sir[c] = channelData[c+yi*CHANNELS];
-			
-			rbs = radiusPlusOne - abs(i);
-			
-			for( int c = 0; c < CHANNELS; ++c )
-				sum[c] += channelData[c+yi*CHANNELS] * rbs;
-			
-			if( i > 0 )
-				for( int c = 0; c < CHANNELS; ++c )
-					inSum[c] += sir[c];
-			else
-				for( int c = 0; c < CHANNELS; ++c )
-					outSum[c] += sir[c];
-			
-			if( i < heightMinusOne )
-				yp += width;
-		}
-		size_t offset = x * dstPixelInc;
-		stackPointer = radius;
-		for( int32_t y = 0; y < height; y++) {
-			for( int c = 0; c < CHANNELS; ++c ) {
-				if( std::is_integral<SUMT>::value )
-					dstPixelData[offset + c] = (T)(sum[c] / divisor);
-				else
-					dstPixelData[offset + c] = (T)(sum[c] * invDivisor);
-				sum[c] -= outSum[c];
-			}
-			
-			int stackStart = stackPointer - radius + div;
-			sir = &stack[(stackStart % div)*CHANNELS];
-			
-			for( int c = 0; c < CHANNELS; ++c )
-				outSum[c] -= sir[c];
-			
-			p = x + std::min( y + radiusPlusOne, heightMinusOne ) * width;
-			
-			for( int c = 0; c < CHANNELS; ++c ) {
-				sir[c] = channelData[c+p*CHANNELS];
-				inSum[c] += sir[c];
-				sum[c] += inSum[c];
-			}
-			
-			stackPointer = (stackPointer + 1) % div;
-			sir = &stack[stackPointer*CHANNELS];
-
-			for( int c = 0; c < CHANNELS; ++c ) {
-				outSum[c] += sir[c];
-				inSum[c] -= sir[c];
-			}			
-			offset += dstRowInc;
-		}
+	const OPS ops( divisor );
+	// each band borrows its own stack from the scratch, whose buffers are aligned for the SIMD types
+	BlurScratch localScratch;
+	if( ! scratch )
+		scratch = &localScratch;
+	const size_t stackBytes = div * sizeof(VecT);
+
+	// the horizontal pass must be complete before any column is blurred, so the passes are split into bands separately
+	const Area bounds( 0, 0, width, height );
+	parallelRows( bounds, width * ( srcPixelInc + dstPixelInc ) * sizeof(T), [&]( const Area &band ) {
+		const BlurScratch::Lease stackLease = scratch->acquire( stackBytes );
+		VecT *stack = stackLease.get<VecT>();
+		for( int32_t y = band.getY1(); y < band.getY2(); y++ )
+			stackBlurLine( ops, srcPixelData + y * srcRowInc, srcPixelInc, dstPixelData + y * dstRowInc, dstPixelInc, width, radius, stack );
+	} );
+	parallelColumns( bounds, height * dstPixelInc * sizeof(T), [&]( const Area &band ) {
+		const BlurScratch::Lease stackLease = scratch->acquire( stackBytes );
+		VecT *stack = stackLease.get<VecT>();
+		for( int32_t x = band.getX1(); x < band.getX2(); x++ )
+			stackBlurLine( ops, dstPixelData + x * dstPixelInc, dstRowInc, dstPixelData + x * dstPixelInc, dstRowInc, height, radius, stack );
+	} );
+}
+
+template<typename T, typename SUMT, typename IMAGET, uint8_t CHANNELS>
+void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &area, int radius, BlurScratch *scratch )
+{
+	const SUMT divisor = (SUMT)( ( radius + 1 ) * ( radius + 1 ) );
+	stackBlur_impl<StackBlurOpsScalar<T,SUMT,CHANNELS>,CHANNELS>( srcSurface, dstSurface, area, radius, divisor, scratch );
+}
+
+// RGBA specializations, which dispatch to the SIMD kernels when available
+template<>
+void stackBlur_impl<uint8_t,int32_t,Surface8u,4>( const Surface8u &srcSurface, Surface8u *dstSurface, const Area &area, int radius, BlurScratch *scratch )
+{
+	const int32_t divisor = ( radius + 1 ) * ( radius + 1 );
+#if defined( CINDER_BLUR_SSE2 ) || defined( CINDER_BLUR_NEON )
+	if( radius <= 255 && hasBlurSimd() ) {
+		stackBlur_impl<StackBlurOpsSimd_8u,4>( srcSurface, dstSurface, area, radius, divisor, scratch );
+		return;
 	}
+#endif
+	stackBlur_impl<StackBlurOpsScalar<uint8_t,int32_t,4>,4>( srcSurface, dstSurface, area, radius, divisor, scratch );
+}
 
-	free( tempPixelData );
+template<>
+void stackBlur_impl<float,float,Surface32f,4>( const Surface32f &srcSurface, Surface32f *dstSurface, const Area &area, int radius, BlurScratch *scratch )
+{
+	const float divisor = (float)( ( radius + 1 ) * ( radius + 1 ) );
+#if defined( CINDER_BLUR_SSE2 ) || defined( CINDER_BLUR_NEON )
+	if( hasBlurSimd() ) {
+		stackBlur_impl<StackBlurOpsSimd_32f,4>( srcSurface, dstSurface, area, radius, divisor, scratch );
+		return;
+	}
+#endif
+	stackBlur_impl<StackBlurOpsScalar<float,float,4>,4>( srcSurface, dstSurface, area, radius, divisor, scratch );
 }
 
 } // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Surface8u
-void stackBlur( Surface8u *surface, int radius )
+void stackBlur( Surface8u *surface, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	if( surface->hasAlpha() )
-		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, surface->getBounds(), radius, scratch );
 	else
-		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( *surface, surface, surface->getBounds(), radius, scratch );
 }
 
-void stackBlur( Surface8u *surface, const Area &area, int radius )
+void stackBlur( Surface8u *surface, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
-		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, clippedArea, radius, scratch );
 	else
-		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( *surface, surface, clippedArea, radius, scratch );
 }
 
-Surface8u stackBlurCopy( const Surface8u &surface, int radius )
+Surface8u stackBlurCopy( const Surface8u &surface, int radius, BlurScratch *scratch )
 {
 	Surface8u result = surface.clone( false );
 
 	if( surface.hasAlpha() )
-		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( surface, &result, surface.getBounds(), radius, scratch );
 	else
-		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<uint8_t,int32_t,Surface8u,3>( surface, &result, surface.getBounds(), radius, scratch );
 	
 	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Channel8u
-void stackBlur( Channel8u *channel, int radius )
+void stackBlur( Channel8u *channel, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
-	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( *channel, channel, channel->getBounds(), radius );
+	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( *channel, channel, channel->getBounds(), radius, scratch );
 }
 
-void stackBlur( Channel8u *channel, const Area &area, int radius )
+void stackBlur( Channel8u *channel, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( channel->getBounds() );
-	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( *channel, channel, clippedArea, radius );
+	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( *channel, channel, clippedArea, radius, scratch );
 }
 
-Channel8u stackBlurCopy( const Channel8u &channel, int radius )
+Channel8u stackBlurCopy( const Channel8u &channel, int radius, BlurScratch *scratch )
 {
 	Channel8u result = channel.clone( false );
 
-	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( channel, &result, channel.getBounds(), radius );
+	stackBlur_impl<uint8_t,int32_t,Channel8u,1>( channel, &result, channel.getBounds(), radius, scratch );
 	
 	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Surface16u
-void stackBlur( Surface16u *surface, int radius )
+void stackBlur( Surface16u *surface, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	if( surface->hasAlpha() )
-		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, surface->getBounds(), radius, scratch );
 	else
-		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( *surface, surface, surface->getBounds(), radius, scratch );
 }
 
-void stackBlur( Surface16u *surface, const Area &area, int radius )
+void stackBlur( Surface16u *surface, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
-		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, clippedArea, radius, scratch );
 	else
-		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( *surface, surface, clippedArea, radius, scratch );
 }
 
-Surface16u stackBlurCopy( const Surface16u &surface, int radius )
+Surface16u stackBlurCopy( const Surface16u &surface, int radius, BlurScratch *scratch )
 {
 	Surface16u result = surface.clone( false );
 
 	if( surface.hasAlpha() )
-		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( surface, &result, surface.getBounds(), radius, scratch );
 	else
-		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<uint16_t,int64_t,Surface16u,3>( surface, &result, surface.getBounds(), radius, scratch );
 	
 	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Channel16u
-void stackBlur( Channel16u *channel, int radius )
+void stackBlur( Channel16u *channel, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
-	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( *channel, channel, channel->getBounds(), radius );
+	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( *channel, channel, channel->getBounds(), radius, scratch );
 }
 
-void stackBlur( Channel16u *channel, const Area &area, int radius )
+void stackBlur( Channel16u *channel, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( channel->getBounds() );
-	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( *channel, channel, clippedArea, radius );
+	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( *channel, channel, clippedArea, radius, scratch );
 }
 
-Channel16u stackBlurCopy( const Channel16u &channel, int radius )
+Channel16u stackBlurCopy( const Channel16u &channel, int radius, BlurScratch *scratch )
 {
 	Channel16u result = channel.clone( false );
 
-	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( channel, &result, channel.getBounds(), radius );
+	stackBlur_impl<uint16_t,int64_t,Channel16u,1>( channel, &result, channel.getBounds(), radius, scratch );
 	
 	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Surface32f
-void stackBlur( Surface32f *surface, int radius )
+void stackBlur( Surface32f *surface, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	if( surface->hasAlpha() )
-		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, surface->getBounds(), radius, scratch );
 	else
-		stackBlur_impl<float,float,Surface32f,3>( *surface, surface, surface->getBounds(), radius );
+		stackBlur_impl<float,float,Surface32f,3>( *surface, surface, surface->getBounds(), radius, scratch );
 }
 
-void stackBlur( Surface32f *surface, const Area &area, int radius )
+void stackBlur( Surface32f *surface, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
-		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, clippedArea, radius, scratch );
 	else
-		stackBlur_impl<float,float,Surface32f,3>( *surface, surface, clippedArea, radius );
+		stackBlur_impl<float,float,Surface32f,3>( *surface, surface, clippedArea, radius, scratch );
 }
 
-Surface32f stackBlurCopy( const Surface32f &surface, int radius )
+Surface32f stackBlurCopy( const Surface32f &surface, int radius, BlurScratch *scratch )
 {
 	Surface32f result = surface.clone( false );
 
 	if( surface.hasAlpha() )
-		stackBlur_impl<float,float,Surface32f,4>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<float,float,Surface32f,4>( surface, &result, surface.getBounds(), radius, scratch );
 	else
-		stackBlur_impl<float,float,Surface32f,3>( surface, &result, surface.getBounds(), radius );
+		stackBlur_impl<float,float,Surface32f,3>( surface, &result, surface.getBounds(), radius, scratch );
 	
 	return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////
 // Channel32f
-void stackBlur( Channel32f *channel, int radius )
+void stackBlur( Channel32f *channel, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
-	stackBlur_impl<float,float,Channel32f,1>( *channel, channel, channel->getBounds(), radius );
+	stackBlur_impl<float,float,Channel32f,1>( *channel, channel, channel->getBounds(), radius, scratch );
 }
 
-void stackBlur( Channel32f *channel, const Area &area, int radius )
+void stackBlur( Channel32f *channel, const Area &area, int radius, BlurScratch *scratch )
 {
 	if( radius < 1 )
 		return;
 
 	const Area clippedArea = area.getClipBy( channel->getBounds() );
-	stackBlur_impl<float,float,Channel32f,1>( *channel, channel, clippedArea, radius );
+	stackBlur_impl<float,float,Channel32f,1>( *channel, channel, clippedArea, radius, scratch );
 }
 
-Channel32f stackBlurCopy( const Channel32f &channel, int radius )
+Channel32f stackBlurCopy( const Channel32f &channel, int radius, BlurScratch *scratch )
 {
 	Channel32f result = channel.clone( false );
 
-	stackBlur_impl<float,float,Channel32f,1>( channel, &result, channel.getBounds(), radius );
+	stackBlur_impl<float,float,Channel32f,1>( channel, &result, channel.getBounds(), radius, scratch );
 	
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// boxBlur
+namespace {
+
+template<typename T, typename SUMT>
+inline T boxAverage( SUMT sum, int32_t count, std::true_type /*isIntegral*/ )
+{
+	return static_cast<T>( ( sum + count / 2 ) / count );
+}
+
+template<typename T, typename SUMT>
+inline T boxAverage( SUMT sum, int32_t count, std::false_type /*isIntegral*/ )
+{
+	return static_cast<T>( sum / count );
+}
+
+// Writes the average of the box of \a radius around each pixel, clipped to the image, from \a integralImage into \a dstData.
+// \a integralImage holds everything needed from the source, so \a dstData may point at the source itself.
+template<typename T>
+void boxBlur_impl( const IntegralImageT<T> &integralImage, T *dstData, ptrdiff_t dstRowBytes, uint8_t dstPixelInc, const uint8_t *dstOffsets, int radius )
+{
+	typedef typename std::is_integral<T>::type IsIntegral;
+	const int32_t width = integralImage.getSize().x, height = integralImage.getSize().y;
+	const uint8_t numChannels = integralImage.getNumChannels();
+
+	parallelRows( Area( 0, 0, width, height ), width * dstPixelInc * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.y1; y < band.y2; ++y ) {
+			const int32_t y1 = std::max( y - radius, 0 ), y2 = std::min( y + radius + 1, height );
+			T *dst = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( dstData ) + y * dstRowBytes );
+			for( int32_t x = 0; x < width; ++x, dst += dstPixelInc ) {
+				const int32_t x1 = std::max( x - radius, 0 ), x2 = std::min( x + radius + 1, width );
+				const Area box( x1, y1, x2, y2 );
+				const int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+				for( uint8_t c = 0; c < numChannels; ++c )
+					dst[dstOffsets[c]] = boxAverage<T>( integralImage.areaSum( box, c ), count, IsIntegral() );
+			}
+		}
+	} );
+}
+
+template<typename T>
+void boxBlur_impl( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, int radius )
+{
+	const IntegralImageT<T> integralImage( srcSurface );
+	const SurfaceChannelOrder &co = dstSurface->getChannelOrder();
+	const uint8_t offsets[4] = { co.getRedOffset(), co.getGreenOffset(), co.getBlueOffset(), static_cast<uint8_t>( co.hasAlpha() ? co.getAlphaOffset() : 0 ) };
+	boxBlur_impl( integralImage, dstSurface->getData(), dstSurface->getRowBytes(), dstSurface->getPixelInc(), offsets, radius );
+}
+
+template<typename T>
+void boxBlur_impl( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, int radius )
+{
+	const IntegralImageT<T> integralImage( srcChannel );
+	const uint8_t offsets[1] = { 0 };
+	boxBlur_impl( integralImage, dstChannel->getData(), dstChannel->getRowBytes(), dstChannel->getIncrement(), offsets, radius );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void boxBlur( SurfaceT<T> *surface, int radius )
+{
+	if( radius < 1 )
+		return;
+
+	boxBlur_impl( *surface, surface, radius );
+}
+
+template<typename T>
+void boxBlur( ChannelT<T> *channel, int radius )
+{
+	if( radius < 1 )
+		return;
+
+	boxBlur_impl( *channel, channel, radius );
+}
+
+template<typename T>
+SurfaceT<T> boxBlurCopy( const SurfaceT<T> &surface, int radius )
+{
+	if( radius < 1 )
+		return surface.clone();
+
+	SurfaceT<T> result = surface.clone( false );
+	boxBlur_impl( surface, &result, radius );
+	return result;
+}
+
+template<typename T>
+ChannelT<T> boxBlurCopy( const ChannelT<T> &channel, int radius )
+{
+	if( radius < 1 )
+		return channel.clone();
+
+	ChannelT<T> result = channel.clone( false );
+	boxBlur_impl( channel, &result, radius );
+	return result;
+}
+
+#define boxBlur_PROTOTYPES(T)\
+	template CI_API void boxBlur<T>( SurfaceT<T> *surface, int radius );\
+	template CI_API void boxBlur<T>( ChannelT<T> *channel, int radius );\
+	template CI_API SurfaceT<T> boxBlurCopy<T>( const SurfaceT<T> &surface, int radius );\
+	template CI_API ChannelT<T> boxBlurCopy<T>( const ChannelT<T> &channel, int radius );
+
+boxBlur_PROTOTYPES(uint8_t)
+boxBlur_PROTOTYPES(uint16_t)
+boxBlur_PROTOTYPES(float)
+
+///////////////////////////////////////////////////////////////////////////////////
+// gaussianBlur
+namespace {
+
+// The Gaussian is approximated by three passes of an "extended box" filter, a box of \a radius whose two outer neighbors have the
+// fractional weight \a alpha. Unlike integer box widths this matches the variance of any sigma exactly. Gwosdek et al.,
+// "Theoretical Foundations of Gaussian Convolution by Extended Box Filtering" (2011)
+struct ExtendedBox {
+	ExtendedBox( float sigma )
+	{
+		const int numPasses = 3;
+		const float variance = sigma * sigma / numPasses;
+		mRadius = (int)std::floor( 0.5f * std::sqrt( 12 * variance + 1 ) - 0.5f );
+		const float r = (float)mRadius;
+		mAlpha = ( 2 * r + 1 ) * ( 3 * variance - r * ( r + 1 ) ) / ( 6 * ( ( r + 1 ) * ( r + 1 ) - variance ) );
+		mScale = 1 / ( 2 * r + 1 + 2 * mAlpha );
+	}
+
+	int		mRadius;
+	float	mAlpha, mScale;
+};
+
+// Filters \a length pixels of CHANNELS interleaved floats from \a src into \a dst with \a box, repeating the edge pixels
+template<uint8_t CHANNELS>
+void boxLine( const float *src, float *dst, int32_t length, const ExtendedBox &box )
+{
+	const int radius = box.mRadius;
+	const int32_t last = length - 1;
+	float sum[CHANNELS];
+	for( int c = 0; c < CHANNELS; ++c )
+		sum[c] = ( radius + 1 ) * src[c];
+	for( int32_t i = 1; i <= radius; ++i )
+		for( int c = 0; c < CHANNELS; ++c )
+			sum[c] += src[std::min( i, last ) * CHANNELS + c];
+
+	for( int32_t x = 0; x < length; ++x, dst += CHANNELS ) {
+		const float *add = src + std::min( x + radius + 1, last ) * CHANNELS;
+		const float *sub = src + std::max( x - radius, 0 ) * CHANNELS;
+		const float *outer = src + std::max( x - radius - 1, 0 ) * CHANNELS;
+		for( int c = 0; c < CHANNELS; ++c ) {
+			dst[c] = ( sum[c] + box.mAlpha * ( outer[c] + add[c] ) ) * box.mScale;
+			sum[c] += add[c] - sub[c];
+		}
+	}
+}
+
+#if defined( CINDER_BLUR_SSE2 )
+// RGBA: one pixel per __m128
+void boxLineSimd4( const float *src, float *dst, int32_t length, const ExtendedBox &box )
+{
+	const int radius = box.mRadius;
+	const __m128 alpha = _mm_set1_ps( box.mAlpha ), scale = _mm_set1_ps( box.mScale );
+	const int32_t last = length - 1;
+	__m128 sum = _mm_mul_ps( _mm_loadu_ps( src ), _mm_set1_ps( (float)( radius + 1 ) ) );
+	for( int32_t i = 1; i <= radius; ++i )
+		sum = _mm_add_ps( sum, _mm_loadu_ps( src + std::min( i, last ) * 4 ) );
+
+	for( int32_t x = 0; x < length; ++x, dst += 4 ) {
+		const __m128 add = _mm_loadu_ps( src + std::min( x + radius + 1, last ) * 4 );
+		const __m128 sub = _mm_loadu_ps( src + std::max( x - radius, 0 ) * 4 );
+		const __m128 outer = _mm_loadu_ps( src + std::max( x - radius - 1, 0 ) * 4 );
+		_mm_storeu_ps( dst, _mm_mul_ps( _mm_add_ps( sum, _mm_mul_ps( alpha, _mm_add_ps( outer, add ) ) ), scale ) );
+		sum = _mm_add_ps( sum, _mm_sub_ps( add, sub ) );
+	}
+}
+
+// out = ( sum + alpha * ( outer + add ) ) * scale; sum += add - sub, over \a count floats
+void boxStepSimd( float *out, float *sum, const float *add, const float *sub, const float *outer, const ExtendedBox &box, int32_t count )
+{
+	const __m128 alpha = _mm_set1_ps( box.mAlpha ), scale = _mm_set1_ps( box.mScale );
+	int32_t i = 0;
+	for( ; i + 4 <= count; i += 4 ) {
+		const __m128 s = _mm_loadu_ps( sum + i ), a = _mm_loadu_ps( add + i );
+		_mm_storeu_ps( out + i, _mm_mul_ps( _mm_add_ps( s, _mm_mul_ps( alpha, _mm_add_ps( _mm_loadu_ps( outer + i ), a ) ) ), scale ) );
+		_mm_storeu_ps( sum + i, _mm_add_ps( s, _mm_sub_ps( a, _mm_loadu_ps( sub + i ) ) ) );
+	}
+	for( ; i < count; ++i ) {
+		const float a = add[i];
+		out[i] = ( sum[i] + box.mAlpha * ( outer[i] + a ) ) * box.mScale;
+		sum[i] += a - sub[i];
+	}
+}
+
+#elif defined( CINDER_BLUR_NEON )
+// see the SSE2 versions
+void boxLineSimd4( const float *src, float *dst, int32_t length, const ExtendedBox &box )
+{
+	const int radius = box.mRadius;
+	const int32_t last = length - 1;
+	float32x4_t sum = vmulq_n_f32( vld1q_f32( src ), (float)( radius + 1 ) );
+	for( int32_t i = 1; i <= radius; ++i )
+		sum = vaddq_f32( sum, vld1q_f32( src + std::min( i, last ) * 4 ) );
+
+	for( int32_t x = 0; x < length; ++x, dst += 4 ) {
+		const float32x4_t add = vld1q_f32( src + std::min( x + radius + 1, last ) * 4 );
+		const float32x4_t sub = vld1q_f32( src + std::max( x - radius, 0 ) * 4 );
+		const float32x4_t outer = vld1q_f32( src + std::max( x - radius - 1, 0 ) * 4 );
+		vst1q_f32( dst, vmulq_n_f32( vaddq_f32( sum, vmulq_n_f32( vaddq_f32( outer, add ), box.mAlpha ) ), box.mScale ) );
+		sum = vaddq_f32( sum, vsubq_f32( add, sub ) );
+	}
+}
+
+void boxStepSimd( float *out, float *sum, const float *add, const float *sub, const float *outer, const ExtendedBox &box, int32_t count )
+{
+	int32_t i = 0;
+	for( ; i + 4 <= count; i += 4 ) {
+		const float32x4_t s = vld1q_f32( sum + i ), a = vld1q_f32( add + i );
+		vst1q_f32( out + i, vmulq_n_f32( vaddq_f32( s, vmulq_n_f32( vaddq_f32( vld1q_f32( outer + i ), a ), box.mAlpha ) ), box.mScale ) );
+		vst1q_f32( sum + i, vaddq_f32( s, vsubq_f32( a, vld1q_f32( sub + i ) ) ) );
+	}
+	for( ; i < count; ++i ) {
+		const float a = add[i];
+		out[i] = ( sum[i] + box.mAlpha * ( outer[i] + a ) ) * box.mScale;
+		sum[i] += a - sub[i];
+	}
+}
+#endif
+
+void boxStep( float *out, float *sum, const float *add, const float *sub, const float *outer, const ExtendedBox &box, int32_t count )
+{
+#if defined( CINDER_BLUR_SSE2 ) || defined( CINDER_BLUR_NEON )
+	if( hasBlurSimd() ) {
+		boxStepSimd( out, sum, add, sub, outer, box, count );
+		return;
+	}
+#endif
+	for( int32_t i = 0; i < count; ++i ) {
+		const float a = add[i];
+		out[i] = ( sum[i] + box.mAlpha * ( outer[i] + a ) ) * box.mScale;
+		sum[i] += a - sub[i];
+	}
+}
+
+template<uint8_t CHANNELS>
+void boxLineDispatch( const float *src, float *dst, int32_t length, const ExtendedBox &box )
+{
+#if defined( CINDER_BLUR_SSE2 ) || defined( CINDER_BLUR_NEON )
+	if( CHANNELS == 4 && hasBlurSimd() ) {
+		boxLineSimd4( src, dst, length, box );
+		return;
+	}
+#endif
+	boxLine<CHANNELS>( src, dst, length, box );
+}
+
+// Filters the columns of the \a height rows of \a rowLength floats at \a data in-place with \a box, repeating the edge rows.
+// \a sum holds \a rowLength floats and \a ring ( radius + 2 ) rows, which keep the original rows still needed after they are overwritten.
+void boxColumnsInPlace( float *data, int32_t height, int32_t rowLength, const ExtendedBox &box, float *sum, float *ring )
+{
+	const int radius = box.mRadius;
+	const int32_t last = height - 1;
+	const int32_t ringSize = radius + 2;
+	const size_t rowBytes = rowLength * sizeof(float);
+
+	for( int32_t i = 0; i < rowLength; ++i )
+		sum[i] = ( radius + 1 ) * data[i];
+	for( int32_t k = 1; k <= radius; ++k ) {
+		const float *row = data + std::min( k, last ) * rowLength;
+		for( int32_t i = 0; i < rowLength; ++i )
+			sum[i] += row[i];
+	}
+
+	for( int32_t y = 0; y < height; ++y ) {
+		float *row = data + y * rowLength;
+		memcpy( ring + ( y % ringSize ) * rowLength, row, rowBytes );
+		// the row added is below y, so it hasn't been overwritten yet
+		const float *add = data + std::min( y + radius + 1, last ) * rowLength;
+		const float *sub = ring + ( std::max( y - radius, 0 ) % ringSize ) * rowLength;
+		const float *outer = ring + ( std::max( y - radius - 1, 0 ) % ringSize ) * rowLength;
+		boxStep( row, sum, add, sub, outer, box, rowLength );
+	}
+}
+
+template<uint8_t CHANNELS, typename T>
+void loadLine( const T *src, uint8_t srcInc, int32_t count, float *dst )
+{
+	for( int32_t x = 0; x < count; ++x, src += srcInc, dst += CHANNELS )
+		for( int c = 0; c < CHANNELS; ++c )
+			dst[c] = src[c];
+}
+
+template<typename T>
+inline T fromFloat( float v, std::true_type /*isIntegral*/ )
+{
+	return static_cast<T>( std::min<float>( std::max( v, 0.0f ), CHANTRAIT<T>::max() ) + 0.5f );
+}
+
+template<typename T>
+inline T fromFloat( float v, std::false_type /*isIntegral*/ )
+{
+	return v;
+}
+
+template<uint8_t CHANNELS, typename T>
+void storeLine( const float *src, int32_t count, T *dst, uint8_t dstInc )
+{
+	typedef typename std::is_integral<T>::type IsIntegral;
+	for( int32_t x = 0; x < count; ++x, src += CHANNELS, dst += dstInc )
+		for( int c = 0; c < CHANNELS; ++c )
+			dst[c] = fromFloat<T>( src[c], IsIntegral() );
+}
+
+// The rows are blurred from \a srcImage into a float image, and then its columns into \a dstImage. Integer images keep that
+// intermediate image in \a scratch so that they are rounded only once, while float images use \a dstImage itself. Both passes work
+// in float line buffers borrowed from \a scratch, and columns are processed in blocks of rows so that memory is read sequentially.
+template<uint8_t CHANNELS, typename T, typename IMAGET>
+void gaussianBlur_impl( const IMAGET &srcImage, IMAGET *dstImage, float sigma, BlurScratch *scratch )
+{
+	const int32_t width = srcImage.getWidth(), height = srcImage.getHeight();
+	if( width <= 0 || height <= 0 )
+		return;
+
+	const ExtendedBox box( sigma );
+	const int numPasses = 3;
+
+	BlurScratch localScratch;
+	if( ! scratch )
+		scratch = &localScratch;
+
+	const uint8_t srcPixelInc = getPixelIncrement( srcImage ), dstPixelInc = getPixelIncrement( *dstImage );
+	const ptrdiff_t srcRowInc = srcImage.getRowBytes() / sizeof(T), dstRowInc = dstImage->getRowBytes() / sizeof(T);
+	// with 4 channels every element of the pixel is blurred, otherwise the (contiguous) color elements
+	const T *srcData = srcImage.getData() + ( ( CHANNELS == 4 ) ? 0 : getPixelDataOffset( srcImage ) );
+	T *dstData = dstImage->getData() + ( ( CHANNELS == 4 ) ? 0 : getPixelDataOffset( *dstImage ) );
+	const Area bounds( 0, 0, width, height );
+
+	// blurs the rows into the float image at interData and then its columns into dstData
+	auto blurPasses = [&]( float *interData, ptrdiff_t interRowInc, uint8_t interPixelInc ) {
+		parallelRows( bounds, width * ( srcPixelInc + dstPixelInc ) * sizeof(T), [&]( const Area &band ) {
+			const BlurScratch::Lease lease = scratch->acquire( 2 * width * CHANNELS * sizeof(float) );
+			float *line = lease.get<float>(), *temp = line + width * CHANNELS;
+			for( int32_t y = band.y1; y < band.y2; ++y ) {
+				loadLine<CHANNELS>( srcData + y * srcRowInc, srcPixelInc, width, line );
+				for( int pass = 0; pass < numPasses; ++pass ) {
+					boxLineDispatch<CHANNELS>( line, temp, width, box );
+					std::swap( line, temp );
+				}
+				storeLine<CHANNELS>( line, width, interData + y * interRowInc, interPixelInc );
+			}
+		} );
+
+		// 64 columns keep each block's rows a few cache lines long, while its ring of rows stays small
+		const int32_t blockColumns = 64;
+		parallelColumns( bounds, height * CHANNELS * sizeof(float), [&]( const Area &band ) {
+			const int32_t maxRowLength = std::min( blockColumns, band.getWidth() ) * CHANNELS;
+			const BlurScratch::Lease lease = scratch->acquire( ( height + box.mRadius + 3 ) * maxRowLength * sizeof(float) );
+			float *block = lease.get<float>(), *ring = block + height * maxRowLength, *sum = ring + ( box.mRadius + 2 ) * maxRowLength;
+			for( int32_t x1 = band.x1; x1 < band.x2; x1 += blockColumns ) {
+				const int32_t columns = std::min( blockColumns, band.x2 - x1 );
+				const int32_t rowLength = columns * CHANNELS;
+				const float *interBlock = interData + x1 * interPixelInc;
+				T *dstBlock = dstData + x1 * dstPixelInc;
+				for( int32_t y = 0; y < height; ++y )
+					loadLine<CHANNELS>( interBlock + y * interRowInc, interPixelInc, columns, block + y * rowLength );
+				for( int pass = 0; pass < numPasses; ++pass )
+					boxColumnsInPlace( block, height, rowLength, box, sum, ring );
+				for( int32_t y = 0; y < height; ++y )
+					storeLine<CHANNELS>( block + y * rowLength, columns, dstBlock + y * dstRowInc, dstPixelInc );
+			}
+		} );
+	};
+
+	if( std::is_same<T, float>::value )
+		blurPasses( reinterpret_cast<float*>( dstData ), dstRowInc, dstPixelInc );
+	else {
+		const BlurScratch::Lease interLease = scratch->acquire( width * height * CHANNELS * sizeof(float) );
+		blurPasses( interLease.get<float>(), width * CHANNELS, CHANNELS );
+	}
+}
+
+} // anonymous namespace
+
+template<typename T>
+void gaussianBlur( SurfaceT<T> *surface, float sigma, BlurScratch *scratch )
+{
+	if( sigma <= 0 )
+		return;
+
+	if( surface->hasAlpha() )
+		gaussianBlur_impl<4,T>( *surface, surface, sigma, scratch );
+	else
+		gaussianBlur_impl<3,T>( *surface, surface, sigma, scratch );
+}
+
+template<typename T>
+void gaussianBlur( ChannelT<T> *channel, float sigma, BlurScratch *scratch )
+{
+	if( sigma <= 0 )
+		return;
+
+	gaussianBlur_impl<1,T>( *channel, channel, sigma, scratch );
+}
+
+template<typename T>
+SurfaceT<T> gaussianBlurCopy( const SurfaceT<T> &surface, float sigma, BlurScratch *scratch )
+{
+	if( sigma <= 0 )
+		return surface.clone();
+
+	SurfaceT<T> result = surface.clone( false );
+	if( surface.hasAlpha() )
+		gaussianBlur_impl<4,T>( surface, &result, sigma, scratch );
+	else
+		gaussianBlur_impl<3,T>( surface, &result, sigma, scratch );
+	return result;
+}
+
+template<typename T>
+ChannelT<T> gaussianBlurCopy( const ChannelT<T> &channel, float sigma, BlurScratch *scratch )
+{
+	if( sigma <= 0 )
+		return channel.clone();
+
+	ChannelT<T> result = channel.clone( false );
+	gaussianBlur_impl<1,T>( channel, &result, sigma, scratch );
+	return result;
+}
+
+#define gaussianBlur_PROTOTYPES(T)\
+	template CI_API void gaussianBlur<T>( SurfaceT<T> *surface, float sigma, BlurScratch *scratch );\
+	template CI_API void gaussianBlur<T>( ChannelT<T> *channel, float sigma, BlurScratch *scratch );\
+	template CI_API SurfaceT<T> gaussianBlurCopy<T>( const SurfaceT<T> &surface, float sigma, BlurScratch *scratch );\
+	template CI_API ChannelT<T> gaussianBlurCopy<T>( const ChannelT<T> &channel, float sigma, BlurScratch *scratch );
+
+gaussianBlur_PROTOTYPES(uint8_t)
+gaussianBlur_PROTOTYPES(uint16_t)
+gaussianBlur_PROTOTYPES(float)
+
 } } // namespace cinder::ip
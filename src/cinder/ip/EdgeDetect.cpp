@@ -21,6 +21,7 @@
 */
 
 #include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/ThreadPool.h"
 #include "cinder/Surface.h"
 #include "cinder/CinderMath.h"
 
@@ -38,28 +39,32 @@ void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const
 	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcChannel.getBounds(), srcArea, dstChannel->getBounds(), dstLT );
 	const Area &area( srcDst.first );
 	const ivec2 &dstOffset( srcDst.second );
-	typename CHANTRAIT<T>::SignedSum sumX, sumY;
+	if( area.getHeight() < 3 )
+		return;
 
 	ptrdiff_t srcRowInc = srcChannel.getRowBytes() / sizeof(T);
 	uint8_t srcPixelInc = srcChannel.getIncrement();
 	uint8_t dstPixelInc = dstChannel->getIncrement();
 	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 1; y < area.getHeight() - 1; ++y ) {
-		const T *srcLine = srcChannel.getData( area.getX1() + 1, area.getY1() + y );
-		T *dstLine = dstChannel->getData( dstOffset.x + area.getX1() + 1, dstOffset.y + y );
-		for( int32_t x = area.getX1() + 1; x < area.getX2() - 1; ++x ) {
-			sumX = -*(srcLine-srcRowInc-srcPixelInc) + *(srcLine-srcRowInc+srcPixelInc) - 2 * *(srcLine-srcPixelInc)
-							+ 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc-srcPixelInc) + *(srcLine+srcRowInc+srcPixelInc);
-			sumY = *(srcLine-srcRowInc-srcPixelInc) + 2 * *(srcLine-srcRowInc) + *(srcLine-srcRowInc+srcPixelInc)
-							- *(srcLine+srcRowInc-srcPixelInc) - 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc+srcPixelInc);
-			sumX = (typename CHANTRAIT<T>::SignedSum)math<float>::sqrt( (float)sumX * sumX + (float)sumY * sumY );
-			if( sumX > maxValue )
-				sumX = maxValue;
-			*dstLine = static_cast<T>( sumX );
-			dstLine += dstPixelInc;
-			srcLine += srcPixelInc;
+	parallelRows( Area( 0, 1, area.getWidth(), area.getHeight() - 1 ), area.getWidth() * ( srcPixelInc + dstPixelInc ) * sizeof(T), [&]( const Area &band ) {
+		typename CHANTRAIT<T>::SignedSum sumX, sumY;
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			const T *srcLine = srcChannel.getData( area.getX1() + 1, area.getY1() + y );
+			T *dstLine = dstChannel->getData( dstOffset.x + area.getX1() + 1, dstOffset.y + y );
+			for( int32_t x = area.getX1() + 1; x < area.getX2() - 1; ++x ) {
+				sumX = -*(srcLine-srcRowInc-srcPixelInc) + *(srcLine-srcRowInc+srcPixelInc) - 2 * *(srcLine-srcPixelInc)
+								+ 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc-srcPixelInc) + *(srcLine+srcRowInc+srcPixelInc);
+				sumY = *(srcLine-srcRowInc-srcPixelInc) + 2 * *(srcLine-srcRowInc) + *(srcLine-srcRowInc+srcPixelInc)
+								- *(srcLine+srcRowInc-srcPixelInc) - 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc+srcPixelInc);
+				sumX = (typename CHANTRAIT<T>::SignedSum)math<float>::sqrt( (float)sumX * sumX + (float)sumY * sumY );
+				if( sumX > maxValue )
+					sumX = maxValue;
+				*dstLine = static_cast<T>( sumX );
+				dstLine += dstPixelInc;
+				srcLine += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
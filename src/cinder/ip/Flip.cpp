@@ -21,6 +21,7 @@
 */
 
 #include "cinder/ip/Flip.h"
+#include "cinder/ip/ThreadPool.h"
 
 using namespace std;
 
@@ -30,24 +31,26 @@ template<typename T>
 void flipVertical( SurfaceT<T> *surface )
 {
 	const ptrdiff_t rowBytes = surface->getRowBytes();
-	unique_ptr<uint8_t[]> buffer( new uint8_t[rowBytes] );
-	
 	const int32_t lastRow = surface->getHeight() - 1;
 	const int32_t halfHeight = surface->getHeight() / 2;
-	for( int32_t y = 0; y < halfHeight; ++y ) {
-		memcpy( buffer.get(), surface->getData( ivec2( 0, y ) ), rowBytes );
-		memcpy( surface->getData( ivec2( 0, y ) ), surface->getData( ivec2( 0, lastRow - y ) ), rowBytes );
-		memcpy( surface->getData( ivec2( 0, lastRow - y ) ), buffer.get(), rowBytes );
-	}	
+	// each band swaps its rows in the top half with their mirrors in the bottom half
+	parallelRows( Area( 0, 0, surface->getWidth(), halfHeight ), rowBytes * 2, [&]( const Area &band ) {
+		unique_ptr<uint8_t[]> buffer( new uint8_t[rowBytes] );
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			memcpy( buffer.get(), surface->getData( ivec2( 0, y ) ), rowBytes );
+			memcpy( surface->getData( ivec2( 0, y ) ), surface->getData( ivec2( 0, lastRow - y ) ), rowBytes );
+			memcpy( surface->getData( ivec2( 0, lastRow - y ) ), buffer.get(), rowBytes );
+		}
+	} );
 }
 
 namespace { // anonymous
 template<typename T>
-void flipVerticalRawSameChannelOrder( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size )
+void flipVerticalRawSameChannelOrder( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size, int32_t y1, int32_t y2 )
 {
 	const uint8_t srcPixelInc = srcSurface.getPixelInc();
 	const size_t copyBytes = size.x * srcPixelInc * sizeof(T);
-	for( int32_t y = 0; y < size.y; ++y ) {
+	for( int32_t y = y1; y < y2; ++y ) {
 		const T *srcPtr = srcSurface.getData( ivec2( 0, y ) );
 		T *dstPtr = destSurface->getData( ivec2( 0, size.y - y - 1 ) );
 		memcpy( dstPtr, srcPtr, copyBytes );
@@ -55,7 +58,7 @@ void flipVerticalRawSameChannelOrder( const SurfaceT<T> &srcSurface, SurfaceT<T>
 }
 
 template<typename T>
-void flipVerticalRawRgba( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size )
+void flipVerticalRawRgba( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size, int32_t y1, int32_t y2 )
 {
 	const uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
 	const uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
@@ -67,7 +70,7 @@ void flipVerticalRawRgba( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurfac
 	const uint8_t dstBlue = destSurface->getChannelOrder().getBlueOffset();
 	const uint8_t dstAlpha = destSurface->getChannelOrder().getAlphaOffset();
 	
-	for( int32_t y = 0; y < size.y; ++y ) {
+	for( int32_t y = y1; y < y2; ++y ) {
 		const T *src = srcSurface.getData( ivec2( 0, y ) );
 		T *dst = destSurface->getData( ivec2( 0, size.y - y - 1 ) );
 		for( int x = 0; x < size.x; ++x ) {
@@ -82,7 +85,7 @@ void flipVerticalRawRgba( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurfac
 }
 
 template<typename T>
-void flipVerticalRawRgbFullAlpha( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size )
+void flipVerticalRawRgbFullAlpha( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size, int32_t y1, int32_t y2 )
 {
 	const uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
 	const uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
@@ -95,7 +98,7 @@ void flipVerticalRawRgbFullAlpha( const SurfaceT<T> &srcSurface, SurfaceT<T> *de
 	const uint8_t dstBlue = destSurface->getChannelOrder().getBlueOffset();
 	const uint8_t dstAlpha = destSurface->getChannelOrder().getAlphaOffset();
 	
-	for( int32_t y = 0; y < size.y; ++y ) {
+	for( int32_t y = y1; y < y2; ++y ) {
 		const T *src = srcSurface.getData( ivec2( 0, y ) );
 		T *dst = destSurface->getData( ivec2( 0, size.y - y - 1 ) );
 		for( int x = 0; x < size.x; ++x ) {
@@ -110,7 +113,7 @@ void flipVerticalRawRgbFullAlpha( const SurfaceT<T> &srcSurface, SurfaceT<T> *de
 }
 
 template<typename T>
-void flipVerticalRawRgb( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size )
+void flipVerticalRawRgb( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size, int32_t y1, int32_t y2 )
 {
 	const uint8_t srcRed = srcSurface.getChannelOrder().getRedOffset();
 	const uint8_t srcGreen = srcSurface.getChannelOrder().getGreenOffset();
@@ -122,7 +125,7 @@ void flipVerticalRawRgb( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface
 	const uint8_t dstBlue = destSurface->getChannelOrder().getBlueOffset();
 	const uint8_t dstPixelInc = destSurface->getPixelInc();
 	
-	for( int32_t y = 0; y < size.y; ++y ) {
+	for( int32_t y = y1; y < y2; ++y ) {
 		const T *src = srcSurface.getData( ivec2( 0, y ) );
 		T *dst = destSurface->getData( ivec2( 0, size.y - y - 1 ) );
 		for( int x = 0; x < size.x; ++x ) {
@@ -134,21 +137,31 @@ void flipVerticalRawRgb( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface
 		}
 	}
 }
-} // anonymous namespace
 
+// flips source rows [y1, y2) of an image sized \a size
 template<typename T>
-void flipVertical( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface )
+void flipVerticalRaw( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface, const ivec2 &size, int32_t y1, int32_t y2 )
 {
-	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), destSurface->getBounds(), destSurface->getBounds(), ivec2(0,0) );
-	
 	if( destSurface->getChannelOrder() == srcSurface.getChannelOrder() )
-		flipVerticalRawSameChannelOrder( srcSurface, destSurface, srcDst.first.getSize() );
+		flipVerticalRawSameChannelOrder( srcSurface, destSurface, size, y1, y2 );
 	else if( destSurface->hasAlpha() && srcSurface.hasAlpha() )
-		flipVerticalRawRgba( srcSurface, destSurface, srcDst.first.getSize() );
+		flipVerticalRawRgba( srcSurface, destSurface, size, y1, y2 );
 	else if( destSurface->hasAlpha() && ( ! srcSurface.hasAlpha() ) )
-		flipVerticalRawRgbFullAlpha( srcSurface, destSurface, srcDst.first.getSize() );
+		flipVerticalRawRgbFullAlpha( srcSurface, destSurface, size, y1, y2 );
 	else
-		flipVerticalRawRgb( srcSurface, destSurface, srcDst.first.getSize() );
+		flipVerticalRawRgb( srcSurface, destSurface, size, y1, y2 );
+}
+} // anonymous namespace
+
+template<typename T>
+void flipVertical( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface )
+{
+	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), destSurface->getBounds(), destSurface->getBounds(), ivec2(0,0) );
+	const ivec2 size = srcDst.first.getSize();
+
+	parallelRows( Area( ivec2( 0 ), size ), size.x * destSurface->getPixelInc() * sizeof(T), [&]( const Area &band ) {
+		flipVerticalRaw( srcSurface, destSurface, size, band.getY1(), band.getY2() );
+	} );
 }
 
 template<typename T>
@@ -156,28 +169,33 @@ void flipVertical( const ChannelT<T> &srcChannel, ChannelT<T> *destChannel )
 {
 	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcChannel.getBounds(), destChannel->getBounds(), destChannel->getBounds(), ivec2(0,0) );
 	
+	const Area area( ivec2( 0 ), srcDst.first.getSize() );
 	if( srcChannel.isPlanar() && destChannel->isPlanar() ) { // both channels are planar, so do a series of memcpy()'s
 		const size_t srcPixelInc = srcChannel.getIncrement();
 		const size_t copyBytes = srcDst.first.getWidth() * srcPixelInc * sizeof(T);
-		for( int32_t y = 0; y < srcDst.first.getHeight(); ++y ) {
-			const T *srcPtr = srcChannel.getData( ivec2( 0, y ) );
-			T *dstPtr = destChannel->getData( ivec2( 0, srcDst.first.getHeight() - y - 1 ) );
-			memcpy( dstPtr, srcPtr, copyBytes );
-		}
+		parallelRows( area, copyBytes, [&]( const Area &band ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+				const T *srcPtr = srcChannel.getData( ivec2( 0, y ) );
+				T *dstPtr = destChannel->getData( ivec2( 0, srcDst.first.getHeight() - y - 1 ) );
+				memcpy( dstPtr, srcPtr, copyBytes );
+			}
+		} );
 	}
 	else {
 		const uint8_t srcInc = srcChannel.getIncrement();
 		const uint8_t destInc = destChannel->getIncrement();
 		const int32_t width = srcDst.first.getWidth();
-		for( int y = 0; y < srcDst.first.getHeight(); ++y ) {
-			const T* src = srcChannel.getData( 0, y );
-			T* dest = destChannel->getData( 0, srcDst.first.getHeight() - 1 - y );
-			for ( int x = 0; x < width; ++x ) {
-				*dest	= *src;
-				src	+= srcInc;
-				dest += destInc;
+		parallelRows( area, width * ( srcInc + destInc ) * sizeof(T), [&]( const Area &band ) {
+			for( int y = band.getY1(); y < band.getY2(); ++y ) {
+				const T* src = srcChannel.getData( 0, y );
+				T* dest = destChannel->getData( 0, srcDst.first.getHeight() - 1 - y );
+				for ( int x = 0; x < width; ++x ) {
+					*dest	= *src;
+					src	+= srcInc;
+					dest += destInc;
+				}
 			}
-		}
+		} );
 	}
 }
 
@@ -187,31 +205,34 @@ void flipHorizontal( SurfaceT<T> *surface )
 	const int32_t height = surface->getHeight();
 	const int32_t width = surface->getWidth();
 	const int32_t halfWidth = width / 2;
+	const uint8_t pixelInc = surface->getPixelInc();
 	
-	if( surface->getPixelInc() == 4 ) {
-		for( int32_t y = 0; y < height; ++y ) {
-			T *rowPtr = surface->getData( ivec2( 0, y ) );
-			for( int32_t x = 0; x < halfWidth; ++x ) {
-				for( int c = 0; c < 4; ++c ) {
-					T temp = rowPtr[x*4+c];
-					rowPtr[x*4+c] = rowPtr[(width-x-1)*4+c];
-					rowPtr[(width-x-1)*4+c] = temp;
+	parallelRows( Area( 0, 0, width, height ), width * pixelInc * sizeof(T), [&]( const Area &band ) {
+		if( pixelInc == 4 ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+				T *rowPtr = surface->getData( ivec2( 0, y ) );
+				for( int32_t x = 0; x < halfWidth; ++x ) {
+					for( int c = 0; c < 4; ++c ) {
+						T temp = rowPtr[x*4+c];
+						rowPtr[x*4+c] = rowPtr[(width-x-1)*4+c];
+						rowPtr[(width-x-1)*4+c] = temp;
+					}
 				}
 			}
 		}
-	}
-	else { // pixel inc of 3
-		for( int32_t y = 0; y < height; ++y ) {
-			T *rowPtr = surface->getData( ivec2( 0, y ) );
-			for( int32_t x = 0; x < halfWidth; ++x ) {
-				for( int c = 0; c < 3; ++c ) {
-					T temp = rowPtr[x*3+c];
-					rowPtr[x*3+c] = rowPtr[(width-x-1)*3+c];
-					rowPtr[(width-x-1)*3+c] = temp;
+		else { // pixel inc of 3
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+				T *rowPtr = surface->getData( ivec2( 0, y ) );
+				for( int32_t x = 0; x < halfWidth; ++x ) {
+					for( int c = 0; c < 3; ++c ) {
+						T temp = rowPtr[x*3+c];
+						rowPtr[x*3+c] = rowPtr[(width-x-1)*3+c];
+						rowPtr[(width-x-1)*3+c] = temp;
+					}
 				}
 			}
 		}
-	}
+	} );
 }
 
 #define flip_PROTOTYPES(T)\
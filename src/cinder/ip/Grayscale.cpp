@@ -21,73 +21,438 @@
 */
 
 #include "cinder/ip/Grayscale.h"
+#include "cinder/ip/ThreadPool.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/System.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_GRAYSCALE_SSE
+	#include <tmmintrin.h>
+	// the 8u kernels gather channels with pshufb, which is SSSE3 and so compiled for it explicitly and chosen at runtime; the 32f kernels only need SSE2
+	#if defined( __SSSE3__ ) || defined( _MSC_VER )
+		#define CINDER_GRAYSCALE_SSSE3_TARGET
+	#else
+		#define CINDER_GRAYSCALE_SSSE3_TARGET __attribute__(( target( "ssse3" ) ))
+	#endif
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_GRAYSCALE_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
-template<typename T>
-void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface )
+namespace {
+
+// The weights of red, green and blue in 8u grays, which sum to 256. The Surface versions use those of CHANTRAIT<uint8_t>::grayscale(),
+// while grayscale( Surface8u, Channel8u* ) has always used its own.
+const uint16_t sSurfaceWeights8u[3] = { 54, 183, 19 };
+const uint16_t sChannelWeights8u[3] = { 74, 147, 35 };
+
+// Where the red, green and blue of a pixel are, and how many elements it spans. A Channel is a single element at offset 0.
+struct GrayLayout {
+	GrayLayout( const SurfaceChannelOrder &channelOrder )
+		: mInc( channelOrder.getPixelInc() ), mOffsets{ channelOrder.getRedOffset(), channelOrder.getGreenOffset(), channelOrder.getBlueOffset() }, mIsChannel( false )
+	{}
+	GrayLayout( uint8_t inc )
+		: mInc( inc ), mOffsets{ 0, 0, 0 }, mIsChannel( true )
+	{}
+
+	// The SIMD kernels store whole pixels, which would reach past the end of the row of a Channel interleaved in a Surface
+	bool	isSimdDestination() const	{ return ! mIsChannel || mInc == 1; }
+
+	uint8_t		mInc;
+	uint8_t		mOffsets[3];
+	bool		mIsChannel;
+};
+
+// The SIMD kernels below convert whole blocks of pixels, 16 for 8u and 4 for 32f, from 3 or 4 element Surface pixels to either Surface pixels or
+// single Channel elements (DST_INC of 1), returning the number of pixels converted. The remainder is left to the scalar loops.
+
+#if defined( CINDER_GRAYSCALE_SSE )
+
+bool hasGrayscaleSsse3()
 {
-	Area area = srcSurface.getBounds().getClipBy( dstSurface->getBounds() );
-
-	int8_t srcPixelInc = srcSurface.getPixelInc();
-	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
-	uint8_t dstRedOffset = dstSurface->getRedOffset(), dstGreenOffset = dstSurface->getGreenOffset(), dstBlueOffset = dstSurface->getBlueOffset();	
-	int8_t dstPixelInc = dstSurface->getPixelInc();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstSurface->getData( ivec2( area.getX1(), y ) );
-		const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			T gray = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
-			dstPtr[dstRedOffset] = gray;
-			dstPtr[dstGreenOffset] = gray;
-			dstPtr[dstBlueOffset] = gray;
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	static const bool sHasSsse3 = System::hasSsse3();
+	return sHasSsse3;
+}
+
+// pshufb masks moving the bytes of the 16 pixels spread over SRC_INC registers to or from the 16 bytes of a single register
+template<int SRC_INC, int DST_INC>
+struct ShuffleMasks8u {
+	ShuffleMasks8u( const GrayLayout &src, const GrayLayout &dst )
+	{
+		for( int c = 0; c < 3; ++c ) {
+			for( int i = 0; i < SRC_INC; ++i ) {
+				for( int k = 0; k < 16; ++k ) {
+					const int pos = k * SRC_INC + src.mOffsets[c] - 16 * i;
+					mGather[c][i][k] = ( pos >= 0 && pos < 16 ) ? (uint8_t)pos : 0x80;
+				}
+			}
+		}
+		for( int j = 0; j < DST_INC; ++j ) {
+			for( int k = 0; k < 16; ++k ) {
+				const int pos = 16 * j + k, lane = pos % DST_INC;
+				const bool isColor = lane == dst.mOffsets[0] || lane == dst.mOffsets[1] || lane == dst.mOffsets[2];
+				mScatter[j][k] = isColor ? (uint8_t)( pos / DST_INC ) : 0x80;
+				mKeep[j][k] = isColor ? 0 : 0xFF;
+			}
 		}
 	}
+
+	uint8_t		mGather[3][SRC_INC][16];
+	uint8_t		mScatter[DST_INC][16];
+	uint8_t		mKeep[DST_INC][16];
+};
+
+template<int SRC_INC, int DST_INC>
+CINDER_GRAYSCALE_SSSE3_TARGET
+int32_t grayscaleRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout, const uint16_t *weights )
+{
+	const ShuffleMasks8u<SRC_INC, DST_INC> masks( srcLayout, dstLayout );
+	__m128i gather[3][SRC_INC], scatter[DST_INC], keep[DST_INC];
+	for( int c = 0; c < 3; ++c )
+		for( int i = 0; i < SRC_INC; ++i )
+			gather[c][i] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( masks.mGather[c][i] ) );
+	for( int j = 0; j < DST_INC; ++j ) {
+		scatter[j] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( masks.mScatter[j] ) );
+		keep[j] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( masks.mKeep[j] ) );
+	}
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i weightR = _mm_set1_epi16( weights[0] ), weightG = _mm_set1_epi16( weights[1] ), weightB = _mm_set1_epi16( weights[2] );
+
+	int32_t x = 0;
+	for( ; x + 16 <= width; x += 16 ) {
+		__m128i in[SRC_INC], channel[3];
+		for( int i = 0; i < SRC_INC; ++i )
+			in[i] = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * SRC_INC + 16 * i ) );
+		for( int c = 0; c < 3; ++c ) {
+			channel[c] = _mm_shuffle_epi8( in[0], gather[c][0] );
+			for( int i = 1; i < SRC_INC; ++i )
+				channel[c] = _mm_or_si128( channel[c], _mm_shuffle_epi8( in[i], gather[c][i] ) );
+		}
+
+		// the weights sum to 256, so the 16-bit sums can't overflow
+		const __m128i lo = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpacklo_epi8( channel[0], zero ), weightR ),
+							_mm_mullo_epi16( _mm_unpacklo_epi8( channel[1], zero ), weightG ) ), _mm_mullo_epi16( _mm_unpacklo_epi8( channel[2], zero ), weightB ) );
+		const __m128i hi = _mm_add_epi16( _mm_add_epi16( _mm_mullo_epi16( _mm_unpackhi_epi8( channel[0], zero ), weightR ),
+							_mm_mullo_epi16( _mm_unpackhi_epi8( channel[1], zero ), weightG ) ), _mm_mullo_epi16( _mm_unpackhi_epi8( channel[2], zero ), weightB ) );
+		const __m128i gray = _mm_packus_epi16( _mm_srli_epi16( lo, 8 ), _mm_srli_epi16( hi, 8 ) );
+
+		if( DST_INC == 1 )
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x ), gray );
+		else {
+			// every source register has been loaded, so this is safe in place
+			for( int j = 0; j < DST_INC; ++j ) {
+				__m128i *p = reinterpret_cast<__m128i*>( dst + x * DST_INC + 16 * j );
+				_mm_storeu_si128( p, _mm_or_si128( _mm_shuffle_epi8( gray, scatter[j] ), _mm_and_si128( _mm_loadu_si128( p ), keep[j] ) ) );
+			}
+		}
+	}
+
+	return x;
 }
 
-template<typename T>
-void grayscale( const SurfaceT<T> &srcSurface, ChannelT<T> *dstChannel )
+template<int SRC_INC, int DST_INC>
+int32_t grayscaleRowSimd( const float *src, float *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
 {
-	Area area = srcSurface.getBounds().getClipBy( dstChannel->getBounds() );
-
-	int8_t srcPixelInc = srcSurface.getPixelInc();
-	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
-	int8_t dstPixelInc = dstChannel->getIncrement();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
-		const T *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			*dstPtr = CHANTRAIT<T>::grayscale( srcPtr[srcRedOffset], srcPtr[srcGreenOffset], srcPtr[srcBlueOffset] );
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	const __m128 weightR = _mm_set1_ps( 0.2126f ), weightG = _mm_set1_ps( 0.7152f ), weightB = _mm_set1_ps( 0.0722f );
+	const uint8_t *srcOffsets = srcLayout.mOffsets;
+	const uint8_t *dstOffsets = dstLayout.mOffsets;
+	__m128 colorMask = _mm_setzero_ps();
+	if( DST_INC == 4 ) {
+		int32_t lanes[4] = { 0, 0, 0, 0 };
+		for( int c = 0; c < 3; ++c )
+			lanes[dstOffsets[c]] = -1;
+		colorMask = _mm_castsi128_ps( _mm_setr_epi32( lanes[0], lanes[1], lanes[2], lanes[3] ) );
+	}
+
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		const float *s = src + x * SRC_INC;
+		__m128 r, g, b;
+		if( SRC_INC == 4 ) {
+			__m128 v[4] = { _mm_loadu_ps( s ), _mm_loadu_ps( s + 4 ), _mm_loadu_ps( s + 8 ), _mm_loadu_ps( s + 12 ) };
+			_MM_TRANSPOSE4_PS( v[0], v[1], v[2], v[3] );
+			r = v[srcOffsets[0]];
+			g = v[srcOffsets[1]];
+			b = v[srcOffsets[2]];
+		}
+		else {
+			r = _mm_setr_ps( s[srcOffsets[0]], s[3 + srcOffsets[0]], s[6 + srcOffsets[0]], s[9 + srcOffsets[0]] );
+			g = _mm_setr_ps( s[srcOffsets[1]], s[3 + srcOffsets[1]], s[6 + srcOffsets[1]], s[9 + srcOffsets[1]] );
+			b = _mm_setr_ps( s[srcOffsets[2]], s[3 + srcOffsets[2]], s[6 + srcOffsets[2]], s[9 + srcOffsets[2]] );
+		}
+		// summed in the same order as CHANTRAIT<float>::grayscale(), so that the results are identical
+		const __m128 gray = _mm_add_ps( _mm_add_ps( _mm_mul_ps( r, weightR ), _mm_mul_ps( g, weightG ) ), _mm_mul_ps( b, weightB ) );
+
+		if( DST_INC == 1 )
+			_mm_storeu_ps( dst + x, gray );
+		else if( DST_INC == 4 ) {
+			float *d = dst + x * 4;
+			const __m128 grays[4] = { _mm_shuffle_ps( gray, gray, _MM_SHUFFLE( 0, 0, 0, 0 ) ), _mm_shuffle_ps( gray, gray, _MM_SHUFFLE( 1, 1, 1, 1 ) ),
+										_mm_shuffle_ps( gray, gray, _MM_SHUFFLE( 2, 2, 2, 2 ) ), _mm_shuffle_ps( gray, gray, _MM_SHUFFLE( 3, 3, 3, 3 ) ) };
+			for( int k = 0; k < 4; ++k )
+				_mm_storeu_ps( d + 4 * k, _mm_or_ps( _mm_and_ps( grays[k], colorMask ), _mm_andnot_ps( colorMask, _mm_loadu_ps( d + 4 * k ) ) ) );
+		}
+		else {
+			float grays[4];
+			_mm_storeu_ps( grays, gray );
+			float *d = dst + x * 3;
+			for( int k = 0; k < 4; ++k, d += 3 )
+				d[dstOffsets[0]] = d[dstOffsets[1]] = d[dstOffsets[2]] = grays[k];
 		}
 	}
+
+	return x;
+}
+
+#elif defined( CINDER_GRAYSCALE_NEON )
+
+inline uint8x16_t grayBlock( uint8x16_t r, uint8x16_t g, uint8x16_t b, const uint16_t *weights )
+{
+	const uint8x8_t weightR = vdup_n_u8( (uint8_t)weights[0] ), weightG = vdup_n_u8( (uint8_t)weights[1] ), weightB = vdup_n_u8( (uint8_t)weights[2] );
+	uint16x8_t lo = vmull_u8( vget_low_u8( r ), weightR );
+	lo = vmlal_u8( lo, vget_low_u8( g ), weightG );
+	lo = vmlal_u8( lo, vget_low_u8( b ), weightB );
+	uint16x8_t hi = vmull_u8( vget_high_u8( r ), weightR );
+	hi = vmlal_u8( hi, vget_high_u8( g ), weightG );
+	hi = vmlal_u8( hi, vget_high_u8( b ), weightB );
+	return vcombine_u8( vshrn_n_u16( lo, 8 ), vshrn_n_u16( hi, 8 ) );
 }
 
+template<typename VECTOR>
+void storeGrayBlock( uint8_t *dst, uint8x16_t gray, const uint8_t *offsets );
+
 template<>
-void grayscale( const Surface8u &srcSurface, Channel8u *dstChannel )
+void storeGrayBlock<uint8x16x3_t>( uint8_t *dst, uint8x16_t gray, const uint8_t * /*offsets*/ )
+{
+	uint8x16x3_t v;
+	v.val[0] = v.val[1] = v.val[2] = gray;
+	vst3q_u8( dst, v );
+}
+
+template<>
+void storeGrayBlock<uint8x16x4_t>( uint8_t *dst, uint8x16_t gray, const uint8_t *offsets )
+{
+	uint8x16x4_t v = vld4q_u8( dst );
+	v.val[offsets[0]] = v.val[offsets[1]] = v.val[offsets[2]] = gray;
+	vst4q_u8( dst, v );
+}
+
+template<int SRC_INC, int DST_INC>
+int32_t grayscaleRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout, const uint16_t *weights )
 {
-	Area area = srcSurface.getBounds().getClipBy( dstChannel->getBounds() );
-
-	int8_t srcPixelInc = srcSurface.getPixelInc();
-	uint8_t srcRedOffset = srcSurface.getRedOffset(), srcGreenOffset = srcSurface.getGreenOffset(), srcBlueOffset = srcSurface.getBlueOffset();
-	int8_t dstPixelInc = dstChannel->getIncrement();
-	const uint8_t redWeight = 74, greenWeight = 147, blueWeight = 35;
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		uint8_t *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) );
-		const uint8_t *srcPtr = srcSurface.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			uint32_t sum = srcPtr[srcRedOffset] * redWeight + srcPtr[srcGreenOffset] * greenWeight + srcPtr[srcBlueOffset] * blueWeight;
-			*dstPtr = static_cast<uint8_t>( sum >> 8 );
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	const uint8_t *srcOffsets = srcLayout.mOffsets;
+	int32_t x = 0;
+	for( ; x + 16 <= width; x += 16 ) {
+		uint8x16_t gray;
+		if( SRC_INC == 4 ) {
+			const uint8x16x4_t v = vld4q_u8( src + x * 4 );
+			gray = grayBlock( v.val[srcOffsets[0]], v.val[srcOffsets[1]], v.val[srcOffsets[2]], weights );
 		}
+		else {
+			const uint8x16x3_t v = vld3q_u8( src + x * 3 );
+			gray = grayBlock( v.val[srcOffsets[0]], v.val[srcOffsets[1]], v.val[srcOffsets[2]], weights );
+		}
+
+		if( DST_INC == 1 )
+			vst1q_u8( dst + x, gray );
+		else if( DST_INC == 3 )
+			storeGrayBlock<uint8x16x3_t>( dst + x * 3, gray, dstLayout.mOffsets );
+		else
+			storeGrayBlock<uint8x16x4_t>( dst + x * 4, gray, dstLayout.mOffsets );
+	}
+
+	return x;
+}
+
+template<int SRC_INC, int DST_INC>
+int32_t grayscaleRowSimd( const float *src, float *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
+{
+	const uint8_t *srcOffsets = srcLayout.mOffsets, *dstOffsets = dstLayout.mOffsets;
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		float32x4_t r, g, b;
+		if( SRC_INC == 4 ) {
+			const float32x4x4_t v = vld4q_f32( src + x * 4 );
+			r = v.val[srcOffsets[0]]; g = v.val[srcOffsets[1]]; b = v.val[srcOffsets[2]];
+		}
+		else {
+			const float32x4x3_t v = vld3q_f32( src + x * 3 );
+			r = v.val[srcOffsets[0]]; g = v.val[srcOffsets[1]]; b = v.val[srcOffsets[2]];
+		}
+		const float32x4_t gray = vaddq_f32( vaddq_f32( vmulq_n_f32( r, 0.2126f ), vmulq_n_f32( g, 0.7152f ) ), vmulq_n_f32( b, 0.0722f ) );
+
+		if( DST_INC == 1 )
+			vst1q_f32( dst + x, gray );
+		else if( DST_INC == 3 ) {
+			float32x4x3_t v;
+			v.val[0] = v.val[1] = v.val[2] = gray;
+			vst3q_f32( dst + x * 3, v );
+		}
+		else {
+			float32x4x4_t v = vld4q_f32( dst + x * 4 );
+			v.val[dstOffsets[0]] = v.val[dstOffsets[1]] = v.val[dstOffsets[2]] = gray;
+			vst4q_f32( dst + x * 4, v );
+		}
+	}
+
+	return x;
+}
+
+#endif
+
+#if defined( CINDER_GRAYSCALE_SSE ) || defined( CINDER_GRAYSCALE_NEON )
+
+template<int SRC_INC>
+int32_t grayscaleRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout, const uint16_t *weights )
+{
+	switch( dstLayout.mInc ) {
+		case 1: return grayscaleRowSimd<SRC_INC, 1>( src, dst, width, srcLayout, dstLayout, weights );
+		case 3: return grayscaleRowSimd<SRC_INC, 3>( src, dst, width, srcLayout, dstLayout, weights );
+		case 4: return grayscaleRowSimd<SRC_INC, 4>( src, dst, width, srcLayout, dstLayout, weights );
+		default: return 0;
+	}
+}
+
+template<int SRC_INC>
+int32_t grayscaleRowSimd( const float *src, float *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
+{
+	switch( dstLayout.mInc ) {
+		case 1: return grayscaleRowSimd<SRC_INC, 1>( src, dst, width, srcLayout, dstLayout );
+		case 3: return grayscaleRowSimd<SRC_INC, 3>( src, dst, width, srcLayout, dstLayout );
+		case 4: return grayscaleRowSimd<SRC_INC, 4>( src, dst, width, srcLayout, dstLayout );
+		default: return 0;
+	}
+}
+
+// Returns the number of leading pixels converted with SIMD, which is zero when it isn't available for the layouts
+int32_t grayscaleRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout, const uint16_t *weights )
+{
+  #if defined( CINDER_GRAYSCALE_SSE )
+	if( ! hasGrayscaleSsse3() )
+		return 0;
+  #endif
+	if( ! dstLayout.isSimdDestination() )
+		return 0;
+	switch( srcLayout.mInc ) {
+		case 3: return grayscaleRowSimd<3>( src, dst, width, srcLayout, dstLayout, weights );
+		case 4: return grayscaleRowSimd<4>( src, dst, width, srcLayout, dstLayout, weights );
+		default: return 0;
+	}
+}
+
+int32_t grayscaleRowSimd( const float *src, float *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
+{
+	if( ! dstLayout.isSimdDestination() )
+		return 0;
+	switch( srcLayout.mInc ) {
+		case 3: return grayscaleRowSimd<3>( src, dst, width, srcLayout, dstLayout );
+		case 4: return grayscaleRowSimd<4>( src, dst, width, srcLayout, dstLayout );
+		default: return 0;
 	}
 }
 
+#else
+
+int32_t grayscaleRowSimd( const uint8_t * /*src*/, uint8_t * /*dst*/, int32_t /*width*/, const GrayLayout & /*srcLayout*/, const GrayLayout & /*dstLayout*/, const uint16_t * /*weights*/ )
+{
+	return 0;
+}
+
+int32_t grayscaleRowSimd( const float * /*src*/, float * /*dst*/, int32_t /*width*/, const GrayLayout & /*srcLayout*/, const GrayLayout & /*dstLayout*/ )
+{
+	return 0;
+}
+
+#endif
+
+// Writes \a gray to the red, green and blue of \a dst, or to its only element when it's a Channel
+template<typename T>
+inline void storeGray( T *dst, T gray, const GrayLayout &dstLayout )
+{
+	dst[dstLayout.mOffsets[0]] = gray;
+	dst[dstLayout.mOffsets[1]] = gray;
+	dst[dstLayout.mOffsets[2]] = gray;
+}
+
+void grayscaleRowImpl( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout, const uint16_t *weights )
+{
+	const int32_t simdWidth = grayscaleRowSimd( src, dst, width, srcLayout, dstLayout, weights );
+	src += simdWidth * srcLayout.mInc;
+	dst += simdWidth * dstLayout.mInc;
+	const uint8_t red = srcLayout.mOffsets[0], green = srcLayout.mOffsets[1], blue = srcLayout.mOffsets[2];
+	for( int32_t x = simdWidth; x < width; ++x ) {
+		const uint32_t sum = src[red] * weights[0] + src[green] * weights[1] + src[blue] * weights[2];
+		storeGray( dst, static_cast<uint8_t>( sum >> 8 ), dstLayout );
+		src += srcLayout.mInc;
+		dst += dstLayout.mInc;
+	}
+}
+
+template<typename T>
+void grayscaleRowImpl( const T *src, T *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
+{
+	int32_t simdWidth = 0;
+	if( std::is_same<T, float>::value )
+		simdWidth = grayscaleRowSimd( reinterpret_cast<const float*>( src ), reinterpret_cast<float*>( dst ), width, srcLayout, dstLayout );
+	src += simdWidth * srcLayout.mInc;
+	dst += simdWidth * dstLayout.mInc;
+	const uint8_t red = srcLayout.mOffsets[0], green = srcLayout.mOffsets[1], blue = srcLayout.mOffsets[2];
+	for( int32_t x = simdWidth; x < width; ++x ) {
+		storeGray( dst, CHANTRAIT<T>::grayscale( src[red], src[green], src[blue] ), dstLayout );
+		src += srcLayout.mInc;
+		dst += dstLayout.mInc;
+	}
+}
+
+template<>
+void grayscaleRowImpl<uint8_t>( const uint8_t *src, uint8_t *dst, int32_t width, const GrayLayout &srcLayout, const GrayLayout &dstLayout )
+{
+	grayscaleRowImpl( src, dst, width, srcLayout, dstLayout, sSurfaceWeights8u );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void grayscaleRow( const T *src, T *dst, int32_t width, const SurfaceChannelOrder &srcChannelOrder, const SurfaceChannelOrder &dstChannelOrder )
+{
+	grayscaleRowImpl( src, dst, width, GrayLayout( srcChannelOrder ), GrayLayout( dstChannelOrder ) );
+}
+
+template<typename T>
+void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface )
+{
+	const Area area = srcSurface.getBounds().getClipBy( dstSurface->getBounds() );
+	const GrayLayout srcLayout( srcSurface.getChannelOrder() ), dstLayout( dstSurface->getChannelOrder() );
+	parallelRows( area, area.getWidth() * ( srcLayout.mInc + dstLayout.mInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+			grayscaleRowImpl( srcSurface.getData( ivec2( area.getX1(), y ) ), dstSurface->getData( ivec2( area.getX1(), y ) ), area.getWidth(), srcLayout, dstLayout );
+	} );
+}
+
+template<typename T>
+void grayscale( const SurfaceT<T> &srcSurface, ChannelT<T> *dstChannel )
+{
+	const Area area = srcSurface.getBounds().getClipBy( dstChannel->getBounds() );
+	const GrayLayout srcLayout( srcSurface.getChannelOrder() ), dstLayout( dstChannel->getIncrement() );
+	parallelRows( area, area.getWidth() * ( srcLayout.mInc + dstLayout.mInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+			grayscaleRowImpl( srcSurface.getData( ivec2( area.getX1(), y ) ), dstChannel->getData( ivec2( area.getX1(), y ) ), area.getWidth(), srcLayout, dstLayout );
+	} );
+}
+
+template<>
+void grayscale( const Surface8u &srcSurface, Channel8u *dstChannel )
+{
+	const Area area = srcSurface.getBounds().getClipBy( dstChannel->getBounds() );
+	const GrayLayout srcLayout( srcSurface.getChannelOrder() ), dstLayout( dstChannel->getIncrement() );
+	parallelRows( area, area.getWidth() * ( srcLayout.mInc + dstLayout.mInc ), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+			grayscaleRowImpl( srcSurface.getData( ivec2( area.getX1(), y ) ), dstChannel->getData( ivec2( area.getX1(), y ) ), area.getWidth(), srcLayout, dstLayout, sChannelWeights8u );
+	} );
+}
+
 #define grayscale_PROTOTYPES(T)\
 	template CI_API void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface );
 	
@@ -97,5 +462,8 @@ template CI_API void grayscale( const SurfaceT<float> &srcSurface, ChannelT<floa
 grayscale_PROTOTYPES(uint8_t)
 grayscale_PROTOTYPES(float)
 
+template CI_API void grayscaleRow( const uint8_t *src, uint8_t *dst, int32_t width, const SurfaceChannelOrder &srcChannelOrder, const SurfaceChannelOrder &dstChannelOrder );
+template CI_API void grayscaleRow( const uint16_t *src, uint16_t *dst, int32_t width, const SurfaceChannelOrder &srcChannelOrder, const SurfaceChannelOrder &dstChannelOrder );
+template CI_API void grayscaleRow( const float *src, float *dst, int32_t width, const SurfaceChannelOrder &srcChannelOrder, const SurfaceChannelOrder &dstChannelOrder );
 
 } } // namespace cinder::ip
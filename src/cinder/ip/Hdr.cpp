@@ -24,55 +24,181 @@
 #include "cinder/ip/Grayscale.h"
 #include "cinder/ChanTraits.h"
 #include "cinder/ip/Fill.h"
+#include "cinder/ip/ThreadPool.h"
 #include <algorithm>
+#include <mutex>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_HDR_SSE
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_HDR_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
-void hdrNormalize( Surface32f *surface )
+namespace {
+
+// Rows are processed as runs of floats, 4 at a time. Pixels of 1 or 4 elements line up with those blocks, so \a isColor marks the same lanes
+// in each, while 3 element pixels are all color. Lanes which aren't color are left out of the extremes and keep their values when normalized.
+struct ColorLanes {
+	ColorLanes( const SurfaceChannelOrder &channelOrder )
+		: mPixelInc( channelOrder.getPixelInc() ), mIsColor{ false, false, false, false }
+	{
+		mIsColor[channelOrder.getRedOffset()] = mIsColor[channelOrder.getGreenOffset()] = mIsColor[channelOrder.getBlueOffset()] = true;
+		if( mPixelInc == 3 )
+			mIsColor[3] = true;
+		mAllColor = mIsColor[0] && mIsColor[1] && mIsColor[2] && mIsColor[3];
+	}
+	ColorLanes()
+		: mPixelInc( 1 ), mIsColor{ true, true, true, true }, mAllColor( true )
+	{}
+
+	uint8_t		mPixelInc;
+	bool		mIsColor[4];
+	bool		mAllColor;
+};
+
+// Accumulates the extremes of the color elements of the \a count elements at \a data into \a minVal and \a maxVal. The comparisons match
+// std::min() and std::max(), so that a NaN never replaces an extreme.
+void minMaxRow( const float *data, int32_t count, const ColorLanes &lanes, float *minVal, float *maxVal )
 {
-	// first take histogram to find the minimum and maximum values present
-	float minVal = *(surface->getDataRed( ivec2() )), maxVal = *(surface->getDataRed( ivec2() ));
-
-	const int8_t pixelInc = surface->getPixelInc();
-	const uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset();
-	for( int32_t y = 0; y < surface->getHeight(); ++y ) {
-		const float *srcPtr = surface->getData( ivec2( 0, y ) );
-		for( int32_t x = 0; x < surface->getWidth(); ++x ) {
-			minVal = std::min( minVal, srcPtr[redOffset] );
-			maxVal = std::max( maxVal, srcPtr[redOffset] );
-			minVal = std::min( minVal, srcPtr[greenOffset] );
-			maxVal = std::max( maxVal, srcPtr[greenOffset] );
-			minVal = std::min( minVal, srcPtr[blueOffset] );
-			maxVal = std::max( maxVal, srcPtr[blueOffset] );
-
-			srcPtr += pixelInc;
+	int32_t e = 0;
+#if defined( CINDER_HDR_SSE )
+	const __m128 color = _mm_castsi128_ps( _mm_setr_epi32( lanes.mIsColor[0] ? -1 : 0, lanes.mIsColor[1] ? -1 : 0, lanes.mIsColor[2] ? -1 : 0, lanes.mIsColor[3] ? -1 : 0 ) );
+	// an element which isn't color is replaced by the current minimum, which changes neither extreme
+	const __m128 neutral = _mm_set1_ps( *minVal );
+	__m128 minAcc = _mm_set1_ps( *minVal ), maxAcc = _mm_set1_ps( *maxVal );
+	for( ; e + 4 <= count; e += 4 ) {
+		__m128 v = _mm_loadu_ps( data + e );
+		if( ! lanes.mAllColor )
+			v = _mm_or_ps( _mm_and_ps( v, color ), _mm_andnot_ps( color, neutral ) );
+		minAcc = _mm_min_ps( v, minAcc );
+		maxAcc = _mm_max_ps( v, maxAcc );
+	}
+	float mins[4], maxs[4];
+	_mm_storeu_ps( mins, minAcc );
+	_mm_storeu_ps( maxs, maxAcc );
+	for( int i = 0; i < 4; ++i ) {
+		*minVal = std::min( *minVal, mins[i] );
+		*maxVal = std::max( *maxVal, maxs[i] );
+	}
+#elif defined( CINDER_HDR_NEON )
+	const uint32_t colorLanes[4] = { lanes.mIsColor[0] ? 0xFFFFFFFFu : 0, lanes.mIsColor[1] ? 0xFFFFFFFFu : 0, lanes.mIsColor[2] ? 0xFFFFFFFFu : 0, lanes.mIsColor[3] ? 0xFFFFFFFFu : 0 };
+	const uint32x4_t color = vld1q_u32( colorLanes );
+	const float32x4_t neutral = vdupq_n_f32( *minVal );
+	float32x4_t minAcc = vdupq_n_f32( *minVal ), maxAcc = vdupq_n_f32( *maxVal );
+	for( ; e + 4 <= count; e += 4 ) {
+		float32x4_t v = vld1q_f32( data + e );
+		if( ! lanes.mAllColor )
+			v = vbslq_f32( color, v, neutral );
+		// vminq_f32() and vmaxq_f32() propagate NaNs
+		minAcc = vbslq_f32( vcltq_f32( v, minAcc ), v, minAcc );
+		maxAcc = vbslq_f32( vcgtq_f32( v, maxAcc ), v, maxAcc );
+	}
+	float mins[4], maxs[4];
+	vst1q_f32( mins, minAcc );
+	vst1q_f32( maxs, maxAcc );
+	for( int i = 0; i < 4; ++i ) {
+		*minVal = std::min( *minVal, mins[i] );
+		*maxVal = std::max( *maxVal, maxs[i] );
+	}
+#endif
+	for( ; e < count; ++e ) {
+		if( lanes.mIsColor[e % lanes.mPixelInc] ) {
+			*minVal = std::min( *minVal, data[e] );
+			*maxVal = std::max( *maxVal, data[e] );
 		}
 	}
-	
+}
+
+// Maps the color elements of the \a count elements at \a data from [minVal,minVal+1/scale] to [0,1]
+void normalizeRow( float *data, int32_t count, const ColorLanes &lanes, float minVal, float scale )
+{
+	int32_t e = 0;
+#if defined( CINDER_HDR_SSE )
+	const __m128 color = _mm_castsi128_ps( _mm_setr_epi32( lanes.mIsColor[0] ? -1 : 0, lanes.mIsColor[1] ? -1 : 0, lanes.mIsColor[2] ? -1 : 0, lanes.mIsColor[3] ? -1 : 0 ) );
+	const __m128 minVec = _mm_set1_ps( minVal ), scaleVec = _mm_set1_ps( scale );
+	for( ; e + 4 <= count; e += 4 ) {
+		const __m128 v = _mm_loadu_ps( data + e );
+		const __m128 normalized = _mm_mul_ps( _mm_sub_ps( v, minVec ), scaleVec );
+		_mm_storeu_ps( data + e, lanes.mAllColor ? normalized : _mm_or_ps( _mm_and_ps( normalized, color ), _mm_andnot_ps( color, v ) ) );
+	}
+#elif defined( CINDER_HDR_NEON )
+	const uint32_t colorLanes[4] = { lanes.mIsColor[0] ? 0xFFFFFFFFu : 0, lanes.mIsColor[1] ? 0xFFFFFFFFu : 0, lanes.mIsColor[2] ? 0xFFFFFFFFu : 0, lanes.mIsColor[3] ? 0xFFFFFFFFu : 0 };
+	const uint32x4_t color = vld1q_u32( colorLanes );
+	const float32x4_t minVec = vdupq_n_f32( minVal ), scaleVec = vdupq_n_f32( scale );
+	for( ; e + 4 <= count; e += 4 ) {
+		const float32x4_t v = vld1q_f32( data + e );
+		const float32x4_t normalized = vmulq_f32( vsubq_f32( v, minVec ), scaleVec );
+		vst1q_f32( data + e, lanes.mAllColor ? normalized : vbslq_f32( color, normalized, v ) );
+	}
+#endif
+	for( ; e < count; ++e ) {
+		if( lanes.mIsColor[e % lanes.mPixelInc] )
+			data[e] = ( data[e] - minVal ) * scale;
+	}
+}
+
+// Finds the extremes of the color elements of \a surface in a single pass, each band of rows merging its own into the result
+void surfaceMinMax( const Surface32f &surface, float *resultMin, float *resultMax )
+{
+	const float firstVal = *(surface.getDataRed( ivec2() ));
+	float minVal = firstVal, maxVal = firstVal;
+
+	const ColorLanes lanes( surface.getChannelOrder() );
+	const int32_t rowElements = surface.getWidth() * lanes.mPixelInc;
+	std::mutex minMaxMutex;
+	parallelRows( surface.getBounds(), rowElements * sizeof(float), [&]( const Area &band ) {
+		float bandMin = firstVal, bandMax = firstVal;
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+			minMaxRow( surface.getData( ivec2( 0, y ) ), rowElements, lanes, &bandMin, &bandMax );
+
+		std::lock_guard<std::mutex> lock( minMaxMutex );
+		minVal = std::min( minVal, bandMin );
+		maxVal = std::max( maxVal, bandMax );
+	} );
+	*resultMin = minVal;
+	*resultMax = maxVal;
+}
+
+} // anonymous namespace
+
+void hdrNormalize( Surface32f *surface, float *resultMin, float *resultMax )
+{
+	// Every output depends on the extremes of the whole Surface, so they have to be found in a pass of their own before normalizing
+	float minVal, maxVal;
+	surfaceMinMax( *surface, &minVal, &maxVal );
+	if( resultMin )
+		*resultMin = minVal;
+	if( resultMax )
+		*resultMax = maxVal;
+
 	// if min==max then we should just fill with black
 	if( minVal == maxVal ) {
 		fill( surface, Color( 0, 0, 0 ) );
 		return;
 	}
 	
-	float scale = 1.0f / ( maxVal - minVal );
-	for( int32_t y = 0; y < surface->getHeight(); ++y ) {
-		float *dstPtr = surface->getData( ivec2( 0, y ) );
-		for( int32_t x = 0; x < surface->getWidth(); ++x ) {
-			dstPtr[redOffset] = ( dstPtr[redOffset] - minVal ) * scale;
-			dstPtr[greenOffset] = ( dstPtr[greenOffset] - minVal ) * scale;
-			dstPtr[blueOffset] = ( dstPtr[blueOffset] - minVal ) * scale;
-
-			dstPtr += pixelInc;
-		}
-	}	
+	const float scale = 1.0f / ( maxVal - minVal );
+	const ColorLanes lanes( surface->getChannelOrder() );
+	const int32_t rowElements = surface->getWidth() * lanes.mPixelInc;
+	parallelRows( surface->getBounds(), rowElements * sizeof(float), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+			normalizeRow( surface->getData( ivec2( 0, y ) ), rowElements, lanes, minVal, scale );
+	} );
 }
 
-void hdrNormalize( Channel32f *channel )
+void hdrNormalize( Channel32f *channel, float *resultMin, float *resultMax )
 {
 	// first take histogram to find the minimum and maximum values present
 	float minVal, maxVal;
 	getMinMax( *channel, &minVal, &maxVal );
+	if( resultMin )
+		*resultMin = minVal;
+	if( resultMax )
+		*resultMax = maxVal;
 
 	// if min==max then we should just fill with black
 	if( minVal == maxVal ) {
@@ -81,24 +207,53 @@ void hdrNormalize( Channel32f *channel )
 	}
 	
 	float scale = 1.0f / ( maxVal - minVal );
-	Channel32f::Iter iter = channel->getIter();
-	while( iter.line() ) {
-		while( iter.pixel() ) {
-			iter.v() = ( iter.v() - minVal ) * scale;
+	const bool planar = channel->getIncrement() == 1;
+	parallelRows( channel->getBounds(), channel->getWidth() * channel->getIncrement() * sizeof(float), [&]( const Area &band ) {
+		if( planar ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+				normalizeRow( channel->getData( ivec2( 0, y ) ), channel->getWidth(), ColorLanes(), minVal, scale );
+			return;
 		}
-	}
+		Channel32f::Iter iter = channel->getIter( band );
+		while( iter.line() ) {
+			while( iter.pixel() ) {
+				iter.v() = ( iter.v() - minVal ) * scale;
+			}
+		}
+	} );
+}
+
+void getMinMax( const Surface32f &surface, float *resultMin, float *resultMax )
+{
+	surfaceMinMax( surface, resultMin, resultMax );
 }
 
 void getMinMax( const Channel32f &channel, float *resultMin, float *resultMax )
 {
-	float minVal = *(channel.getData( ivec2() )), maxVal = *(channel.getData( ivec2() ));
-	Channel32f::ConstIter iter = channel.getIter();
-	while( iter.line() ) {
-		while( iter.pixel() ) {
-			minVal = std::min( minVal, iter.v() );
-			maxVal = std::max( maxVal, iter.v() );
+	const float firstVal = *(channel.getData( ivec2() ));
+	float minVal = firstVal, maxVal = firstVal;
+	const bool planar = channel.getIncrement() == 1;
+	std::mutex minMaxMutex;
+	parallelRows( channel.getBounds(), channel.getWidth() * channel.getIncrement() * sizeof(float), [&]( const Area &band ) {
+		float bandMin = firstVal, bandMax = firstVal;
+		if( planar ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+				minMaxRow( channel.getData( ivec2( 0, y ) ), channel.getWidth(), ColorLanes(), &bandMin, &bandMax );
 		}
-	}
+		else {
+			Channel32f::ConstIter iter = channel.getIter( band );
+			while( iter.line() ) {
+				while( iter.pixel() ) {
+					bandMin = std::min( bandMin, iter.v() );
+					bandMax = std::max( bandMax, iter.v() );
+				}
+			}
+		}
+
+		std::lock_guard<std::mutex> lock( minMaxMutex );
+		minVal = std::min( minVal, bandMin );
+		maxVal = std::max( maxVal, bandMax );
+	} );
 	*resultMin = minVal;
 	*resultMax = maxVal;
 }
@@ -0,0 +1,189 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+
+namespace cinder { namespace ip {
+
+template<typename T>
+IntegralImageT<T>::IntegralImageT( const ChannelT<T> &channel, bool computeSquares )
+{
+	allocate( channel.getSize(), 1, computeSquares );
+	const uint8_t offsets[1] = { 0 };
+	calculate( channel.getData(), channel.getRowBytes(), channel.getIncrement(), offsets, ivec2( 0 ) );
+}
+
+template<typename T>
+IntegralImageT<T>::IntegralImageT( const SurfaceT<T> &surface, bool computeSquares )
+{
+	allocate( surface.getSize(), surface.hasAlpha() ? 4 : 3, computeSquares );
+	const uint8_t offsets[4] = { surface.getRedOffset(), surface.getGreenOffset(), surface.getBlueOffset(), surface.hasAlpha() ? surface.getAlphaOffset() : (uint8_t)0 };
+	calculate( surface.getData(), surface.getRowBytes(), surface.getPixelInc(), offsets, ivec2( 0 ) );
+}
+
+template<typename T>
+void IntegralImageT<T>::allocate( const ivec2 &size, uint8_t numChannels, bool computeSquares )
+{
+	mSize = size;
+	mNumChannels = numChannels;
+	mHasSquares = computeSquares;
+
+	// the first row and column stay zero, which removes any special cases for areas touching the top or left edges
+	const size_t numEntries = ( size.x + 1 ) * ( size.y + 1 ) * numChannels;
+	mSums.assign( numEntries, 0 );
+	if( computeSquares )
+		mSquares.assign( numEntries, 0 );
+	else
+		mSquares.clear();
+}
+
+template<typename T>
+void IntegralImageT<T>::update( const ChannelT<T> &channel, const Area &dirtyArea )
+{
+	CI_ASSERT( channel.getSize() == mSize && mNumChannels == 1 );
+
+	const Area clipped = dirtyArea.getClipBy( channel.getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return;
+
+	const uint8_t offsets[1] = { 0 };
+	calculate( channel.getData(), channel.getRowBytes(), channel.getIncrement(), offsets, clipped.getUL() );
+}
+
+template<typename T>
+void IntegralImageT<T>::update( const SurfaceT<T> &surface, const Area &dirtyArea )
+{
+	CI_ASSERT( surface.getSize() == mSize && mNumChannels == ( surface.hasAlpha() ? 4 : 3 ) );
+
+	const Area clipped = dirtyArea.getClipBy( surface.getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return;
+
+	const uint8_t offsets[4] = { surface.getRedOffset(), surface.getGreenOffset(), surface.getBlueOffset(), surface.hasAlpha() ? surface.getAlphaOffset() : (uint8_t)0 };
+	calculate( surface.getData(), surface.getRowBytes(), surface.getPixelInc(), offsets, clipped.getUL() );
+}
+
+template<typename T>
+void IntegralImageT<T>::calculate( const T *data, ptrdiff_t rowBytes, uint8_t pixelInc, const uint8_t *channelOffsets, const ivec2 &pixelUL )
+{
+	const int32_t width = mSize.x, height = mSize.y;
+	const uint8_t numChannels = mNumChannels;
+	const size_t tableRowInc = ( width + 1 ) * numChannels;
+
+	// Entries left of pixelUL.x only depend on unchanged pixels. Each recomputed row starts from the sum of its pixels
+	// left of pixelUL.x, which is the difference between the two entries above one another in column pixelUL.x.
+	SumT rowSums[4], rowSquares[4];
+	for( int32_t y = pixelUL.y; y < height; ++y ) {
+		const T *src = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( data ) + y * rowBytes ) + pixelUL.x * pixelInc;
+		const size_t entry = ( y + 1 ) * tableRowInc + pixelUL.x * numChannels;
+		SumT *sums = &mSums[entry];
+		for( uint8_t c = 0; c < numChannels; ++c )
+			rowSums[c] = sums[c] - ( sums - tableRowInc )[c];
+
+		SumT *squares = nullptr;
+		if( mHasSquares ) {
+			squares = &mSquares[entry];
+			for( uint8_t c = 0; c < numChannels; ++c )
+				rowSquares[c] = squares[c] - ( squares - tableRowInc )[c];
+		}
+
+		for( int32_t x = pixelUL.x; x < width; ++x ) {
+			sums += numChannels;
+			for( uint8_t c = 0; c < numChannels; ++c ) {
+				rowSums[c] += static_cast<SumT>( src[channelOffsets[c]] );
+				sums[c] = ( sums - tableRowInc )[c] + rowSums[c];
+			}
+
+			if( squares ) {
+				squares += numChannels;
+				for( uint8_t c = 0; c < numChannels; ++c ) {
+					const SumT v = static_cast<SumT>( src[channelOffsets[c]] );
+					rowSquares[c] += v * v;
+					squares[c] = ( squares - tableRowInc )[c] + rowSquares[c];
+				}
+			}
+
+			src += pixelInc;
+		}
+	}
+}
+
+template<typename T>
+typename IntegralImageT<T>::SumT IntegralImageT<T>::tableSum( const std::vector<SumT> &table, const Area &clipped, uint8_t channel ) const
+{
+	const size_t tableRowInc = ( mSize.x + 1 ) * mNumChannels;
+	const SumT *upper = &table[clipped.y1 * tableRowInc + channel];
+	const SumT *lower = &table[clipped.y2 * tableRowInc + channel];
+	const size_t left = clipped.x1 * mNumChannels, right = clipped.x2 * mNumChannels;
+
+	return ( lower[right] - lower[left] ) - ( upper[right] - upper[left] );
+}
+
+template<typename T>
+typename IntegralImageT<T>::SumT IntegralImageT<T>::areaSum( const Area &area, uint8_t channel ) const
+{
+	CI_ASSERT( channel < mNumChannels );
+
+	const Area clipped = area.getClipBy( Area( ivec2( 0 ), mSize ) );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return 0;
+
+	return tableSum( mSums, clipped, channel );
+}
+
+template<typename T>
+double IntegralImageT<T>::areaAverage( const Area &area, uint8_t channel ) const
+{
+	CI_ASSERT( channel < mNumChannels );
+
+	const Area clipped = area.getClipBy( Area( ivec2( 0 ), mSize ) );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return 0;
+
+	return (double)tableSum( mSums, clipped, channel ) / ( (double)clipped.getWidth() * clipped.getHeight() );
+}
+
+template<typename T>
+double IntegralImageT<T>::areaVariance( const Area &area, uint8_t channel ) const
+{
+	CI_ASSERT( channel < mNumChannels && mHasSquares );
+
+	const Area clipped = area.getClipBy( Area( ivec2( 0 ), mSize ) );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 || ! mHasSquares )
+		return 0;
+
+	const double count = (double)clipped.getWidth() * clipped.getHeight();
+	const double mean = (double)tableSum( mSums, clipped, channel ) / count;
+	const double meanOfSquares = (double)tableSum( mSquares, clipped, channel ) / count;
+
+	// rounding can leave a tiny negative result for uniform areas of floats
+	return std::max( 0.0, meanOfSquares - mean * mean );
+}
+
+template class CI_API IntegralImageT<uint8_t>;
+template class CI_API IntegralImageT<uint16_t>;
+template class CI_API IntegralImageT<float>;
+
+} } // namespace cinder::ip
@@ -0,0 +1,243 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/ChanTraits.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder { namespace ip {
+
+template<typename T>
+PipelineT<T>::PipelineT( SurfaceT<T> *surface )
+	: mSurface( surface ), mChannel( nullptr ), mData( surface->getData() ), mWidth( surface->getWidth() ), mHeight( surface->getHeight() ),
+	mRowBytes( surface->getRowBytes() ), mPixelInc( surface->getPixelInc() ), mRedOffset( surface->getRedOffset() ),
+	mGreenOffset( surface->getGreenOffset() ), mBlueOffset( surface->getBlueOffset() ), mAlphaOffset( surface->hasAlpha() ? surface->getAlphaOffset() : 0 ),
+	mHasAlpha( surface->hasAlpha() )
+{
+}
+
+template<typename T>
+PipelineT<T>::PipelineT( ChannelT<T> *channel )
+	: mSurface( nullptr ), mChannel( channel ), mData( channel->getData() ), mWidth( channel->getWidth() ), mHeight( channel->getHeight() ),
+	mRowBytes( channel->getRowBytes() ), mPixelInc( channel->getIncrement() ), mRedOffset( 0 ), mGreenOffset( 0 ), mBlueOffset( 0 ), mAlphaOffset( 0 ),
+	mHasAlpha( false )
+{
+}
+
+template<typename T>
+typename PipelineT<T>::Stage& PipelineT<T>::getPointStage()
+{
+	if( mStages.empty() || mStages.back().mType != Stage::POINT )
+		mStages.push_back( Stage( Stage::POINT ) );
+
+	return mStages.back();
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::grayscale()
+{
+	if( ! mSurface )
+		return *this;
+
+	const SurfaceChannelOrder channelOrder = mSurface->getChannelOrder();
+	return pointOp( [=]( T *row, int32_t width, uint8_t /*pixelInc*/ ) {
+		ip::grayscaleRow( row, row, width, channelOrder, channelOrder );
+	} );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::threshold( T value )
+{
+	const T maxValue = CHANTRAIT<T>::max();
+	if( ! mSurface ) {
+		return pointOp( [=]( T *row, int32_t width, uint8_t pixelInc ) {
+			for( int32_t x = 0; x < width; ++x ) {
+				*row = ( *row > value ) ? maxValue : 0;
+				row += pixelInc;
+			}
+		} );
+	}
+
+	const SurfaceChannelOrder channelOrder = mSurface->getChannelOrder();
+	return pointOp( [=]( T *row, int32_t width, uint8_t /*pixelInc*/ ) {
+		ip::thresholdRow( row, row, width, channelOrder, value );
+	} );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::premultiply()
+{
+	if( ! mHasAlpha )
+		return *this;
+
+	const SurfaceChannelOrder channelOrder = mSurface->getChannelOrder();
+	pointOp( [=]( T *row, int32_t width, uint8_t /*pixelInc*/ ) {
+		ip::premultiplyRow( row, width, channelOrder );
+	} );
+	getPointStage().mSetPremultiplied = 1;
+
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::unpremultiply()
+{
+	if( ! mHasAlpha )
+		return *this;
+
+	const SurfaceChannelOrder channelOrder = mSurface->getChannelOrder();
+	pointOp( [=]( T *row, int32_t width, uint8_t /*pixelInc*/ ) {
+		ip::unpremultiplyRow( row, width, channelOrder );
+	} );
+	getPointStage().mSetPremultiplied = 0;
+
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipVertical()
+{
+	// point operations don't depend on position, so a flip can be done at any point within the fused pass
+	Stage &stage = getPointStage();
+	stage.mFlipVertical = ! stage.mFlipVertical;
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipHorizontal()
+{
+	Stage &stage = getPointStage();
+	stage.mFlipHorizontal = ! stage.mFlipHorizontal;
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::pointOp( const RowFn &fn )
+{
+	getPointStage().mRowFns.push_back( fn );
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::stackBlur( int radius )
+{
+	mStages.push_back( Stage( Stage::STACK_BLUR, radius ) );
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::edgeDetectSobel()
+{
+	mStages.push_back( Stage( Stage::EDGE_DETECT_SOBEL ) );
+	return *this;
+}
+
+template<typename T>
+void PipelineT<T>::run()
+{
+	for( const auto &stage : mStages ) {
+		switch( stage.mType ) {
+			case Stage::POINT:
+				runPointStage( stage );
+				if( mSurface && stage.mSetPremultiplied >= 0 )
+					mSurface->setPremultiplied( stage.mSetPremultiplied != 0 );
+			break;
+			case Stage::STACK_BLUR:
+				if( mSurface )
+					ip::stackBlur( mSurface, stage.mRadius );
+				else
+					ip::stackBlur( mChannel, stage.mRadius );
+			break;
+			case Stage::EDGE_DETECT_SOBEL:
+				if( mSurface )
+					ip::edgeDetectSobel( mSurface->clone(), mSurface );
+				else
+					ip::edgeDetectSobel( mChannel->clone(), mChannel );
+			break;
+		}
+	}
+
+	mStages.clear();
+}
+
+template<typename T>
+void PipelineT<T>::runPointStage( const Stage &stage )
+{
+	const int32_t width = mWidth, height = mHeight;
+	const uint8_t pixelInc = mPixelInc;
+	// a Surface moves whole pixels when flipping, while a Channel may be interleaved with others that must stay put
+	const uint8_t elementsPerPixel = mSurface ? pixelInc : 1;
+	T *data = mData;
+	const ptrdiff_t rowBytes = mRowBytes;
+	auto getRow = [=]( int32_t y ) { return reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( data ) + y * rowBytes ); };
+
+	auto processRow = [&]( T *row ) {
+		for( const auto &fn : stage.mRowFns )
+			fn( row, width, pixelInc );
+		if( stage.mFlipHorizontal ) {
+			for( int32_t x = 0; x < width / 2; ++x )
+				std::swap_ranges( row + x * pixelInc, row + x * pixelInc + elementsPerPixel, row + ( width - x - 1 ) * pixelInc );
+		}
+	};
+
+	const size_t bytesPerRow = width * pixelInc * sizeof(T);
+	if( ! stage.mFlipVertical ) {
+		parallelRows( Area( 0, 0, width, height ), bytesPerRow, [&]( const Area &band ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y )
+				processRow( getRow( y ) );
+		} );
+	}
+	else {
+		// each band processes rows in the top half along with their mirrors in the bottom half, then swaps them
+		parallelRows( Area( 0, 0, width, ( height + 1 ) / 2 ), bytesPerRow * 2, [&]( const Area &band ) {
+			for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+				T *top = getRow( y ), *bottom = getRow( height - y - 1 );
+				processRow( top );
+				if( top == bottom )
+					continue;
+
+				processRow( bottom );
+				if( elementsPerPixel == pixelInc )
+					std::swap_ranges( top, top + width * pixelInc, bottom );
+				else {
+					for( int32_t x = 0; x < width; ++x )
+						std::swap( top[x * pixelInc], bottom[x * pixelInc] );
+				}
+			}
+		} );
+	}
+}
+
+template class CI_API PipelineT<uint8_t>;
+template class CI_API PipelineT<uint16_t>;
+template class CI_API PipelineT<float>;
+
+} } // namespace cinder::ip
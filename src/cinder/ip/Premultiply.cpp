@@ -21,72 +21,346 @@
 */
 
 #include "cinder/ip/Premultiply.h"
+#include "cinder/ip/ThreadPool.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/System.h"
 
 #include <algorithm>
+#include <type_traits>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_PREMULTIPLY_SSE2
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_PREMULTIPLY_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
-// this is a candidate for sse2
+namespace {
+
+// Every Surface with an alpha channel has 4 elements per pixel, with alpha either first or last. The SIMD kernels
+// below are specialized on the alpha offset and each process as many whole groups of 4 pixels as fit in \a width,
+// returning the number of pixels handled. The remainder is left to the scalar loops.
+
+#if defined( CINDER_PREMULTIPLY_SSE2 )
+
+// Returns the 16-bit lanes of two pixels with each pixel's alpha broadcast to its color lanes and 255 in its alpha lane
+template<int ALPHA>
+inline __m128i alphaMultiplier16( __m128i v, __m128i alphaLanes )
+{
+	v = _mm_shufflehi_epi16( _mm_shufflelo_epi16( v, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ), _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+	return _mm_or_si128( v, alphaLanes );
+}
+
+// floor( x / 255 ) for 16-bit lanes x <= 255 * 255, as ( x + 1 + ( x >> 8 ) ) >> 8
+inline __m128i div255( __m128i x )
+{
+	return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+template<int ALPHA>
+int32_t premultiplyRowSimd( uint8_t *p, int32_t width )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaLanes = _mm_setr_epi16( ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0, ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0 );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, p += 16 ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+		const __m128i lo = _mm_unpacklo_epi8( v, zero ), hi = _mm_unpackhi_epi8( v, zero );
+		const __m128i loResult = div255( _mm_mullo_epi16( lo, alphaMultiplier16<ALPHA>( lo, alphaLanes ) ) );
+		const __m128i hiResult = div255( _mm_mullo_epi16( hi, alphaMultiplier16<ALPHA>( hi, alphaLanes ) ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( p ), _mm_packus_epi16( loResult, hiResult ) );
+	}
+	return x;
+}
+
+// c * 255 / a is computed as a correctly-rounded float division of integers <= 65025, which truncates to the same
+// result as the integer division since the rounding error is always smaller than 1 / a
+template<int ALPHA>
+inline __m128i unpremultiplyPixel( __m128i v32, __m128 colorMask )
+{
+	const __m128 c = _mm_cvtepi32_ps( v32 );
+	const __m128 a = _mm_shuffle_ps( c, c, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+	const __m128 q = _mm_min_ps( _mm_div_ps( _mm_mul_ps( c, _mm_set1_ps( 255.0f ) ), a ), _mm_set1_ps( 255.0f ) );
+	// keep the original values in the alpha lane, and in every lane when alpha is zero
+	const __m128 useQ = _mm_andnot_ps( _mm_cmpeq_ps( a, _mm_setzero_ps() ), colorMask );
+	return _mm_cvttps_epi32( _mm_or_ps( _mm_and_ps( useQ, q ), _mm_andnot_ps( useQ, c ) ) );
+}
+
+template<int ALPHA>
+int32_t unpremultiplyRowSimd( uint8_t *p, int32_t width )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 colorMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? 0 : -1, -1, -1, ALPHA == 3 ? 0 : -1 ) );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, p += 16 ) {
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+		const __m128i lo = _mm_unpacklo_epi8( v, zero ), hi = _mm_unpackhi_epi8( v, zero );
+		const __m128i p0 = unpremultiplyPixel<ALPHA>( _mm_unpacklo_epi16( lo, zero ), colorMask );
+		const __m128i p1 = unpremultiplyPixel<ALPHA>( _mm_unpackhi_epi16( lo, zero ), colorMask );
+		const __m128i p2 = unpremultiplyPixel<ALPHA>( _mm_unpacklo_epi16( hi, zero ), colorMask );
+		const __m128i p3 = unpremultiplyPixel<ALPHA>( _mm_unpackhi_epi16( hi, zero ), colorMask );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( p ), _mm_packus_epi16( _mm_packs_epi32( p0, p1 ), _mm_packs_epi32( p2, p3 ) ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+int32_t premultiplyRowSimd( float *p, int32_t width )
+{
+	const __m128 colorMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? 0 : -1, -1, -1, ALPHA == 3 ? 0 : -1 ) );
+	const __m128 alphaOne = _mm_andnot_ps( colorMask, _mm_set1_ps( 1.0f ) );
+	for( int32_t x = 0; x < width; ++x, p += 4 ) {
+		const __m128 v = _mm_loadu_ps( p );
+		const __m128 a = _mm_shuffle_ps( v, v, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		_mm_storeu_ps( p, _mm_mul_ps( v, _mm_or_ps( _mm_and_ps( a, colorMask ), alphaOne ) ) );
+	}
+	return width;
+}
+
+// 1 / a is a reciprocal estimate refined by a Newton-Raphson step, which is accurate to about 22 bits
+template<int ALPHA>
+int32_t unpremultiplyRowSimd( float *p, int32_t width )
+{
+	const __m128 colorMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? 0 : -1, -1, -1, ALPHA == 3 ? 0 : -1 ) );
+	const __m128 one = _mm_set1_ps( 1.0f ), two = _mm_set1_ps( 2.0f );
+	for( int32_t x = 0; x < width; ++x, p += 4 ) {
+		const __m128 v = _mm_loadu_ps( p );
+		const __m128 a = _mm_shuffle_ps( v, v, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m128 r = _mm_rcp_ps( a );
+		r = _mm_mul_ps( r, _mm_sub_ps( two, _mm_mul_ps( a, r ) ) );
+		// multiply color lanes by 1 / a unless a is zero, and the alpha lane by 1
+		const __m128 useR = _mm_andnot_ps( _mm_cmpeq_ps( a, _mm_setzero_ps() ), colorMask );
+		_mm_storeu_ps( p, _mm_mul_ps( v, _mm_or_ps( _mm_and_ps( useR, r ), _mm_andnot_ps( useR, one ) ) ) );
+	}
+	return width;
+}
+
+#elif defined( CINDER_PREMULTIPLY_NEON )
+
+// Returns \a v with each pixel's alpha broadcast to its color bytes and 255 in its alpha byte
+template<int ALPHA>
+inline uint8x16_t alphaMultiplier8( uint8x16_t v )
+{
+	static const uint8_t sIndices[16] = { ALPHA, ALPHA, ALPHA, ALPHA, 4 + ALPHA, 4 + ALPHA, 4 + ALPHA, 4 + ALPHA,
+										8 + ALPHA, 8 + ALPHA, 8 + ALPHA, 8 + ALPHA, 12 + ALPHA, 12 + ALPHA, 12 + ALPHA, 12 + ALPHA };
+	static const uint8_t sAlphaLanes[16] = { ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0, ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0,
+										ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0, ALPHA == 0 ? 255 : 0, 0, 0, ALPHA == 3 ? 255 : 0 };
+	return vorrq_u8( vqtbl1q_u8( v, vld1q_u8( sIndices ) ), vld1q_u8( sAlphaLanes ) );
+}
+
+// floor( x / 255 ) for 16-bit lanes x <= 255 * 255, narrowed to 8 bits
+inline uint8x8_t div255( uint16x8_t x )
+{
+	return vshrn_n_u16( vaddq_u16( vaddq_u16( x, vdupq_n_u16( 1 ) ), vshrq_n_u16( x, 8 ) ), 8 );
+}
+
+template<int ALPHA>
+int32_t premultiplyRowSimd( uint8_t *p, int32_t width )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, p += 16 ) {
+		const uint8x16_t v = vld1q_u8( p );
+		const uint8x16_t a = alphaMultiplier8<ALPHA>( v );
+		const uint8x8_t lo = div255( vmull_u8( vget_low_u8( v ), vget_low_u8( a ) ) );
+		const uint8x8_t hi = div255( vmull_high_u8( v, a ) );
+		vst1q_u8( p, vcombine_u8( lo, hi ) );
+	}
+	return x;
+}
+
+// see the SSE2 version for why the float division truncates exactly
+template<int ALPHA>
+inline uint32x4_t unpremultiplyPixel( uint32x4_t v32, uint32x4_t colorMask )
+{
+	const float32x4_t c = vcvtq_f32_u32( v32 );
+	const float32x4_t a = vdupq_laneq_f32( c, ALPHA );
+	const float32x4_t q = vminq_f32( vdivq_f32( vmulq_n_f32( c, 255.0f ), a ), vdupq_n_f32( 255.0f ) );
+	const uint32x4_t useQ = vbicq_u32( colorMask, vceqq_f32( a, vdupq_n_f32( 0 ) ) );
+	return vcvtq_u32_f32( vbslq_f32( useQ, q, c ) );
+}
+
+template<int ALPHA>
+int32_t unpremultiplyRowSimd( uint8_t *p, int32_t width )
+{
+	const uint32_t colorMaskLanes[4] = { ALPHA == 0 ? 0u : ~0u, ~0u, ~0u, ALPHA == 3 ? 0u : ~0u };
+	const uint32x4_t colorMask = vld1q_u32( colorMaskLanes );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4, p += 16 ) {
+		const uint8x16_t v = vld1q_u8( p );
+		const uint16x8_t lo = vmovl_u8( vget_low_u8( v ) ), hi = vmovl_high_u8( v );
+		const uint32x4_t p0 = unpremultiplyPixel<ALPHA>( vmovl_u16( vget_low_u16( lo ) ), colorMask );
+		const uint32x4_t p1 = unpremultiplyPixel<ALPHA>( vmovl_high_u16( lo ), colorMask );
+		const uint32x4_t p2 = unpremultiplyPixel<ALPHA>( vmovl_u16( vget_low_u16( hi ) ), colorMask );
+		const uint32x4_t p3 = unpremultiplyPixel<ALPHA>( vmovl_high_u16( hi ), colorMask );
+		const uint16x8_t lo16 = vcombine_u16( vmovn_u32( p0 ), vmovn_u32( p1 ) );
+		const uint16x8_t hi16 = vcombine_u16( vmovn_u32( p2 ), vmovn_u32( p3 ) );
+		vst1q_u8( p, vcombine_u8( vmovn_u16( lo16 ), vmovn_u16( hi16 ) ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+int32_t premultiplyRowSimd( float *p, int32_t width )
+{
+	const float alphaOneLanes[4] = { ALPHA == 0 ? 1.0f : 0, 0, 0, ALPHA == 3 ? 1.0f : 0 };
+	const float32x4_t alphaOne = vld1q_f32( alphaOneLanes );
+	const uint32x4_t colorMask = vceqq_f32( alphaOne, vdupq_n_f32( 0 ) );
+	for( int32_t x = 0; x < width; ++x, p += 4 ) {
+		const float32x4_t v = vld1q_f32( p );
+		const float32x4_t a = vdupq_laneq_f32( v, ALPHA );
+		vst1q_f32( p, vmulq_f32( v, vbslq_f32( colorMask, a, alphaOne ) ) );
+	}
+	return width;
+}
+
+// see the SSE2 version, vrecpsq_f32() computes the Newton-Raphson step
+template<int ALPHA>
+int32_t unpremultiplyRowSimd( float *p, int32_t width )
+{
+	const float alphaOneLanes[4] = { ALPHA == 0 ? 1.0f : 0, 0, 0, ALPHA == 3 ? 1.0f : 0 };
+	const uint32x4_t colorMask = vceqq_f32( vld1q_f32( alphaOneLanes ), vdupq_n_f32( 0 ) );
+	for( int32_t x = 0; x < width; ++x, p += 4 ) {
+		const float32x4_t v = vld1q_f32( p );
+		const float32x4_t a = vdupq_laneq_f32( v, ALPHA );
+		float32x4_t r = vrecpeq_f32( a );
+		r = vmulq_f32( r, vrecpsq_f32( a, r ) );
+		const uint32x4_t useR = vbicq_u32( colorMask, vceqq_f32( a, vdupq_n_f32( 0 ) ) );
+		vst1q_f32( p, vmulq_f32( v, vbslq_f32( useR, r, vdupq_n_f32( 1.0f ) ) ) );
+	}
+	return width;
+}
+
+#endif
+
+// Returns true when the SIMD kernels are available on this machine
+bool hasPremultiplySimd()
+{
+#if defined( CINDER_PREMULTIPLY_SSE2 )
+	static const bool sHasSse2 = System::hasSse2();
+	return sHasSse2;
+#elif defined( CINDER_PREMULTIPLY_NEON )
+	return true;
+#else
+	return false;
+#endif
+}
+
+// Dispatches to the SIMD kernels for 8u and 32f Surfaces. Returns the number of pixels of the row handled
 template<typename T>
-void premultiply( SurfaceT<T> *surface )
+int32_t premultiplyRowSimd( T *, int32_t, uint8_t )
 {
-	const Area clippedArea = surface->getBounds();
+	return 0;
+}
 
-	if( ! surface->hasAlpha() )
-		return;
+template<typename T>
+int32_t unpremultiplyRowSimd( T *, int32_t, uint8_t )
+{
+	return 0;
+}
 
-	surface->setPremultiplied( true );
+#if defined( CINDER_PREMULTIPLY_SSE2 ) || defined( CINDER_PREMULTIPLY_NEON )
+template<>
+int32_t premultiplyRowSimd<uint8_t>( uint8_t *p, int32_t width, uint8_t alphaOffset )
+{
+	return ( alphaOffset == 0 ) ? premultiplyRowSimd<0>( p, width ) : premultiplyRowSimd<3>( p, width );
+}
+
+template<>
+int32_t premultiplyRowSimd<float>( float *p, int32_t width, uint8_t alphaOffset )
+{
+	return ( alphaOffset == 0 ) ? premultiplyRowSimd<0>( p, width ) : premultiplyRowSimd<3>( p, width );
+}
 
-	ptrdiff_t rowBytes = surface->getRowBytes();
-	uint8_t pixelInc = surface->getPixelInc();
-	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			T alpha = dstPtr[alphaOffset];
-			
-			dstPtr[redOffset] = CHANTRAIT<T>::premultiply( dstPtr[redOffset], alpha );
-			dstPtr[greenOffset] = CHANTRAIT<T>::premultiply( dstPtr[greenOffset], alpha );
-			dstPtr[blueOffset] = CHANTRAIT<T>::premultiply( dstPtr[blueOffset], alpha );
-			dstPtr += pixelInc;
+template<>
+int32_t unpremultiplyRowSimd<uint8_t>( uint8_t *p, int32_t width, uint8_t alphaOffset )
+{
+	return ( alphaOffset == 0 ) ? unpremultiplyRowSimd<0>( p, width ) : unpremultiplyRowSimd<3>( p, width );
+}
+
+template<>
+int32_t unpremultiplyRowSimd<float>( float *p, int32_t width, uint8_t alphaOffset )
+{
+	return ( alphaOffset == 0 ) ? unpremultiplyRowSimd<0>( p, width ) : unpremultiplyRowSimd<3>( p, width );
+}
+#endif
+
+// matches the integer formula c * max / a, saturated
+template<typename T>
+inline T unpremultiplyValue( T c, T a, std::true_type /*isIntegral*/ )
+{
+	return static_cast<T>( std::min<int64_t>( (int64_t)c * CHANTRAIT<T>::max() / a, CHANTRAIT<T>::max() ) );
+}
+
+template<typename T>
+inline T unpremultiplyValue( T c, T a, std::false_type /*isIntegral*/ )
+{
+	return c * ( 1.0f / a );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void premultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder )
+{
+	const uint8_t pixelInc = channelOrder.getPixelInc();
+	const uint8_t redOffset = channelOrder.getRedOffset(), greenOffset = channelOrder.getGreenOffset(), blueOffset = channelOrder.getBlueOffset(), alphaOffset = channelOrder.getAlphaOffset();
+	const int32_t simdWidth = ( pixelInc == 4 && hasPremultiplySimd() ) ? premultiplyRowSimd( data, width, alphaOffset ) : 0;
+	data += simdWidth * pixelInc;
+	for( int32_t x = simdWidth; x < width; ++x ) {
+		const T alpha = data[alphaOffset];
+		data[redOffset] = CHANTRAIT<T>::premultiply( data[redOffset], alpha );
+		data[greenOffset] = CHANTRAIT<T>::premultiply( data[greenOffset], alpha );
+		data[blueOffset] = CHANTRAIT<T>::premultiply( data[blueOffset], alpha );
+		data += pixelInc;
+	}
+}
+
+template<typename T>
+void unpremultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder )
+{
+	typedef typename std::is_integral<T>::type IsIntegral;
+	const uint8_t pixelInc = channelOrder.getPixelInc();
+	const uint8_t redOffset = channelOrder.getRedOffset(), greenOffset = channelOrder.getGreenOffset(), blueOffset = channelOrder.getBlueOffset(), alphaOffset = channelOrder.getAlphaOffset();
+	const int32_t simdWidth = ( pixelInc == 4 && hasPremultiplySimd() ) ? unpremultiplyRowSimd( data, width, alphaOffset ) : 0;
+	data += simdWidth * pixelInc;
+	for( int32_t x = simdWidth; x < width; ++x ) {
+		// The basic formula for unpremultiplication is to divide by the alpha
+		const T alpha = data[alphaOffset];
+		if( alpha != 0 ) {
+			data[redOffset] = unpremultiplyValue( data[redOffset], alpha, IsIntegral() );
+			data[greenOffset] = unpremultiplyValue( data[greenOffset], alpha, IsIntegral() );
+			data[blueOffset] = unpremultiplyValue( data[blueOffset], alpha, IsIntegral() );
 		}
+		data += pixelInc;
 	}
 }
 
-// this is a candidate for sse2
-template<>
-void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
+template<typename T>
+void premultiply( SurfaceT<T> *surface )
 {
 	const Area clippedArea = surface->getBounds();
 
 	if( ! surface->hasAlpha() )
 		return;
 
-	surface->setPremultiplied( false );
+	surface->setPremultiplied( true );
 
-	ptrdiff_t rowBytes = surface->getRowBytes();
-	uint8_t pixelInc = surface->getPixelInc();
-	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		uint8_t *dstPtr = reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes;
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			// which in 8bit pixel arithmetic is to multiply by 255 and divide by the alpha
-			uint8_t alpha = dstPtr[alphaOffset];
-			if( alpha ) {
-				dstPtr[redOffset] = std::min<int>( dstPtr[redOffset] * 255 / alpha, 255 );
-				dstPtr[greenOffset] = std::min<int>( dstPtr[greenOffset] * 255 / alpha, 255 );
-				dstPtr[blueOffset] = std::min<int>( dstPtr[blueOffset] * 255 / alpha, 255 );
-			}
-			dstPtr += pixelInc;
+	const ptrdiff_t rowBytes = surface->getRowBytes();
+	const uint8_t pixelInc = surface->getPixelInc();
+	const SurfaceChannelOrder &channelOrder = surface->getChannelOrder();
+	parallelRows( clippedArea, clippedArea.getWidth() * pixelInc * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			premultiplyRow( dstPtr, clippedArea.getWidth(), channelOrder );
 		}
-	}	
+	} );
 }
 
-template<>
-void unpremultiply<float>( SurfaceT<float> *surface )
+template<typename T>
+void unpremultiply( SurfaceT<T> *surface )
 {
 	const Area clippedArea = surface->getBounds();
 
@@ -95,26 +369,25 @@ void unpremultiply<float>( SurfaceT<float> *surface )
 
 	surface->setPremultiplied( false );
 
-	ptrdiff_t rowBytes = surface->getRowBytes();
-	uint8_t pixelInc = surface->getPixelInc();
-	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		float *dstPtr = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			// The basic formula for unpremultiplication is to divide by the alpha
-			if( dstPtr[alphaOffset] != 0 ) {
-				float invAlpha = 1.0f / dstPtr[alphaOffset];
-				dstPtr[redOffset] *= invAlpha;
-				dstPtr[greenOffset] *= invAlpha;
-				dstPtr[blueOffset] *= invAlpha;
-			}
-			dstPtr += pixelInc;
+	const ptrdiff_t rowBytes = surface->getRowBytes();
+	const uint8_t pixelInc = surface->getPixelInc();
+	const SurfaceChannelOrder &channelOrder = surface->getChannelOrder();
+	parallelRows( clippedArea, clippedArea.getWidth() * pixelInc * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			unpremultiplyRow( dstPtr, clippedArea.getWidth(), channelOrder );
 		}
-	}	
+	} );
 }
 
-template CI_API void premultiply( SurfaceT<uint8_t> *Surface );
-template CI_API void premultiply( SurfaceT<uint16_t> *Surface );
-template CI_API void premultiply( SurfaceT<float> *Surface );	
+#define premultiply_PROTOTYPES(T)\
+	template CI_API void premultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder );\
+	template CI_API void unpremultiplyRow( T *data, int32_t width, const SurfaceChannelOrder &channelOrder );\
+	template CI_API void premultiply( SurfaceT<T> *surface );\
+	template CI_API void unpremultiply( SurfaceT<T> *surface );
+
+premultiply_PROTOTYPES(uint8_t)
+premultiply_PROTOTYPES(uint16_t)
+premultiply_PROTOTYPES(float)
 
 } } // namespace cinder::ip
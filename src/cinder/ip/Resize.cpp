@@ -22,9 +22,11 @@
 
 #include "cinder/Surface.h"
 #include "cinder/ip/Resize.h"
+#include "cinder/ip/ThreadPool.h"
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
 
 #include <math.h>
 #include <vector>
@@ -34,6 +36,7 @@ using std::unique_ptr;
 #include <limits>
 #include <fstream>
 #include <algorithm>
+#include <thread>
 
 namespace cinder { namespace ip {
 
@@ -114,11 +117,11 @@ void scanlineShiftAccumToChannel( AT *accum, int32_t x1, int32_t y, int32_t widt
 }
 
 template<typename T, typename WT, typename AT>
-void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t y, const ChannelT<T> &channel, AT *lineBuffer, int32_t width )
+void scanlineFilterChannelToBuffer( const int32_t *starts, const int32_t *ends, const WT *weights, int32_t filterWidth, int32_t x, int32_t y, const ChannelT<T> &channel, AT *lineBuffer, int32_t width )
 {
 	int32_t b, af;
 	AT sum;
-	AT *wp;
+	const WT *wp;
 	const T *srcLine, *src;
 
 	srcLine = channel.getData( x, y );
@@ -129,94 +132,16 @@ void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t
 			sum = 1 << 7;
 		else
 			sum = 0;
-		src = srcLine + weights->start * pixelStride;
-		wp = weights->weight;
-		for ( af = weights->start; af < weights->end; af++ ) {
+		src = srcLine + starts[b] * pixelStride;
+		wp = weights + b * filterWidth;
+		for ( af = starts[b]; af < ends[b]; af++ ) {
 			sum += *wp++ * *src;
 			src += pixelStride;
 		}
 		*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
-		weights++;
 	}	
 }
 
-// assumes channels are of same dimensions
-template<typename T>
-void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &filter, const Area &srcArea, const Area &dstArea, const vector<ChannelT<T>*> &dstChannels )
-{
-	Rectf clippedSrcRect;
-	Area clippedDstArea;
-	getClippedScaledRects( srcChannels[0]->getBounds(), Rectf( srcArea ), dstChannels[0]->getBounds(), dstArea, &clippedSrcRect, &clippedDstArea );
-	
-	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( clippedDstArea.getWidth() <= 0 ) 
-		|| ( clippedSrcRect.getHeight() <= 0 ) || ( clippedDstArea.getHeight() <= 0 ) )
-		return;
-	
-	FilterParams filterParamsX, filterParamsY;
-	Mapping m;
-	int32_t dstWidth = (int32_t)clippedDstArea.getWidth(), dstHeight = (int32_t)clippedDstArea.getHeight();
-	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
-	int32_t srcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
-	int32_t srcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
-	vector<pair<int32_t,unique_ptr<typename SCALETRAIT<T>::SUMT[]>>> linesBuffer;
-
-	m.sx = dstWidth / (float)srcWidth;
-	m.sy = dstHeight / (float)srcHeight;
-	m.tx = clippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
-	m.ty = clippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
-	m.ux = clippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
-	m.uy = clippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
-
-	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
-	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
-	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
-
-	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
-	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
-	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
-
-	for( int32_t i = 0; i < filterParamsY.width; i++ )
-		linesBuffer.push_back( std::make_pair( -1, unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] ) ) );
-
-	WeightTable<typename SCALETRAIT<T>::SUMT> *xWeights, yWeights;
-	typename SCALETRAIT<T>::SUMT *xWeightBuffer, *xWeightPtr;
-	xWeights = (WeightTable<typename SCALETRAIT<T>::SUMT>*)malloc( sizeof(WeightTable<int32_t>) * dstWidth );
-	xWeightBuffer = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * dstWidth * filterParamsX.width );
-	yWeights.weight = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * filterParamsY.width );
-	unique_ptr<typename SCALETRAIT<T>::SUMT[]> accum = unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] );
-
-	xWeightPtr = xWeightBuffer;
-	for ( int32_t bx = 0; bx < dstWidth; bx++, xWeightPtr += filterParamsX.width ) {
-		xWeights[bx].weight = xWeightPtr;
-		makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
-	}
-
-	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
-		for ( int32_t dstY = 0; dstY < dstHeight; ++dstY ) {     // loop over dest scanlines
-			// prepare a weight table for dest y position by
-			makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
-
-			memset( accum.get(), 0, sizeof(int32_t) * dstWidth );
-
-			// loop over source scanlines that influence this dest scanline
-			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
-				typename SCALETRAIT<T>::SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
-				if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
-					scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
-					linesBuffer[ayf % filterParamsY.width].first = ayf;
-				}
-				scanlineAccumulate<typename SCALETRAIT<T>::SUMT,typename SCALETRAIT<T>::SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
-			}
-
-			scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
-		}
-	}
-
-	free( xWeights );
-	free( xWeightBuffer );
-	free( yWeights.weight );
-}
-
 template<typename LT, typename AT>
 void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t width, AT *accum )
 {
@@ -307,9 +232,91 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 	}   
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// ResizePlanT
 template<typename T>
-void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+ResizePlanT<T>::ResizePlanT( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter, int numThreads )
+	: ResizePlanT( srcSize, Area( ivec2( 0 ), srcSize ), dstSize, Area( ivec2( 0 ), dstSize ), filter, numThreads )
+{
+}
+
+template<typename T>
+ResizePlanT<T>::ResizePlanT( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter, int numThreads )
+	: mSrcSize( srcSize ), mDstSize( dstSize ), mSrcOffsetX( 0 ), mSrcOffsetY( 0 ), mFilterWidthX( 0 ), mFilterWidthY( 0 )
+{
+	setNumThreads( numThreads );
+
+	Rectf clippedSrcRect;
+	getClippedScaledRects( Area( ivec2( 0 ), srcSize ), Rectf( srcArea ), Area( ivec2( 0 ), dstSize ), dstArea, &clippedSrcRect, &mClippedDstArea );
+	
+	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( mClippedDstArea.getWidth() <= 0 ) 
+		|| ( clippedSrcRect.getHeight() <= 0 ) || ( mClippedDstArea.getHeight() <= 0 ) ) {
+		mClippedDstArea = Area( 0, 0, 0, 0 );
+		return;
+	}
+	
+	FilterParams filterParamsX, filterParamsY;
+	Mapping m;
+	int32_t dstWidth = (int32_t)mClippedDstArea.getWidth(), dstHeight = (int32_t)mClippedDstArea.getHeight();
+	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
+	mSrcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
+	mSrcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
+
+	m.sx = dstWidth / (float)srcWidth;
+	m.sy = dstHeight / (float)srcHeight;
+	m.tx = mClippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
+	m.ty = mClippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
+	m.ux = mClippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
+	m.uy = mClippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
+
+	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
+	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
+	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
+
+	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
+	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
+	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
+
+	mFilterWidthX = filterParamsX.width;
+	mFilterWidthY = filterParamsY.width;
+
+	WeightTable<WeightT> weightTable;
+
+	mXStart.resize( dstWidth );
+	mXEnd.resize( dstWidth );
+	mXWeights.resize( dstWidth * mFilterWidthX );
+	for( int32_t bx = 0; bx < dstWidth; bx++ ) {
+		weightTable.weight = &mXWeights[bx * mFilterWidthX];
+		makeWeightTable<T,WeightT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &weightTable );
+		mXStart[bx] = weightTable.start;
+		mXEnd[bx] = weightTable.end;
+	}
+
+	mYStart.resize( dstHeight );
+	mYEnd.resize( dstHeight );
+	mYWeights.resize( dstHeight * mFilterWidthY );
+	for( int32_t by = 0; by < dstHeight; by++ ) {
+		weightTable.weight = &mYWeights[by * mFilterWidthY];
+		makeWeightTable<T,WeightT>( MAP(by, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &weightTable );
+		mYStart[by] = weightTable.start;
+		mYEnd[by] = weightTable.end;
+	}
+}
+
+template<typename T>
+void ResizePlanT<T>::setNumThreads( int numThreads )
+{
+	if( numThreads <= 0 )
+		numThreads = std::max<int>( 1, std::thread::hardware_concurrency() );
+
+	mNumThreads = numThreads;
+}
+
+template<typename T>
+void ResizePlanT<T>::resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const
 {
+	CI_ASSERT( srcSurface.getSize() == mSrcSize && dstSurface->getSize() == mDstSize );
+
 	vector<const ChannelT<T>*> srcChannels;
 	vector<ChannelT<T>*> dstChannels;
 
@@ -324,19 +331,115 @@ void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *ds
 		dstChannels.push_back( &dstSurface->getChannelAlpha() );	
 	}
 
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	resample( srcChannels, dstChannels );
 }
 
 template<typename T>
-void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
+void ResizePlanT<T>::resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const
 {
+	CI_ASSERT( srcChannel.getSize() == mSrcSize && dstChannel->getSize() == mDstSize );
+
 	vector<const ChannelT<T>*> srcChannels;
 	vector<ChannelT<T>*> dstChannels;
 	
 	srcChannels.push_back( &srcChannel );
 	dstChannels.push_back( dstChannel );
 	
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	resample( srcChannels, dstChannels );
+}
+
+template<typename T>
+SurfaceT<T> ResizePlanT<T>::resizeCopy( const SurfaceT<T> &srcSurface ) const
+{
+	SurfaceT<T> result( mDstSize.x, mDstSize.y, srcSurface.hasAlpha(), srcSurface.getChannelOrder() );
+	resize( srcSurface, &result );
+	return result;
+}
+
+template<typename T>
+void ResizePlanT<T>::resample( const vector<const ChannelT<T>*> &srcChannels, const vector<ChannelT<T>*> &dstChannels ) const
+{
+	// bands of fewer rows than this aren't worth a thread, since each band re-filters the source lines it shares with its neighbors
+	const int32_t MIN_ROWS_PER_BAND = 16;
+
+	const int32_t dstHeight = mClippedDstArea.getHeight();
+	if( mClippedDstArea.getWidth() <= 0 || dstHeight <= 0 )
+		return;
+
+	const int32_t numBands = std::max<int32_t>( 1, std::min<int32_t>( mNumThreads, dstHeight / MIN_ROWS_PER_BAND ) );
+	if( numBands == 1 ) {
+		resampleRows( srcChannels, dstChannels, 0, dstHeight );
+		return;
+	}
+
+	// prefer the shared ip::ThreadPool over spawning threads for every call
+	ThreadPoolRef threadPool = getThreadPool();
+	if( threadPool ) {
+		threadPool->parallelFor( numBands, 1, [&]( size_t begin, size_t end ) {
+			for( int32_t band = (int32_t)begin; band < (int32_t)end; ++band )
+				resampleRows( srcChannels, dstChannels, dstHeight * band / numBands, dstHeight * ( band + 1 ) / numBands );
+		} );
+		return;
+	}
+
+	vector<std::thread> threads;
+	for( int32_t band = 1; band < numBands; ++band ) {
+		const int32_t y1 = dstHeight * band / numBands, y2 = dstHeight * ( band + 1 ) / numBands;
+		threads.emplace_back( [&, y1, y2] { resampleRows( srcChannels, dstChannels, y1, y2 ); } );
+	}
+	resampleRows( srcChannels, dstChannels, 0, dstHeight / numBands );
+
+	for( auto &thread : threads )
+		thread.join();
+}
+
+// resamples destination rows [dstY1, dstY2), relative to mClippedDstArea
+template<typename T>
+void ResizePlanT<T>::resampleRows( const vector<const ChannelT<T>*> &srcChannels, const vector<ChannelT<T>*> &dstChannels, int32_t dstY1, int32_t dstY2 ) const
+{
+	const int32_t dstWidth = mClippedDstArea.getWidth();
+	vector<pair<int32_t,unique_ptr<WeightT[]>>> linesBuffer;
+	for( int32_t i = 0; i < mFilterWidthY; i++ )
+		linesBuffer.push_back( std::make_pair( -1, unique_ptr<WeightT[]>( new WeightT[dstWidth] ) ) );
+
+	unique_ptr<WeightT[]> accum( new WeightT[dstWidth] );
+
+	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
+		// lines filtered from the previous channel must not be mistaken for this one's
+		for( auto &line : linesBuffer )
+			line.first = -1;
+
+		for ( int32_t dstY = dstY1; dstY < dstY2; ++dstY ) {     // loop over dest scanlines
+			const WeightT *yWeights = &mYWeights[dstY * mFilterWidthY];
+			memset( accum.get(), 0, sizeof(WeightT) * dstWidth );
+
+			// loop over source scanlines that influence this dest scanline
+			for ( int32_t ayf = mYStart[dstY]; ayf < mYEnd[dstY]; ayf++ ) {
+				WeightT *line = linesBuffer[ayf % mFilterWidthY].second.get();
+				if( linesBuffer[ayf % mFilterWidthY].first != ayf ) {
+					scanlineFilterChannelToBuffer( mXStart.data(), mXEnd.data(), mXWeights.data(), mFilterWidthX, mSrcOffsetX, mSrcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
+					linesBuffer[ayf % mFilterWidthY].first = ayf;
+				}
+				scanlineAccumulate<WeightT,WeightT>( yWeights[ayf - mYStart[dstY]], line, dstWidth, accum.get() );
+			}
+
+			scanlineShiftAccumToChannel( accum.get(), mClippedDstArea.getX1(), mClippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
+		}
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+// resize
+template<typename T>
+void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+{
+	ResizePlanT<T>( srcSurface.getSize(), srcArea, dstSurface->getSize(), dstArea, filter, 1 ).resize( srcSurface, dstSurface );
+}
+
+template<typename T>
+void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
+{
+	ResizePlanT<T>( srcChannel.getSize(), srcArea, dstChannel->getSize(), dstArea, filter, 1 ).resize( srcChannel, dstChannel );
 }
 
 template<typename T>
@@ -370,4 +473,7 @@ void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Filte
 resize_PROTOTYPES(uint8_t)
 resize_PROTOTYPES(float)
 
+template class CI_API ResizePlanT<uint8_t>;
+template class CI_API ResizePlanT<float>;
+
 } } // namespace cinder::ip
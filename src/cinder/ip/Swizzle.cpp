@@ -0,0 +1,263 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/Swizzle.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/System.h"
+
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_SWIZZLE_SSSE3
+	#include <tmmintrin.h>
+	// pshufb is SSSE3, which x86 compilers don't assume by default, so its kernels are compiled for it explicitly and chosen at runtime
+	#if defined( __SSSE3__ ) || defined( _MSC_VER )
+		#define CINDER_SWIZZLE_SSSE3_TARGET
+	#else
+		#define CINDER_SWIZZLE_SSSE3_TARGET __attribute__(( target( "ssse3" ) ))
+	#endif
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_SWIZZLE_NEON
+	#include <arm_neon.h>
+#endif
+
+namespace cinder { namespace ip {
+
+SwizzleMap SwizzleMap::fromChannelOrders( const SurfaceChannelOrder &srcOrder, const SurfaceChannelOrder &dstOrder )
+{
+	SwizzleMap result;
+	result.mSrcInc = srcOrder.getPixelInc();
+	result.mDstInc = dstOrder.getPixelInc();
+	result.mIndex[dstOrder.getRedOffset()] = srcOrder.getRedOffset();
+	result.mIndex[dstOrder.getGreenOffset()] = srcOrder.getGreenOffset();
+	result.mIndex[dstOrder.getBlueOffset()] = srcOrder.getBlueOffset();
+	if( dstOrder.hasAlpha() && srcOrder.hasAlpha() )
+		result.mIndex[dstOrder.getAlphaOffset()] = srcOrder.getAlphaOffset();
+
+	return result;
+}
+
+namespace {
+
+template<typename SD, typename TD, int DST_INC>
+void swizzleRowScalar( const SD *src, TD *dst, int32_t width, uint8_t srcInc, const int8_t *index )
+{
+	const TD fill = CHANTRAIT<TD>::max();
+	for( int32_t x = 0; x < width; ++x ) {
+		for( int j = 0; j < DST_INC; ++j )
+			dst[j] = ( index[j] >= 0 ) ? CHANTRAIT<TD>::convert( src[index[j]] ) : fill;
+		src += srcInc;
+		dst += DST_INC;
+	}
+}
+
+template<typename SD, typename TD>
+void swizzleRowScalar( const SD *src, TD *dst, int32_t width, const SwizzleMap &map )
+{
+	switch( map.mDstInc ) {
+		case 1: swizzleRowScalar<SD,TD,1>( src, dst, width, map.mSrcInc, map.mIndex ); break;
+		case 2: swizzleRowScalar<SD,TD,2>( src, dst, width, map.mSrcInc, map.mIndex ); break;
+		case 3: swizzleRowScalar<SD,TD,3>( src, dst, width, map.mSrcInc, map.mIndex ); break;
+		case 4: swizzleRowScalar<SD,TD,4>( src, dst, width, map.mSrcInc, map.mIndex ); break;
+	}
+}
+
+#if defined( CINDER_SWIZZLE_SSSE3 ) || defined( CINDER_SWIZZLE_NEON )
+
+// The byte shuffle which converts a block of whole pixels held in one 16-byte register
+struct ShuffleBlock {
+	uint8_t		mShuffle[16];	// the source byte of each destination byte, or 0x80 to zero it
+	uint8_t		mFill[16];		// ORed into the result: the channel maximum wherever the map's index is negative
+	int32_t		mPixels;		// pixels converted per block
+	int32_t		mGuardPixels;	// a block reads and writes a full 16 bytes, which spans this many pixels of the narrower row
+};
+
+// Builds the shuffle for a map whose elements are of type T. Returns false if the map's pixels are too wide for a register.
+template<typename T>
+bool makeShuffleBlock( const SwizzleMap &map, T fill, ShuffleBlock *result )
+{
+	if( map.mSrcInc < 1 || map.mSrcInc > 4 || map.mDstInc < 1 || map.mDstInc > 4 )
+		return false;
+
+	const int32_t srcPixelBytes = map.mSrcInc * sizeof(T), dstPixelBytes = map.mDstInc * sizeof(T);
+	result->mPixels = 16 / std::max( srcPixelBytes, dstPixelBytes );
+	result->mGuardPixels = ( 16 + std::min( srcPixelBytes, dstPixelBytes ) - 1 ) / std::min( srcPixelBytes, dstPixelBytes );
+	if( result->mPixels < 1 )
+		return false;
+
+	uint8_t fillBytes[sizeof(T)];
+	memcpy( fillBytes, &fill, sizeof(T) );
+	memset( result->mShuffle, 0x80, 16 );
+	memset( result->mFill, 0, 16 );
+	for( int32_t p = 0; p < result->mPixels; ++p ) {
+		for( int32_t j = 0; j < map.mDstInc; ++j ) {
+			for( size_t k = 0; k < sizeof(T); ++k ) {
+				const size_t dstByte = ( p * map.mDstInc + j ) * sizeof(T) + k;
+				if( map.mIndex[j] >= 0 )
+					result->mShuffle[dstByte] = static_cast<uint8_t>( ( p * map.mSrcInc + map.mIndex[j] ) * sizeof(T) + k );
+				else
+					result->mFill[dstByte] = fillBytes[k];
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
+
+#if defined( CINDER_SWIZZLE_SSSE3 )
+
+bool hasSwizzleSimd()
+{
+	static const bool sHasSsse3 = System::hasSsse3();
+	return sHasSsse3;
+}
+
+// Loads 16 elements as bytes, narrowing them as CHANTRAIT<uint8_t>::convert() does
+inline __m128i loadBytes( const uint8_t *src )
+{
+	return _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+}
+
+inline __m128i loadBytes( const uint16_t *src )
+{
+	// v / 257 is exactly ( v * 65281 ) >> 24 for all 16-bit v
+	const __m128i mult = _mm_set1_epi16( (short)65281 );
+	const __m128i lo = _mm_srli_epi16( _mm_mulhi_epu16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) ), mult ), 8 );
+	const __m128i hi = _mm_srli_epi16( _mm_mulhi_epu16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + 8 ) ), mult ), 8 );
+	return _mm_packus_epi16( lo, hi );
+}
+
+inline __m128i loadBytes( const float *src )
+{
+	const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps( 1.0f ), scale = _mm_set1_ps( 255.0f );
+	__m128i v[4];
+	for( int i = 0; i < 4; ++i )
+		v[i] = _mm_cvttps_epi32( _mm_mul_ps( _mm_min_ps( _mm_max_ps( _mm_loadu_ps( src + i * 4 ), zero ), one ), scale ) );
+	return _mm_packus_epi16( _mm_packs_epi32( v[0], v[1] ), _mm_packs_epi32( v[2], v[3] ) );
+}
+
+// Stores 16 bytes as elements, widening them as CHANTRAIT<TD>::convert() does
+inline void storeBytes( uint8_t *dst, __m128i v )
+{
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), v );
+}
+
+inline void storeBytes( uint16_t *dst, __m128i v )
+{
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), _mm_unpacklo_epi8( v, v ) );
+	_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + 8 ), _mm_unpackhi_epi8( v, v ) );
+}
+
+inline void storeBytes( float *dst, __m128i v )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 divisor = _mm_set1_ps( 255.0f );
+	const __m128i lo = _mm_unpacklo_epi8( v, zero ), hi = _mm_unpackhi_epi8( v, zero );
+	_mm_storeu_ps( dst,			_mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ), divisor ) );
+	_mm_storeu_ps( dst + 4,		_mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ), divisor ) );
+	_mm_storeu_ps( dst + 8,		_mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ), divisor ) );
+	_mm_storeu_ps( dst + 12,	_mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ), divisor ) );
+}
+
+// Converts whole blocks of pixels, shuffling them as bytes. \a srcInc and \a dstInc are measured in elements of SD and TD. Returns the number of pixels converted.
+template<typename SD, typename TD>
+CINDER_SWIZZLE_SSSE3_TARGET
+int32_t shuffleRow( const SD *src, TD *dst, int32_t width, const ShuffleBlock &block, int32_t srcInc, int32_t dstInc )
+{
+	const __m128i shuffle = _mm_loadu_si128( reinterpret_cast<const __m128i*>( block.mShuffle ) );
+	const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( block.mFill ) );
+	int32_t x = 0;
+	for( ; x + block.mGuardPixels <= width; x += block.mPixels )
+		storeBytes( dst + x * dstInc, _mm_or_si128( _mm_shuffle_epi8( loadBytes( src + x * srcInc ), shuffle ), fill ) );
+
+	return x;
+}
+
+#elif defined( CINDER_SWIZZLE_NEON )
+
+bool hasSwizzleSimd()
+{
+	return true;
+}
+
+int32_t shuffleRow( const uint8_t *src, uint8_t *dst, int32_t width, const ShuffleBlock &block, int32_t srcInc, int32_t dstInc )
+{
+	const uint8x16_t shuffle = vld1q_u8( block.mShuffle );
+	const uint8x16_t fill = vld1q_u8( block.mFill );
+	int32_t x = 0;
+	for( ; x + block.mGuardPixels <= width; x += block.mPixels )
+		vst1q_u8( dst + x * dstInc, vorrq_u8( vqtbl1q_u8( vld1q_u8( src + x * srcInc ), shuffle ), fill ) );
+
+	return x;
+}
+
+#endif
+
+// Returns the number of leading pixels converted with SIMD, which is zero when it isn't available
+template<typename T>
+int32_t swizzleRowSimd( const T *src, T *dst, int32_t width, const SwizzleMap &map )
+{
+#if defined( CINDER_SWIZZLE_SSSE3 ) || defined( CINDER_SWIZZLE_NEON )
+	// the elements are shuffled as bytes, so any element type works
+	ShuffleBlock block;
+	if( hasSwizzleSimd() && makeShuffleBlock<T>( map, CHANTRAIT<T>::max(), &block ) )
+		return shuffleRow( reinterpret_cast<const uint8_t*>( src ), reinterpret_cast<uint8_t*>( dst ), width, block, map.mSrcInc * sizeof(T), map.mDstInc * sizeof(T) );
+#endif
+	return 0;
+}
+
+template<typename SD, typename TD>
+int32_t swizzleRowSimd( const SD *src, TD *dst, int32_t width, const SwizzleMap &map )
+{
+#if defined( CINDER_SWIZZLE_SSSE3 )
+	// the elements are narrowed to or widened from bytes around the shuffle
+	ShuffleBlock block;
+	if( hasSwizzleSimd() && makeShuffleBlock<uint8_t>( map, 255, &block ) )
+		return shuffleRow( src, dst, width, block, map.mSrcInc, map.mDstInc );
+#endif
+	return 0;
+}
+
+} // anonymous namespace
+
+template<typename SD, typename TD>
+void swizzleRow( const SD *src, TD *dst, int32_t width, const SwizzleMap &map )
+{
+	static_assert( IsSwizzleRowSupported<SD,TD>::value, "swizzleRow() doesn't support these types" );
+	CI_ASSERT( map.mDstInc >= 1 && map.mDstInc <= 4 );
+
+	const int32_t simdWidth = swizzleRowSimd( src, dst, width, map );
+	swizzleRowScalar( src + simdWidth * map.mSrcInc, dst + simdWidth * map.mDstInc, width - simdWidth, map );
+}
+
+template CI_API void swizzleRow<uint8_t,uint8_t>( const uint8_t *src, uint8_t *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<uint8_t,uint16_t>( const uint8_t *src, uint16_t *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<uint8_t,float>( const uint8_t *src, float *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<uint16_t,uint8_t>( const uint16_t *src, uint8_t *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<float,uint8_t>( const float *src, uint8_t *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<uint16_t,uint16_t>( const uint16_t *src, uint16_t *dst, int32_t width, const SwizzleMap &map );
+template CI_API void swizzleRow<float,float>( const float *src, float *dst, int32_t width, const SwizzleMap &map );
+
+} } // namespace cinder::ip
@@ -0,0 +1,209 @@
+/*
+ Copyright (c) 2010, The Barbarian Group
+ All rights reserved.
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder { namespace ip {
+
+ThreadPool::ThreadPool( size_t numThreads )
+	: mStop( false )
+{
+	if( numThreads == 0 )
+		numThreads = std::max<size_t>( 1, std::thread::hardware_concurrency() );
+
+	// the thread calling parallelFor() always does its share of the work, so it counts as one of the threads
+	for( size_t t = 1; t < numThreads; ++t )
+		mWorkers.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		lock_guard<mutex> lock( mMutex );
+		mStop = true;
+	}
+	mCondition.notify_all();
+
+	for( auto &worker : mWorkers )
+		worker.join();
+}
+
+void ThreadPool::parallelFor( size_t count, size_t grain, const function<void( size_t, size_t )> &fn )
+{
+	if( count == 0 )
+		return;
+
+	grain = std::max<size_t>( 1, grain );
+	if( mWorkers.empty() || count <= grain ) {
+		fn( 0, count );
+		return;
+	}
+
+	auto job = make_shared<Job>( count, grain, fn );
+	{
+		lock_guard<mutex> lock( mMutex );
+		mJobs.push_back( job );
+	}
+	mCondition.notify_all();
+
+	runJob( job.get() );
+	removeJob( job );
+
+	// wait for any ranges still running on the workers
+	{
+		unique_lock<mutex> lock( job->mMutex );
+		job->mDoneCondition.wait( lock, [&] { return job->mRemaining.load() == 0; } );
+	}
+
+	if( job->mException )
+		rethrow_exception( job->mException );
+}
+
+void ThreadPool::workerLoop()
+{
+	ThreadSetup threadSetup;
+
+	unique_lock<mutex> lock( mMutex );
+	while( true ) {
+		mCondition.wait( lock, [this] { return mStop || ! mJobs.empty(); } );
+		if( mStop )
+			return;
+
+		// the newest job is the most likely to be a nested parallelFor() that some other range is blocked on
+		shared_ptr<Job> job = mJobs.back();
+		lock.unlock();
+		runJob( job.get() );
+		removeJob( job );
+		lock.lock();
+	}
+}
+
+// claims and runs ranges of job until there are none left to claim
+void ThreadPool::runJob( Job *job )
+{
+	while( true ) {
+		const size_t begin = job->mNext.fetch_add( job->mGrain );
+		if( begin >= job->mCount )
+			return;
+
+		const size_t end = std::min( begin + job->mGrain, job->mCount );
+		try {
+			job->mFn( begin, end );
+		}
+		catch( ... ) {
+			lock_guard<mutex> lock( job->mMutex );
+			if( ! job->mException )
+				job->mException = current_exception();
+		}
+
+		if( job->mRemaining.fetch_sub( end - begin ) == end - begin ) {
+			lock_guard<mutex> lock( job->mMutex );
+			job->mDoneCondition.notify_all();
+		}
+	}
+}
+
+void ThreadPool::removeJob( const shared_ptr<Job> &job )
+{
+	lock_guard<mutex> lock( mMutex );
+	auto it = find( mJobs.begin(), mJobs.end(), job );
+	if( it != mJobs.end() )
+		mJobs.erase( it );
+}
+
+namespace {
+
+// operations touching less memory than this are done before the workers would have woken up
+const size_t MIN_PARALLEL_BYTES = 128 * 1024;
+// bands are sized to stay resident in a core's L2 cache
+const size_t BAND_BYTES = 64 * 1024;
+
+mutex			sThreadPoolMutex;
+ThreadPoolRef	sThreadPool;
+
+// returns the pool to split \a length lines of \a bytesPerLine across, or nullptr if they should be processed serially
+ThreadPoolRef getThreadPoolFor( int32_t length, size_t bytesPerLine )
+{
+	if( length < 2 || bytesPerLine * length < MIN_PARALLEL_BYTES )
+		return ThreadPoolRef();
+
+	ThreadPoolRef threadPool = getThreadPool();
+	if( threadPool && threadPool->getNumThreads() < 2 )
+		return ThreadPoolRef();
+
+	return threadPool;
+}
+
+size_t calcLinesPerBand( const ThreadPoolRef &threadPool, int32_t length, size_t bytesPerLine )
+{
+	const size_t linesPerBand = std::max<size_t>( 1, BAND_BYTES / std::max<size_t>( 1, bytesPerLine ) );
+	// wide images shouldn't leave any threads without a band
+	const size_t numThreads = threadPool->getNumThreads();
+	return std::min( linesPerBand, ( length + numThreads - 1 ) / numThreads );
+}
+
+} // anonymous namespace
+
+void setThreadPool( const ThreadPoolRef &threadPool )
+{
+	lock_guard<mutex> lock( sThreadPoolMutex );
+	sThreadPool = threadPool;
+}
+
+ThreadPoolRef getThreadPool()
+{
+	lock_guard<mutex> lock( sThreadPoolMutex );
+	return sThreadPool;
+}
+
+void parallelRows( const Area &area, size_t bytesPerRow, const function<void( const Area &band )> &fn )
+{
+	ThreadPoolRef threadPool = getThreadPoolFor( area.getHeight(), bytesPerRow );
+	if( ! threadPool ) {
+		fn( area );
+		return;
+	}
+
+	threadPool->parallelFor( area.getHeight(), calcLinesPerBand( threadPool, area.getHeight(), bytesPerRow ), [&]( size_t begin, size_t end ) {
+		fn( Area( area.x1, area.y1 + (int32_t)begin, area.x2, area.y1 + (int32_t)end ) );
+	} );
+}
+
+void parallelColumns( const Area &area, size_t bytesPerColumn, const function<void( const Area &band )> &fn )
+{
+	ThreadPoolRef threadPool = getThreadPoolFor( area.getWidth(), bytesPerColumn );
+	if( ! threadPool ) {
+		fn( area );
+		return;
+	}
+
+	threadPool->parallelFor( area.getWidth(), calcLinesPerBand( threadPool, area.getWidth(), bytesPerColumn ), [&]( size_t begin, size_t end ) {
+		fn( Area( area.x1 + (int32_t)begin, area.y1, area.x1 + (int32_t)end, area.y2 ) );
+	} );
+}
+
+} } // namespace cinder::ip
@@ -21,29 +21,146 @@
 */
 
 #include "cinder/ip/Threshold.h"
+#include "cinder/ip/ThreadPool.h"
 #include "cinder/ChanTraits.h"
 
-#include <stdlib.h>
+#include <algorithm>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_THRESHOLD_SSE
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_THRESHOLD_NEON
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip {
 
+namespace {
+
+// The SIMD kernels below threshold whole blocks of 16 bytes, treating a row of pixels as a run of elements. Because 16 bytes hold a whole number of
+// 1 or 4 element pixels, \a colorMask marks the same elements in every block, while 3 element pixels are all color. Elements outside the mask keep
+// the value in \a dst. Each returns the number of elements thresholded, leaving the remainder to the scalar loop.
+
+#if defined( CINDER_THRESHOLD_SSE )
+
+int32_t thresholdElementsSimd( const uint8_t *src, uint8_t *dst, int32_t count, uint8_t value, const uint8_t colorMask[16], bool allColor )
+{
+	// SSE2 only compares signed bytes, so both sides are offset by 128 to compare them unsigned
+	const __m128i bias = _mm_set1_epi8( (char)0x80 );
+	const __m128i threshold = _mm_xor_si128( _mm_set1_epi8( (char)value ), bias );
+	const __m128i color = _mm_loadu_si128( reinterpret_cast<const __m128i*>( colorMask ) );
+
+	int32_t e = 0;
+	for( ; e + 16 <= count; e += 16 ) {
+		const __m128i greater = _mm_cmpgt_epi8( _mm_xor_si128( _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + e ) ), bias ), threshold );
+		__m128i *d = reinterpret_cast<__m128i*>( dst + e );
+		_mm_storeu_si128( d, allColor ? greater : _mm_or_si128( _mm_and_si128( greater, color ), _mm_andnot_si128( color, _mm_loadu_si128( d ) ) ) );
+	}
+
+	return e;
+}
+
+int32_t thresholdElementsSimd( const float *src, float *dst, int32_t count, float value, const uint8_t colorMask[16], bool allColor )
+{
+	const __m128 threshold = _mm_set1_ps( value ), one = _mm_set1_ps( 1.0f );
+	const __m128 color = _mm_castsi128_ps( _mm_setr_epi32( colorMask[0] ? -1 : 0, colorMask[4] ? -1 : 0, colorMask[8] ? -1 : 0, colorMask[12] ? -1 : 0 ) );
+
+	int32_t e = 0;
+	for( ; e + 4 <= count; e += 4 ) {
+		const __m128 result = _mm_and_ps( _mm_cmpgt_ps( _mm_loadu_ps( src + e ), threshold ), one );
+		float *d = dst + e;
+		_mm_storeu_ps( d, allColor ? result : _mm_or_ps( _mm_and_ps( result, color ), _mm_andnot_ps( color, _mm_loadu_ps( d ) ) ) );
+	}
+
+	return e;
+}
+
+#elif defined( CINDER_THRESHOLD_NEON )
+
+int32_t thresholdElementsSimd( const uint8_t *src, uint8_t *dst, int32_t count, uint8_t value, const uint8_t colorMask[16], bool allColor )
+{
+	const uint8x16_t threshold = vdupq_n_u8( value );
+	const uint8x16_t color = vld1q_u8( colorMask );
+
+	int32_t e = 0;
+	for( ; e + 16 <= count; e += 16 ) {
+		const uint8x16_t greater = vcgtq_u8( vld1q_u8( src + e ), threshold );
+		vst1q_u8( dst + e, allColor ? greater : vbslq_u8( color, greater, vld1q_u8( dst + e ) ) );
+	}
+
+	return e;
+}
+
+int32_t thresholdElementsSimd( const float *src, float *dst, int32_t count, float value, const uint8_t colorMask[16], bool allColor )
+{
+	const float32x4_t threshold = vdupq_n_f32( value );
+	const uint32x4_t one = vreinterpretq_u32_f32( vdupq_n_f32( 1.0f ) );
+	const uint32_t colorLanes[4] = { colorMask[0] ? 0xFFFFFFFFu : 0, colorMask[4] ? 0xFFFFFFFFu : 0, colorMask[8] ? 0xFFFFFFFFu : 0, colorMask[12] ? 0xFFFFFFFFu : 0 };
+	const uint32x4_t color = vld1q_u32( colorLanes );
+
+	int32_t e = 0;
+	for( ; e + 4 <= count; e += 4 ) {
+		const uint32x4_t result = vandq_u32( vcgtq_f32( vld1q_f32( src + e ), threshold ), one );
+		const uint32x4_t kept = allColor ? result : vbslq_u32( color, result, vreinterpretq_u32_f32( vld1q_f32( dst + e ) ) );
+		vst1q_f32( dst + e, vreinterpretq_f32_u32( kept ) );
+	}
+
+	return e;
+}
+
+#endif
+
+template<typename T>
+int32_t thresholdElementsSimd( const T * /*src*/, T * /*dst*/, int32_t /*count*/, T /*value*/, const uint8_t /*colorMask*/[16], bool /*allColor*/ )
+{
+	return 0;
+}
+
+// Thresholds the \a width pixels of \a pixelInc elements at \a src into \a dst, where \a isColor[i] tells whether the element at offset i is thresholded
+template<typename T>
+void thresholdElements( const T *src, T *dst, int32_t width, uint8_t pixelInc, const bool isColor[4], T value )
+{
+	uint8_t colorMask[16];
+	bool allColor = true;
+	for( int i = 0; i < 16; ++i ) {
+		// elements of 3 element pixels don't line up with the blocks, and are all color anyway
+		const bool color = ( pixelInc == 3 ) ? true : isColor[( i / sizeof(T) ) % pixelInc];
+		colorMask[i] = color ? 0xFF : 0;
+		allColor = allColor && color;
+	}
+
+	const int32_t count = width * pixelInc;
+	const T maxValue = CHANTRAIT<T>::max();
+	for( int32_t e = thresholdElementsSimd( src, dst, count, value, colorMask, allColor ); e < count; ++e ) {
+		if( isColor[e % pixelInc] )
+			dst[e] = ( src[e] > value ) ? maxValue : 0;
+	}
+}
+
+struct ColorElements {
+	ColorElements( const SurfaceChannelOrder &channelOrder )
+		: mIsColor{ false, false, false, false }
+	{
+		mIsColor[channelOrder.getRedOffset()] = mIsColor[channelOrder.getGreenOffset()] = mIsColor[channelOrder.getBlueOffset()] = true;
+	}
+
+	bool	mIsColor[4];
+};
+
 template<typename T>
 void thresholdImpl( SurfaceT<T> *surface, T value, const Area &area )
 {
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	ptrdiff_t rowBytes = surface->getRowBytes();
 	uint8_t pixelInc = surface->getPixelInc();
-	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset();
-	T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
-			dstPtr[redOffset] = ( dstPtr[redOffset] > value ) ? maxValue : 0;
-			dstPtr[greenOffset] = ( dstPtr[greenOffset] > value ) ? maxValue : 0;
-			dstPtr[blueOffset] = ( dstPtr[blueOffset] > value ) ? maxValue : 0;;
-			dstPtr += pixelInc;
+	const ColorElements colorElements( surface->getChannelOrder() );
+	parallelRows( clippedArea, clippedArea.getWidth() * pixelInc * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
+			thresholdElements( dstPtr, dstPtr, clippedArea.getWidth(), pixelInc, colorElements.mIsColor, value );
 		}
-	}	
+	} );
 }
 
 template<typename T>
@@ -59,18 +176,27 @@ void thresholdImpl( const SurfaceT<T> &srcSurface, T value, const Area &srcArea,
 	ptrdiff_t dstRowBytes = dstSurface->getRowBytes();
 	uint8_t dstPixelInc = dstSurface->getPixelInc();
 	uint8_t dstRedOffset = dstSurface->getRedOffset(), dstGreenOffset = dstSurface->getGreenOffset(), dstBlueOffset = dstSurface->getBlueOffset();
+	// Surfaces sharing a channel order are thresholded element for element; others are reordered pixel by pixel
+	const bool sameOrder = srcSurface.getChannelOrder() == dstSurface->getChannelOrder();
+	const ColorElements colorElements( dstSurface->getChannelOrder() );
 	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( dstSurface->getData() + ( dstOffset.x + area.getX1() ) * dstPixelInc ) + ( y + dstOffset.y ) * dstRowBytes );
-		const T *srcPtr = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + area.getX1() * srcPixelInc ) + ( y + area.getY1() ) * srcRowBytes );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			dstPtr[dstRedOffset] = ( srcPtr[srcRedOffset] > value ) ? maxValue : 0;
-			dstPtr[dstGreenOffset] = ( srcPtr[srcGreenOffset] > value ) ? maxValue : 0;
-			dstPtr[dstBlueOffset] = ( srcPtr[srcBlueOffset] > value ) ? maxValue : 0;;			
-			dstPtr += dstPixelInc;
-			srcPtr += srcPixelInc;
+	parallelRows( Area( 0, 0, area.getWidth(), area.getHeight() ), area.getWidth() * ( srcPixelInc + dstPixelInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( dstSurface->getData() + ( dstOffset.x + area.getX1() ) * dstPixelInc ) + ( y + dstOffset.y ) * dstRowBytes );
+			const T *srcPtr = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcSurface.getData() + area.getX1() * srcPixelInc ) + ( y + area.getY1() ) * srcRowBytes );
+			if( sameOrder ) {
+				thresholdElements( srcPtr, dstPtr, area.getWidth(), dstPixelInc, colorElements.mIsColor, value );
+				continue;
+			}
+			for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
+				dstPtr[dstRedOffset] = ( srcPtr[srcRedOffset] > value ) ? maxValue : 0;
+				dstPtr[dstGreenOffset] = ( srcPtr[srcGreenOffset] > value ) ? maxValue : 0;
+				dstPtr[dstBlueOffset] = ( srcPtr[srcBlueOffset] > value ) ? maxValue : 0;;			
+				dstPtr += dstPixelInc;
+				srcPtr += srcPixelInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
@@ -82,16 +208,32 @@ void thresholdImpl( const ChannelT<T> &srcChannel, T value, const Area &srcArea,
 
 	uint8_t srcInc = srcChannel.getIncrement();
 	uint8_t dstInc = dstChannel->getIncrement();
+	const bool isColor[4] = { true, true, true, true };
 	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 0; y < area.getHeight(); ++y ) {
-		T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) + dstOffset );
-		const T *srcPtr = srcChannel.getData( ivec2( area.getX1(), y ) );
-		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
-			*dstPtr = ( *srcPtr > value ) ? maxValue : 0;
-			dstPtr += dstInc;
-			srcPtr += srcInc;
+	parallelRows( Area( 0, 0, area.getWidth(), area.getHeight() ), area.getWidth() * ( srcInc + dstInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *dstPtr = dstChannel->getData( ivec2( area.getX1(), y ) + dstOffset );
+			const T *srcPtr = srcChannel.getData( ivec2( area.getX1(), y ) );
+			// only planar Channels are contiguous
+			if( srcInc == 1 && dstInc == 1 ) {
+				thresholdElements( srcPtr, dstPtr, area.getWidth(), 1, isColor, value );
+				continue;
+			}
+			for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
+				*dstPtr = ( *srcPtr > value ) ? maxValue : 0;
+				dstPtr += dstInc;
+				srcPtr += srcInc;
+			}
 		}
-	}
+	} );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void thresholdRow( const T *src, T *dst, int32_t width, const SurfaceChannelOrder &channelOrder, T value )
+{
+	thresholdElements( src, dst, width, channelOrder.getPixelInc(), ColorElements( channelOrder ).mIsColor, value );
 }
 
 template<typename T>
@@ -118,235 +260,112 @@ void threshold( const ChannelT<T> &srcChannel, T value, ChannelT<T> *dstChannel
 	thresholdImpl( srcChannel, value, srcChannel.getBounds(), ivec2(), dstChannel );
 }
 
-template<typename T>
-void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
-{
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel->getWidth();
-	int32_t imageHeight = srcChannel->getHeight();
-
-	int s2 = windowSize / 2;
-	uint8_t srcInc = srcChannel->getIncrement();
-	uint8_t dstInc = dstChannel->getIncrement();
-
-	SUMT comparisonMult = static_cast<SUMT>( ( 1.0f - percentageDelta ) * 256 );
-	const T maxValue = CHANTRAIT<T>::max();
+namespace {
 
-	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
-			dst += dstInc;
-			src += srcInc;
+// Calls fn( src, dst, count, sum ) for every pixel, where sum is the total of the window of size windowSize around it and count is the window's
+// number of pixels. Matching the original Bradley & Roth implementation, the window covers the pixels (x1, x2] x (y1, y2], clamped to the image.
+template<typename T, typename FN>
+void forEachAdaptiveWindow( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel, const FN &fn )
+{
+	const int32_t imageWidth = srcChannel.getWidth();
+	const int32_t imageHeight = srcChannel.getHeight();
+	const int s2 = windowSize / 2;
+	const uint8_t srcInc = srcChannel.getIncrement();
+	const uint8_t dstInc = dstChannel->getIncrement();
+
+	parallelRows( srcChannel.getBounds(), imageWidth * ( srcInc + dstInc ) * sizeof(T), [&]( const Area &band ) {
+		for( int32_t j = band.getY1(); j < band.getY2(); j++ ) {
+			T *dst = dstChannel->getData( 0, j );
+			const T *src = srcChannel.getData( 0, j );
+			const int32_t y1 = std::max( j - s2, 0 ), y2 = std::min( j + s2, imageHeight - 1 );
+			for( int32_t i = 0; i < imageWidth; i++ ) {
+				const int32_t x1 = std::max( i - s2, 0 ), x2 = std::min( i + s2, imageWidth - 1 );
+				const int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+				fn( src, dst, count, integralImage.areaSum( Area( x1 + 1, y1 + 1, x2 + 1, y2 + 1 ) ) );
+				dst += dstInc;
+				src += srcInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
-void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
+void calculateAdaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel->getWidth();
-	int32_t imageHeight = srcChannel->getHeight();
-	int s2 = windowSize / 2;
-	uint8_t srcInc = srcChannel->getIncrement();
-	uint8_t dstInc = dstChannel->getIncrement();
-
-	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
-			int32_t diffSignExtended = (int32_t)( sum - *src * count );
-			diffSignExtended >>= 31;
-			*dst = (T)(diffSignExtended & 0xFF);
-			dst += dstInc;
-			src += srcInc;
-		}
-	}
+	typedef typename IntegralImageT<T>::SumT SUMT;
 
+	const SUMT comparisonMult = static_cast<SUMT>( ( 1.0f - percentageDelta ) * 256 );
+	const T maxValue = CHANTRAIT<T>::max();
+	forEachAdaptiveWindow( srcChannel, integralImage, windowSize, dstChannel, [=]( const T *src, T *dst, int32_t count, SUMT sum ) {
+		*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
+	} );
 }
 
 template<typename T>
-void calculateIntegralImage( const ChannelT<T> &channel, typename CHANTRAIT<T>::Accum *integralImage )
+void calculateAdaptiveThresholdZero( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
 {
-	int32_t imageWidth = channel.getWidth(), imageHeight = channel.getHeight();
-	ptrdiff_t srcRowBytes = channel.getRowBytes();
-	uint8_t srcInc = channel.getIncrement();
-	const T *src = channel.getData();
-	/*for( int32_t i = 0; i < imageWidth; i++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t j = 0; j < imageHeight; j++ ) {
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( i == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-1] + sum;
-		}
-	}*/
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t i = 0; i < imageWidth; i++ ) {		
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( j == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-imageWidth] + sum;
-		}
-	}
+	typedef typename IntegralImageT<T>::SumT SUMT;
+
+	const T maxValue = CHANTRAIT<T>::max();
+	forEachAdaptiveWindow( srcChannel, integralImage, windowSize, dstChannel, [=]( const T *src, T *dst, int32_t count, SUMT sum ) {
+		*dst = ( sum < (SUMT)(*src * count) ) ? maxValue : 0;
+	} );
 }
 
+} // anonymous namespace
+
 template<typename T>
 void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( srcChannel );
+	calculateAdaptiveThreshold( srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
 }
 
 template<typename T>
 void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-
-	calculateAdaptiveThreshold( channel, integralImage, windowSize, percentageDelta, channel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( *channel );
+	calculateAdaptiveThreshold( *channel, integralImage, windowSize, percentageDelta, channel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-	
-	calculateAdaptiveThresholdZero( channel, integralImage, windowSize, channel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( *channel );
+	calculateAdaptiveThresholdZero( *channel, integralImage, windowSize, channel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThresholdZero( &srcChannel, integralImage, windowSize, dstChannel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( srcChannel );
+	calculateAdaptiveThresholdZero( srcChannel, integralImage, windowSize, dstChannel );
 }
 
 template<typename T>
 AdaptiveThresholdT<T>::AdaptiveThresholdT( const ChannelT<T> *channel )
-	: mChannel( channel )
+	: mChannel( channel ), mIntegralImage( *channel )
 {
-	mImageWidth = mChannel->getWidth();
-	mImageHeight = mChannel->getHeight();
-	mIncrement = mChannel->getIncrement();
+}
 
-	// create the integral image
-	mIntegralImage.resize( mImageWidth * mImageHeight );
-	calculateIntegralImage( *channel, mIntegralImage.data() );
+template<typename T>
+void AdaptiveThresholdT<T>::update( const Area &dirtyArea )
+{
+	mIntegralImage.update( *mChannel, dirtyArea );
 }
 
 template<typename T>
 void AdaptiveThresholdT<T>::calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
 	if( percentageDelta < 0.0001f ) {
-		calculateAdaptiveThresholdZero( mChannel, mIntegralImage.data(), windowSize, dstChannel );
+		calculateAdaptiveThresholdZero( *mChannel, mIntegralImage, windowSize, dstChannel );
 	} else {
-		calculateAdaptiveThreshold( mChannel, mIntegralImage.data(), windowSize, percentageDelta, dstChannel );
+		calculateAdaptiveThreshold( *mChannel, mIntegralImage, windowSize, percentageDelta, dstChannel );
 	}
 }
 
 template class CI_API AdaptiveThresholdT<uint8_t>;
+template class CI_API AdaptiveThresholdT<uint16_t>;
 template class CI_API AdaptiveThresholdT<float>;
 
 #define threshold_PROTOTYPES(T)\
@@ -361,4 +380,18 @@ template class CI_API AdaptiveThresholdT<float>;
 
 threshold_PROTOTYPES(uint8_t)
 
+template CI_API void adaptiveThreshold( const ChannelT<uint16_t> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<uint16_t> *dstChannel );
+template CI_API void adaptiveThreshold( ChannelT<uint16_t> *channel, int32_t windowSize, float percentageDelta );
+template CI_API void adaptiveThresholdZero( ChannelT<uint16_t> *channel, int32_t windowSize );
+template CI_API void adaptiveThresholdZero( const ChannelT<uint16_t> &srcChannel, int32_t windowSize, ChannelT<uint16_t> *dstChannel );
+
+template CI_API void threshold( SurfaceT<float> *surface, float value );
+template CI_API void threshold( SurfaceT<float> *surface, float value, const Area &area );
+template CI_API void threshold( const SurfaceT<float> &srcSurface, float value, SurfaceT<float> *dstSurface );
+template CI_API void threshold( const ChannelT<float> &srcChannel, float value, ChannelT<float> *dstChannel );
+
+template CI_API void thresholdRow( const uint8_t *src, uint8_t *dst, int32_t width, const SurfaceChannelOrder &channelOrder, uint8_t value );
+template CI_API void thresholdRow( const uint16_t *src, uint16_t *dst, int32_t width, const SurfaceChannelOrder &channelOrder, uint16_t value );
+template CI_API void thresholdRow( const float *src, float *dst, int32_t width, const SurfaceChannelOrder &channelOrder, float value );
+
 } } // namespace cinder::ip
@@ -21,77 +21,212 @@
 */
 
 #include "cinder/ip/Trim.h"
+#include "cinder/ip/ThreadPool.h"
 #include <algorithm>
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_TRIM_SSE
+	#include <emmintrin.h>
+#elif defined( __aarch64__ ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+	#define CINDER_TRIM_NEON
+	#include <arm_neon.h>
+#endif
+
+using namespace std;
+
 namespace cinder { namespace ip {
 
-template<typename T>
-bool transparentHorizontalScanline( const SurfaceT<T> &surface, int32_t row, int32_t x1, int32_t x2 )
+namespace {
+
+// The SIMD kernels test blocks of 16 four-element pixels at a time, returning whether any of them has a non-zero alpha.
+// Like the scalar test, a float alpha of -0 is transparent and a NaN is not.
+
+#if defined( CINDER_TRIM_SSE )
+
+bool anyOpaqueBlock( const uint8_t *pixels, uint8_t alphaOffset )
 {
-	const T *dstPtr = surface.getDataAlpha( ivec2( x1, row ) );
-	uint8_t inc = surface.getPixelInc();
-	for( int32_t x = x1; x < x2; ++x ) {
-		if( *dstPtr ) return false;
-		dstPtr += inc;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32( (int)( 0xFFu << ( alphaOffset * 8 ) ) );
+	__m128i any = _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels ) );
+	any = _mm_or_si128( any, _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + 16 ) ) );
+	any = _mm_or_si128( any, _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + 32 ) ) );
+	any = _mm_or_si128( any, _mm_loadu_si128( reinterpret_cast<const __m128i*>( pixels + 48 ) ) );
+	return _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_and_si128( any, alphaMask ), zero ) ) != 0xFFFF;
+}
+
+bool anyOpaqueBlock( const float *pixels, uint8_t alphaOffset )
+{
+	const __m128 zero = _mm_setzero_ps();
+	int notZero = 0;
+	for( int i = 0; i < 16; i += 4 ) {
+		notZero |= _mm_movemask_ps( _mm_cmpneq_ps( _mm_loadu_ps( pixels + i * 4 ), zero ) );
+		notZero |= _mm_movemask_ps( _mm_cmpneq_ps( _mm_loadu_ps( pixels + i * 4 + 4 ), zero ) );
+		notZero |= _mm_movemask_ps( _mm_cmpneq_ps( _mm_loadu_ps( pixels + i * 4 + 8 ), zero ) );
+		notZero |= _mm_movemask_ps( _mm_cmpneq_ps( _mm_loadu_ps( pixels + i * 4 + 12 ), zero ) );
 	}
-	return true;
+	return ( notZero & ( 1 << alphaOffset ) ) != 0;
+}
+
+#elif defined( CINDER_TRIM_NEON )
+
+bool anyOpaqueBlock( const uint8_t *pixels, uint8_t alphaOffset )
+{
+	return vmaxvq_u8( vld4q_u8( pixels ).val[alphaOffset] ) != 0;
+}
+
+bool anyOpaqueBlock( const float *pixels, uint8_t alphaOffset )
+{
+	uint32x4_t isZero = vdupq_n_u32( 0xFFFFFFFF );
+	for( int i = 0; i < 16; i += 4 )
+		isZero = vandq_u32( isZero, vceqq_f32( vld4q_f32( pixels + i * 4 ).val[alphaOffset], vdupq_n_f32( 0 ) ) );
+	return vminvq_u32( isZero ) == 0;
+}
+
+#endif
+
+#if defined( CINDER_TRIM_SSE ) || defined( CINDER_TRIM_NEON )
+const int32_t kBlockPixels = 16;
+#else
+const int32_t kBlockPixels = 1;
+#endif
+
+// Tests pixels [x, x + kBlockPixels) of \a row
+template<typename T>
+bool anyOpaque( const T *row, int32_t x, uint8_t pixelInc, uint8_t alphaOffset )
+{
+#if defined( CINDER_TRIM_SSE ) || defined( CINDER_TRIM_NEON )
+	// Surfaces with alpha always have four elements per pixel
+	if( pixelInc == 4 )
+		return anyOpaqueBlock( row + x * 4, alphaOffset );
+#endif
+	for( int32_t i = x; i < x + kBlockPixels; ++i )
+		if( row[i * pixelInc + alphaOffset] )
+			return true;
+	return false;
 }
 
+// Returns the first pixel in [x1, x2) of \a row with a non-zero alpha, or \a x2 if there isn't one
 template<typename T>
-bool transparentVerticalScanline( const SurfaceT<T> &surface, int32_t column, int32_t y1, int32_t y2 )
+int32_t firstOpaque( const T *row, int32_t x1, int32_t x2, uint8_t pixelInc, uint8_t alphaOffset )
 {
-	const T *dstPtr = surface.getDataAlpha( ivec2( column, y1 ) );
-	ptrdiff_t rowBytes = surface.getRowBytes();
-	for( int32_t y = y1; y < y2; ++y ) {
-		if( *dstPtr ) return false;
-		dstPtr += rowBytes;
-	}
-	return true;
+	int32_t x = x1;
+	// whole blocks are skipped until one has an opaque pixel, which is then found one pixel at a time
+	while( x + kBlockPixels <= x2 && ! anyOpaque( row, x, pixelInc, alphaOffset ) )
+		x += kBlockPixels;
+	for( ; x < x2; ++x )
+		if( row[x * pixelInc + alphaOffset] )
+			return x;
+	return x2;
+}
+
+// Returns one past the last pixel in [x1, x2) of \a row with a non-zero alpha, or \a x1 if there isn't one
+template<typename T>
+int32_t lastOpaqueEnd( const T *row, int32_t x1, int32_t x2, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	int32_t x = x2;
+	while( x - kBlockPixels >= x1 && ! anyOpaque( row, x - kBlockPixels, pixelInc, alphaOffset ) )
+		x -= kBlockPixels;
+	for( ; x > x1; --x )
+		if( row[( x - 1 ) * pixelInc + alphaOffset] )
+			return x;
+	return x1;
 }
 
+} // anonymous namespace
+
 template<typename T>
 Area findNonTransparentArea( const SurfaceT<T> &surface, const Area &unclippedBounds )
 {
 	const Area bounds = unclippedBounds.getClipBy( surface.getBounds() );
 	// if no alpha we'll fail over the to alpha-less fill
 	if( ! surface.hasAlpha() ) {
-		return surface.getBounds();
+		return bounds;
 	}
-	
-	int32_t topLine, bottomLine;
-	int32_t leftColumn, rightColumn;
-	// find the top and bottom lines
-	for( topLine = bounds.getY1(); topLine < bounds.getY2(); ++topLine ) {
-		if( ! transparentHorizontalScanline( surface, topLine, bounds.getX1(), bounds.getX2() ) ) {
+
+	// Each row is read at most once, and never a column at a time. The first non-transparent rows from the top and the bottom give the
+	// vertical extent, and the rows between them need only be searched outside of the horizontal extent found so far.
+	const uint8_t pixelInc = surface.getPixelInc(), alphaOffset = surface.getAlphaOffset();
+	const int32_t x1 = bounds.getX1(), x2 = bounds.getX2();
+	auto rowAt = [&]( int32_t y ) { return surface.getData( ivec2( 0, y ) ); };
+
+	int32_t topLine = bounds.getY1(), left = x2;
+	for( ; topLine < bounds.getY2(); ++topLine ) {
+		left = firstOpaque( rowAt( topLine ), x1, x2, pixelInc, alphaOffset );
+		if( left < x2 )
 			break;
-		}
 	}
-	for( bottomLine = bounds.getY2() - 1; bottomLine > topLine; --bottomLine ) {
-		if( ! transparentHorizontalScanline( surface, bottomLine, bounds.getX1(), bounds.getX2() ) ) {
+	// entirely transparent
+	if( topLine == bounds.getY2() )
+		return Area( x2, bounds.getY2(), x2, bounds.getY2() );
+	int32_t right = lastOpaqueEnd( rowAt( topLine ), left + 1, x2, pixelInc, alphaOffset );
+	right = std::max( right, left + 1 );
+
+	int32_t bottomLine = bounds.getY2() - 1;
+	for( ; bottomLine > topLine; --bottomLine ) {
+		const int32_t rowLeft = firstOpaque( rowAt( bottomLine ), x1, x2, pixelInc, alphaOffset );
+		if( rowLeft < x2 ) {
+			left = std::min( left, rowLeft );
+			right = std::max( right, lastOpaqueEnd( rowAt( bottomLine ), rowLeft + 1, x2, pixelInc, alphaOffset ) );
+			right = std::max( right, rowLeft + 1 );
 			break;
 		}
 	}
 
-	// find the left and right columns
-	for( leftColumn = bounds.getX1(); leftColumn < bounds.getX2(); ++leftColumn ) {
-		if( ! transparentVerticalScanline( surface, leftColumn, topLine, bottomLine ) ) {
-			break;
-		}
+	for( int32_t y = topLine + 1; y < bottomLine && ( left > x1 || right < x2 ); ++y ) {
+		const T *row = rowAt( y );
+		left = firstOpaque( row, x1, left, pixelInc, alphaOffset );
+		right = lastOpaqueEnd( row, right, x2, pixelInc, alphaOffset );
 	}
-	for( rightColumn = bounds.getX2() - 1; rightColumn > leftColumn; --rightColumn ) {
-		if( ! transparentVerticalScanline( surface, rightColumn, topLine, bottomLine ) ) {
-			break;
+
+	// we add one to the bottom because Area represents an inclusive range on top/left and exclusive range on bottom/right
+	return Area( left, topLine, right, bottomLine + 1 );
+}
+
+template<typename T>
+vector<Area> findNonTransparentAreas( const vector<SurfaceT<T>> &surfaces )
+{
+	vector<Area> result( surfaces.size() );
+	auto findRange = [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i )
+			result[i] = findNonTransparentArea( surfaces[i], surfaces[i].getBounds() );
+	};
+
+	ThreadPoolRef threadPool = getThreadPool();
+	if( threadPool && surfaces.size() > 1 )
+		threadPool->parallelFor( surfaces.size(), 1, findRange );
+	else
+		findRange( 0, surfaces.size() );
+
+	return result;
+}
+
+template<typename T>
+vector<SurfaceT<T>> trimTransparent( const vector<SurfaceT<T>> &surfaces, vector<Area> *resultAreas )
+{
+	vector<SurfaceT<T>> result( surfaces.size() );
+	vector<Area> areas( surfaces.size() );
+	auto trimRange = [&]( size_t begin, size_t end ) {
+		for( size_t i = begin; i < end; ++i ) {
+			areas[i] = findNonTransparentArea( surfaces[i], surfaces[i].getBounds() );
+			result[i] = surfaces[i].clone( areas[i] );
 		}
-	}
-	// we add one to right and bottom because Area represents an inclusive range on top/left and exclusive range on bottom/right
-	rightColumn = std::min( bounds.getX2(), rightColumn + 1 );
-	bottomLine = std::min( bounds.getY2(), bottomLine + 1 );
+	};
+
+	ThreadPoolRef threadPool = getThreadPool();
+	if( threadPool && surfaces.size() > 1 )
+		threadPool->parallelFor( surfaces.size(), 1, trimRange );
+	else
+		trimRange( 0, surfaces.size() );
 
-	return Area( leftColumn, topLine, rightColumn, bottomLine );
+	if( resultAreas )
+		*resultAreas = std::move( areas );
+	return result;
 }
 
 #define TRIM_PROTOTYPES(T)\
-	template CI_API Area findNonTransparentArea( const SurfaceT<T> &surface, const Area &unclippedBounds );
+	template CI_API Area findNonTransparentArea( const SurfaceT<T> &surface, const Area &unclippedBounds );\
+	template CI_API vector<Area> findNonTransparentAreas( const vector<SurfaceT<T>> &surfaces );\
+	template CI_API vector<SurfaceT<T>> trimTransparent( const vector<SurfaceT<T>> &surfaces, vector<Area> *resultAreas );
 
 // These should match CHANNEL_TYPES
 TRIM_PROTOTYPES(uint8_t)
@@ -30,15 +30,13 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cstring>
 #include <algorithm>
 
+#include <atomic>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "tinyexr.h"
 
-#ifdef _OPENMP
-#include <omp.h>
-#endif
-
 namespace {
 
 namespace miniz {
@@ -6966,6 +6964,81 @@ void DecompressZip(unsigned char *dst, unsigned long &uncompressedSize,
   }
 }
 
+// Calls func(i) for every i in [begin, end), spread over numThreads threads
+// including the calling one; 0 uses one per hardware thread.
+template <typename Func>
+void ParallelFor(int begin, int end, int numThreads, const Func &func) {
+  if (numThreads <= 0) {
+    numThreads = (std::max)(1, (int)std::thread::hardware_concurrency());
+  }
+  numThreads = (std::min)(numThreads, end - begin);
+
+  if (numThreads <= 1) {
+    for (int i = begin; i < end; i++) {
+      func(i);
+    }
+    return;
+  }
+
+  std::atomic<int> next(begin);
+  auto work = [&]() {
+    for (int i = next++; i < end; i = next++) {
+      func(i);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int t = 1; t < numThreads; t++) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (size_t t = 0; t < threads.size(); t++) {
+    threads[t].join();
+  }
+}
+
+int PixelTypeSize(int pixelType) {
+  // FLOAT and UINT are both 4 bytes
+  return (pixelType == TINYEXR_PIXELTYPE_HALF) ? sizeof(unsigned short)
+                                               : sizeof(unsigned int);
+}
+
+// Copies one line of `width` samples from a scanline block in the file's
+// (little endian) `srcType` into an image in `dstType`.
+void ReadChannelLine(unsigned char *dst, int dstType, const unsigned char *src,
+                     int srcType, int width) {
+  const bool isBigEndian = IsBigEndian();
+
+  if (srcType == dstType && !isBigEndian) {
+    memcpy(dst, src, width * PixelTypeSize(srcType));
+  } else if (srcType == TINYEXR_PIXELTYPE_HALF &&
+             dstType == TINYEXR_PIXELTYPE_FLOAT) {
+    float *out = reinterpret_cast<float *>(dst);
+    for (int u = 0; u < width; u++) {
+      FP16 hf;
+      memcpy(&hf.u, src + u * sizeof(unsigned short), sizeof(unsigned short));
+      if (isBigEndian) {
+        swap2(&hf.u);
+      }
+      out[u] = half_to_float(hf).f;
+    }
+  } else if (srcType == TINYEXR_PIXELTYPE_HALF) {
+    unsigned short *out = reinterpret_cast<unsigned short *>(dst);
+    for (int u = 0; u < width; u++) {
+      memcpy(&out[u], src + u * sizeof(unsigned short),
+             sizeof(unsigned short));
+      swap2(&out[u]);
+    }
+  } else {
+    // FLOAT and UINT are only ever loaded as themselves
+    unsigned int *out = reinterpret_cast<unsigned int *>(dst);
+    for (int u = 0; u < width; u++) {
+      memcpy(&out[u], src + u * sizeof(unsigned int), sizeof(unsigned int));
+      swap4(&out[u]);
+    }
+  }
+}
+
 } // namespace
 
 int LoadEXR(float **out_rgba, int *width, int *height, const char *filename,
@@ -7480,50 +7553,46 @@ int LoadMultiChannelEXRFromMemory(EXRImage *exrImage,
     return -10;
   }
 
+  // Only the rows [lineBegin, lineBegin + numLines) of the data window are
+  // stored when a range was requested.
+  int lineBegin = 0;
+  int numLines = dataHeight;
+  if (exrImage->line_end > exrImage->line_begin) {
+    lineBegin = (std::max)(0, exrImage->line_begin);
+    numLines = (std::min)(exrImage->line_end, dataHeight) - lineBegin;
+    if (numLines <= 0) {
+      if (err) {
+        (*err) = "Requested lines are outside of the data window.";
+      }
+      return -11;
+    }
+  }
+
   exrImage->images = reinterpret_cast<unsigned char **>(
       (float **)malloc(sizeof(float *) * numChannels));
-  for (int c = 0; c < numChannels; c++) {
-  }
 
   std::vector<size_t> channelOffsetList(numChannels);
   int pixelDataSize = 0;
   size_t channelOffset = 0;
   for (int c = 0; c < numChannels; c++) {
     channelOffsetList[c] = channelOffset;
-    if (channels[c].pixelType == TINYEXR_PIXELTYPE_HALF) {
-      pixelDataSize += sizeof(unsigned short);
-      channelOffset += sizeof(unsigned short);
-      // Alloc internal image for half type.
-      if (exrImage->requested_pixel_types[c] == TINYEXR_PIXELTYPE_HALF) {
-        exrImage->images[c] =
-            reinterpret_cast<unsigned char *>((unsigned short *)malloc(
-                sizeof(unsigned short) * dataWidth * dataHeight));
-      } else if (exrImage->requested_pixel_types[c] ==
-                 TINYEXR_PIXELTYPE_FLOAT) {
-        exrImage->images[c] = reinterpret_cast<unsigned char *>(
-            (float *)malloc(sizeof(float) * dataWidth * dataHeight));
-      } else {
-        assert(0);
-      }
-    } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_FLOAT) {
-      pixelDataSize += sizeof(float);
-      channelOffset += sizeof(float);
-      exrImage->images[c] = reinterpret_cast<unsigned char *>(
-          (float *)malloc(sizeof(float) * dataWidth * dataHeight));
-    } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_UINT) {
-      pixelDataSize += sizeof(unsigned int);
-      channelOffset += sizeof(unsigned int);
-      exrImage->images[c] = reinterpret_cast<unsigned char *>((
-          unsigned int *)malloc(sizeof(unsigned int) * dataWidth * dataHeight));
-    } else {
-      assert(0);
+    pixelDataSize += PixelTypeSize(channels[c].pixelType);
+    channelOffset += PixelTypeSize(channels[c].pixelType);
+
+    if (exrImage->requested_pixel_types[c] == TINYEXR_PIXELTYPE_NONE) {
+      exrImage->images[c] = NULL;
+      continue;
     }
+    // only HALF channels may be requested as another type
+    if (channels[c].pixelType != TINYEXR_PIXELTYPE_HALF) {
+      exrImage->requested_pixel_types[c] = channels[c].pixelType;
+    }
+    exrImage->images[c] = reinterpret_cast<unsigned char *>(
+        malloc(PixelTypeSize(exrImage->requested_pixel_types[c]) *
+               (size_t)dataWidth * numLines));
   }
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-  for (int y = 0; y < numBlocks; y++) {
+  ParallelFor(0, numBlocks, exrImage->num_threads, [&](int y) {
     const unsigned char *dataPtr =
         reinterpret_cast<const unsigned char *>(head + offsets[y]);
     // 4 byte: scan line
@@ -7537,230 +7606,73 @@ int LoadMultiChannelEXRFromMemory(EXRImage *exrImage,
       swap4(reinterpret_cast<unsigned int *>(&lineNo));
       swap4(reinterpret_cast<unsigned int *>(&dataLen));
     }
+    lineNo -= dy; // scan lines are numbered within the data window
 
     int endLineNo = (std::min)(lineNo + numScanlineBlocks, dataHeight);
+    if (lineNo < 0 || lineNo >= endLineNo) {
+      return;
+    }
 
-    int numLines = endLineNo - lineNo;
+    // Rows of the image each line of the block lands on
+    int firstRow = (lineOrder == 0) ? lineNo : (dataHeight - 1 - lineNo);
+    int lastRow =
+        (lineOrder == 0) ? (endLineNo - 1) : (dataHeight - endLineNo);
+    if ((std::max)(firstRow, lastRow) < lineBegin ||
+        (std::min)(firstRow, lastRow) >= lineBegin + numLines) {
+      return; // nothing requested in this block
+    }
 
+    const unsigned char *pixels = dataPtr + 8;
+    std::vector<unsigned char> outBuf;
     if (compressionType == 3) { // ZIP
-
       // Allocate original data size.
-      std::vector<unsigned char> outBuf(dataWidth * numLines * pixelDataSize);
+      outBuf.resize(dataWidth * (endLineNo - lineNo) * pixelDataSize);
 
       unsigned long dstLen = outBuf.size();
       DecompressZip(reinterpret_cast<unsigned char *>(&outBuf.at(0)), dstLen,
                     dataPtr + 8, dataLen);
-
-      bool isBigEndian = IsBigEndian();
-
-      // For ZIP_COMPRESSION:
-      //   pixel sample data for channel 0 for scanline 0
-      //   pixel sample data for channel 1 for scanline 0
-      //   pixel sample data for channel ... for scanline 0
-      //   pixel sample data for channel n for scanline 0
-      //   pixel sample data for channel 0 for scanline 1
-      //   pixel sample data for channel 1 for scanline 1
-      //   pixel sample data for channel ... for scanline 1
-      //   pixel sample data for channel n for scanline 1
-      //   ...
-      for (int c = 0; c < numChannels; c++) {
-
-        if (channels[c].pixelType == TINYEXR_PIXELTYPE_HALF) {
-          for (int v = 0; v < numLines; v++) {
-            const unsigned short *linePtr = reinterpret_cast<unsigned short *>(
-                &outBuf.at(v * pixelDataSize * dataWidth +
-                           channelOffsetList[c] * dataWidth));
-            for (int u = 0; u < dataWidth; u++) {
-              FP16 hf;
-
-              hf.u = linePtr[u];
-
-              if (isBigEndian) {
-                swap2(reinterpret_cast<unsigned short *>(&hf.u));
-              }
-
-              if (exrImage->requested_pixel_types[c] ==
-                  TINYEXR_PIXELTYPE_HALF) {
-                unsigned short *image =
-                    reinterpret_cast<unsigned short **>(exrImage->images)[c];
-                if (lineOrder == 0) {
-                  image += (lineNo + v) * dataWidth + u;
-                } else {
-                  image += (dataHeight - 1 - (lineNo + v)) * dataWidth + u;
-                }
-                *image = hf.u;
-              } else { // HALF -> FLOAT
-                FP32 f32 = half_to_float(hf);
-                float *image = reinterpret_cast<float **>(exrImage->images)[c];
-                if (lineOrder == 0) {
-                  image += (lineNo + v) * dataWidth + u;
-                } else {
-                  image += (dataHeight - 1 - (lineNo + v)) * dataWidth + u;
-                }
-                *image = f32.f;
-              }
-            }
-          }
-        } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_UINT) {
-
-          assert(exrImage->requested_pixel_types[c] == TINYEXR_PIXELTYPE_UINT);
-
-          for (int v = 0; v < numLines; v++) {
-            const unsigned int *linePtr = reinterpret_cast<unsigned int *>(
-                &outBuf.at(v * pixelDataSize * dataWidth +
-                           channelOffsetList[c] * dataWidth));
-            for (int u = 0; u < dataWidth; u++) {
-
-              unsigned int val = linePtr[u];
-
-              if (isBigEndian) {
-                swap4(&val);
-              }
-
-              unsigned int *image =
-                  reinterpret_cast<unsigned int **>(exrImage->images)[c];
-              if (lineOrder == 0) {
-                image += (lineNo + v) * dataWidth + u;
-              } else {
-                image += (dataHeight - 1 - (lineNo + v)) * dataWidth + u;
-              }
-              *image = val;
-            }
-          }
-        } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_FLOAT) {
-          assert(exrImage->requested_pixel_types[c] == TINYEXR_PIXELTYPE_FLOAT);
-          for (int v = 0; v < numLines; v++) {
-            const float *linePtr = reinterpret_cast<float *>(
-                &outBuf.at(v * pixelDataSize * dataWidth +
-                           channelOffsetList[c] * dataWidth));
-            for (int u = 0; u < dataWidth; u++) {
-
-              float val = linePtr[u];
-
-              if (isBigEndian) {
-                swap4(reinterpret_cast<unsigned int *>(&val));
-              }
-
-              float *image = reinterpret_cast<float **>(exrImage->images)[c];
-              if (lineOrder == 0) {
-                image += (lineNo + v) * dataWidth + u;
-              } else {
-                image += (dataHeight - 1 - (lineNo + v)) * dataWidth + u;
-              }
-              *image = val;
-            }
-          }
-        } else {
-          assert(0);
-        }
+      pixels = &outBuf.at(0);
+    }
+
+    // For both ZIP_COMPRESSION and no compression:
+    //   pixel sample data for channel 0 for scanline 0
+    //   pixel sample data for channel 1 for scanline 0
+    //   pixel sample data for channel ... for scanline 0
+    //   pixel sample data for channel n for scanline 0
+    //   pixel sample data for channel 0 for scanline 1
+    //   ...
+    for (int v = 0; v < endLineNo - lineNo; v++) {
+      int row = (lineOrder == 0) ? (lineNo + v) : (dataHeight - 1 - (lineNo + v));
+      if (row < lineBegin || row >= lineBegin + numLines) {
+        continue;
       }
-
-    } else if (compressionType == 0) { // No compression
-
-      bool isBigEndian = IsBigEndian();
+      const unsigned char *linePtr = pixels + v * pixelDataSize * dataWidth;
 
       for (int c = 0; c < numChannels; c++) {
-
-        if (channels[c].pixelType == TINYEXR_PIXELTYPE_HALF) {
-
-          const unsigned short *linePtr =
-              reinterpret_cast<const unsigned short *>(
-                  dataPtr + 8 + c * dataWidth * sizeof(unsigned short));
-
-          if (exrImage->requested_pixel_types[c] == TINYEXR_PIXELTYPE_HALF) {
-            unsigned short *outLine =
-                reinterpret_cast<unsigned short *>(exrImage->images[c]);
-            if (lineOrder == 0) {
-              outLine += y * dataWidth;
-            } else {
-              outLine += (dataHeight - 1 - y) * dataWidth;
-            }
-
-            for (int u = 0; u < dataWidth; u++) {
-              FP16 hf;
-
-              hf.u = linePtr[u];
-
-              if (isBigEndian) {
-                swap2(reinterpret_cast<unsigned short *>(&hf.u));
-              }
-
-              outLine[u] = hf.u;
-            }
-          } else if (exrImage->requested_pixel_types[c] ==
-                     TINYEXR_PIXELTYPE_FLOAT) {
-            float *outLine = reinterpret_cast<float *>(exrImage->images[c]);
-            if (lineOrder == 0) {
-              outLine += y * dataWidth;
-            } else {
-              outLine += (dataHeight - 1 - y) * dataWidth;
-            }
-
-            for (int u = 0; u < dataWidth; u++) {
-              FP16 hf;
-
-              hf.u = linePtr[u];
-
-              if (isBigEndian) {
-                swap2(reinterpret_cast<unsigned short *>(&hf.u));
-              }
-
-              FP32 f32 = half_to_float(hf);
-
-              outLine[u] = f32.f;
-            }
-          } else {
-            assert(0);
-          }
-        } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_FLOAT) {
-
-          const float *linePtr = reinterpret_cast<const float *>(
-              dataPtr + 8 + c * dataWidth * sizeof(float));
-
-          float *outLine = reinterpret_cast<float *>(exrImage->images[c]);
-          if (lineOrder == 0) {
-            outLine += y * dataWidth;
-          } else {
-            outLine += (dataHeight - 1 - y) * dataWidth;
-          }
-
-          for (int u = 0; u < dataWidth; u++) {
-            float val = linePtr[u];
-
-            if (isBigEndian) {
-              swap4(reinterpret_cast<unsigned int *>(&val));
-            }
-
-            outLine[u] = val;
-          }
-        } else if (channels[c].pixelType == TINYEXR_PIXELTYPE_UINT) {
-
-          const unsigned int *linePtr = reinterpret_cast<const unsigned int *>(
-              dataPtr + 8 + c * dataWidth * sizeof(unsigned int));
-
-          unsigned int *outLine =
-              reinterpret_cast<unsigned int *>(exrImage->images[c]);
-          if (lineOrder == 0) {
-            outLine += y * dataWidth;
-          } else {
-            outLine += (dataHeight - 1 - y) * dataWidth;
-          }
-
-          for (int u = 0; u < dataWidth; u++) {
-            unsigned int val = linePtr[u];
-
-            if (isBigEndian) {
-              swap4(reinterpret_cast<unsigned int *>(&val));
-            }
-
-            outLine[u] = val;
-          }
+        if (exrImage->images[c] == NULL) {
+          continue;
         }
+        int requestedType = exrImage->requested_pixel_types[c];
+        unsigned char *outLine =
+            exrImage->images[c] +
+            (size_t)(row - lineBegin) * dataWidth * PixelTypeSize(requestedType);
+        ReadChannelLine(outLine, requestedType,
+                        linePtr + channelOffsetList[c] * dataWidth,
+                        channels[c].pixelType, dataWidth);
       }
     }
-  } // omp parallel
+  });
 
   {
+    // replace what ParseMultiChannelEXRHeaderFrom*() allocated
+    if (exrImage->channel_names) {
+      for (int c = 0; c < exrImage->num_channels; c++) {
+        free((char *)exrImage->channel_names[c]); // remove const
+      }
+      free(exrImage->channel_names);
+    }
+    free(exrImage->pixel_types);
+
     exrImage->channel_names =
         (const char **)malloc(sizeof(const char *) * numChannels);
     for (int c = 0; c < numChannels; c++) {
@@ -7773,7 +7685,7 @@ int LoadMultiChannelEXRFromMemory(EXRImage *exrImage,
     exrImage->num_channels = numChannels;
 
     exrImage->width = dataWidth;
-    exrImage->height = dataHeight;
+    exrImage->height = numLines;
 
     // Fill with requested_pixel_types.
     exrImage->pixel_types = (int *)malloc(sizeof(int *) * numChannels);
@@ -8108,10 +8020,7 @@ size_t SaveMultiChannelEXRToMemory(const EXRImage *exrImage,
     }
   }
 
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-  for (int i = 0; i < numBlocks; i++) {
+  ParallelFor(0, numBlocks, exrImage->num_threads, [&](int i) {
     int startY = numScanlineBlocks * i;
     int endY = (std::min)(numScanlineBlocks * (i + 1), exrImage->height);
     int h = endY - startY;
@@ -8262,7 +8171,7 @@ size_t SaveMultiChannelEXRToMemory(const EXRImage *exrImage,
     //  swap8(reinterpret_cast<unsigned long long*>(&offsets[i]));
     //}
     // offset += dataLen + 8; // 8 = sizeof(blockHeader)
-  } // omp parallel
+  });
 
   for (int i = 0; i < numBlocks; i++) {
 
@@ -8910,6 +8819,11 @@ void InitEXRImage(EXRImage *exrImage) {
   exrImage->images = NULL;
   exrImage->pixel_types = NULL;
   exrImage->requested_pixel_types = NULL;
+  exrImage->width = 0;
+  exrImage->height = 0;
+  exrImage->num_threads = 0;
+  exrImage->line_begin = 0;
+  exrImage->line_end = 0;
 }
 
 int FreeEXRImage(EXRImage *exrImage) {
@@ -0,0 +1,482 @@
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Hdr.h"
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Resize.h"
+#include "cinder/ip/Swizzle.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/ip/Trim.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/ImageIo.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/Rand.h"
+#include "cinder/SurfacePool.h"
+#include "cinder/System.h"
+#include "cinder/Timer.h"
+
+#include <mutex>
+#include <thread>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+// Writes rows into a Surface through getRowPointer() only, which is how every ImageSource loaded before ImageTarget::getContiguousData()
+class RowImageTarget : public ImageTarget {
+  public:
+	RowImageTarget( Surface8u *surface )
+		: mSurface( surface )
+	{
+		setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( surface->hasAlpha() ? ImageIo::RGBA : ImageIo::RGB );
+	}
+
+	bool	hasAlpha() const override { return mSurface->hasAlpha(); }
+	void*	getRowPointer( int32_t row ) override { return mSurface->getData( ivec2( 0, row ) ); }
+
+  private:
+	Surface8u	*mSurface;
+};
+
+namespace {
+
+// The scalar loops ip::grayscale(), ip::threshold() and ip::hdrNormalize() ran before their SIMD kernels, for comparison
+void scalarGrayscale( const Surface8u &src, Channel8u *dst )
+{
+	const uint8_t pixelInc = src.getPixelInc(), red = src.getRedOffset(), green = src.getGreenOffset(), blue = src.getBlueOffset();
+	ip::parallelRows( src.getBounds(), src.getWidth() * ( pixelInc + 1 ), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			const uint8_t *srcPtr = src.getData( ivec2( 0, y ) );
+			uint8_t *dstPtr = dst->getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < src.getWidth(); ++x, srcPtr += pixelInc )
+				*dstPtr++ = static_cast<uint8_t>( ( srcPtr[red] * 74 + srcPtr[green] * 147 + srcPtr[blue] * 35 ) >> 8 );
+		}
+	} );
+}
+
+template<typename T>
+void scalarGrayscale( const SurfaceT<T> &src, SurfaceT<T> *dst )
+{
+	const uint8_t pixelInc = src.getPixelInc(), red = src.getRedOffset(), green = src.getGreenOffset(), blue = src.getBlueOffset();
+	ip::parallelRows( src.getBounds(), src.getWidth() * pixelInc * 2 * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			const T *srcPtr = src.getData( ivec2( 0, y ) );
+			T *dstPtr = dst->getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < src.getWidth(); ++x, srcPtr += pixelInc, dstPtr += pixelInc )
+				dstPtr[red] = dstPtr[green] = dstPtr[blue] = CHANTRAIT<T>::grayscale( srcPtr[red], srcPtr[green], srcPtr[blue] );
+		}
+	} );
+}
+
+template<typename T>
+void scalarThreshold( SurfaceT<T> *surface, T value )
+{
+	const uint8_t pixelInc = surface->getPixelInc(), red = surface->getRedOffset(), green = surface->getGreenOffset(), blue = surface->getBlueOffset();
+	const T maxValue = CHANTRAIT<T>::max();
+	ip::parallelRows( surface->getBounds(), surface->getWidth() * pixelInc * sizeof(T), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			T *ptr = surface->getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < surface->getWidth(); ++x, ptr += pixelInc ) {
+				ptr[red] = ( ptr[red] > value ) ? maxValue : 0;
+				ptr[green] = ( ptr[green] > value ) ? maxValue : 0;
+				ptr[blue] = ( ptr[blue] > value ) ? maxValue : 0;
+			}
+		}
+	} );
+}
+
+void scalarHdrNormalize( Surface32f *surface )
+{
+	const uint8_t pixelInc = surface->getPixelInc(), red = surface->getRedOffset(), green = surface->getGreenOffset(), blue = surface->getBlueOffset();
+	float minVal = *surface->getDataRed( ivec2() ), maxVal = minVal;
+	mutex minMaxMutex;
+	ip::parallelRows( surface->getBounds(), surface->getWidth() * pixelInc * sizeof(float), [&]( const Area &band ) {
+		float bandMin = minVal, bandMax = maxVal;
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			const float *ptr = surface->getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < surface->getWidth(); ++x, ptr += pixelInc )
+				for( uint8_t offset : { red, green, blue } ) {
+					bandMin = std::min( bandMin, ptr[offset] );
+					bandMax = std::max( bandMax, ptr[offset] );
+				}
+		}
+		lock_guard<mutex> lock( minMaxMutex );
+		minVal = std::min( minVal, bandMin );
+		maxVal = std::max( maxVal, bandMax );
+	} );
+
+	const float scale = 1.0f / ( maxVal - minVal );
+	ip::parallelRows( surface->getBounds(), surface->getWidth() * pixelInc * sizeof(float), [&]( const Area &band ) {
+		for( int32_t y = band.getY1(); y < band.getY2(); ++y ) {
+			float *ptr = surface->getData( ivec2( 0, y ) );
+			for( int32_t x = 0; x < surface->getWidth(); ++x, ptr += pixelInc )
+				for( uint8_t offset : { red, green, blue } )
+					ptr[offset] = ( ptr[offset] - minVal ) * scale;
+		}
+	} );
+}
+
+// The alpha scan ip::findNonTransparentArea() used before, which tested whole columns one pixel at a time
+Area scalarNonTransparentArea( const Surface8u &surface )
+{
+	const uint8_t pixelInc = surface.getPixelInc();
+	const ptrdiff_t rowBytes = surface.getRowBytes();
+	auto transparentRow = [&]( int32_t y ) {
+		const uint8_t *ptr = surface.getDataAlpha( ivec2( 0, y ) );
+		for( int32_t x = 0; x < surface.getWidth(); ++x, ptr += pixelInc )
+			if( *ptr ) return false;
+		return true;
+	};
+	auto transparentColumn = [&]( int32_t x, int32_t y1, int32_t y2 ) {
+		const uint8_t *ptr = surface.getDataAlpha( ivec2( x, y1 ) );
+		for( int32_t y = y1; y < y2; ++y, ptr += rowBytes )
+			if( *ptr ) return false;
+		return true;
+	};
+
+	int32_t top = 0, bottom = surface.getHeight() - 1, left = 0, right = surface.getWidth() - 1;
+	while( top < surface.getHeight() && transparentRow( top ) ) ++top;
+	while( bottom > top && transparentRow( bottom ) ) --bottom;
+	while( left < surface.getWidth() && transparentColumn( left, top, bottom ) ) ++left;
+	while( right > left && transparentColumn( right, top, bottom ) ) --right;
+	return Area( left, top, right + 1, bottom + 1 );
+}
+
+} // anonymous namespace
+
+// Runs a series of timing benchmarks for the cinder::ip functions and prints the results to the console.
+class IpBenchmarkApp : public App {
+  public:
+	void setup() override;
+
+	void benchResizePlan();
+	void benchThreadPool();
+	void benchPipeline();
+	void benchSwizzle();
+	void benchPremultiply();
+	void benchBlend();
+	void benchGaussianBlur();
+	void benchGrayscale();
+	void benchThreshold();
+	void benchHdr();
+	void benchTrim();
+	void benchImageLoad();
+
+	//! Returns the average time in milliseconds of \a iterations calls to \a fn
+	static double	timeMs( int iterations, const function<void()> &fn );
+	//! Returns the throughput of \a fn over the pixels of \a size in megapixels per second
+	static double	mpixPerSec( const ivec2 &size, const function<void()> &fn );
+
+	Surface8u	mSource;
+};
+
+double IpBenchmarkApp::timeMs( int iterations, const function<void()> &fn )
+{
+	fn(); // warm-up
+
+	Timer timer( true );
+	for( int i = 0; i < iterations; ++i )
+		fn();
+	timer.stop();
+
+	return timer.getSeconds() * 1000 / iterations;
+}
+
+double IpBenchmarkApp::mpixPerSec( const ivec2 &size, const function<void()> &fn )
+{
+	return size.x * size.y / ( timeMs( 10, fn ) * 1000 );
+}
+
+void IpBenchmarkApp::setup()
+{
+	Rand rnd( 1 );
+	mSource = Surface8u( 3840, 2160, true );
+	auto iter = mSource.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = rnd.nextInt( 256 );
+			iter.g() = rnd.nextInt( 256 );
+			iter.b() = rnd.nextInt( 256 );
+			iter.a() = rnd.nextInt( 256 );
+		}
+	}
+
+	benchResizePlan();
+	benchThreadPool();
+	benchPipeline();
+	benchSwizzle();
+	benchPremultiply();
+	benchBlend();
+	benchGaussianBlur();
+	benchGrayscale();
+	benchThreshold();
+	benchHdr();
+	benchTrim();
+	benchImageLoad();
+
+	quit();
+}
+
+void IpBenchmarkApp::benchResizePlan()
+{
+	console() << "ResizePlan 3840x2160 -> 1280x720 RGBA" << endl;
+
+	Surface8u dst( 1280, 720, true );
+	double ms = timeMs( 5, [&] { ip::resize( mSource, &dst ); } );
+	console() << "  ip::resize:            " << ms << " ms" << endl;
+
+	const int maxThreads = std::max<int>( 1, std::thread::hardware_concurrency() );
+	for( int numThreads = 1; numThreads <= maxThreads; numThreads *= 2 ) {
+		ip::ResizePlan plan( mSource.getSize(), dst.getSize(), FilterTriangle(), numThreads );
+		ms = timeMs( 5, [&] { plan.resize( mSource, &dst ); } );
+		console() << "  ResizePlan " << numThreads << " thread(s): " << ms << " ms" << endl;
+	}
+}
+
+void IpBenchmarkApp::benchThreadPool()
+{
+	console() << "ip::ThreadPool 3840x2160 RGBA, serial vs. N threads (ms)" << endl;
+
+	Surface8u dst = mSource.clone();
+	Channel8u gray( mSource.getWidth(), mSource.getHeight() );
+	const vector<pair<string,function<void()>>> ops = {
+		{ "fill",            [&] { ip::fill( &dst, ColorA8u( 10, 20, 30, 40 ) ); } },
+		{ "grayscale",       [&] { ip::grayscale( mSource, &gray ); } },
+		{ "premultiply",     [&] { dst.setPremultiplied( false ); ip::premultiply( &dst ); } },
+		{ "edgeDetectSobel", [&] { ip::edgeDetectSobel( mSource, &dst ); } },
+		{ "stackBlur",       [&] { ip::stackBlur( &dst, 8 ); } }
+	};
+
+	const int maxThreads = std::max<int>( 1, std::thread::hardware_concurrency() );
+	for( const auto &op : ops ) {
+		ip::setThreadPool( nullptr );
+		console() << "  " << op.first << ": serial " << timeMs( 5, op.second );
+		for( int numThreads = 2; numThreads <= maxThreads; numThreads *= 2 ) {
+			ip::setThreadPool( ip::ThreadPool::create( numThreads ) );
+			console() << ", " << numThreads << ": " << timeMs( 5, op.second );
+		}
+		console() << endl;
+	}
+
+	ip::setThreadPool( nullptr );
+}
+
+void IpBenchmarkApp::benchPipeline()
+{
+	console() << "Pipeline 3840x2160 RGBA grayscale -> threshold -> premultiply -> flipVertical" << endl;
+
+	Surface8u dst = mSource.clone();
+	double ms = timeMs( 5, [&] {
+		dst.setPremultiplied( false );
+		ip::grayscale( dst, &dst );
+		ip::threshold( &dst, (uint8_t)128 );
+		ip::premultiply( &dst );
+		ip::flipVertical( &dst );
+	} );
+	console() << "  separate passes: " << ms << " ms" << endl;
+
+	ms = timeMs( 5, [&] {
+		dst.setPremultiplied( false );
+		ip::Pipeline( &dst ).grayscale().threshold( 128 ).premultiply().flipVertical().run();
+	} );
+	console() << "  ip::Pipeline:    " << ms << " ms" << endl;
+}
+
+void IpBenchmarkApp::benchSwizzle()
+{
+	console() << "Swizzle 3840x2160 (" << ( System::hasSsse3() ? "SSSE3" : "scalar" ) << ")" << endl;
+
+	Surface8u bgra( 3840, 2160, true, SurfaceChannelOrder::BGRA );
+	Surface8u rgb( 3840, 2160, false, SurfaceChannelOrder::RGB );
+	Surface8u rgba( 3840, 2160, true, SurfaceChannelOrder::RGBA );
+	Surface32f rgba32f( 3840, 2160, true );
+	const Area area = mSource.getBounds();
+
+	console() << "  copyFrom RGBA -> BGRA: " << timeMs( 5, [&] { bgra.copyFrom( mSource, area ); } ) << " ms" << endl;
+	console() << "  copyFrom RGBA -> RGB:  " << timeMs( 5, [&] { rgb.copyFrom( mSource, area ); } ) << " ms" << endl;
+	console() << "  copyFrom RGB -> RGBA:  " << timeMs( 5, [&] { rgba.copyFrom( rgb, area ); } ) << " ms" << endl;
+	console() << "  Surface8u -> Surface32f: " << timeMs( 5, [&] { rgba32f = Surface32f( mSource ); } ) << " ms" << endl;
+	console() << "  Surface32f -> Surface8u: " << timeMs( 5, [&] { rgba = Surface8u( rgba32f ); } ) << " ms" << endl;
+}
+
+void IpBenchmarkApp::benchPremultiply()
+{
+	console() << "Premultiply 3840x2160 RGBA" << endl;
+
+	Surface8u surface8u = mSource.clone();
+	Surface32f surface32f( mSource );
+	console() << "  premultiply 8u:   " << timeMs( 5, [&] { ip::premultiply( &surface8u ); } ) << " ms" << endl;
+	console() << "  unpremultiply 8u: " << timeMs( 5, [&] { ip::unpremultiply( &surface8u ); } ) << " ms" << endl;
+	console() << "  premultiply 32f:   " << timeMs( 5, [&] { ip::premultiply( &surface32f ); } ) << " ms" << endl;
+	console() << "  unpremultiply 32f: " << timeMs( 5, [&] { ip::unpremultiply( &surface32f ); } ) << " ms" << endl;
+}
+
+void IpBenchmarkApp::benchBlend()
+{
+	console() << "Blend 3840x2160 RGBA over RGBA" << endl;
+
+	const pair<ip::BlendMode, const char*> modes[] = { { ip::BLEND_NORMAL, "normal" }, { ip::BLEND_ADD, "add" }, { ip::BLEND_MULTIPLY, "multiply" }, { ip::BLEND_SCREEN, "screen" } };
+	Surface8u foreground = mSource.clone(), background = mSource.clone();
+	Surface32f foreground32f( mSource ), background32f( mSource );
+	for( bool premultiplied : { false, true } ) {
+		foreground.setPremultiplied( premultiplied );
+		background.setPremultiplied( premultiplied );
+		foreground32f.setPremultiplied( premultiplied );
+		background32f.setPremultiplied( premultiplied );
+		for( const auto &mode : modes ) {
+			console() << "  " << mode.second << ( premultiplied ? " premultiplied" : "" ) << ": 8u " << timeMs( 5, [&] { ip::blend( &background, foreground, mode.first ); } );
+			console() << " ms, 32f " << timeMs( 5, [&] { ip::blend( &background32f, foreground32f, mode.first ); } ) << " ms" << endl;
+		}
+	}
+}
+
+void IpBenchmarkApp::benchGaussianBlur()
+{
+	console() << "Blur 3840x2160 RGBA, stackBlur vs. gaussianBlur (ms)" << endl;
+
+	Surface8u dst = mSource.clone();
+	ip::BlurScratch scratch;
+	for( int radius : { 4, 16, 64 } ) {
+		// a stack blur of radius r is close to a Gaussian of sigma r / 2
+		const float sigma = radius / 2.0f;
+		console() << "  radius " << radius << ": stackBlur " << timeMs( 3, [&] { ip::stackBlur( &dst, radius ); } );
+		console() << ", with scratch " << timeMs( 3, [&] { ip::stackBlur( &dst, radius, &scratch ); } );
+		console() << ", gaussianBlur " << timeMs( 3, [&] { ip::gaussianBlur( &dst, sigma ); } );
+		console() << ", with scratch " << timeMs( 3, [&] { ip::gaussianBlur( &dst, sigma, &scratch ); } ) << endl;
+	}
+}
+
+void IpBenchmarkApp::benchGrayscale()
+{
+	console() << "Grayscale 3840x2160, scalar vs. SIMD (MPix/s, " << ( System::hasSsse3() ? "SSSE3" : "no SSSE3" ) << ")" << endl;
+
+	const ivec2 size = mSource.getSize();
+	Surface8u dst8u = mSource.clone();
+	Channel8u channel8u( size.x, size.y );
+	Surface32f src32f( mSource ), dst32f = src32f.clone();
+	console() << "  Surface8u -> Channel8u:   " << mpixPerSec( size, [&] { scalarGrayscale( mSource, &channel8u ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::grayscale( mSource, &channel8u ); } ) << endl;
+	console() << "  Surface8u -> Surface8u:   " << mpixPerSec( size, [&] { scalarGrayscale( mSource, &dst8u ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::grayscale( mSource, &dst8u ); } ) << endl;
+	console() << "  Surface32f -> Surface32f: " << mpixPerSec( size, [&] { scalarGrayscale( src32f, &dst32f ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::grayscale( src32f, &dst32f ); } ) << endl;
+}
+
+void IpBenchmarkApp::benchThreshold()
+{
+	console() << "Threshold 3840x2160 RGBA in place, scalar vs. SIMD (MPix/s)" << endl;
+
+	const ivec2 size = mSource.getSize();
+	Surface8u surface8u = mSource.clone();
+	Surface32f surface32f( mSource );
+	console() << "  8u:  " << mpixPerSec( size, [&] { scalarThreshold( &surface8u, (uint8_t)128 ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::threshold( &surface8u, (uint8_t)128 ); } ) << endl;
+	console() << "  32f: " << mpixPerSec( size, [&] { scalarThreshold( &surface32f, 0.5f ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::threshold( &surface32f, 0.5f ); } ) << endl;
+}
+
+void IpBenchmarkApp::benchHdr()
+{
+	console() << "hdrNormalize 3840x2160 RGBA 32f, scalar vs. SIMD (MPix/s)" << endl;
+
+	const ivec2 size = mSource.getSize();
+	// normalizing again finds a range of [0,1], which takes as long as the first time
+	Surface32f surface( mSource );
+	float minVal, maxVal;
+	console() << "  getMinMax:    " << mpixPerSec( size, [&] { ip::getMinMax( surface, &minVal, &maxVal ); } ) << endl;
+	console() << "  hdrNormalize: " << mpixPerSec( size, [&] { scalarHdrNormalize( &surface ); } );
+	console() << " vs. " << mpixPerSec( size, [&] { ip::hdrNormalize( &surface, &minVal, &maxVal ); } ) << endl;
+}
+
+void IpBenchmarkApp::benchTrim()
+{
+	console() << "findNonTransparentArea, 2000 128x128 RGBA sprite frames (ms)" << endl;
+
+	// each frame is a disc of a different size around the middle, as in an animation
+	Rand rnd( 3 );
+	vector<Surface8u> frames;
+	for( int i = 0; i < 2000; ++i ) {
+		Surface8u frame( 128, 128, true );
+		const float radius = 10.0f + rnd.nextFloat( 50.0f );
+		auto iter = frame.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() ) {
+				iter.r() = iter.g() = iter.b() = 255;
+				iter.a() = ( length( vec2( iter.getPos() ) - vec2( 64 ) ) < radius ) ? 255 : 0;
+			}
+		}
+		frames.push_back( frame );
+	}
+
+	console() << "  per pixel, column scans: " << timeMs( 3, [&] { for( const auto &frame : frames ) scalarNonTransparentArea( frame ); } ) << endl;
+	console() << "  SIMD rows:               " << timeMs( 3, [&] { for( const auto &frame : frames ) ip::findNonTransparentArea( frame, frame.getBounds() ); } ) << endl;
+	ip::setThreadPool( ip::ThreadPool::create() );
+	console() << "  findNonTransparentAreas, " << ip::getThreadPool()->getNumThreads() << " threads: " << timeMs( 3, [&] { ip::findNonTransparentAreas( frames ); } ) << endl;
+	console() << "  trimTransparent:         " << timeMs( 3, [&] { ip::trimTransparent( frames ); } ) << endl;
+	ip::setThreadPool( nullptr );
+}
+
+void IpBenchmarkApp::benchImageLoad()
+{
+	// a folder of JPEGs and PNGs may be passed on the command line, otherwise a set of 3840x2160 PNGs is generated
+	vector<DataSourceRef> images;
+	const auto &args = getCommandLineArgs();
+	if( args.size() > 1 && fs::is_directory( args[1] ) ) {
+		for( fs::directory_iterator it( args[1] ), end; it != end; ++it ) {
+			const string extension = it->path().extension().string();
+			if( extension == ".jpg" || extension == ".jpeg" || extension == ".png" )
+				images.push_back( loadFile( it->path() ) );
+		}
+	}
+	else {
+		Surface8u rgb( mSource.getWidth(), mSource.getHeight(), false, SurfaceChannelOrder::RGB );
+		rgb.copyFrom( mSource, mSource.getBounds() );
+		for( int i = 0; i < 4; ++i ) {
+			OStreamMemRef stream = OStreamMem::create();
+			writeImage( DataTargetStream::createRef( stream ), ( i % 2 ) ? mSource : rgb, ImageTarget::Options(), "png" );
+			BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+			memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+			images.push_back( DataSourceBuffer::create( buffer ) );
+		}
+	}
+	console() << "ImageSourceFileStbImage load, " << images.size() << " images (ms per image)" << endl;
+	auto decoder = []( const DataSourceRef &image ) { return ImageSourceFileStbImage::create( image, ImageSource::Options() ); };
+	if( images.empty() )
+		return;
+
+	// a target without contiguous memory makes stb_image decode into a buffer of its own, whose rows are then copied into the Surface
+	double ms = timeMs( 1, [&] {
+		for( const auto &image : images ) {
+			ImageSourceRef source = decoder( image );
+			Surface8u surface( source->getWidth(), source->getHeight(), source->hasAlpha(), source->hasAlpha() ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+			source->load( ImageTargetRef( new RowImageTarget( &surface ) ) );
+		}
+	} ) / images.size();
+	console() << "  row by row:      " << ms << endl;
+
+	// formats stb_image decodes straight into the Surface skip that buffer; 16-bit, tRNS and converted images still use it
+	ms = timeMs( 1, [&] {
+		for( const auto &image : images )
+			Surface8u surface( decoder( image ) );
+	} ) / images.size();
+	console() << "  direct:          " << ms << endl;
+
+	SurfacePoolRef pool = SurfacePool::create();
+	ms = timeMs( 1, [&] {
+		for( const auto &image : images )
+			Surface8u surface = pool->getSurface<uint8_t>( decoder( image ) );
+	} ) / images.size();
+	console() << "  direct, pooled:  " << ms << ", " << pool->getNumHits() << " of " << pool->getNumHits() + pool->getNumMisses() << " Surfaces reused" << endl;
+}
+
+CINDER_APP( IpBenchmarkApp, RendererGl )
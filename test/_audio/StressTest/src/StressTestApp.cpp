@@ -7,6 +7,7 @@
 #include "cinder/audio/GenNode.h"
 #include "cinder/audio/GainNode.h"
 #include "cinder/audio/MonitorNode.h"
+#include "cinder/audio/OfflineContext.h"
 
 #include "cinder/audio/Utilities.h"
 
@@ -34,9 +35,11 @@ public:
 	void addGens();
 	void removeGens();
 	void clearGens();
+	void runOfflineBenchmark();
+	void cycleNumRenderThreads();
 
-	audio::GenNodeRef	makeSelectedGenType();
-	audio::GenNodeRef	makeOsc( audio::WaveformType type );
+	audio::GenNodeRef	makeSelectedGenType( audio::Context *ctx, audio::WaveTable2dRef *waveTable );
+	audio::GenNodeRef	makeOsc( audio::Context *ctx, audio::WaveformType type, audio::WaveTable2dRef *waveTable );
 
 	audio::GainNodeRef				mGain;
 	audio::MonitorSpectralNodeRef	mMonitor;
@@ -81,7 +84,7 @@ void StressTestApp::addGens()
 	auto ctx = audio::master();
 
 	for( size_t i = 0; i < mAddIncr; i++ ) {
-		auto gen = makeSelectedGenType();
+		auto gen = makeSelectedGenType( ctx, &mWaveTable );
 		gen->setFreq( audio::midiToFreq( randInt( 40, 60 ) ) );
 
 		gen->connect( mGain );
@@ -116,15 +119,51 @@ void StressTestApp::clearGens()
 	CI_LOG_V( "gen count: " << mGenBank.size() );
 }
 
-audio::GenNodeRef StressTestApp::makeSelectedGenType()
+// Renders the current graph configuration in an OfflineContext, as fast as possible, and logs how many seconds of audio were rendered per second.
+void StressTestApp::runOfflineBenchmark()
+{
+	const double renderSeconds = 10;
+	const size_t numGens = std::max<size_t>( mGenBank.size(), 1 );
+
+	auto ctx = audio::OfflineContext::create( audio::OfflineContext::Format().sampleRate( audio::master()->getSampleRate() ).framesPerBlock( audio::master()->getFramesPerBlock() ) );
+	ctx->setNumRenderThreads( audio::master()->getNumRenderThreads() );
+	auto gain = ctx->makeNode( new audio::GainNode( 0.1f ) );
+	gain >> ctx->getOutput();
+
+	audio::WaveTable2dRef waveTable;
+	for( size_t i = 0; i < numGens; i++ ) {
+		auto gen = makeSelectedGenType( ctx.get(), &waveTable );
+		gen->setFreq( audio::midiToFreq( randInt( 40, 60 ) ) );
+		gen >> gain;
+		gen->enable();
+	}
+
+	audio::Buffer rendered( size_t( renderSeconds * ctx->getSampleRate() ), ctx->getOutput()->getNumChannels() );
+	ctx->render( &rendered );
+
+	CI_LOG_I( "offline benchmark, gen count: " << numGens << ", frames per block: " << ctx->getFramesPerBlock()
+				<< ", render threads: " << ctx->getNumRenderThreads() << ", rendered seconds per second: " << ctx->getRenderSpeed() );
+}
+
+// Steps through rendering the gens on 0 up to one less than the number of cores worth of worker threads.
+void StressTestApp::cycleNumRenderThreads()
+{
+	auto ctx = audio::master();
+	size_t maxThreads = std::max<size_t>( thread::hardware_concurrency(), 1 ) - 1;
+	ctx->setNumRenderThreads( ctx->getNumRenderThreads() < maxThreads ? ctx->getNumRenderThreads() + 1 : 0 );
+
+	CI_LOG_V( "render threads: " << ctx->getNumRenderThreads() );
+}
+
+audio::GenNodeRef StressTestApp::makeSelectedGenType( audio::Context *ctx, audio::WaveTable2dRef *waveTable )
 {
 	switch( mSelectedGenType ) {
-		case SINE: return audio::master()->makeNode( new audio::GenSineNode );
-		case TRIANGLE: return audio::master()->makeNode( new audio::GenTriangleNode );
-		case OSC_SINE: return makeOsc( audio::WaveformType::SINE );
-		case OSC_SAW: return makeOsc( audio::WaveformType::SAWTOOTH );
-		case OSC_SQUARE: return makeOsc( audio::WaveformType::SQUARE );
-		case OSC_TRIANGLE: return makeOsc( audio::WaveformType::TRIANGLE );
+		case SINE: return ctx->makeNode( new audio::GenSineNode );
+		case TRIANGLE: return ctx->makeNode( new audio::GenTriangleNode );
+		case OSC_SINE: return makeOsc( ctx, audio::WaveformType::SINE, waveTable );
+		case OSC_SAW: return makeOsc( ctx, audio::WaveformType::SAWTOOTH, waveTable );
+		case OSC_SQUARE: return makeOsc( ctx, audio::WaveformType::SQUARE, waveTable );
+		case OSC_TRIANGLE: return makeOsc( ctx, audio::WaveformType::TRIANGLE, waveTable );
 
 		default: CI_ASSERT_NOT_REACHABLE();
 	}
@@ -132,17 +171,16 @@ audio::GenNodeRef StressTestApp::makeSelectedGenType()
 	return audio::GenNodeRef();
 }
 
-audio::GenNodeRef StressTestApp::makeOsc( audio::WaveformType type )
+audio::GenNodeRef StressTestApp::makeOsc( audio::Context *ctx, audio::WaveformType type, audio::WaveTable2dRef *waveTable )
 {
-	auto ctx = audio::master();
 	auto result = ctx->makeNode( new audio::GenOscNode( type ) );
 
-	if( mWaveTable )
-		result->setWaveTable( mWaveTable );
+	if( *waveTable )
+		result->setWaveTable( *waveTable );
 	else {
 		ctx->initializeNode( result );
 
-		mWaveTable = result->getWaveTable();
+		*waveTable = result->getWaveTable();
 	}
 
 	return result;
@@ -284,6 +322,10 @@ void StressTestApp::keyDown( KeyEvent event )
 			mEnableDrawing = ! mEnableDrawing;
 		else if( event.getChar() == 'a' )
 			addGens();
+		else if( event.getChar() == 'b' )
+			runOfflineBenchmark();
+		else if( event.getChar() == 't' )
+			cycleNumRenderThreads();
 	}
 }
 
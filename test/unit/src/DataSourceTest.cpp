@@ -0,0 +1,61 @@
+#include "catch.hpp"
+#include "cinder/DataSource.h"
+#include "cinder/Utilities.h"
+
+#include <cstring>
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+fs::path writeTempFile( const std::string &name, const std::string &contents )
+{
+	fs::path path = fs::temp_directory_path() / name;
+	std::ofstream file( path.string().c_str(), std::ios::binary );
+	file.write( contents.data(), contents.size() );
+	return path;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "DataSource" )
+{
+	SECTION( "Mapped files match their contents" )
+	{
+		std::string contents;
+		for( int i = 0; i < 100000; ++i )
+			contents += (char)( i * 7 );
+		const fs::path path = writeTempFile( "cinder_DataSourceTest_mapped.bin", contents );
+
+		for( auto access : { DataSourcePathMapped::ACCESS_NORMAL, DataSourcePathMapped::ACCESS_SEQUENTIAL, DataSourcePathMapped::ACCESS_RANDOM } ) {
+			DataSourceRef source = loadFileMapped( path, access );
+			REQUIRE( source->isFilePath() );
+			REQUIRE( source->getFilePath() == path );
+			BufferRef buffer = source->getBuffer();
+			REQUIRE( buffer->getSize() == contents.size() );
+			REQUIRE( memcmp( buffer->getData(), contents.data(), contents.size() ) == 0 );
+			REQUIRE( loadString( source ) == contents );
+			// streams read the file as usual
+			BufferRef streamed = loadStreamBuffer( source->createStream() );
+			REQUIRE( memcmp( streamed->getData(), contents.data(), contents.size() ) == 0 );
+		}
+
+		// the Buffer outlives its DataSource, and writing to it leaves the file alone
+		BufferRef buffer = loadFileMapped( path )->getBuffer();
+		memset( buffer->getData(), 0, buffer->getSize() );
+		REQUIRE( memcmp( loadFile( path )->getBuffer()->getData(), contents.data(), contents.size() ) == 0 );
+		buffer.reset();
+
+		fs::remove( path );
+	}
+
+	SECTION( "Mapped empty and missing files" )
+	{
+		const fs::path path = writeTempFile( "cinder_DataSourceTest_empty.bin", "" );
+		REQUIRE( loadFileMapped( path )->getBuffer()->getSize() == 0 );
+		fs::remove( path );
+
+		REQUIRE_THROWS_AS( loadFileMapped( path )->getBuffer(), StreamExc );
+	}
+}
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include "ip/utils.h"
+#include "cinder/ImageFileTinyExr.h"
+#include "cinder/Rand.h"
+
+#include "tinyexr/tinyexr.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+fs::path tempPath( const std::string &name )
+{
+	return fs::temp_directory_path() / ( "ImageFileTinyExrTest_" + name + ".exr" );
+}
+
+void writeExr( const fs::path &path, const ImageSourceRef &source )
+{
+	writeImage( ImageTargetFileTinyExr::create( DataTargetPath::createRef( path ), source, ImageTarget::Options(), "exr" ), source );
+}
+
+// Writes planar channels straight through tinyexr; \a pixelType applies to all of them and \a data holds floats or halfs
+void writeChannels( const fs::path &path, int32_t width, int32_t height, const std::vector<const char*> &names, int pixelType, const std::vector<const void*> &data )
+{
+	EXRImage image;
+	InitEXRImage( &image );
+	std::vector<int> pixelTypes( names.size(), pixelType );
+	image.num_channels = (int)names.size();
+	image.channel_names = const_cast<const char**>( names.data() );
+	image.images = (unsigned char**)const_cast<void**>( data.data() );
+	image.pixel_types = pixelTypes.data();
+	image.requested_pixel_types = pixelTypes.data();
+	image.width = width;
+	image.height = height;
+	const char *error;
+	REQUIRE( SaveMultiChannelEXRToFile( &image, path.string().c_str(), &error ) == 0 );
+}
+
+int filePixelType( const fs::path &path )
+{
+	EXRImage image;
+	InitEXRImage( &image );
+	const char *error;
+	REQUIRE( ParseMultiChannelEXRHeaderFromFile( &image, path.string().c_str(), &error ) == 0 );
+	const int result = image.pixel_types[0];
+	FreeEXRImage( &image );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageFileTinyExr" )
+{
+	SECTION( "Round trips float RGB and RGBA with any number of threads" )
+	{
+		// 53 rows span four 16-line ZIP blocks, the last one partial
+		for( bool alpha : { false, true } ) {
+			const Surface32f original = makeNoiseSurface<float>( 37, 53, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB, 16, -2.0f, 100.0f );
+			const fs::path path = tempPath( "float" );
+			writeExr( path, original );
+			REQUIRE( filePixelType( path ) == TINYEXR_PIXELTYPE_FLOAT );
+
+			for( int numThreads : { 0, 1, 3, 8 } ) {
+				ImageSourceRef source = ImageSourceFileTinyExr::create( DataSourcePath::create( path ), ImageSourceFileTinyExr::Options().numThreads( numThreads ) );
+				REQUIRE( source->getDataType() == ImageIo::FLOAT32 );
+				REQUIRE( samePixels( Surface32f( source ), original ) );
+			}
+			fs::remove( path );
+		}
+	}
+
+	SECTION( "Keeps half channels as half from decoding to writing" )
+	{
+		const int32_t width = 29, height = 40;
+		Rand rnd( 3 );
+		std::vector<std::vector<uint16_t>> planes( 3, std::vector<uint16_t>( width * height ) );
+		for( auto &plane : planes )
+			for( auto &value : plane )
+				value = (uint16_t)rnd.nextUint( 0x7c00 ); // finite, non-negative halfs
+		const fs::path path = tempPath( "half" ), rewritten = tempPath( "half_rewritten" );
+		writeChannels( path, width, height, { "B", "G", "R" }, TINYEXR_PIXELTYPE_HALF, { planes[0].data(), planes[1].data(), planes[2].data() } );
+
+		ImageSourceRef source = ImageSourceFileTinyExr::create( DataSourcePath::create( path ) );
+		REQUIRE( source->getDataType() == ImageIo::FLOAT16 );
+		writeExr( rewritten, source );
+		REQUIRE( filePixelType( rewritten ) == TINYEXR_PIXELTYPE_HALF );
+
+		// the half path and the decoder's expansion to float agree, and both match the half bits written
+		const Surface32f expanded( ImageSourceFileTinyExr::create( DataSourcePath::create( path ), ImageSourceFileTinyExr::Options().halfAsFloat() ) );
+		REQUIRE( samePixels( Surface32f( ImageSourceFileTinyExr::create( DataSourcePath::create( rewritten ) ) ), expanded ) );
+		bool equal = true;
+		for( int32_t y = 0; y < height; ++y ) {
+			for( int32_t x = 0; x < width; ++x ) {
+				const Colorf c = expanded.getPixel( ivec2( x, y ) );
+				equal = equal && floatToHalf( c.b ).u == planes[0][y * width + x] && floatToHalf( c.g ).u == planes[1][y * width + x] && floatToHalf( c.r ).u == planes[2][y * width + x];
+			}
+		}
+		REQUIRE( equal );
+		fs::remove( path );
+		fs::remove( rewritten );
+	}
+
+	SECTION( "Loads selected channels and areas" )
+	{
+		const int32_t width = 41, height = 70;
+		const Surface32f rgba = makeNoiseSurface<float>( width, height, SurfaceChannelOrder::RGBA, 16, -2.0f, 100.0f );
+		std::vector<std::vector<float>> planes( 5, std::vector<float>( width * height ) );
+		for( int32_t y = 0; y < height; ++y ) {
+			for( int32_t x = 0; x < width; ++x ) {
+				const ColorAf c = rgba.getPixel( ivec2( x, y ) );
+				planes[0][y * width + x] = c.a;
+				planes[1][y * width + x] = c.b;
+				planes[2][y * width + x] = c.g;
+				planes[3][y * width + x] = c.r;
+				planes[4][y * width + x] = (float)( x * 1000 + y ); // depth
+			}
+		}
+		const fs::path path = tempPath( "channels" );
+		writeChannels( path, width, height, { "A", "B", "G", "R", "Z" }, TINYEXR_PIXELTYPE_FLOAT, { planes[0].data(), planes[1].data(), planes[2].data(), planes[3].data(), planes[4].data() } );
+
+		// extra channels are skipped by default
+		REQUIRE( samePixels( Surface32f( ImageSourceFileTinyExr::create( DataSourcePath::create( path ) ) ), rgba ) );
+
+		const Area area( 5, 18, 30, 51 );
+		for( int numThreads : { 1, 4 } ) {
+			auto options = ImageSourceFileTinyExr::Options().area( area ).numThreads( numThreads );
+			ImageSourceRef source = ImageSourceFileTinyExr::create( DataSourcePath::create( path ), options );
+			REQUIRE( source->getWidth() == area.getWidth() );
+			REQUIRE( source->getHeight() == area.getHeight() );
+			REQUIRE( samePixels( Surface32f( source ), rgba, area ) );
+
+			const Channel32f depth( ImageSourceFileTinyExr::create( DataSourcePath::create( path ), options.channels( { "Z" } ) ) );
+			bool equal = depth.getSize() == area.getSize();
+			for( int32_t y = 0; y < depth.getHeight(); ++y )
+				for( int32_t x = 0; x < depth.getWidth(); ++x )
+					equal = equal && depth.getValue( ivec2( x, y ) ) == (float)( ( area.x1 + x ) * 1000 + area.y1 + y );
+			REQUIRE( equal );
+		}
+
+		// areas are clipped to the data window
+		ImageSourceRef clipped = ImageSourceFileTinyExr::create( DataSourcePath::create( path ), ImageSourceFileTinyExr::Options().area( Area( 30, 60, 100, 100 ) ) );
+		REQUIRE( clipped->getWidth() == 11 );
+		REQUIRE( clipped->getHeight() == 10 );
+		REQUIRE_THROWS_AS( ImageSourceFileTinyExr::create( DataSourcePath::create( path ), ImageSourceFileTinyExr::Options().area( Area( 50, 0, 60, 10 ) ) ), ImageIoExceptionFailedLoadTinyExr );
+		REQUIRE_THROWS_AS( ImageSourceFileTinyExr::create( DataSourcePath::create( path ), ImageSourceFileTinyExr::Options().channels( { "R", "G", "X" } ) ), ImageIoExceptionFailedLoadTinyExr );
+		fs::remove( path );
+	}
+}
@@ -0,0 +1,222 @@
+#include "catch.hpp"
+#include "cinder/ImageLoader.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/ImageTargetFileStbImage.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// Returns a DataSource over \a surface encoded as a PNG
+DataSourceRef encodePng( const Surface8u &surface )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = surface;
+	writeImage( ImageTargetFileStbImage::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), "png" ), source );
+
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+// A solid image whose color identifies it
+DataSourceRef solidPng( int32_t width, uint8_t value )
+{
+	Surface8u surface( width, 8, false );
+	auto iter = surface.getIter();
+	while( iter.line() )
+		while( iter.pixel() )
+			iter.r() = iter.g() = iter.b() = value;
+	return encodePng( surface );
+}
+
+// A DataSource which blocks until released, holding a worker busy
+class DataSourceGate : public DataSource {
+  public:
+	DataSourceGate( const DataSourceRef &source ) : DataSource( "", Url() ), mSource( source ), mOpen( false ) {}
+
+	void open()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mOpen = true;
+		}
+		mCondition.notify_all();
+	}
+
+	bool	isFilePath() override	{ return false; }
+	bool	isUrl() override		{ return false; }
+
+	IStreamRef	createStream() override
+	{
+		getBuffer();
+		return mSource->createStream();
+	}
+
+  protected:
+	void	createBuffer() override
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mCondition.wait( lock, [this] { return mOpen; } );
+		mBuffer = mSource->getBuffer();
+	}
+
+	DataSourceRef			mSource;
+	bool					mOpen;
+	std::mutex				mMutex;
+	std::condition_variable	mCondition;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ImageLoader" )
+{
+	ImageSourceFileStbImage::registerSelf();
+
+	SECTION( "Loads every request and calls completions from update()" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 3 ) );
+		std::vector<ImageLoader::RequestRef> requests;
+		size_t numCompleted = 0;
+		for( int i = 0; i < 20; ++i )
+			requests.push_back( loader->load( solidPng( 10 + i, (uint8_t)i ), 0, [&]( const ImageLoader::RequestRef &request ) {
+				REQUIRE( request->isDone() );
+				++numCompleted;
+			} ) );
+		loader->waitAll();
+
+		REQUIRE( numCompleted == 0 );
+		REQUIRE( loader->update( 5 ) == 5 );
+		REQUIRE( loader->update() == 15 );
+		REQUIRE( numCompleted == 20 );
+		for( int i = 0; i < 20; ++i ) {
+			REQUIRE( requests[i]->isDone() );
+			const Surface8uRef surface = requests[i]->getFuture().get();
+			REQUIRE( surface->getWidth() == 10 + i );
+			REQUIRE( surface->getPixel( ivec2( 3, 3 ) ).g == i );
+		}
+	}
+
+	SECTION( "Loads higher priorities first" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ) );
+		auto gate = std::make_shared<DataSourceGate>( solidPng( 4, 0 ) );
+		loader->load( gate );
+		while( loader->getNumLoading() == 0 )
+			std::this_thread::yield();
+
+		std::vector<int> order;
+		auto record = [&order]( const ImageLoader::RequestRef &request ) { order.push_back( request->getFuture().get()->getPixel( ivec2( 0 ) ).r ); };
+		loader->load( solidPng( 4, 1 ), 0, record );
+		loader->load( solidPng( 4, 2 ), 5, record );
+		ImageLoader::RequestRef low = loader->load( solidPng( 4, 3 ), -1, record );
+		loader->load( solidPng( 4, 4 ), 5, record );
+		low->setPriority( 10 );
+		REQUIRE( loader->getNumPending() == 4 );
+
+		gate->open();
+		loader->waitAll();
+		loader->update();
+		REQUIRE( order == std::vector<int>( { 3, 2, 4, 1 } ) );
+	}
+
+	SECTION( "Cancels waiting and loading requests" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ) );
+		auto gate = std::make_shared<DataSourceGate>( solidPng( 4, 0 ) );
+		ImageLoader::RequestRef loading = loader->load( gate );
+		ImageLoader::RequestRef waiting = loader->load( solidPng( 4, 1 ) );
+		ImageLoader::RequestRef kept = loader->load( solidPng( 4, 2 ) );
+		while( loader->getNumLoading() == 0 )
+			std::this_thread::yield();
+
+		waiting->cancel();
+		REQUIRE( waiting->isDone() );
+		REQUIRE( waiting->isCanceled() );
+		REQUIRE_THROWS_AS( waiting->getFuture().get(), ImageLoaderExceptionCanceled );
+
+		loading->cancel();
+		REQUIRE( ! loading->isDone() );
+		gate->open();
+		loader->waitAll();
+		REQUIRE_THROWS_AS( loading->getFuture().get(), ImageLoaderExceptionCanceled );
+		REQUIRE( kept->getFuture().get()->getWidth() == 4 );
+		REQUIRE( ! kept->isCanceled() );
+
+		// canceling a completed request has no effect
+		kept->cancel();
+		REQUIRE( ! kept->isCanceled() );
+	}
+
+	SECTION( "cancelAll() cancels requests being decoded too" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ) );
+		auto gate = std::make_shared<DataSourceGate>( solidPng( 4, 0 ) );
+		ImageLoader::RequestRef loading = loader->load( gate );
+		ImageLoader::RequestRef waiting = loader->load( solidPng( 4, 1 ) );
+		while( loader->getNumLoading() == 0 )
+			std::this_thread::yield();
+
+		loader->cancelAll();
+		REQUIRE( loading->isCanceled() );
+		REQUIRE( waiting->isCanceled() );
+		gate->open();
+		loader->waitAll();
+		REQUIRE_THROWS_AS( loading->getFuture().get(), ImageLoaderExceptionCanceled );
+		REQUIRE_THROWS_AS( waiting->getFuture().get(), ImageLoaderExceptionCanceled );
+	}
+
+	SECTION( "Propagates load failures through the future" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 2 ) );
+		bool called = false;
+		ImageLoader::RequestRef missing = loader->load( fs::path( "does/not/exist.png" ), 0, [&called]( const ImageLoader::RequestRef & ) { called = true; } );
+		BufferRef garbage = Buffer::create( 64 );
+		memset( garbage->getData(), 7, garbage->getSize() );
+		ImageLoader::RequestRef corrupt = loader->load( DataSourceBuffer::create( garbage ) );
+		loader->waitAll();
+
+		REQUIRE( loader->update() == 1 );
+		REQUIRE( called );
+		REQUIRE_THROWS( missing->getFuture().get() );
+		REQUIRE_THROWS( corrupt->getFuture().get() );
+	}
+
+	SECTION( "Decodes into a SurfacePool" )
+	{
+		SurfacePoolRef pool = SurfacePool::create( 64 );
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 2 ).surfacePool( pool ) );
+		ImageLoader::RequestRef request = loader->load( solidPng( 37, 9 ) );
+		Surface8uRef surface = request->getFuture().get();
+		REQUIRE( surface->getRowBytes() % 64 == 0 );
+		REQUIRE( surface->getPixel( ivec2( 36, 7 ) ).b == 9 );
+		REQUIRE( pool->getBytesInUse() > 0 );
+
+		// once the request and its Surface are released, the memory it was decoded into is handed out by the pool again
+		const uint8_t *data = surface->getData();
+		surface.reset();
+		request.reset();
+		loader.reset();
+		REQUIRE( pool->getBytesInUse() == 0 );
+		REQUIRE( pool->getSurface<uint8_t>( 37, 8, false ).getData() == data );
+	}
+
+	SECTION( "Destroying the loader cancels what it hasn't started" )
+	{
+		ImageLoaderRef loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ) );
+		auto gate = std::make_shared<DataSourceGate>( solidPng( 4, 0 ) );
+		ImageLoader::RequestRef loading = loader->load( gate );
+		ImageLoader::RequestRef waiting = loader->load( solidPng( 4, 1 ) );
+		while( loader->getNumLoading() == 0 )
+			std::this_thread::yield();
+
+		std::thread opener( [gate] { gate->open(); } );
+		loader.reset();
+		opener.join();
+		REQUIRE( loading->getFuture().get()->getWidth() == 4 );
+		REQUIRE( waiting->isCanceled() );
+		REQUIRE_THROWS_AS( waiting->getFuture().get(), ImageLoaderExceptionCanceled );
+	}
+}
@@ -0,0 +1,192 @@
+#include "catch.hpp"
+#include "cinder/ImageSequence.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/ImageTargetFileStbImage.h"
+
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+using namespace ci;
+
+namespace {
+
+const int32_t kWidth = 16, kHeight = 8;
+
+// Writes a solid PNG whose color identifies it
+void writeFrame( const fs::path &path, uint8_t value )
+{
+	Surface8u surface( kWidth, kHeight, false );
+	auto iter = surface.getIter();
+	while( iter.line() )
+		while( iter.pixel() )
+			iter.r() = iter.g() = iter.b() = value;
+
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = surface;
+	writeImage( ImageTargetFileStbImage::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), "png" ), source );
+	std::ofstream( path.string(), std::ios::binary ).write( (const char*)stream->getBuffer(), stream->tell() );
+}
+
+uint8_t frameValue( size_t index )
+{
+	return uint8_t( 10 + index * 10 );
+}
+
+// Writes frame1.png through frame<numFrames>.png, unpadded so that only natural ordering sorts them, and a file which isn't an image
+fs::path writeSequence( size_t numFrames )
+{
+	const fs::path directory = fs::temp_directory_path() / "ImageSequenceTest";
+	fs::remove_all( directory );
+	fs::create_directories( directory );
+	for( size_t i = 0; i < numFrames; ++i )
+		writeFrame( directory / ( "frame" + std::to_string( i + 1 ) + ".png" ), frameValue( i ) );
+	std::ofstream( ( directory / "notes.txt" ).string() ) << "not a frame";
+	return directory;
+}
+
+// Waits up to a few seconds for \a predicate to hold
+template<typename PredicateT>
+bool eventually( PredicateT predicate )
+{
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds( 5 );
+	while( ! predicate() ) {
+		if( std::chrono::steady_clock::now() > deadline )
+			return false;
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	return true;
+}
+
+bool isFrame( const Surface8uRef &surface, size_t index )
+{
+	return surface->getSize() == ivec2( kWidth, kHeight ) && surface->getPixel( ivec2( kWidth - 1, kHeight - 1 ) ).r == frameValue( index );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSequence" )
+{
+	ImageSourceFileStbImage::registerSelf();
+	ImageTargetFileStbImage::registerSelf();
+	const size_t numFrames = 12;
+	const fs::path directory = writeSequence( numFrames );
+	const size_t frameBytes = Surface8u( kWidth, kHeight, false ).getRowBytes() * kHeight;
+
+	SECTION( "Orders a directory's images naturally and plays them back" )
+	{
+		ImageSequence8uRef sequence = ImageSequence8u::create( directory, ImageSequence8u::Options().readAhead( 3 ).numThreads( 2 ) );
+		REQUIRE( sequence->getNumFrames() == numFrames );
+		REQUIRE( sequence->getFilePath( 1 ).filename() == "frame2.png" );
+		REQUIRE( sequence->getFilePath( 9 ).filename() == "frame10.png" );
+
+		bool allFrames = true;
+		for( size_t i = 0; i < numFrames; ++i )
+			allFrames = allFrames && isFrame( sequence->getFrame( i ), i );
+		REQUIRE( allFrames );
+		REQUIRE( sequence->getNumHits() + sequence->getNumLate() == numFrames );
+		REQUIRE( sequence->getNumDecoded() == numFrames );
+		REQUIRE( sequence->getPlayhead() == numFrames - 1 );
+
+		REQUIRE_THROWS_AS( sequence->getFrame( numFrames ), std::out_of_range );
+		REQUIRE_THROWS_AS( ImageSequence8u::create( directory / "missing" ), ImageIoException );
+	}
+
+	SECTION( "Decodes ahead of the playhead, wrapping around when looping" )
+	{
+		ImageSequence8uRef sequence = ImageSequence8u::create( directory, ImageSequence8u::Options().readAhead( 3 ).numThreads( 1 ).loop() );
+		REQUIRE( isFrame( sequence->getFrame( 10 ), 10 ) );
+		REQUIRE( eventually( [&] { return sequence->getNumCached() == 4; } ) );
+
+		// frames 11, 0 and 1 were read ahead
+		Surface8uRef frame;
+		for( size_t i : { 11, 0, 1 } ) {
+			REQUIRE( sequence->tryGetFrame( i, &frame ) );
+			REQUIRE( isFrame( frame, i ) );
+		}
+		REQUIRE( sequence->getNumDropped() == 0 );
+		REQUIRE( sequence->getNumHits() + sequence->getNumLate() == 4 );
+
+		// a frame which isn't cached is dropped rather than waited for, but is then decoded first
+		size_t attempts = 1;
+		while( ! sequence->tryGetFrame( 6, &frame ) ) {
+			std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+			++attempts;
+		}
+		REQUIRE( isFrame( frame, 6 ) );
+		REQUIRE( sequence->getNumDropped() == attempts - 1 );
+		REQUIRE( sequence->getNumHits() + sequence->getNumLate() == 5 );
+
+		sequence->resetCounters();
+		REQUIRE( sequence->getNumHits() == 0 );
+		REQUIRE( sequence->getNumDropped() == 0 );
+	}
+
+	SECTION( "Bounds the cache in bytes, evicting played frames first" )
+	{
+		ImageSequence8uRef sequence = ImageSequence8u::create( directory, ImageSequence8u::Options().readAhead( 2 ).numThreads( 1 ).maxCacheBytes( 4 * frameBytes ) );
+		for( size_t i = 0; i < numFrames; ++i )
+			sequence->getFrame( i );
+		REQUIRE( sequence->getCachedBytes() <= 4 * frameBytes );
+		REQUIRE( sequence->getNumCached() == sequence->getCachedBytes() / frameBytes );
+		REQUIRE( sequence->getNumEvicted() >= numFrames - 4 );
+
+		// the most recently played frames survived
+		Surface8uRef frame;
+		REQUIRE( sequence->tryGetFrame( numFrames - 1, &frame ) );
+		REQUIRE( sequence->tryGetFrame( numFrames - 2, &frame ) );
+		REQUIRE( isFrame( frame, numFrames - 2 ) );
+		REQUIRE_FALSE( sequence->tryGetFrame( 0, &frame ) );
+	}
+
+	SECTION( "Seeks, abandoning the old read-ahead" )
+	{
+		ImageSequence8uRef sequence = ImageSequence8u::create( directory, ImageSequence8u::Options().readAhead( 4 ).numThreads( 1 ) );
+		sequence->seek( 0 );
+		sequence->seek( 7 );
+		REQUIRE( sequence->getPlayhead() == 7 );
+		REQUIRE( isFrame( sequence->getFrame( 7 ), 7 ) );
+		REQUIRE( eventually( [&] { return sequence->getNumCached() >= 5; } ) );
+
+		// at most the frame which was being decoded when the playhead moved is left over from the first window
+		REQUIRE( sequence->getNumDecoded() <= 6 );
+		Surface8uRef frame;
+		for( size_t i = 7; i < numFrames; ++i )
+			REQUIRE( sequence->tryGetFrame( i, &frame ) );
+	}
+
+	SECTION( "Caches the Surfaces of a SurfacePool, and recycles their memory" )
+	{
+		// the playhead's frame is the only one kept
+		SurfacePoolRef pool = SurfacePool::create();
+		ImageSequence8uRef sequence = ImageSequence8u::create( directory, ImageSequence8u::Options().readAhead( 0 ).numThreads( 1 ).maxCacheBytes( 1 ).surfacePool( pool ) );
+		Surface8uRef frame = sequence->getFrame( 0 );
+		REQUIRE( isFrame( frame, 0 ) );
+		// the cache holds the pooled memory itself, which every request for the frame shares
+		REQUIRE( pool->getBytesInUse() == sequence->getCachedBytes() );
+		const uint8_t *data = frame->getData();
+		REQUIRE( sequence->getFrame( 0 )->getData() == data );
+
+		// frame 0 is evicted once frame 1 is decoded, and its memory then decodes frame 2
+		frame.reset();
+		REQUIRE( isFrame( sequence->getFrame( 1 ), 1 ) );
+		frame = sequence->getFrame( 2 );
+		REQUIRE( isFrame( frame, 2 ) );
+		REQUIRE( frame->getData() == data );
+		REQUIRE( pool->getNumHits() == 1 );
+	}
+
+	SECTION( "Rethrows load failures, and retries them" )
+	{
+		std::ofstream( ( directory / "frame13.png" ).string() ) << "not a png";
+		ImageSequence32fRef sequence = ImageSequence32f::create( directory, ImageSequence32f::Options().numThreads( 1 ) );
+		REQUIRE( sequence->getNumFrames() == numFrames + 1 );
+		REQUIRE_THROWS_AS( sequence->getFrame( numFrames ), ImageIoException );
+		REQUIRE_THROWS_AS( sequence->getFrame( numFrames ), ImageIoException );
+
+		// the other frames convert to float
+		REQUIRE( sequence->getFrame( 2 )->getPixel( ivec2( 0, 0 ) ).g == Approx( frameValue( 2 ) / 255.0f ) );
+	}
+
+	fs::remove_all( directory );
+}
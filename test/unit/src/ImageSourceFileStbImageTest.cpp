@@ -0,0 +1,123 @@
+#include "catch.hpp"
+#include "ip/utils.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/ImageTargetFileStbImage.h"
+#include "cinder/SurfacePool.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// Encodes \a surface in the format of \a extension and returns a DataSource over the encoded bytes
+template<typename T>
+DataSourceRef encode( const SurfaceT<T> &surface, const std::string &extension )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = surface;
+	writeImage( ImageTargetFileStbImage::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), extension ), source );
+
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+ImageSourceRef decoder( const DataSourceRef &dataSource )
+{
+	return ImageSourceFileStbImage::create( dataSource, ImageSource::Options() );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSourceFileStbImage" )
+{
+	SECTION( "Decodes PNGs into new, caller-provided and pooled Surfaces" )
+	{
+		SurfacePoolRef pool = SurfacePool::create( 64 );
+		// 37 pixels leaves the pooled rows padded, 64 RGB pixels are exactly 3 alignments wide
+		for( int32_t width : { 37, 64 } ) {
+			for( bool alpha : { false, true } ) {
+				const Surface8u original = makeNoiseSurface<uint8_t>( width, 23, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+				DataSourceRef encoded = encode( original, "png" );
+
+				// the same layout as the image, which is decoded in place
+				REQUIRE( samePixels( Surface8u( decoder( encoded ) ), original ) );
+				Surface8u pooled = pool->getSurface<uint8_t>( decoder( encoded ) );
+				REQUIRE( pooled.getRowBytes() % 64 == 0 );
+				REQUIRE( samePixels( pooled, original ) );
+				Surface8u provided( width, 23, alpha, original.getChannelOrder() );
+				provided.load( decoder( encoded ) );
+				REQUIRE( samePixels( provided, original ) );
+
+				// a different channel order is converted row by row
+				Surface8u swizzled( width, 23, alpha, alpha ? SurfaceChannelOrder::BGRA : SurfaceChannelOrder::BGR );
+				swizzled.load( decoder( encoded ) );
+				REQUIRE( samePixels( swizzled, original ) );
+			}
+		}
+	}
+
+	SECTION( "Reuses its decoded image after a conversion" )
+	{
+		const Surface8u original = makeNoiseSurface<uint8_t>( 19, 7, SurfaceChannelOrder::RGBA );
+		ImageSourceRef source = decoder( encode( original, "png" ) );
+		Surface8u swizzled( 19, 7, true, SurfaceChannelOrder::ARGB );
+		swizzled.load( source );
+		Surface8u direct( 19, 7, true, SurfaceChannelOrder::RGBA );
+		direct.load( source );
+		REQUIRE( samePixels( swizzled, original ) );
+		REQUIRE( samePixels( direct, original ) );
+	}
+
+	SECTION( "Decodes HDR into Surface32f and gray into Channels" )
+	{
+		Surface32f hdr( 21, 9, false, SurfaceChannelOrder::RGB );
+		for( int32_t y = 0; y < hdr.getHeight(); ++y )
+			for( int32_t x = 0; x < hdr.getWidth(); ++x )
+				hdr.setPixel( ivec2( x, y ), Colorf( x * 0.5f, y * 2.0f, 1.0f ) ); // exactly representable in RGBE
+		REQUIRE( samePixels( Surface32f( decoder( encode( hdr, "hdr" ) ) ), hdr ) );
+
+		const Surface8u original = makeNoiseSurface<uint8_t>( 29, 13, SurfaceChannelOrder::RGB );
+		const Channel8u gray = Channel8u( original.getChannelGreen() ).clone();
+		const Channel8u decoded( decoder( encode( Surface8u( gray ), "png" ) ) );
+		bool equal = true;
+		for( int32_t y = 0; y < gray.getHeight(); ++y )
+			for( int32_t x = 0; x < gray.getWidth(); ++x )
+				equal = equal && decoded.getValue( ivec2( x, y ) ) == gray.getValue( ivec2( x, y ) );
+		REQUIRE( equal );
+	}
+
+	SECTION( "Decoding into a view leaves the rest of its Surface untouched" )
+	{
+		const Surface8u parentOriginal = makeNoiseSurface<uint8_t>( 40, 30, SurfaceChannelOrder::RGBA );
+		const Surface8u image = makeNoiseSurface<uint8_t>( 17, 11, SurfaceChannelOrder::RGBA );
+		const Area viewArea( 5, 4, 22, 15 );
+		Surface8u parent = parentOriginal.clone();
+		Surface8u view = parent.getView( viewArea );
+		view.load( decoder( encode( image, "png" ) ) );
+		REQUIRE( samePixels( view, image ) );
+
+		bool untouched = true;
+		for( int32_t y = 0; y < parent.getHeight(); ++y )
+			for( int32_t x = 0; x < parent.getWidth(); ++x )
+				if( ! viewArea.contains( ivec2( x, y ) ) )
+					untouched = untouched && parent.getPixel( ivec2( x, y ) ) == parentOriginal.getPixel( ivec2( x, y ) );
+		REQUIRE( untouched );
+
+		// a full width view has packed rows and is decoded in place, but must not be written past its last row
+		const Surface8u bandImage = makeNoiseSurface<uint8_t>( 40, 10, SurfaceChannelOrder::RGB );
+		Surface8u parentRgb = makeNoiseSurface<uint8_t>( 40, 12, SurfaceChannelOrder::RGB );
+		const Surface8u parentRgbOriginal = parentRgb.clone();
+		Surface8u band = parentRgb.getView( Area( 0, 0, 40, 10 ) );
+		band.load( decoder( encode( bandImage, "png" ) ) );
+		REQUIRE( samePixels( band, bandImage ) );
+		REQUIRE( samePixels( parentRgb.getView( Area( 0, 10, 40, 12 ) ).clone(), parentRgbOriginal.getView( Area( 0, 10, 40, 12 ) ).clone() ) );
+	}
+
+	SECTION( "Throws when the Surface size differs" )
+	{
+		Surface8u surface( 10, 10, true );
+		REQUIRE_THROWS_AS( surface.load( decoder( encode( makeNoiseSurface<uint8_t>( 11, 10, SurfaceChannelOrder::RGBA ), "png" ) ) ), ImageIoException );
+	}
+}
@@ -0,0 +1,79 @@
+#include "catch.hpp"
+#include "ip/utils.h"
+#include "cinder/ImageTargetBands.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/ImageTargetFileStbImage.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+DataSourceRef encodePng( const Surface8u &surface )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = surface;
+	writeImage( ImageTargetFileStbImage::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), "png" ), source );
+
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+// Loads \a source in bands of \a bandHeight, checking their sizes and order, and copies them into a Surface
+Surface8u assembleBands( const ImageSourceRef &source, int32_t bandHeight, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED )
+{
+	const bool alpha = ( channelOrder.getCode() == SurfaceChannelOrder::UNSPECIFIED ) ? source->hasAlpha() : channelOrder.hasAlpha();
+	Surface8u result( source->getWidth(), source->getHeight(), alpha, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+	int32_t nextY = 0;
+	ImageTargetBands8u::load( source, bandHeight, [&]( const Surface8u &band, int32_t y ) {
+		REQUIRE( y == nextY );
+		REQUIRE( band.getWidth() == source->getWidth() );
+		REQUIRE( band.getHeight() == std::min( bandHeight, source->getHeight() - y ) );
+		if( channelOrder.getCode() != SurfaceChannelOrder::UNSPECIFIED )
+			REQUIRE( band.getChannelOrder() == channelOrder );
+		result.copyFrom( band, band.getBounds(), ivec2( 0, y ) );
+		nextY += band.getHeight();
+	}, channelOrder );
+	REQUIRE( nextY == source->getHeight() );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageTargetBands" )
+{
+	SECTION( "Bands reassemble into the image" )
+	{
+		for( bool alpha : { false, true } ) {
+			const Surface8u original = makeNoiseSurface<uint8_t>( 31, 45, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+			for( int32_t bandHeight : { 1, 7, 15, 45, 100 } ) {
+				REQUIRE( samePixels( assembleBands( (ImageSourceRef)original, bandHeight ), original ) );
+				REQUIRE( samePixels( assembleBands( ImageSourceFileStbImage::create( encodePng( original ), ImageSource::Options() ), bandHeight ), original ) );
+			}
+		}
+	}
+
+	SECTION( "Bands in another channel order, with alpha added" )
+	{
+		const Surface8u original = makeNoiseSurface<uint8_t>( 20, 9, SurfaceChannelOrder::RGB );
+		const Surface8u bands = assembleBands( (ImageSourceRef)original, 4, SurfaceChannelOrder::BGRA );
+		bool opaque = true;
+		for( int32_t y = 0; y < bands.getHeight(); ++y )
+			for( int32_t x = 0; x < bands.getWidth(); ++x )
+				opaque = opaque && bands.getPixel( ivec2( x, y ) ).a == 255;
+		REQUIRE( opaque );
+		Surface8u withoutAlpha( 20, 9, false );
+		withoutAlpha.copyFrom( bands, bands.getBounds() );
+		REQUIRE( samePixels( withoutAlpha, original ) );
+	}
+
+	SECTION( "Rejects rows out of order" )
+	{
+		auto target = ImageTargetBands8u::create( 4, false, 2, []( const Surface8u &, int32_t ) {} );
+		target->getRowPointer( 0 );
+		target->getRowPointer( 3 );
+		REQUIRE_THROWS_AS( target->getRowPointer( 1 ), ImageIoException );
+	}
+}
@@ -0,0 +1,145 @@
+#include "catch.hpp"
+#include "ip/utils.h"
+#include "cinder/ImageTargetFilePng.h"
+#include "cinder/ImageSourcePng.h"
+#include "cinder/ImageWriter.h"
+#include "cinder/ip/ThreadPool.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// Encodes \a source with \a options and returns the PNG's bytes
+BufferRef encode( const ImageSourceRef &source, const ImageTargetFilePng::Options &options )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	writeImage( ImageTargetFilePng::create( DataTargetStream::createRef( stream ), source, options ), source );
+
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return buffer;
+}
+
+// libpng checks every chunk's CRC and the zlib stream's Adler-32 while decoding
+ImageSourceRef decode( const BufferRef &png )
+{
+	return ImageSourcePng::createRef( DataSourceBuffer::create( png ) );
+}
+
+bool sameBytes( const BufferRef &a, const BufferRef &b )
+{
+	return a->getSize() == b->getSize() && memcmp( a->getData(), b->getData(), a->getSize() ) == 0;
+}
+
+// A DataTarget whose stream can't be opened, as when a file's directory is missing
+class UnwritableDataTarget : public DataTarget {
+  public:
+	UnwritableDataTarget() : DataTarget( "", Url() ) {}
+
+	bool		providesFilePath() override	{ return false; }
+	bool		providesUrl() override		{ return false; }
+	OStreamRef	getStream() override		{ return OStreamRef(); }
+};
+
+const ImageTargetFilePng::Filter kFilters[] = { ImageTargetFilePng::FILTER_NONE, ImageTargetFilePng::FILTER_SUB, ImageTargetFilePng::FILTER_UP,
+												ImageTargetFilePng::FILTER_AVERAGE, ImageTargetFilePng::FILTER_PAETH, ImageTargetFilePng::FILTER_ADAPTIVE };
+
+} // anonymous namespace
+
+TEST_CASE( "ImageTargetFilePng" )
+{
+	SECTION( "Round trips 8-bit RGB and RGBA with every filter, with and without a ThreadPool" )
+	{
+		// 300 RGBA rows of 1601 bytes span four 128k bands
+		const ip::ThreadPoolRef threadPool = ip::ThreadPool::create( 3 );
+		for( auto order : { SurfaceChannelOrder::RGB, SurfaceChannelOrder::RGBA } ) {
+			const Surface8u original = makeGradientSurface<uint8_t>( 400, 300, order );
+			for( auto filter : kFilters ) {
+				ip::setThreadPool( nullptr );
+				const BufferRef serial = encode( original, ImageTargetFilePng::Options().filter( filter ) );
+				REQUIRE( samePixels( Surface8u( decode( serial ) ), original ) );
+				// the bands are split the same way regardless of the threads deflating them
+				ip::setThreadPool( threadPool );
+				const BufferRef parallel = encode( original, ImageTargetFilePng::Options().filter( filter ) );
+				ip::setThreadPool( nullptr );
+				REQUIRE( sameBytes( parallel, serial ) );
+			}
+		}
+	}
+
+	SECTION( "Round trips gray, gray with alpha and 16-bit images" )
+	{
+		const Surface8u rgba = makeGradientSurface<uint8_t>( 53, 41, SurfaceChannelOrder::RGBA );
+		const Channel8u gray = Channel8u( rgba.getChannelRed() ).clone();
+		for( auto filter : kFilters ) {
+			const Channel8u decoded( decode( encode( gray, ImageTargetFilePng::Options().filter( filter ) ) ) );
+			bool equal = decoded.getSize() == gray.getSize();
+			for( int32_t y = 0; y < gray.getHeight(); ++y )
+				for( int32_t x = 0; x < gray.getWidth(); ++x )
+					equal = equal && decoded.getValue( ivec2( x, y ) ) == gray.getValue( ivec2( x, y ) );
+			REQUIRE( equal );
+
+			const ImageSourceRef grayAlpha = decode( encode( rgba, ImageTargetFilePng::Options( ImageTarget::Options().colorModel( ImageIo::CM_GRAY ) ).filter( filter ) ) );
+			REQUIRE( grayAlpha->getColorModel() == ImageIo::CM_GRAY );
+			REQUIRE( grayAlpha->hasAlpha() );
+
+			const Surface16u deep = makeGradientSurface<uint16_t>( 37, 29, SurfaceChannelOrder::RGBA );
+			// ImageSourcePng reads the rows as it loads them, so the encoded bytes must outlive it
+			const BufferRef deepPng = encode( deep, ImageTargetFilePng::Options().filter( filter ) );
+			const ImageSourceRef deepSource = decode( deepPng );
+			REQUIRE( deepSource->getDataType() == ImageIo::UINT16 );
+			REQUIRE( samePixels( Surface16u( deepSource ), deep ) );
+		}
+	}
+
+	SECTION( "Trades size for speed with the compression level" )
+	{
+		const Surface8u original = makeGradientSurface<uint8_t>( 200, 150, SurfaceChannelOrder::RGB );
+		const BufferRef stored = encode( original, ImageTargetFilePng::Options().level( 0 ) );
+		const BufferRef fastest = encode( original, ImageTargetFilePng::Options().level( 1 ) );
+		const BufferRef smallest = encode( original, ImageTargetFilePng::Options().level( 9 ).strategy( ImageTargetFilePng::STRATEGY_FILTERED ) );
+		REQUIRE( stored->getSize() > original.getHeight() * original.getRowBytes() );
+		REQUIRE( smallest->getSize() <= fastest->getSize() );
+		REQUIRE( fastest->getSize() < stored->getSize() );
+		for( const BufferRef &png : { stored, fastest, smallest } )
+			REQUIRE( samePixels( Surface8u( decode( png ) ), original ) );
+
+		REQUIRE_THROWS_AS( encode( original, ImageTargetFilePng::Options().level( 10 ) ), ImageIoExceptionFailedWrite );
+	}
+
+	SECTION( "ImageWriter encodes in the background once the image is loaded" )
+	{
+		ImageTargetFilePng::registerSelf();
+		ImageWriterRef writer = ImageWriter::create( ImageWriter::Options().maxPending( 2 ) );
+		Surface8u frame = makeGradientSurface<uint8_t>( 64, 48, SurfaceChannelOrder::RGB );
+		const Surface8u first = frame.clone();
+
+		std::vector<OStreamMemRef> streams;
+		std::vector<std::shared_future<void>> futures;
+		for( int i = 0; i < 6; ++i ) {
+			streams.push_back( OStreamMem::create() );
+			futures.push_back( writer->write( DataTargetStream::createRef( streams.back() ), frame, ImageTarget::Options(), "png" ) );
+			// the frame may be reused as soon as write() returns
+			frame.setPixel( ivec2( 0, 0 ), Color8u( i, i, i ) );
+		}
+		writer->waitAll();
+		REQUIRE( writer->getNumPending() == 0 );
+		REQUIRE( writer->getNumWriting() == 0 );
+
+		for( size_t i = 0; i < streams.size(); ++i ) {
+			futures[i].get();
+			BufferRef png = Buffer::create( (size_t)streams[i]->tell() );
+			memcpy( png->getData(), streams[i]->getBuffer(), png->getSize() );
+			const Surface8u decoded( decode( png ) );
+			const uint8_t marker = uint8_t( i - 1 );
+			REQUIRE( decoded.getPixel( ivec2( 0, 0 ) ) == ( i == 0 ? first.getPixel( ivec2( 0, 0 ) ) : ColorA8u( marker, marker, marker, 255 ) ) );
+			REQUIRE( decoded.getPixel( ivec2( 5, 7 ) ) == first.getPixel( ivec2( 5, 7 ) ) );
+		}
+
+		// the encoder's exceptions are delivered through the future
+		std::shared_future<void> failed = writer->write( std::make_shared<UnwritableDataTarget>(), frame, ImageTarget::Options(), "png" );
+		REQUIRE_THROWS_AS( failed.get(), ImageIoExceptionFailedWrite );
+	}
+}
@@ -0,0 +1,114 @@
+#include "catch.hpp"
+#include "cinder/Stream.h"
+#include "cinder/Rand.h"
+
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+// Splits \a text at "\n", "\r\n" and "\r" the way readLine() is documented to
+std::vector<std::string> referenceLines( const std::string &text )
+{
+	std::vector<std::string> result;
+	std::string line;
+	for( size_t i = 0; i < text.size(); ++i ) {
+		if( text[i] == '\n' || text[i] == '\r' ) {
+			result.push_back( line );
+			line.clear();
+			if( text[i] == '\r' && i + 1 < text.size() && text[i + 1] == '\n' )
+				++i;
+		}
+		else
+			line += text[i];
+	}
+	if( ! line.empty() )
+		result.push_back( line );
+	return result;
+}
+
+std::vector<std::string> readLines( const IStreamRef &stream )
+{
+	std::vector<std::string> result;
+	const char *line;
+	size_t length;
+	while( stream->readLine( &line, &length ) )
+		result.push_back( std::string( line, length ) );
+	return result;
+}
+
+// Lines of varied lengths, some longer than the streams' buffers, with every kind of terminator
+std::string randomText( uint32_t seed )
+{
+	Rand rnd( seed );
+	const char *terminators[] = { "\n", "\r\n", "\r" };
+	std::string result;
+	for( int line = 0; line < 300; ++line ) {
+		const uint32_t length = ( rnd.nextUint( 10 ) == 0 ) ? rnd.nextUint( 5000 ) : rnd.nextUint( 40 );
+		for( uint32_t c = 0; c < length; ++c )
+			result += (char)( 'a' + rnd.nextUint( 26 ) );
+		result += terminators[rnd.nextUint( 3 )];
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Stream" )
+{
+	const fs::path path = fs::temp_directory_path() / "cinder_StreamTest.txt";
+	auto writeText = [&path]( const std::string &text ) {
+		std::ofstream file( path.string().c_str(), std::ios::binary );
+		file.write( text.data(), text.size() );
+	};
+
+	SECTION( "readLine matches the reference for file, memory and generic streams" )
+	{
+		for( uint32_t seed = 1; seed <= 4; ++seed ) {
+			std::string text = randomText( seed );
+			if( seed == 2 )
+				text += "unterminated";
+			const std::vector<std::string> expected = referenceLines( text );
+			writeText( text );
+
+			REQUIRE( readLines( IStreamMem::create( text.data(), text.size() ) ) == expected );
+			REQUIRE( readLines( loadFileStream( path ) ) == expected );
+			// small buffers split lines and "\r\n" pairs across refills
+			for( int32_t bufferSize : { 1, 2, 7, 64 } )
+				REQUIRE( readLines( IStreamFile::create( fopen( path.string().c_str(), "rb" ), true, bufferSize ) ) == expected );
+			// IoStreamFile falls back to IStreamCinder's chunked implementation
+			REQUIRE( readLines( IoStreamFile::create( fopen( path.string().c_str(), "rb" ) ) ) == expected );
+		}
+	}
+
+	SECTION( "readLine overloads agree" )
+	{
+		const std::string text = "first\r\n\r\nthird\rfourth\n";
+		IStreamRef stream = IStreamMem::create( text.data(), text.size() );
+		REQUIRE( stream->readLine() == "first" );
+		std::string line = "overwritten";
+		REQUIRE( stream->readLine( &line ) );
+		REQUIRE( line.empty() );
+		REQUIRE( stream->readLine() == "third" );
+		REQUIRE( stream->readLine( &line ) );
+		REQUIRE( line == "fourth" );
+		REQUIRE( ! stream->readLine( &line ) );
+		REQUIRE( stream->readLine() == "" );
+	}
+
+	SECTION( "reads resume after the line" )
+	{
+		const std::string text = "header\r\nBODY";
+		writeText( text );
+		for( IStreamRef stream : { (IStreamRef)IStreamMem::create( text.data(), text.size() ), (IStreamRef)loadFileStream( path ), (IStreamRef)IoStreamFile::create( fopen( path.string().c_str(), "rb" ) ) } ) {
+			REQUIRE( stream->readLine() == "header" );
+			REQUIRE( stream->tell() == 8 );
+			char body[4];
+			stream->readData( body, 4 );
+			REQUIRE( std::string( body, 4 ) == "BODY" );
+		}
+	}
+
+	fs::remove( path );
+}
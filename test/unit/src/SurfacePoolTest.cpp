@@ -0,0 +1,95 @@
+#include "catch.hpp"
+#include "cinder/SurfacePool.h"
+
+using namespace ci;
+
+TEST_CASE( "SurfacePool" )
+{
+	SECTION( "Recycles released Surfaces" )
+	{
+		SurfacePoolRef pool = SurfacePool::create( 64 );
+		const uint8_t *firstData;
+		{
+			Surface8u surface = pool->getSurface<uint8_t>( 33, 10, true, SurfaceChannelOrder::BGRA );
+			REQUIRE( surface.getChannelOrder() == SurfaceChannelOrder::BGRA );
+			REQUIRE( surface.getRowBytes() == 192 );
+			REQUIRE( reinterpret_cast<uintptr_t>( surface.getData() ) % 64 == 0 );
+			firstData = surface.getData();
+			REQUIRE( pool->getBytesInUse() == 1920 );
+			REQUIRE( pool->getBytesHeld() == 0 );
+		}
+		REQUIRE( pool->getBytesInUse() == 0 );
+		REQUIRE( pool->getBytesHeld() == 1920 );
+		REQUIRE( pool->getNumMisses() == 1 );
+
+		Surface8u surface = pool->getSurface<uint8_t>( 33, 10, true, SurfaceChannelOrder::BGRA );
+		REQUIRE( surface.getData() == firstData );
+		REQUIRE( pool->getNumHits() == 1 );
+		REQUIRE( pool->getBytesHeld() == 0 );
+
+		// a different shape or channel order misses
+		Surface8u rgba = pool->getSurface<uint8_t>( 33, 10, true, SurfaceChannelOrder::RGBA );
+		Surface8u rgb = pool->getSurface<uint8_t>( 33, 10, false );
+		Surface32f floats = pool->getSurface<float>( 33, 10, true, SurfaceChannelOrder::BGRA );
+		REQUIRE( pool->getNumMisses() == 4 );
+		REQUIRE( pool->getNumHits() == 1 );
+	}
+
+	SECTION( "Views and Channels alias the pooled memory, and views keep it out of the pool" )
+	{
+		SurfacePoolRef pool = SurfacePool::create();
+		const uint8_t *data;
+		Surface8u view;
+		{
+			Surface8u surface = pool->getSurface<uint8_t>( 16, 16, false );
+			data = surface.getData();
+			REQUIRE( surface.getChannelRed().getData() == data + surface.getRedOffset() );
+			REQUIRE( surface.getChannelBlue().getData( ivec2( 3, 5 ) ) == surface.getDataBlue( ivec2( 3, 5 ) ) );
+			view = surface.getView( Area( 2, 2, 4, 4 ) );
+			REQUIRE( view.getData() == surface.getData( ivec2( 2, 2 ) ) );
+		}
+		REQUIRE( pool->getBytesHeld() == 0 );
+		view = Surface8u();
+		REQUIRE( pool->getBytesHeld() == 64 * 16 );
+		REQUIRE( pool->getSurface<uint8_t>( 16, 16, false ).getData() == data );
+	}
+
+	SECTION( "Channels" )
+	{
+		SurfacePoolRef pool = SurfacePool::create( 16 );
+		const float *firstData = pool->getChannel<float>( 7, 5 ).getData();
+		Channel32f channel = pool->getChannel<float>( 7, 5 );
+		REQUIRE( channel.getData() == firstData );
+		REQUIRE( channel.getRowBytes() == 32 );
+		REQUIRE( channel.isPlanar() );
+		REQUIRE( pool->getNumHits() == 1 );
+	}
+
+	SECTION( "Limits and clearing" )
+	{
+		SurfacePoolRef pool = SurfacePool::create( 4 );
+		pool->setMaxBytesHeld( 100 );
+		{
+			Channel8u a = pool->getChannel<uint8_t>( 8, 8 );
+			Channel8u b = pool->getChannel<uint8_t>( 8, 8 );
+		}
+		// only one of the two 64-byte blocks fits
+		REQUIRE( pool->getBytesHeld() == 64 );
+		pool->clear();
+		REQUIRE( pool->getBytesHeld() == 0 );
+		pool->getChannel<uint8_t>( 8, 8 );
+		REQUIRE( pool->getNumHits() == 0 );
+		REQUIRE( pool->getNumMisses() == 3 );
+		pool->resetCounters();
+		REQUIRE( pool->getNumMisses() == 0 );
+	}
+
+	SECTION( "Surfaces outlive their pool" )
+	{
+		SurfacePoolRef pool = SurfacePool::create();
+		Surface16u surface = pool->getSurface<uint16_t>( 4, 4, true );
+		pool.reset();
+		surface.setPixel( ivec2( 3, 3 ), ColorAT<uint16_t>( 1, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 3, 3 ) ).b == 3 );
+	}
+}
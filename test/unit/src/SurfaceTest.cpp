@@ -0,0 +1,140 @@
+#include "catch.hpp"
+#include "cinder/Surface.h"
+
+using namespace ci;
+
+namespace {
+
+// Counts the blocks it hands out and how many of them are still referenced
+class CountingAllocator : public SurfaceAllocator {
+  public:
+	CountingAllocator() : mNumAllocations( 0 ), mNumLive( 0 ) {}
+
+	std::shared_ptr<void> allocate( size_t numBytes ) override
+	{
+		++mNumAllocations;
+		++mNumLive;
+		std::shared_ptr<void> block = mHeap.allocate( numBytes );
+		int *numLive = &mNumLive;
+		return std::shared_ptr<void>( block.get(), [numLive, block]( void * ) { --*numLive; } );
+	}
+	size_t getAlignment() const override { return mHeap.getAlignment(); }
+
+	int						mNumAllocations, mNumLive;
+	SurfaceAllocatorHeap	mHeap;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "Surface/View" )
+{
+	SECTION( "Surface views share pixels" )
+	{
+		Surface8u surface( 64, 48, true, SurfaceChannelOrder::BGRA );
+		for( int32_t y = 0; y < surface.getHeight(); ++y )
+			for( int32_t x = 0; x < surface.getWidth(); ++x )
+				surface.setPixel( ivec2( x, y ), ColorA8u( x, y, x + y, 255 ) );
+
+		Surface8u view = surface.getView( Area( 10, 20, 30, 25 ) );
+		REQUIRE( view.getSize() == ivec2( 20, 5 ) );
+		REQUIRE( view.getRowBytes() == surface.getRowBytes() );
+		REQUIRE( view.getChannelOrder() == surface.getChannelOrder() );
+		REQUIRE( view.getData() == surface.getData( ivec2( 10, 20 ) ) );
+		REQUIRE( view.getPixel( ivec2( 3, 2 ) ) == ColorA8u( 13, 22, 35, 255 ) );
+		REQUIRE( view.getChannelGreen().getValue( ivec2( 3, 2 ) ) == 22 );
+
+		view.setPixel( ivec2( 0, 0 ), ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 10, 20 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+
+		// views of views, clipped to the parent's bounds
+		Surface8u subView = view.getView( Area( 15, 3, 100, 100 ) );
+		REQUIRE( subView.getSize() == ivec2( 5, 2 ) );
+		REQUIRE( subView.getData() == surface.getData( ivec2( 25, 23 ) ) );
+
+		// copies of a view are independent duplicates
+		Surface8u copy = view;
+		REQUIRE( copy.getData() != view.getData() );
+		REQUIRE( copy.getPixel( ivec2( 3, 2 ) ) == view.getPixel( ivec2( 3, 2 ) ) );
+	}
+
+	SECTION( "Views keep the data store alive" )
+	{
+		auto allocator = std::make_shared<CountingAllocator>();
+		Surface32f view;
+		{
+			Surface32f surface( 16, 16, false, SurfaceConstraintsAligned( 16, allocator ) );
+			REQUIRE( allocator->mNumAllocations == 1 );
+			surface.setPixel( ivec2( 5, 6 ), Color( 0.25f, 0.5f, 0.75f ) );
+			view = surface.getView( Area( 4, 4, 8, 8 ) );
+		}
+		REQUIRE( allocator->mNumLive == 1 );
+		REQUIRE( view.getPixel( ivec2( 1, 2 ) ) == ColorA( 0.25f, 0.5f, 0.75f, 1.0f ) );
+
+		Channel32f channelView = view.getChannelRed().getView( Area( 1, 2, 3, 3 ) );
+		view = Surface32f();
+		REQUIRE( allocator->mNumLive == 1 );
+		REQUIRE( channelView.getValue( ivec2( 0, 0 ) ) == 0.25f );
+		channelView = Channel32f();
+		REQUIRE( allocator->mNumLive == 0 );
+		REQUIRE( allocator->mNumAllocations == 1 );
+	}
+
+	SECTION( "Externally owned data store" )
+	{
+		auto allocator = std::make_shared<CountingAllocator>();
+		std::shared_ptr<uint8_t> dataStore = allocator->allocateData<uint8_t>( 8 * 3 * 4 );
+		{
+			Surface8u surface( dataStore.get(), 8, 4, 8 * 3, SurfaceChannelOrder::RGB, dataStore );
+			dataStore.reset();
+			REQUIRE( allocator->mNumLive == 1 );
+			Surface8u moved( std::move( surface ) );
+			REQUIRE( moved.getDataStore() );
+			REQUIRE( surface.getData() == nullptr );
+		}
+		REQUIRE( allocator->mNumLive == 0 );
+	}
+
+	SECTION( "Channel views share pixels" )
+	{
+		Channel16u channel( 32, 32 );
+		for( int32_t y = 0; y < 32; ++y )
+			for( int32_t x = 0; x < 32; ++x )
+				channel.setValue( ivec2( x, y ), (uint16_t)( y * 32 + x ) );
+
+		Channel16u view = channel.getView( Area( -5, 30, 4, 40 ) );
+		REQUIRE( view.getSize() == ivec2( 4, 2 ) );
+		REQUIRE( view.getValue( ivec2( 3, 1 ) ) == 31 * 32 + 3 );
+		view.setValue( ivec2( 0, 0 ), 7 );
+		REQUIRE( channel.getValue( ivec2( 0, 30 ) ) == 7 );
+	}
+}
+
+TEST_CASE( "Surface/Allocator" )
+{
+	SECTION( "Aligned rows" )
+	{
+		Surface8u surface( 33, 7, false, SurfaceConstraintsAligned( 64 ) );
+		REQUIRE( surface.getRowBytes() == 128 );
+		for( int32_t y = 0; y < surface.getHeight(); ++y )
+			REQUIRE( reinterpret_cast<uintptr_t>( surface.getData( ivec2( 0, y ) ) ) % 64 == 0 );
+
+		Channel32f channel( 5, 3, SurfaceAllocatorAligned::create( 32 ) );
+		REQUIRE( channel.getRowBytes() == 32 );
+		REQUIRE( reinterpret_cast<uintptr_t>( channel.getData() ) % 32 == 0 );
+	}
+
+	SECTION( "Default allocator" )
+	{
+		auto allocator = std::make_shared<CountingAllocator>();
+		SurfaceAllocator::setDefault( allocator );
+		{
+			Surface8u surface( 10, 10, true );
+			Surface8u copy = surface.clone();
+			Channel8u channel( 10, 10 );
+			REQUIRE( allocator->mNumAllocations == 3 );
+		}
+		SurfaceAllocator::setDefault( nullptr );
+		REQUIRE( allocator->mNumLive == 0 );
+		REQUIRE( std::dynamic_pointer_cast<SurfaceAllocatorHeap>( SurfaceAllocator::getDefault() ) );
+	}
+}
@@ -0,0 +1,102 @@
+#include "catch.hpp"
+
+#include "cinder/Cinder.h"
+#include "cinder/audio/CommandQueue.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace ci::audio;
+
+TEST_CASE( "audio/CommandQueue" )
+{
+
+SECTION( "runs commands in order" )
+{
+	CommandQueue queue( 8 );
+	std::vector<int> result;
+
+	for( int i = 0; i < 5; i++ )
+		REQUIRE( queue.push( [&result, i] { result.push_back( i ); } ) );
+
+	REQUIRE( queue.getNumPending() == 5 );
+	REQUIRE( queue.process() == 5 );
+	REQUIRE( queue.getNumPending() == 0 );
+	REQUIRE( queue.process() == 0 );
+
+	REQUIRE( result == std::vector<int>( { 0, 1, 2, 3, 4 } ) );
+}
+
+SECTION( "full" )
+{
+	CommandQueue queue( 4 );
+	int count = 0;
+
+	for( int i = 0; i < 4; i++ )
+		REQUIRE( queue.push( [&count] { count++; } ) );
+
+	REQUIRE_FALSE( queue.push( [&count] { count++; } ) );
+
+	queue.process();
+	REQUIRE( count == 4 );
+
+	// processed commands make room again
+	for( int i = 0; i < 4; i++ )
+		REQUIRE( queue.push( [&count] { count++; } ) );
+
+	queue.process();
+	REQUIRE( count == 8 );
+}
+
+SECTION( "captures are released by the pushing thread" )
+{
+	CommandQueue queue( 4 );
+	auto captured = std::make_shared<int>( 0 );
+
+	REQUIRE( queue.push( [captured] { (*captured)++; } ) );
+	REQUIRE( captured.use_count() == 2 );
+
+	queue.process();
+	REQUIRE( *captured == 1 );
+	REQUIRE( captured.use_count() == 2 ); // still owned by the processed command
+
+	queue.releaseProcessed();
+	REQUIRE( captured.use_count() == 1 );
+}
+
+SECTION( "multiple producers" )
+{
+	const int numProducers = 4;
+	const int numCommandsPerProducer = 5000;
+
+	CommandQueue queue( 64 );
+	std::atomic<bool> producing( true );
+	long long sum = 0;
+
+	std::thread consumer( [&] {
+		while( producing || queue.getNumPending() )
+			queue.process();
+	} );
+
+	std::vector<std::thread> producers;
+	for( int p = 0; p < numProducers; p++ ) {
+		producers.emplace_back( [&queue, &sum, numCommandsPerProducer] {
+			for( int i = 1; i <= numCommandsPerProducer; i++ ) {
+				while( ! queue.push( [&sum, i] { sum += i; } ) )
+					std::this_thread::yield();
+			}
+		} );
+	}
+
+	for( auto &producer : producers )
+		producer.join();
+
+	producing = false;
+	consumer.join();
+
+	REQUIRE( sum == (long long)numProducers * numCommandsPerProducer * ( numCommandsPerProducer + 1 ) / 2 );
+}
+
+} // "audio/CommandQueue"
@@ -0,0 +1,314 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/audio/dsp/Converter.h"
+#include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace ci::audio;
+
+namespace {
+
+// Lengths around the 4, 8 and 16 element SIMD blocks, so that each kernel is run with and without a scalar remainder
+const size_t sLengths[] = { 0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 33, 64, 67, 512, 1031 };
+
+// Random samples starting one float past the start of their storage, so that the kernels see unaligned arrays
+struct Samples {
+	Samples( size_t length, float range = 1.0f )
+		: mStorage( length + 1 )
+	{
+		for( size_t i = 0; i < length; i++ )
+			mStorage[i + 1] = ci::randFloat( -range, range );
+	}
+
+	float*	data()	{ return mStorage.data() + 1; }
+
+	std::vector<float>	mStorage;
+};
+
+bool equal( const float *a, const float *b, size_t length )
+{
+	return length == 0 || std::memcmp( a, b, length * sizeof( float ) ) == 0;
+}
+
+int32_t int24At( const char *bytes )
+{
+	return ( (int32_t)(int8_t)bytes[2] << 16 ) | ( (int32_t)(uint8_t)bytes[1] << 8 ) | (int32_t)(uint8_t)bytes[0];
+}
+
+// Runs fn until about 50ms have passed and returns its average time in nanoseconds
+template<typename FnT>
+double timeNanoseconds( const FnT &fn )
+{
+	ci::Timer timer( true );
+	size_t iterations = 0;
+	while( timer.getSeconds() < 0.05 ) {
+		for( int i = 0; i < 100; i++ )
+			fn();
+		iterations += 100;
+	}
+	return timer.getSeconds() * 1e9 / (double)iterations;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Dsp" )
+{
+
+SECTION( "element-wise math matches scalar" )
+{
+	for( size_t length : sLengths ) {
+		Samples a( length ), b( length ), result( length ), expected( length );
+		const float scalar = 0.7f;
+
+		dsp::add( a.data(), b.data(), result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] + b.data()[i];
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::sub( a.data(), b.data(), result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] - b.data()[i];
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::mul( a.data(), b.data(), result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] * b.data()[i];
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::divide( a.data(), b.data(), result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] / b.data()[i];
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::addMul( a.data(), b.data(), scalar, result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = ( a.data()[i] + b.data()[i] ) * scalar;
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::add( a.data(), scalar, result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] + scalar;
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::sub( a.data(), scalar, result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] - scalar;
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::mul( a.data(), scalar, result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] * scalar;
+		REQUIRE( equal( result.data(), expected.data(), length ) );
+
+		dsp::fill( scalar, result.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			REQUIRE( result.data()[i] == scalar );
+
+		// in place, as mixBuffers() and sumBuffers() use it
+		std::vector<float> sum( a.data(), a.data() + length );
+		dsp::add( sum.data(), b.data(), sum.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			expected.data()[i] = a.data()[i] + b.data()[i];
+		REQUIRE( equal( sum.data(), expected.data(), length ) );
+	}
+}
+
+SECTION( "reductions" )
+{
+	for( size_t length : sLengths ) {
+		Samples a( length );
+		double expectedSum = 0, expectedSumSquared = 0;
+		float expectedMax = 0;
+		for( size_t i = 0; i < length; i++ ) {
+			const float x = a.data()[i];
+			expectedSum += x;
+			expectedSumSquared += x * x;
+			expectedMax = std::max( expectedMax, x );
+		}
+
+		// the SIMD versions sum in a different order, so they're only as close as the rounding error of the scalar sum
+		REQUIRE( std::fabs( dsp::sum( a.data(), length ) - expectedSum ) < 1e-5 * ( length + 1 ) );
+		if( length ) {
+			REQUIRE( std::fabs( dsp::rms( a.data(), length ) - std::sqrt( expectedSumSquared / length ) ) < ACCEPTABLE_FLOAT_ERROR * 10 );
+
+			dsp::normalize( a.data(), length, 0.5f );
+			float max = 0;
+			for( size_t i = 0; i < length; i++ )
+				max = std::max( max, a.data()[i] );
+			if( expectedMax > 0.00001f )
+				REQUIRE( std::fabs( max - 0.5f ) < ACCEPTABLE_FLOAT_ERROR );
+		}
+	}
+}
+
+SECTION( "int16 conversion" )
+{
+	for( size_t length : sLengths ) {
+		Samples a( length, 1.5f );
+		if( length > 2 ) {
+			a.data()[0] = 1.0f;
+			a.data()[1] = -1.0f;
+			a.data()[2] = 1e9f;
+		}
+
+		std::vector<int16_t> converted( length + 1 );
+		dsp::convert( a.data(), converted.data() + 1, length );
+		for( size_t i = 0; i < length; i++ ) {
+			const float scaled = std::min( std::max( a.data()[i] * 32768.0f, -32768.0f ), 32767.0f );
+			REQUIRE( converted[i + 1] == (int16_t)scaled );
+		}
+
+		// double samples saturate the same way, through the templated overload
+		std::vector<double> doubles( a.data(), a.data() + length );
+		std::vector<int16_t> convertedDoubles( length );
+		dsp::convert( doubles.data(), convertedDoubles.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			REQUIRE( convertedDoubles[i] == converted[i + 1] );
+
+		Samples roundTrip( length );
+		dsp::convert( converted.data() + 1, roundTrip.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			REQUIRE( roundTrip.data()[i] == (float)converted[i + 1] * 3.0517578125e-05f );
+	}
+}
+
+SECTION( "int24 conversion" )
+{
+	for( size_t length : sLengths ) {
+		Samples a( length, 1.5f );
+		std::vector<char> converted( length * 3 + 1 );
+		dsp::convertFloatToInt24( a.data(), converted.data() + 1, length );
+		for( size_t i = 0; i < length; i++ ) {
+			const float scaled = std::min( std::max( a.data()[i] * 8388607.0f, -8388608.0f ), 8388607.0f );
+			REQUIRE( int24At( &converted[i * 3 + 1] ) == (int32_t)scaled );
+		}
+
+		std::vector<double> doubles( a.data(), a.data() + length );
+		std::vector<char> convertedDoubles( length * 3 );
+		dsp::convertFloatToInt24( doubles.data(), convertedDoubles.data(), length );
+		for( size_t i = 0; i < length; i++ ) {
+			const double scaled = std::min( std::max( doubles[i] * 8388607.0, -8388608.0 ), 8388607.0 );
+			REQUIRE( int24At( &convertedDoubles[i * 3] ) == (int32_t)scaled );
+		}
+
+		Samples roundTrip( length );
+		dsp::convertInt24ToFloat( converted.data() + 1, roundTrip.data(), length );
+		for( size_t i = 0; i < length; i++ )
+			REQUIRE( roundTrip.data()[i] == (float)int24At( &converted[i * 3 + 1] ) * ( 1.0f / 8388607.0f ) );
+	}
+}
+
+SECTION( "interleave and deinterleave" )
+{
+	for( size_t numChannels = 1; numChannels <= 3; numChannels++ ) {
+		for( size_t numFrames : sLengths ) {
+			// the non-interleaved buffer is larger than the copied frames, as it is in the Context implementations
+			const size_t numFramesPerChannel = numFrames + 3;
+			Buffer source( numFramesPerChannel, numChannels );
+			fillRandom( &source );
+
+			BufferInterleaved interleaved( numFrames, numChannels ), expectedInterleaved( numFrames, numChannels );
+			dsp::interleave( source.getData(), interleaved.getData(), numFramesPerChannel, numChannels, numFrames );
+			dsp::interleave<float>( source.getData(), expectedInterleaved.getData(), numFramesPerChannel, numChannels, numFrames );
+			REQUIRE( equal( interleaved.getData(), expectedInterleaved.getData(), interleaved.getSize() ) );
+
+			Buffer deinterleaved( numFramesPerChannel, numChannels );
+			dsp::deinterleave( interleaved.getData(), deinterleaved.getData(), numFramesPerChannel, numChannels, numFrames );
+			for( size_t ch = 0; ch < numChannels; ch++ )
+				REQUIRE( equal( deinterleaved.getChannel( ch ), source.getChannel( ch ), numFrames ) );
+
+			std::vector<int16_t> interleavedInt16( numFrames * numChannels ), expectedInt16( numFrames * numChannels );
+			dsp::interleave( source.getData(), interleavedInt16.data(), numFramesPerChannel, numChannels, numFrames );
+			dsp::interleave<float>( source.getData(), expectedInt16.data(), numFramesPerChannel, numChannels, numFrames );
+			REQUIRE( interleavedInt16 == expectedInt16 );
+
+			// full-scale samples saturate in the double overload, rather than wrapping
+			std::vector<double> fullScale( numFramesPerChannel * numChannels, 1.0 );
+			std::vector<int16_t> fullScaleInt16( numFrames * numChannels );
+			dsp::interleave( fullScale.data(), fullScaleInt16.data(), numFramesPerChannel, numChannels, numFrames );
+			for( int16_t sample : fullScaleInt16 )
+				REQUIRE( sample == 32767 );
+
+			Buffer deinterleavedInt16( numFramesPerChannel, numChannels ), expectedDeinterleavedInt16( numFramesPerChannel, numChannels );
+			dsp::deinterleave( interleavedInt16.data(), deinterleavedInt16.getData(), numFramesPerChannel, numChannels, numFrames );
+			dsp::deinterleave<float>( interleavedInt16.data(), expectedDeinterleavedInt16.getData(), numFramesPerChannel, numChannels, numFrames );
+			for( size_t ch = 0; ch < numChannels; ch++ )
+				REQUIRE( equal( deinterleavedInt16.getChannel( ch ), expectedDeinterleavedInt16.getChannel( ch ), numFrames ) );
+
+			std::vector<char> interleavedInt24( numFrames * numChannels * 3 );
+			dsp::convertFloatToInt24( interleaved.getData(), interleavedInt24.data(), interleaved.getSize() );
+			Buffer deinterleavedInt24( numFramesPerChannel, numChannels );
+			dsp::deinterleaveInt24ToFloat( interleavedInt24.data(), deinterleavedInt24.getData(), numFramesPerChannel, numChannels, numFrames );
+			for( size_t ch = 0; ch < numChannels; ch++ ) {
+				for( size_t i = 0; i < numFrames; i++ )
+					REQUIRE( std::fabs( deinterleavedInt24.getChannel( ch )[i] - source.getChannel( ch )[i] ) < 1.0f / 8388607.0f * 2 );
+			}
+		}
+	}
+}
+
+SECTION( "stereo buffers" )
+{
+	Buffer source( 67, 2 ), deinterleaved( 67, 2 );
+	BufferInterleaved interleaved( 67, 2 );
+	fillRandom( &source );
+
+	dsp::interleaveStereoBuffer( &source, &interleaved );
+	dsp::deinterleaveStereoBuffer( &interleaved, &deinterleaved );
+	REQUIRE( interleaved[0] == source.getChannel( 0 )[0] );
+	REQUIRE( interleaved[1] == source.getChannel( 1 )[0] );
+	REQUIRE( equal( deinterleaved.getData(), source.getData(), source.getSize() ) );
+}
+
+SECTION( "mixBuffers and sumBuffers" )
+{
+	Buffer stereo( 67, 2 ), mono( 67, 1 ), sum( 67, 2 );
+	fillRandom( &stereo );
+	fillRandom( &mono );
+
+	dsp::mixBuffers( &mono, &sum );
+	dsp::sumBuffers( &stereo, &sum );
+	for( size_t ch = 0; ch < 2; ch++ ) {
+		for( size_t i = 0; i < 67; i++ )
+			REQUIRE( sum.getChannel( ch )[i] == mono[i] + stereo.getChannel( ch )[i] );
+	}
+}
+
+SECTION( "throughput" )
+{
+	// Timings are logged for comparison against scalar loops that the compiler can't vectorize on its own
+	const size_t length = 512;
+	Samples a( length ), b( length ), result( length );
+	std::vector<int16_t> int16Samples( length * 2 );
+	std::vector<char> int24Samples( length * 3 );
+	Buffer stereo( length, 2 );
+	BufferInterleaved interleaved( length, 2 );
+	fillRandom( &stereo );
+
+	const double addNs = timeNanoseconds( [&] { dsp::add( a.data(), b.data(), result.data(), length ); } );
+	const double addScalarNs = timeNanoseconds( [&] {
+		volatile float *r = result.data();
+		for( size_t i = 0; i < length; i++ )
+			r[i] = a.data()[i] + b.data()[i];
+	} );
+	const double addMulNs = timeNanoseconds( [&] { dsp::addMul( a.data(), b.data(), 0.5f, result.data(), length ); } );
+	const double rmsNs = timeNanoseconds( [&] { volatile float r = dsp::rms( a.data(), length ); (void)r; } );
+	const double toInt16Ns = timeNanoseconds( [&] { dsp::convert( a.data(), int16Samples.data(), length ); } );
+	const double toInt16ScalarNs = timeNanoseconds( [&] { dsp::convert<float>( a.data(), int16Samples.data(), length ); } );
+	const double fromInt24Ns = timeNanoseconds( [&] { dsp::convertInt24ToFloat( int24Samples.data(), result.data(), length ); } );
+	const double fromInt24ScalarNs = timeNanoseconds( [&] { dsp::convertInt24ToFloat<float>( int24Samples.data(), result.data(), length ); } );
+	const double interleaveNs = timeNanoseconds( [&] { dsp::interleave( stereo.getData(), interleaved.getData(), length, 2, length ); } );
+	const double interleaveScalarNs = timeNanoseconds( [&] { dsp::interleave<float>( stereo.getData(), interleaved.getData(), length, 2, length ); } );
+
+	CI_LOG_I( "... " << length << " samples, ns per call (scalar): add " << addNs << " (" << addScalarNs << "), addMul " << addMulNs << ", rms " << rmsNs
+				<< ", float to int16 " << toInt16Ns << " (" << toInt16ScalarNs << "), int24 to float " << fromInt24Ns << " (" << fromInt24ScalarNs << ")"
+				<< ", interleave stereo " << interleaveNs << " (" << interleaveScalarNs << ")" );
+}
+
+} // "audio/Dsp"
@@ -0,0 +1,214 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/GainNode.h"
+#include "cinder/audio/FilterNode.h"
+#include "cinder/audio/DelayNode.h"
+#include "cinder/audio/NodeMath.h"
+
+#include <atomic>
+#include <functional>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const size_t NUM_FRAMES = 48000;
+
+OfflineContextRef makeContext( size_t numRenderThreads )
+{
+	auto ctx = OfflineContext::create( OfflineContext::Format().sampleRate( 48000 ).framesPerBlock( 128 ).channels( 2 ) );
+	ctx->setNumRenderThreads( numRenderThreads );
+	return ctx;
+}
+
+// Each voice is a sine generator followed by a gain ramp and a lowpass filter, all summed by a mixer.
+NodeRef makeVoice( const OfflineContextRef &ctx, size_t index, const NodeRef &mixer )
+{
+	auto gen = ctx->makeNode( new GenSineNode( 110.0f + 37.0f * index ) );
+	auto gain = ctx->makeNode( new GainNode( 0 ) );
+	auto lowpass = ctx->makeNode( new FilterLowPassNode );
+	lowpass->setCutoffFreq( 500.0f + 100.0f * index );
+
+	gen >> gain >> lowpass >> mixer;
+	gen->enable();
+	gain->getParam()->applyRamp( 1, 0.1f + 0.01f * index );
+	return lowpass;
+}
+
+GainNodeRef makeMixer( const OfflineContextRef &ctx, size_t numVoices )
+{
+	auto mixer = ctx->makeNode( new GainNode( 1.0f / numVoices ) );
+	mixer >> ctx->getOutput();
+	return mixer;
+}
+
+NodeRef makeVoicesGraph( const OfflineContextRef &ctx )
+{
+	const size_t numVoices = 32;
+	auto mixer = makeMixer( ctx, numVoices );
+	for( size_t i = 0; i < numVoices; i++ )
+		makeVoice( ctx, i, mixer );
+	return mixer;
+}
+
+// Mixes independent voices with branches that share nodes, a shared Param processor and a feedback loop, which must all be pulled serially.
+NodeRef makeSharedGraph( const OfflineContextRef &ctx )
+{
+	auto mixer = makeMixer( ctx, 16 );
+	for( size_t i = 0; i < 8; i++ )
+		makeVoice( ctx, i, mixer );
+
+	auto shared = ctx->makeNode( new GenTriangleNode( 220 ) );
+	auto sharedGainA = ctx->makeNode( new GainNode( 0.5f ) );
+	auto sharedGainB = ctx->makeNode( new GainNode( 0.25f ) );
+	shared >> sharedGainA >> mixer;
+	shared >> sharedGainB >> mixer;
+	shared->enable();
+
+	// a stateless processor, as a stateful one would advance once for each Param that pulls it, in an order that depends on the graph
+	auto processor = ctx->makeNode( new AddNode( 0.5f ) );
+	for( size_t i = 0; i < 2; i++ ) {
+		auto gen = ctx->makeNode( new GenSineNode( 330.0f + 110.0f * i ) );
+		auto gain = ctx->makeNode( new GainNode );
+		gain->getParam()->setProcessor( processor );
+		gen >> gain >> mixer;
+		gen->enable();
+	}
+
+	auto feedbackGen = ctx->makeNode( new GenSineNode( 440 ) );
+	auto delay = ctx->makeNode( new DelayNode );
+	auto feedbackGain = ctx->makeNode( new GainNode( 0.5f ) );
+	delay->setDelaySeconds( 0.01f );
+	feedbackGen >> delay >> mixer;
+	delay >> feedbackGain >> delay;
+	feedbackGen->enable();
+	return mixer;
+}
+
+// Renders the graph built by makeGraph, which returns its mixer, and checks that expectedParallelInputs of the mixer's inputs were rendered in parallel
+Buffer render( const std::function<NodeRef ( const OfflineContextRef & )> &makeGraph, size_t numRenderThreads, size_t expectedParallelInputs )
+{
+	auto ctx = makeContext( numRenderThreads );
+	NodeRef mixer = makeGraph( ctx );
+
+	Buffer result( NUM_FRAMES, 2 );
+	ctx->render( &result );
+
+	std::lock_guard<std::mutex> lock( ctx->getMutex() );
+	GraphScheduler *scheduler = ctx->getGraphScheduler();
+	REQUIRE( scheduler->getNumParallelInputs( mixer.get() ) == expectedParallelInputs );
+	REQUIRE( scheduler->getNumParallelRenders() == ( expectedParallelInputs ? NUM_FRAMES / ctx->getFramesPerBlock() : 0 ) );
+	return result;
+}
+
+// Records whether Context::isAudioThread() held every time it was processed
+class AudioThreadCheckNode : public Node {
+  public:
+	AudioThreadCheckNode()
+		: Node( Format() ), mAlwaysAudioThread( true )
+	{}
+
+	bool	wasAlwaysAudioThread() const	{ return mAlwaysAudioThread; }
+
+  protected:
+	void process( Buffer * /*buffer*/ ) override
+	{
+		if( ! getContext()->isAudioThread() )
+			mAlwaysAudioThread = false;
+	}
+
+  private:
+	std::atomic<bool>	mAlwaysAudioThread;
+};
+
+} // anonymous namespace
+
+// Node::getInputs() is ordered by address, so the summing order, and with it float rounding, differs between two separately built graphs.
+
+TEST_CASE( "audio/GraphScheduler" )
+{
+
+SECTION( "render threads" )
+{
+	auto ctx = makeContext( 3 );
+	REQUIRE( ctx->getNumRenderThreads() == 3 );
+
+	ctx->setNumRenderThreads( 0 );
+	REQUIRE( ctx->getNumRenderThreads() == 0 );
+}
+
+SECTION( "parallel render matches serial" )
+{
+	Buffer serial = render( makeVoicesGraph, 0, 0 );
+	Buffer parallel = render( makeVoicesGraph, 3, 32 );
+
+	REQUIRE( maxError( serial, parallel ) < ACCEPTABLE_FLOAT_ERROR );
+}
+
+SECTION( "shared nodes and feedback" )
+{
+	// only the 8 independent voices of the mixer's 13 inputs are rendered in parallel
+	Buffer serial = render( makeSharedGraph, 0, 0 );
+	Buffer parallel = render( makeSharedGraph, 3, 8 );
+
+	REQUIRE( maxError( serial, parallel ) < ACCEPTABLE_FLOAT_ERROR );
+}
+
+SECTION( "render threads count as the audio thread" )
+{
+	auto ctx = makeContext( 3 );
+	auto mixer = makeMixer( ctx, 16 );
+	std::vector<std::shared_ptr<AudioThreadCheckNode> > checks;
+	for( size_t i = 0; i < 16; i++ ) {
+		checks.push_back( ctx->makeNode( new AudioThreadCheckNode ) );
+		makeVoice( ctx, i, checks.back() );
+		checks.back() >> mixer;
+	}
+
+	Buffer result( NUM_FRAMES, 2 );
+	ctx->render( &result );
+
+	REQUIRE( ctx->getGraphScheduler()->getNumParallelRenders() > 0 );
+	for( const auto &check : checks )
+		REQUIRE( check->wasAlwaysAudioThread() );
+}
+
+SECTION( "connections change while rendering" )
+{
+	auto renderWithChanges = []( size_t numRenderThreads ) {
+		auto ctx = makeContext( numRenderThreads );
+		auto mixer = makeMixer( ctx, 16 );
+		std::vector<NodeRef> voices;
+		for( size_t i = 0; i < 16; i++ )
+			voices.push_back( makeVoice( ctx, i, mixer ) );
+
+		Buffer result( NUM_FRAMES, 2 ), block( NUM_FRAMES / 4, 2 );
+		const size_t blocksPerRender = ( block.getNumFrames() + ctx->getFramesPerBlock() - 1 ) / ctx->getFramesPerBlock();
+		for( size_t i = 0; i < 4; i++ ) {
+			// the schedule is rebuilt after each change, so every block stays parallel
+			const uint64_t parallelRenders = ctx->getGraphScheduler()->getNumParallelRenders();
+			ctx->render( &block );
+			REQUIRE( ctx->getGraphScheduler()->getNumParallelRenders() - parallelRenders == ( numRenderThreads ? blocksPerRender : 0 ) );
+			for( size_t ch = 0; ch < 2; ch++ )
+				std::copy( block.getChannel( ch ), block.getChannel( ch ) + block.getNumFrames(), result.getChannel( ch ) + i * block.getNumFrames() );
+
+			// move one voice to the output and drop another
+			voices[i]->disconnectAllOutputs();
+			voices[i] >> ctx->getOutput();
+			voices[i + 4]->disconnectAll();
+		}
+
+		return result;
+	};
+
+	Buffer serial = renderWithChanges( 0 );
+	Buffer parallel = renderWithChanges( 2 );
+
+	REQUIRE( maxError( serial, parallel ) < ACCEPTABLE_FLOAT_ERROR );
+}
+
+} // "audio/GraphScheduler"
@@ -0,0 +1,111 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/GainNode.h"
+#include "cinder/audio/Exception.h"
+
+#include <cmath>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// mirrors the phase accumulation of GenSineNode
+Buffer makeSineReference( float freq, size_t sampleRate, size_t numFrames )
+{
+	Buffer result( numFrames );
+	const float phaseIncr = freq / (float)sampleRate;
+	float phase = 0;
+	for( size_t i = 0; i < numFrames; i++ ) {
+		result[i] = std::sin( phase * float( 2 * M_PI ) );
+		phase = phase + phaseIncr;
+		phase -= std::floor( phase );
+	}
+
+	return result;
+}
+
+OfflineContextRef makeSineGraph( float freq, float gain, size_t framesPerBlock )
+{
+	auto ctx = OfflineContext::create( OfflineContext::Format().sampleRate( 48000 ).framesPerBlock( framesPerBlock ).channels( 1 ) );
+	auto gen = ctx->makeNode( new GenSineNode( freq ) );
+	auto gainNode = ctx->makeNode( new GainNode( gain ) );
+
+	gen >> gainNode >> ctx->getOutput();
+	gen->enable();
+	return ctx;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/OfflineContext" )
+{
+
+SECTION( "format" )
+{
+	auto ctx = OfflineContext::create( OfflineContext::Format().sampleRate( 96000 ).framesPerBlock( 64 ).channels( 3 ) );
+
+	REQUIRE( ctx->getSampleRate() == 96000 );
+	REQUIRE( ctx->getFramesPerBlock() == 64 );
+	REQUIRE( ctx->getOutput()->getNumChannels() == 3 );
+	REQUIRE( ctx->getNumProcessedFrames() == 0 );
+}
+
+SECTION( "render sine" )
+{
+	const size_t numFrames = 48000;
+	auto ctx = makeSineGraph( 480, 1, 256 );
+
+	Buffer rendered( numFrames );
+	ctx->render( &rendered );
+
+	// the last, partial block is rendered in full
+	REQUIRE( ctx->getNumProcessedFrames() == 188 * 256 );
+	REQUIRE( ctx->getRenderSpeed() > 0 );
+
+	Buffer expected = makeSineReference( 480, 48000, numFrames );
+	REQUIRE( maxError( rendered, expected ) < 0.0001f );
+}
+
+SECTION( "renders are repeatable" )
+{
+	Buffer a( 10000 ), b( 10000 );
+	makeSineGraph( 220, 0.5f, 128 )->render( &a );
+	makeSineGraph( 220, 0.5f, 128 )->render( &b );
+
+	REQUIRE( maxError( a, b ) == 0 );
+}
+
+SECTION( "scheduled events are sample accurate" )
+{
+	auto ctx = OfflineContext::create( OfflineContext::Format().sampleRate( 48000 ).framesPerBlock( 256 ).channels( 1 ) );
+	auto gen = ctx->makeNode( new GenSineNode( 480 ) );
+	gen >> ctx->getOutput();
+
+	gen->enable( 0.25 ); // frame 12000, in the middle of a block
+
+	Buffer rendered( 24000 );
+	ctx->render( &rendered );
+
+	for( size_t i = 0; i < 12000; i++ )
+		REQUIRE( rendered[i] == 0 );
+
+	REQUIRE( rendered[12001] != 0 );
+}
+
+SECTION( "unsupported" )
+{
+	auto ctx = OfflineContext::create();
+
+	// explicit devices, as the defaults would query the hardware
+	REQUIRE_THROWS_AS( ctx->createOutputDeviceNode( nullptr ), AudioContextExc );
+	REQUIRE_THROWS_AS( ctx->createInputDeviceNode( nullptr ), AudioContextExc );
+
+	Buffer mono( 512, 1 );
+	REQUIRE_THROWS_AS( ctx->render( &mono ), AudioFormatExc );
+}
+
+} // "audio/OfflineContext"
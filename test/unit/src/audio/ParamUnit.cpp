@@ -0,0 +1,122 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/NodeMath.h"
+
+#include <atomic>
+#include <thread>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const size_t SAMPLE_RATE = 48000;
+
+// An AddNode without inputs outputs the value of its Param.
+AddNodeRef makeParamGraph( const OfflineContextRef &ctx )
+{
+	auto add = ctx->makeNode( new AddNode( 0.0f ) );
+	add >> ctx->getOutput();
+	return add;
+}
+
+OfflineContextRef makeContext()
+{
+	return OfflineContext::create( OfflineContext::Format().sampleRate( SAMPLE_RATE ).framesPerBlock( 256 ).channels( 1 ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Param" )
+{
+
+SECTION( "applyRamp" )
+{
+	auto ctx = makeContext();
+	auto add = makeParamGraph( ctx );
+
+	add->getParam()->applyRamp( 0, 1, 1000.0 / SAMPLE_RATE, Param::Options().beginTime( 0 ) );
+	REQUIRE( add->getParam()->getNumEvents() == 1 );
+
+	Buffer rendered( 2048 );
+	ctx->render( &rendered );
+
+	REQUIRE( rendered[0] == Approx( 0.0f ) );
+	REQUIRE( rendered[500] == Approx( 0.5f ).epsilon( 0.001 ) );
+	REQUIRE( rendered[1500] == 1.0f );
+	REQUIRE( add->getParam()->getValue() == 1.0f );
+	REQUIRE( add->getParam()->getNumEvents() == 0 );
+}
+
+SECTION( "appendRamp" )
+{
+	auto ctx = makeContext();
+	auto add = makeParamGraph( ctx );
+	auto param = add->getParam();
+
+	param->applyRamp( 0, 1, 0.01 );
+	param->appendRamp( 0.5f, 0.01 );
+
+	REQUIRE( param->getNumEvents() == 2 );
+	REQUIRE( param->findDuration() == Approx( 0.02f ) );
+	REQUIRE( param->findEndTimeAndValue().second == 0.5f );
+
+	Buffer rendered( 2048 );
+	ctx->render( &rendered );
+
+	REQUIRE( rendered[2047] == 0.5f );
+	REQUIRE( param->getNumEvents() == 0 );
+}
+
+SECTION( "setValue cancels Events" )
+{
+	auto ctx = makeContext();
+	auto add = makeParamGraph( ctx );
+	auto param = add->getParam();
+
+	auto event = param->applyRamp( 0, 1, 1.0 );
+	param->setValue( 0.25f );
+
+	REQUIRE( param->getValue() == 0.25f );
+	REQUIRE( param->getNumEvents() == 0 );
+
+	Buffer rendered( 512 );
+	ctx->render( &rendered );
+
+	REQUIRE( rendered[0] == 0.25f );
+	REQUIRE( rendered[511] == 0.25f );
+	REQUIRE_FALSE( event->isComplete() );
+}
+
+SECTION( "ramps applied while rendering on another thread" )
+{
+	auto ctx = makeContext();
+	auto add = makeParamGraph( ctx );
+	auto param = add->getParam();
+
+	std::atomic<bool> rendering( true );
+	std::thread renderThread( [&] {
+		while( rendering )
+			ctx->renderBlock();
+	} );
+
+	for( int i = 0; i < 1000; i++ )
+		param->applyRamp( i / 1000.0f, 0.0001 );
+
+	param->applyRamp( 0.75f, 0.001 );
+
+	// let the last ramp complete
+	while( param->getNumEvents() )
+		std::this_thread::yield();
+
+	rendering = false;
+	renderThread.join();
+
+	Buffer rendered( 256 );
+	ctx->render( &rendered );
+	REQUIRE( rendered[255] == 0.75f );
+}
+
+} // "audio/Param"
@@ -0,0 +1,249 @@
+#include "catch.hpp"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/Rand.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ci;
+
+namespace {
+
+// odd widths exercise the scalar tails after the SIMD kernels
+const int32_t kWidth = 37, kHeight = 5;
+
+template<typename T>
+void randomize( SurfaceT<T> *surface, Rand &rnd )
+{
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = (T)rnd.nextUint( 256 );
+			iter.g() = (T)rnd.nextUint( 256 );
+			iter.b() = (T)rnd.nextUint( 256 );
+			if( surface->hasAlpha() )
+				iter.a() = ( rnd.nextUint( 8 ) == 0 ) ? 0 : (T)rnd.nextUint( 256 ); // include plenty of zero alphas
+		}
+	}
+}
+
+template<>
+void randomize<float>( SurfaceT<float> *surface, Rand &rnd )
+{
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = rnd.nextFloat();
+			iter.g() = rnd.nextFloat();
+			iter.b() = rnd.nextFloat();
+			if( surface->hasAlpha() )
+				iter.a() = ( rnd.nextUint( 8 ) == 0 ) ? 0 : rnd.nextFloat();
+		}
+	}
+}
+
+float toUnit( uint8_t v ) { return v / 255.0f; }
+float toUnit( float v ) { return v; }
+
+// Reference separable blend of unpremultiplied colors, following the W3C compositing spec
+ColorAf referenceBlend( ip::BlendMode mode, ColorAf s, ColorAf d )
+{
+	auto blendChannel = [mode]( float cs, float cd ) {
+		switch( mode ) {
+			case ip::BLEND_MULTIPLY: return cs * cd;
+			case ip::BLEND_SCREEN: return cs + cd - cs * cd;
+			default: return cs;
+		}
+	};
+	const float cs[3] = { s.r, s.g, s.b }, cd[3] = { d.r, d.g, d.b };
+	float co[3];
+	float ao;
+	if( mode == ip::BLEND_ADD ) {
+		ao = std::min( s.a + d.a, 1.0f );
+		for( int c = 0; c < 3; ++c )
+			co[c] = std::min( s.a * cs[c] + d.a * cd[c], 1.0f );
+	}
+	else {
+		ao = s.a + d.a - s.a * d.a;
+		for( int c = 0; c < 3; ++c )
+			co[c] = s.a * ( 1 - d.a ) * cs[c] + d.a * ( 1 - s.a ) * cd[c] + s.a * d.a * blendChannel( cs[c], cd[c] );
+	}
+	if( ao > 0 )
+		return ColorAf( co[0] / ao, co[1] / ao, co[2] / ao, ao );
+	else
+		return ColorAf( 0, 0, 0, 0 );
+}
+
+template<typename T>
+ColorAf unpremultipliedPixel( const SurfaceT<T> &surface, int32_t x, int32_t y )
+{
+	const ColorAT<T> p = surface.getPixel( ivec2( x, y ) );
+	ColorAf result( toUnit( p.r ), toUnit( p.g ), toUnit( p.b ), surface.hasAlpha() ? toUnit( p.a ) : 1.0f );
+	if( surface.isPremultiplied() && result.a > 0 )
+		result = ColorAf( result.r / result.a, result.g / result.a, result.b / result.a, result.a );
+	return result;
+}
+
+// Blends random foregrounds over random backgrounds and compares against referenceBlend(). Colors of transparent
+// results are ignored, as are the quantization errors of premultiplied 8-bit colors at low alpha.
+template<typename T>
+bool testBlend( ip::BlendMode mode, const SurfaceChannelOrder &srcOrder, const SurfaceChannelOrder &dstOrder, bool srcPremult, bool dstPremult, float tolerance )
+{
+	Rand rnd( 77 );
+	SurfaceT<T> fg( kWidth, kHeight, srcOrder.hasAlpha(), srcOrder );
+	SurfaceT<T> bg( kWidth + 3, kHeight + 2, dstOrder.hasAlpha(), dstOrder );
+	randomize( &fg, rnd );
+	randomize( &bg, rnd );
+	if( srcPremult )
+		ip::premultiply( &fg );
+	if( dstPremult )
+		ip::premultiply( &bg );
+	const ivec2 offset( 2, 1 );
+	SurfaceT<T> before = bg.clone();
+	before.setPremultiplied( dstPremult );
+
+	ip::blend( &bg, fg, mode, fg.getBounds(), offset );
+
+	bool equal = true;
+	for( int32_t y = 0; y < bg.getHeight(); ++y ) {
+		for( int32_t x = 0; x < bg.getWidth(); ++x ) {
+			const ColorAf actual = unpremultipliedPixel( bg, x, y );
+			const Area srcBounds = fg.getBounds() + offset;
+			if( ! srcBounds.contains( ivec2( x, y ) ) ) {
+				equal = equal && ( bg.getPixel( ivec2( x, y ) ) == before.getPixel( ivec2( x, y ) ) );
+				continue;
+			}
+			const ColorAf s = unpremultipliedPixel( fg, x - offset.x, y - offset.y );
+			const ColorAf d = unpremultipliedPixel( before, x, y );
+			const ColorAf expected = referenceBlend( mode, s, d );
+			// premultiplied 8-bit inputs and outputs lose color precision proportional to 1 / alpha
+			const float minAlpha = std::max( 1 / 255.0f, std::min( { s.a, d.a, expected.a } ) );
+			const float colorTolerance = ( std::is_integral<T>::value && ( srcPremult || dstPremult ) ) ? tolerance / minAlpha : tolerance;
+			if( expected.a > 0 ) {
+				equal = equal && std::abs( actual.r - expected.r ) <= colorTolerance;
+				equal = equal && std::abs( actual.g - expected.g ) <= colorTolerance;
+				equal = equal && std::abs( actual.b - expected.b ) <= colorTolerance;
+			}
+			if( bg.hasAlpha() )
+				equal = equal && std::abs( actual.a - expected.a ) <= tolerance;
+		}
+	}
+	return equal;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Premultiply" )
+{
+	SECTION( "premultiply and unpremultiply 8u match the integer formulas" )
+	{
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR } ) {
+			Rand rnd( 5 );
+			Surface8u surface( kWidth, kHeight, true, order );
+			randomize( &surface, rnd );
+			// every combination of color and alpha, plus colors greater than alpha for unpremultiply's saturation
+			Surface8u all( 256, 256, true, order );
+			for( int32_t y = 0; y < 256; ++y )
+				for( int32_t x = 0; x < 256; ++x )
+					all.setPixel( ivec2( x, y ), ColorA8u( x, 255 - x, x / 2, y ) );
+
+			for( Surface8u *s : { &surface, &all } ) {
+				const Surface8u original = s->clone();
+				ip::premultiply( s );
+				REQUIRE( s->isPremultiplied() );
+				bool equal = true;
+				for( int32_t y = 0; y < s->getHeight(); ++y ) {
+					for( int32_t x = 0; x < s->getWidth(); ++x ) {
+						const ColorA8u o = original.getPixel( ivec2( x, y ) ), p = s->getPixel( ivec2( x, y ) );
+						equal = equal && p.r == o.r * o.a / 255 && p.g == o.g * o.a / 255 && p.b == o.b * o.a / 255 && p.a == o.a;
+					}
+				}
+				REQUIRE( equal );
+
+				*s = original.clone();
+				ip::unpremultiply( s );
+				REQUIRE( ! s->isPremultiplied() );
+				for( int32_t y = 0; y < s->getHeight(); ++y ) {
+					for( int32_t x = 0; x < s->getWidth(); ++x ) {
+						const ColorA8u o = original.getPixel( ivec2( x, y ) ), p = s->getPixel( ivec2( x, y ) );
+						auto expected = [&o]( uint8_t c ) { return o.a ? std::min<int>( c * 255 / o.a, 255 ) : c; };
+						equal = equal && p.r == expected( o.r ) && p.g == expected( o.g ) && p.b == expected( o.b ) && p.a == o.a;
+					}
+				}
+				REQUIRE( equal );
+			}
+		}
+	}
+
+	SECTION( "premultiply and unpremultiply 32f" )
+	{
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::ARGB } ) {
+			Rand rnd( 6 );
+			Surface32f surface( kWidth, kHeight, true, order );
+			randomize( &surface, rnd );
+			const Surface32f original = surface.clone();
+			ip::premultiply( &surface );
+			bool equal = true;
+			for( int32_t y = 0; y < kHeight; ++y ) {
+				for( int32_t x = 0; x < kWidth; ++x ) {
+					const ColorAf o = original.getPixel( ivec2( x, y ) ), p = surface.getPixel( ivec2( x, y ) );
+					equal = equal && p.r == o.r * o.a && p.g == o.g * o.a && p.b == o.b * o.a && p.a == o.a;
+				}
+			}
+			REQUIRE( equal );
+
+			ip::unpremultiply( &surface );
+			for( int32_t y = 0; y < kHeight; ++y ) {
+				for( int32_t x = 0; x < kWidth; ++x ) {
+					const ColorAf o = original.getPixel( ivec2( x, y ) ), p = surface.getPixel( ivec2( x, y ) );
+					if( o.a == 0 )
+						equal = equal && p.r == 0 && p.g == 0 && p.b == 0 && p.a == 0;
+					else
+						equal = equal && std::abs( p.r - o.r ) < 1e-5f && std::abs( p.g - o.g ) < 1e-5f && std::abs( p.b - o.b ) < 1e-5f && p.a == o.a;
+				}
+			}
+			REQUIRE( equal );
+		}
+	}
+}
+
+TEST_CASE( "ip/Blend" )
+{
+	const ip::BlendMode modes[] = { ip::BLEND_NORMAL, ip::BLEND_ADD, ip::BLEND_MULTIPLY, ip::BLEND_SCREEN };
+
+	SECTION( "8u matching layouts" )
+	{
+		for( auto mode : modes )
+			for( int premult = 0; premult < 4; ++premult )
+				for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::ARGB } )
+					REQUIRE( testBlend<uint8_t>( mode, order, order, ( premult & 1 ) != 0, ( premult & 2 ) != 0, 1.5f / 255 ) );
+	}
+
+	SECTION( "8u mixed layouts and backgrounds without alpha" )
+	{
+		for( auto mode : modes ) {
+			for( int premult = 0; premult < 4; ++premult ) {
+				REQUIRE( testBlend<uint8_t>( mode, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::RGBA, ( premult & 1 ) != 0, ( premult & 2 ) != 0, 1.5f / 255 ) );
+				REQUIRE( testBlend<uint8_t>( mode, SurfaceChannelOrder::RGBA, SurfaceChannelOrder::RGBX, ( premult & 1 ) != 0, false, 1.5f / 255 ) );
+				REQUIRE( testBlend<uint8_t>( mode, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::RGB, ( premult & 1 ) != 0, false, 1.5f / 255 ) );
+			}
+		}
+	}
+
+	SECTION( "foreground without alpha" )
+	{
+		for( auto mode : modes )
+			REQUIRE( testBlend<uint8_t>( mode, SurfaceChannelOrder::RGB, SurfaceChannelOrder::RGBA, false, false, 1.5f / 255 ) );
+	}
+
+	SECTION( "32f" )
+	{
+		for( auto mode : modes ) {
+			for( int premult = 0; premult < 4; ++premult ) {
+				REQUIRE( testBlend<float>( mode, SurfaceChannelOrder::RGBA, SurfaceChannelOrder::RGBA, ( premult & 1 ) != 0, ( premult & 2 ) != 0, 1e-4f ) );
+				REQUIRE( testBlend<float>( mode, SurfaceChannelOrder::ABGR, SurfaceChannelOrder::RGBA, ( premult & 1 ) != 0, ( premult & 2 ) != 0, 1e-4f ) );
+			}
+		}
+	}
+}
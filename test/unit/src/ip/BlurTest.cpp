@@ -0,0 +1,161 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/Fill.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ci;
+
+namespace {
+
+// RGBA surfaces may take a SIMD path while Channels are always blurred by the scalar kernel, so blurring
+// each channel separately must produce the exact same result as blurring the whole surface.
+template<typename T>
+void testStackBlurMatchesChannels( const SurfaceT<T> &surface, int radius )
+{
+	SurfaceT<T> blurred = ip::stackBlurCopy( surface, radius );
+
+	const SurfaceChannelOrder &co = surface.getChannelOrder();
+	for( uint8_t offset : { co.getRedOffset(), co.getGreenOffset(), co.getBlueOffset(), co.getAlphaOffset() } ) {
+		ChannelT<T> channel( surface.getWidth(), surface.getHeight(), surface.getRowBytes(), surface.getPixelInc(), const_cast<T*>( surface.getData() ) + offset );
+		ChannelT<T> blurredChannel = ip::stackBlurCopy( channel.clone(), radius );
+
+		bool equal = true;
+		for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+			for( int32_t x = 0; x < surface.getWidth(); ++x )
+				equal = equal && ( blurred.getData( ivec2( x, y ) )[offset] == blurredChannel.getValue( ivec2( x, y ) ) );
+		}
+
+		REQUIRE( equal );
+	}
+}
+
+// Integer surfaces are blurred in float and rounded once, so they must match blurring a Surface32f holding the same values exactly.
+template<typename T>
+void testGaussianBlurMatchesFloat( const SurfaceT<T> &surface )
+{
+	Surface32f surface32f( surface.getWidth(), surface.getHeight(), true, SurfaceChannelOrder::RGBA );
+	for( int32_t y = 0; y < surface.getHeight(); ++y )
+		for( int32_t x = 0; x < surface.getWidth(); ++x )
+			for( int c = 0; c < 4; ++c )
+				surface32f.getData( ivec2( x, y ) )[c] = surface.getData( ivec2( x, y ) )[c];
+
+	for( float sigma : { 1.0f, 4.0f, 30.0f } ) {
+		SurfaceT<T> blurred = ip::gaussianBlurCopy( surface, sigma );
+		Surface32f blurred32f = ip::gaussianBlurCopy( surface32f, sigma );
+		bool equal = true;
+		for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+			for( int32_t x = 0; x < surface.getWidth(); ++x ) {
+				for( int c = 0; c < 4; ++c ) {
+					const float expected = std::min<float>( std::max( blurred32f.getData( ivec2( x, y ) )[c], 0.0f ), CHANTRAIT<T>::max() );
+					equal = equal && blurred.getData( ivec2( x, y ) )[c] == (T)( expected + 0.5f );
+				}
+			}
+		}
+		REQUIRE( equal );
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/StackBlur" )
+{
+	SECTION( "Surface8u RGBA matches Channel8u" )
+	{
+		Surface8u surface = makeNoiseSurface<uint8_t>( 67, 41 );
+		for( int radius : { 1, 3, 12, 40, 255, 300 } )
+			testStackBlurMatchesChannels( surface, radius );
+	}
+
+	SECTION( "Surface32f RGBA matches Channel32f" )
+	{
+		Surface32f surface = makeNoiseSurface<float>( 67, 41 );
+		for( int radius : { 1, 3, 12, 40 } )
+			testStackBlurMatchesChannels( surface, radius );
+	}
+
+	SECTION( "in-place Area blur leaves outside untouched" )
+	{
+		Surface8u surface = makeNoiseSurface<uint8_t>( 32, 32 );
+		Surface8u original = surface.clone();
+		ip::stackBlur( &surface, Area( 8, 8, 24, 24 ), 4 );
+
+		REQUIRE( surface.getPixel( ivec2( 2, 2 ) ) == original.getPixel( ivec2( 2, 2 ) ) );
+		REQUIRE( surface.getPixel( ivec2( 30, 30 ) ) == original.getPixel( ivec2( 30, 30 ) ) );
+		REQUIRE( surface.getPixel( ivec2( 16, 16 ) ) != original.getPixel( ivec2( 16, 16 ) ) );
+	}
+}
+
+TEST_CASE( "ip/GaussianBlur" )
+{
+	SECTION( "Surface32f RGBA matches Channel32f" )
+	{
+		Surface32f surface = makeNoiseSurface<float>( 131, 77 );
+		for( float sigma : { 0.5f, 1.0f, 3.3f, 20.0f, 100.0f } ) {
+			Surface32f blurred = ip::gaussianBlurCopy( surface, sigma );
+			Channel32f channel( surface.getWidth(), surface.getHeight(), surface.getRowBytes(), surface.getPixelInc(), surface.getData() + surface.getGreenOffset() );
+			Channel32f blurredChannel = ip::gaussianBlurCopy( channel.clone(), sigma );
+			float maxError = 0;
+			for( int32_t y = 0; y < surface.getHeight(); ++y )
+				for( int32_t x = 0; x < surface.getWidth(); ++x )
+					maxError = std::max( maxError, std::abs( blurred.getPixel( ivec2( x, y ) ).g - blurredChannel.getValue( ivec2( x, y ) ) ) );
+			REQUIRE( maxError < 1e-5f );
+		}
+	}
+
+	SECTION( "impulse response has the requested variance" )
+	{
+		for( float sigma : { 0.7f, 2.0f, 5.0f, 12.5f } ) {
+			Channel32f channel( 201, 201 );
+			ip::fill( &channel, 0.0f );
+			channel.setValue( ivec2( 100, 100 ), 1.0f );
+			ip::gaussianBlur( &channel, sigma );
+
+			// three box passes have a support of at most 3 * ( sigma + 1 ); beyond it only the running sums' rounding remains
+			const int32_t support = (int32_t)std::ceil( 3 * ( sigma + 1 ) );
+			double total = 0, varianceX = 0, varianceY = 0;
+			for( int32_t y = 100 - support; y <= 100 + support; ++y ) {
+				for( int32_t x = 100 - support; x <= 100 + support; ++x ) {
+					const double v = channel.getValue( ivec2( x, y ) );
+					total += v;
+					varianceX += v * ( x - 100 ) * ( x - 100 );
+					varianceY += v * ( y - 100 ) * ( y - 100 );
+				}
+			}
+			REQUIRE( total == Approx( 1.0 ).epsilon( 1e-4 ) );
+			REQUIRE( varianceX == Approx( sigma * sigma ).epsilon( 1e-3 ) );
+			REQUIRE( varianceY == Approx( sigma * sigma ).epsilon( 1e-3 ) );
+		}
+	}
+
+	SECTION( "Surface8u and Surface16u are the rounded Surface32f result" )
+	{
+		testGaussianBlurMatchesFloat( makeNoiseSurface<uint8_t>( 96, 50 ) );
+		testGaussianBlurMatchesFloat( makeNoiseSurface<uint16_t>( 96, 50 ) );
+	}
+
+	SECTION( "BlurScratch is reused across calls" )
+	{
+		Surface8u surface = makeNoiseSurface<uint8_t>( 64, 48 );
+		Surface8u expected = ip::gaussianBlurCopy( surface, 6.0f );
+
+		ip::BlurScratch scratch;
+		ip::gaussianBlur( &surface, 6.0f, &scratch );
+		const size_t bytesHeld = scratch.getBytesHeld();
+		REQUIRE( bytesHeld > 0 );
+		bool equal = true;
+		for( int32_t y = 0; y < surface.getHeight(); ++y )
+			for( int32_t x = 0; x < surface.getWidth(); ++x )
+				equal = equal && surface.getPixel( ivec2( x, y ) ) == expected.getPixel( ivec2( x, y ) );
+		REQUIRE( equal );
+
+		ip::gaussianBlur( &surface, 6.0f, &scratch );
+		ip::stackBlur( &surface, 5, &scratch );
+		REQUIRE( scratch.getBytesHeld() == bytesHeld );
+
+		scratch.clear();
+		REQUIRE( scratch.getBytesHeld() == 0 );
+	}
+}
@@ -0,0 +1,121 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Rand.h"
+
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+const SurfaceChannelOrder kChannelOrders[] = { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR,
+												SurfaceChannelOrder::RGBX, SurfaceChannelOrder::XBGR, SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR };
+
+// Compares ip::grayscaleRow() against CHANTRAIT<T>::grayscale() for every pair of channel orders, in place and not
+template<typename T>
+void testGrayscaleRow()
+{
+	Rand rnd( 2718 );
+	bool equal = true;
+	for( const SurfaceChannelOrder &srcOrder : kChannelOrders ) {
+		for( const SurfaceChannelOrder &dstOrder : kChannelOrders ) {
+			const uint8_t srcInc = srcOrder.getPixelInc(), dstInc = dstOrder.getPixelInc();
+			const bool inPlace = srcOrder == dstOrder;
+			for( int32_t width : { 0, 1, 5, 15, 16, 17, 31, 53 } ) {
+				std::vector<T> src( width * srcInc );
+				for( auto &v : src )
+					v = randomValue<T>( rnd, -0.5f, 2.0f );
+				// a guard element past the end of the row must not be written
+				std::vector<T> dst( width * dstInc + 1, (T)7 );
+				if( inPlace )
+					std::copy( src.begin(), src.end(), dst.begin() );
+				const std::vector<T> before = dst;
+				ip::grayscaleRow( inPlace ? dst.data() : src.data(), dst.data(), width, srcOrder, dstOrder );
+
+				for( int32_t x = 0; x < width; ++x ) {
+					const T *s = &src[x * srcInc];
+					const T gray = CHANTRAIT<T>::grayscale( s[srcOrder.getRedOffset()], s[srcOrder.getGreenOffset()], s[srcOrder.getBlueOffset()] );
+					for( uint8_t j = 0; j < dstInc; ++j ) {
+						const bool isColor = j == dstOrder.getRedOffset() || j == dstOrder.getGreenOffset() || j == dstOrder.getBlueOffset();
+						equal = equal && ( dst[x * dstInc + j] == ( isColor ? gray : before[x * dstInc + j] ) );
+					}
+				}
+				equal = equal && ( dst[width * dstInc] == (T)7 );
+			}
+		}
+	}
+
+	REQUIRE( equal );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::Grayscale" )
+{
+	SECTION( "grayscaleRow matches the scalar conversion for every channel order" )
+	{
+		testGrayscaleRow<uint8_t>();
+		testGrayscaleRow<uint16_t>();
+		testGrayscaleRow<float>();
+	}
+
+	SECTION( "Surface8u to Channel8u keeps its own weights" )
+	{
+		for( const SurfaceChannelOrder &order : kChannelOrders ) {
+			const Surface8u src = makeNoiseSurface<uint8_t>( 67, 9, order );
+			Channel8u dst( 67, 9 );
+			ip::grayscale( src, &dst );
+
+			bool equal = true;
+			for( int32_t y = 0; y < src.getHeight(); ++y ) {
+				for( int32_t x = 0; x < src.getWidth(); ++x ) {
+					const ColorA8u c = src.getPixel( ivec2( x, y ) );
+					equal = equal && ( dst.getValue( ivec2( x, y ) ) == ( ( c.r * 74 + c.g * 147 + c.b * 35 ) >> 8 ) );
+				}
+			}
+			REQUIRE( equal );
+		}
+	}
+
+	SECTION( "Converts into a Channel of a Surface without touching its other channels" )
+	{
+		const Surface8u src = makeNoiseSurface<uint8_t>( 45, 7, SurfaceChannelOrder::BGR );
+		Surface8u dst = makeNoiseSurface<uint8_t>( 45, 7, SurfaceChannelOrder::RGBA );
+		const Surface8u original = dst.clone();
+		Channel8u &green = dst.getChannelGreen();
+		ip::grayscale( src, &green );
+
+		bool equal = true;
+		for( int32_t y = 0; y < src.getHeight(); ++y ) {
+			for( int32_t x = 0; x < src.getWidth(); ++x ) {
+				const ColorA8u c = src.getPixel( ivec2( x, y ) ), before = original.getPixel( ivec2( x, y ) ), after = dst.getPixel( ivec2( x, y ) );
+				equal = equal && ( after.g == ( ( c.r * 74 + c.g * 147 + c.b * 35 ) >> 8 ) );
+				equal = equal && after.r == before.r && after.b == before.b && after.a == before.a;
+			}
+		}
+		REQUIRE( equal );
+	}
+
+	SECTION( "Surface32f matches the scalar conversion and leaves alpha alone" )
+	{
+		const Surface32f src = makeNoiseSurface<float>( 38, 5, SurfaceChannelOrder::ABGR, 1618, -0.5f, 2.0f );
+		Surface32f dst = makeNoiseSurface<float>( 38, 5, SurfaceChannelOrder::RGBA, 1618, -0.5f, 2.0f );
+		const Surface32f original = dst.clone();
+		ip::grayscale( src, &dst );
+		Channel32f channel( 38, 5 );
+		ip::grayscale( src, &channel );
+
+		bool equal = true;
+		for( int32_t y = 0; y < src.getHeight(); ++y ) {
+			for( int32_t x = 0; x < src.getWidth(); ++x ) {
+				const ColorAf c = src.getPixel( ivec2( x, y ) ), after = dst.getPixel( ivec2( x, y ) );
+				const float gray = CHANTRAIT<float>::grayscale( c.r, c.g, c.b );
+				equal = equal && after.r == gray && after.g == gray && after.b == gray && after.a == original.getPixel( ivec2( x, y ) ).a;
+				equal = equal && channel.getValue( ivec2( x, y ) ) == gray;
+			}
+		}
+		REQUIRE( equal );
+	}
+}
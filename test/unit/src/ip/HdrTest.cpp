@@ -0,0 +1,110 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Hdr.h"
+
+#include <algorithm>
+
+using namespace ci;
+
+namespace {
+
+// Colors over [-3, 40), with alpha outside of that range, so that including it in the extremes would show
+Surface32f makeHdrSurface( int32_t width, int32_t height, SurfaceChannelOrder channelOrder )
+{
+	Surface32f result = makeNoiseSurface<float>( width, height, channelOrder, 577, -3.0f, 40.0f );
+	if( channelOrder.hasAlpha() ) {
+		auto iter = result.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() )
+				iter.a() = ( iter.x() % 2 ) ? -100.0f : 100.0f;
+		}
+	}
+
+	return result;
+}
+
+// The extremes of the red, green and blue of \a surface, found one element at a time
+void referenceMinMax( const Surface32f &surface, float *resultMin, float *resultMax )
+{
+	float minVal = surface.getPixel( ivec2() ).r, maxVal = minVal;
+	for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+		for( int32_t x = 0; x < surface.getWidth(); ++x ) {
+			const ColorAf c = surface.getPixel( ivec2( x, y ) );
+			minVal = std::min( { minVal, c.r, c.g, c.b } );
+			maxVal = std::max( { maxVal, c.r, c.g, c.b } );
+		}
+	}
+	*resultMin = minVal;
+	*resultMax = maxVal;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::Hdr" )
+{
+	SECTION( "hdrNormalize matches the scalar normalization for every channel order" )
+	{
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::ABGR, SurfaceChannelOrder::BGRX, SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR } ) {
+			for( int32_t width : { 1, 3, 5, 17, 53 } ) {
+				const Surface32f original = makeHdrSurface( width, 7, order );
+				float expectedMin, expectedMax;
+				referenceMinMax( original, &expectedMin, &expectedMax );
+
+				float minVal, maxVal;
+				ip::getMinMax( original, &minVal, &maxVal );
+				REQUIRE( minVal == expectedMin );
+				REQUIRE( maxVal == expectedMax );
+
+				Surface32f surface = original.clone();
+				ip::hdrNormalize( &surface, &minVal, &maxVal );
+				REQUIRE( minVal == expectedMin );
+				REQUIRE( maxVal == expectedMax );
+
+				const float scale = 1.0f / ( expectedMax - expectedMin );
+				bool equal = true;
+				for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+					for( int32_t x = 0; x < surface.getWidth(); ++x ) {
+						const ColorAf before = original.getPixel( ivec2( x, y ) ), after = surface.getPixel( ivec2( x, y ) );
+						equal = equal && after.r == ( before.r - expectedMin ) * scale && after.g == ( before.g - expectedMin ) * scale && after.b == ( before.b - expectedMin ) * scale;
+						equal = equal && after.a == before.a;
+					}
+				}
+				REQUIRE( equal );
+			}
+		}
+	}
+
+	SECTION( "Channels are normalized whether planar or interleaved" )
+	{
+		Surface32f surface = makeHdrSurface( 29, 6, SurfaceChannelOrder::RGBA );
+		Channel32f planar = surface.getChannelBlue().clone();
+		const Channel32f original = planar.clone();
+		float planarMin, planarMax, interleavedMin, interleavedMax;
+		ip::getMinMax( planar, &planarMin, &planarMax );
+		ip::getMinMax( surface.getChannelBlue(), &interleavedMin, &interleavedMax );
+		REQUIRE( planarMin == interleavedMin );
+		REQUIRE( planarMax == interleavedMax );
+
+		ip::hdrNormalize( &planar );
+		ip::hdrNormalize( &surface.getChannelBlue() );
+		const float scale = 1.0f / ( planarMax - planarMin );
+		bool equal = true;
+		for( int32_t y = 0; y < planar.getHeight(); ++y ) {
+			for( int32_t x = 0; x < planar.getWidth(); ++x ) {
+				const float expected = ( original.getValue( ivec2( x, y ) ) - planarMin ) * scale;
+				equal = equal && planar.getValue( ivec2( x, y ) ) == expected && surface.getChannelBlue().getValue( ivec2( x, y ) ) == expected;
+			}
+		}
+		REQUIRE( equal );
+	}
+
+	SECTION( "A flat image becomes black" )
+	{
+		Surface32f surface( 19, 3, false );
+		for( int32_t y = 0; y < surface.getHeight(); ++y )
+			for( int32_t x = 0; x < surface.getWidth(); ++x )
+				surface.setPixel( ivec2( x, y ), Colorf( 2.5f, 2.5f, 2.5f ) );
+		ip::hdrNormalize( &surface );
+		REQUIRE( surface.getPixel( ivec2( 18, 2 ) ) == ColorAf( 0, 0, 0, 1 ) );
+	}
+}
@@ -0,0 +1,198 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/ip/Blur.h"
+
+using namespace ci;
+
+namespace {
+
+template<typename T>
+double bruteSum( const ChannelT<T> &channel, const Area &area )
+{
+	double result = 0;
+	for( int32_t y = area.y1; y < area.y2; ++y )
+		for( int32_t x = area.x1; x < area.x2; ++x )
+			result += channel.getValue( ivec2( x, y ) );
+	return result;
+}
+
+template<typename T>
+double bruteVariance( const ChannelT<T> &channel, const Area &area )
+{
+	const double mean = bruteSum( channel, area ) / area.calcArea();
+	double result = 0;
+	for( int32_t y = area.y1; y < area.y2; ++y )
+		for( int32_t x = area.x1; x < area.x2; ++x )
+			result += ( channel.getValue( ivec2( x, y ) ) - mean ) * ( channel.getValue( ivec2( x, y ) ) - mean );
+	return result / area.calcArea();
+}
+
+const Area sTestAreas[] = { Area( 0, 0, 1, 1 ), Area( 0, 0, 53, 37 ), Area( 5, 7, 6, 30 ), Area( 12, 3, 40, 29 ), Area( 52, 36, 53, 37 ), Area( -10, -10, 20, 15 ), Area( 40, 20, 100, 100 ) };
+
+// Reference Bradley-Roth threshold: the window around (x, y) spans the pixels in (x1, x2] x (y1, y2], and the
+// comparison is made in fixed point with 8 fractional bits.
+Channel8u bruteAdaptiveThreshold( const Channel8u &channel, int32_t windowSize, float percentageDelta )
+{
+	const int32_t w = channel.getWidth(), h = channel.getHeight(), s2 = windowSize / 2;
+	const uint64_t comparisonMult = (uint64_t)( ( 1.0f - percentageDelta ) * 256 );
+	Channel8u result( w, h );
+	for( int32_t y = 0; y < h; ++y ) {
+		for( int32_t x = 0; x < w; ++x ) {
+			const int32_t x1 = std::max( x - s2, 0 ), x2 = std::min( x + s2, w - 1 );
+			const int32_t y1 = std::max( y - s2, 0 ), y2 = std::min( y + s2, h - 1 );
+			const uint64_t count = ( x2 - x1 ) * ( y2 - y1 );
+			const uint64_t sum = (uint64_t)bruteSum( channel, Area( x1 + 1, y1 + 1, x2 + 1, y2 + 1 ) );
+			const bool below = (uint64_t)( channel.getValue( ivec2( x, y ) ) * count ) < sum * comparisonMult / 256;
+			result.setValue( ivec2( x, y ), below ? 0 : 255 );
+		}
+	}
+	return result;
+}
+
+// Reference for the zero percentageDelta path, which sets pixels above their window's average to the type's maximum.
+template<typename T>
+ChannelT<T> bruteAdaptiveThresholdZero( const ChannelT<T> &channel, int32_t windowSize )
+{
+	const int32_t w = channel.getWidth(), h = channel.getHeight(), s2 = windowSize / 2;
+	ChannelT<T> result( w, h );
+	for( int32_t y = 0; y < h; ++y ) {
+		for( int32_t x = 0; x < w; ++x ) {
+			const int32_t x1 = std::max( x - s2, 0 ), x2 = std::min( x + s2, w - 1 );
+			const int32_t y1 = std::max( y - s2, 0 ), y2 = std::min( y + s2, h - 1 );
+			const double count = ( x2 - x1 ) * ( y2 - y1 );
+			const double sum = bruteSum( channel, Area( x1 + 1, y1 + 1, x2 + 1, y2 + 1 ) );
+			const bool above = sum < channel.getValue( ivec2( x, y ) ) * count;
+			result.setValue( ivec2( x, y ), above ? CHANTRAIT<T>::max() : 0 );
+		}
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/IntegralImage" )
+{
+	SECTION( "Channel8u sums, averages and variances" )
+	{
+		Channel8u channel = makeNoiseChannel<uint8_t>( 53, 37 );
+		ip::IntegralImage8u integral( channel, true );
+		REQUIRE( integral.getSize() == ivec2( 53, 37 ) );
+		REQUIRE( integral.getNumChannels() == 1 );
+		for( const Area &area : sTestAreas ) {
+			const Area clipped = area.getClipBy( channel.getBounds() );
+			REQUIRE( integral.areaSum( area ) == (uint64_t)bruteSum( channel, clipped ) );
+			REQUIRE( integral.areaAverage( area ) == Approx( bruteSum( channel, clipped ) / clipped.calcArea() ) );
+			REQUIRE( integral.areaVariance( area ) == Approx( bruteVariance( channel, clipped ) ) );
+		}
+		REQUIRE( integral.areaSum( Area( 100, 100, 120, 120 ) ) == 0 );
+		REQUIRE( integral.areaAverage( Area( 100, 100, 120, 120 ) ) == 0 );
+	}
+
+	SECTION( "Channel32f sums" )
+	{
+		Channel32f channel = makeNoiseChannel<float>( 53, 37 );
+		ip::IntegralImage32f integral( channel );
+		REQUIRE_FALSE( integral.hasSquares() );
+		for( const Area &area : sTestAreas )
+			REQUIRE( integral.areaSum( area ) == Approx( bruteSum( channel, area.getClipBy( channel.getBounds() ) ) ) );
+	}
+
+	SECTION( "Surface sums per channel" )
+	{
+		Surface16u surface = makeNoiseSurface<uint16_t>( 53, 37, SurfaceChannelOrder::BGRA );
+		ip::IntegralImage16u integral( surface );
+		REQUIRE( integral.getNumChannels() == 4 );
+		const Channel16u channels[4] = { surface.getChannelRed(), surface.getChannelGreen(), surface.getChannelBlue(), surface.getChannelAlpha() };
+		for( uint8_t c = 0; c < 4; ++c ) {
+			for( const Area &area : sTestAreas )
+				REQUIRE( integral.areaSum( area, c ) == (uint64_t)bruteSum( channels[c], area.getClipBy( surface.getBounds() ) ) );
+		}
+	}
+
+	SECTION( "update matches a rebuild" )
+	{
+		Channel8u channel = makeNoiseChannel<uint8_t>( 53, 37 );
+		ip::IntegralImage8u integral( channel, true );
+		const Area dirty( 20, 11, 31, 25 );
+		Channel8u patch = makeNoiseChannel<uint8_t>( dirty.getWidth(), dirty.getHeight(), 99 );
+		channel.copyFrom( patch, patch.getBounds(), dirty.getUL() );
+		integral.update( channel, dirty );
+
+		ip::IntegralImage8u rebuilt( channel, true );
+		for( int32_t y = 0; y <= 37; ++y ) {
+			for( int32_t x = 0; x <= 53; ++x ) {
+				REQUIRE( integral.areaSum( Area( 0, 0, x, y ) ) == rebuilt.areaSum( Area( 0, 0, x, y ) ) );
+				REQUIRE( integral.areaVariance( Area( x / 2, y / 2, x, y ) ) == rebuilt.areaVariance( Area( x / 2, y / 2, x, y ) ) );
+			}
+		}
+	}
+}
+
+TEST_CASE( "ip/AdaptiveThreshold" )
+{
+	Channel8u channel = makeNoiseChannel<uint8_t>( 61, 45 );
+	for( int32_t windowSize : { 2, 7, 16, 200 } ) {
+		Channel8u expected = bruteAdaptiveThreshold( channel, windowSize, 0.15f );
+		Channel8u result( channel.getWidth(), channel.getHeight() );
+		ip::adaptiveThreshold( channel, windowSize, 0.15f, &result );
+
+		ip::AdaptiveThreshold adaptive( &channel );
+		Channel8u resultClass( channel.getWidth(), channel.getHeight() );
+		adaptive.calculate( windowSize, 0.15f, &resultClass );
+
+		bool equal = true;
+		for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+			for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+				equal = equal && result.getValue( ivec2( x, y ) ) == expected.getValue( ivec2( x, y ) );
+				equal = equal && resultClass.getValue( ivec2( x, y ) ) == expected.getValue( ivec2( x, y ) );
+			}
+		}
+		REQUIRE( equal );
+	}
+}
+
+TEST_CASE( "ip/AdaptiveThresholdZero" )
+{
+	SECTION( "Channel16u is set to 65535 above the average" )
+	{
+		Channel16u channel16u = makeNoiseChannel<uint16_t>( 61, 45 );
+		Channel16u result16u( channel16u.getWidth(), channel16u.getHeight() );
+		ip::adaptiveThresholdZero( channel16u, 16, &result16u );
+		REQUIRE( imagesEqual( result16u, bruteAdaptiveThresholdZero( channel16u, 16 ) ) );
+		REQUIRE( *std::max_element( result16u.getData(), result16u.getData() + result16u.getWidth() * result16u.getHeight() ) == 65535 );
+	}
+
+	SECTION( "Channel32f is set to 1 above the average" )
+	{
+		Channel32f channel32f = makeNoiseChannel<float>( 61, 45 );
+		ip::AdaptiveThreshold32f adaptive( &channel32f );
+		Channel32f result32f( channel32f.getWidth(), channel32f.getHeight() );
+		adaptive.calculate( 16, 0, &result32f );
+		REQUIRE( imagesEqual( result32f, bruteAdaptiveThresholdZero( channel32f, 16 ) ) );
+		REQUIRE( *std::max_element( result32f.getData(), result32f.getData() + result32f.getWidth() * result32f.getHeight() ) == 1.0f );
+	}
+}
+
+TEST_CASE( "ip/BoxBlur" )
+{
+	Surface8u surface = makeNoiseSurface<uint8_t>( 41, 29, SurfaceChannelOrder::BGRA );
+	const Channel8u red = surface.getChannelRed().clone();
+	for( int radius : { 1, 4, 50 } ) {
+		Surface8u blurred = ip::boxBlurCopy( surface, radius );
+		Surface8u blurredInPlace = surface.clone();
+		ip::boxBlur( &blurredInPlace, radius );
+
+		bool equal = true;
+		for( int32_t y = 0; y < surface.getHeight(); ++y ) {
+			for( int32_t x = 0; x < surface.getWidth(); ++x ) {
+				const Area box = Area( x - radius, y - radius, x + radius + 1, y + radius + 1 ).getClipBy( surface.getBounds() );
+				const uint8_t expected = (uint8_t)( ( (uint64_t)bruteSum( red, box ) + box.calcArea() / 2 ) / box.calcArea() );
+				equal = equal && *blurred.getDataRed( ivec2( x, y ) ) == expected;
+				equal = equal && *blurredInPlace.getDataRed( ivec2( x, y ) ) == expected;
+			}
+		}
+		REQUIRE( equal );
+	}
+}
@@ -0,0 +1,88 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/ip/Threshold.h"
+
+using namespace ci;
+
+TEST_CASE( "ip/Pipeline" )
+{
+	SECTION( "Fused point operations match separate passes" )
+	{
+		for( int32_t height : { 1, 2, 77, 300 } ) {
+			Surface8u expected = makeNoiseSurface<uint8_t>( 251, height, SurfaceChannelOrder::BGRA );
+			Surface8u fused = expected.clone();
+
+			ip::grayscale( expected, &expected );
+			ip::threshold( &expected, (uint8_t)90 );
+			ip::premultiply( &expected );
+			ip::flipVertical( &expected );
+			ip::flipHorizontal( &expected );
+
+			ip::Pipeline pipeline( &fused );
+			pipeline.grayscale().threshold( 90 ).premultiply().flipVertical().flipHorizontal();
+			REQUIRE( pipeline.getNumPasses() == 1 );
+			pipeline.run();
+			REQUIRE( pipeline.getNumPasses() == 0 );
+
+			REQUIRE( imagesEqual( expected, fused ) );
+		}
+	}
+
+	SECTION( "Barriers complete preceding operations" )
+	{
+		Surface32f expected = makeNoiseSurface<float>( 190, 123, SurfaceChannelOrder::BGRA );
+		Surface32f fused = expected.clone();
+
+		ip::premultiply( &expected );
+		ip::flipVertical( &expected );
+		ip::stackBlur( &expected, 5 );
+		ip::unpremultiply( &expected );
+		ip::edgeDetectSobel( expected.clone(), &expected );
+		ip::grayscale( expected, &expected );
+
+		ip::Pipeline32f pipeline( &fused );
+		pipeline.premultiply().flipVertical().stackBlur( 5 ).unpremultiply().edgeDetectSobel().grayscale();
+		REQUIRE( pipeline.getNumPasses() == 5 );
+		pipeline.run();
+
+		REQUIRE( imagesEqual( expected, fused ) );
+	}
+
+	SECTION( "Interleaved Channel leaves other channels alone" )
+	{
+		Surface8u expected = makeNoiseSurface<uint8_t>( 64, 33, SurfaceChannelOrder::BGRA );
+		Surface8u fused = expected.clone();
+
+		Channel8u thresholded = expected.getChannelGreen().clone();
+		ip::threshold( thresholded, (uint8_t)128, &thresholded );
+		for( int32_t y = 0; y < thresholded.getHeight(); ++y ) {
+			for( int32_t x = 0; x < thresholded.getWidth(); ++x )
+				expected.getChannelGreen().setValue( ivec2( x, y ), thresholded.getValue( ivec2( thresholded.getWidth() - x - 1, thresholded.getHeight() - y - 1 ) ) );
+		}
+
+		ip::Pipeline( &fused.getChannelGreen() ).threshold( 128 ).flipVertical().flipHorizontal().run();
+
+		REQUIRE( imagesEqual( expected, fused ) );
+	}
+
+	SECTION( "Fused pass on a ThreadPool matches serial execution" )
+	{
+		Surface8u serial = makeNoiseSurface<uint8_t>( 640, 480, SurfaceChannelOrder::BGRA );
+		Surface8u parallel = serial.clone();
+
+		ip::Pipeline( &serial ).grayscale().threshold( 40 ).flipVertical().run();
+
+		ip::setThreadPool( ip::ThreadPool::create( 4 ) );
+		ip::Pipeline( &parallel ).grayscale().threshold( 40 ).flipVertical().run();
+		ip::setThreadPool( nullptr );
+
+		REQUIRE( imagesEqual( serial, parallel ) );
+	}
+}
@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Resize.h"
+
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+Channel8u makeSource( int32_t width, int32_t height )
+{
+	Channel8u result( width, height );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x )
+			*result.getData( x, y ) = uint8_t( ( x * 29 + y * 71 + x * y * 13 ) % 256 );
+	}
+
+	return result;
+}
+
+bool channelEquals( const Channel8u &channel, const std::vector<uint8_t> &expected )
+{
+	if( expected.size() != size_t( channel.getWidth() * channel.getHeight() ) )
+		return false;
+
+	for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+		for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+			if( *channel.getData( x, y ) != expected[y * channel.getWidth() + x] )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+// The expected values were produced by ip::resize before it was rebuilt on ResizePlanT
+TEST_CASE( "ip/resize" )
+{
+	SECTION( "downsample" )
+	{
+		Channel8u dst( 5, 3 );
+		ip::resize( makeSource( 12, 8 ), &dst, FilterTriangle() );
+		REQUIRE( channelEquals( dst, {
+			104, 138, 125, 138, 126,
+			120, 124, 117, 141, 136,
+			128, 143, 127, 111, 111 } ) );
+	}
+
+	SECTION( "upsample" )
+	{
+		Channel8u dst( 7, 5 );
+		ip::resize( makeSource( 4, 3 ), &dst, FilterCatmullRom() );
+		REQUIRE( channelEquals( dst, {
+			0, 2, 21, 37, 53, 71, 81,
+			19, 30, 52, 70, 91, 120, 136,
+			68, 82, 110, 134, 158, 186, 200,
+			116, 134, 167, 207, 219, 144, 98,
+			143, 162, 199, 249, 251, 108, 23 } ) );
+	}
+
+	SECTION( "sub-areas" )
+	{
+		Channel8u dst( 6, 4 );
+		ip::fill( &dst, (uint8_t)0 );
+		ip::resize( makeSource( 12, 8 ), Area( 2, 1, 10, 7 ), &dst, Area( 1, 1, 5, 3 ), FilterTriangle() );
+		REQUIRE( channelEquals( dst, {
+			0, 0, 0, 0, 0, 0,
+			0, 159, 133, 112, 136, 164,
+			0, 117, 123, 116, 148, 125,
+			0, 152, 140, 122, 104, 106 } ) );
+	}
+}
+
+TEST_CASE( "ip/ResizePlan" )
+{
+	const Surface8u src = makeNoiseSurface<uint8_t>( 301, 203, SurfaceChannelOrder::RGBA, 5678 );
+
+	SECTION( "results don't depend on the thread count" )
+	{
+		for( ivec2 dstSize : { ivec2( 75, 50 ), ivec2( 640, 480 ), ivec2( 301, 203 ) } ) {
+			ip::ResizePlan plan( src.getSize(), dstSize, FilterGaussian(), 1 );
+			const Surface8u expected = plan.resizeCopy( src );
+
+			for( int numThreads : { 2, 3, 8 } ) {
+				plan.setNumThreads( numThreads );
+				REQUIRE( samePixels( plan.resizeCopy( src ), expected ) );
+			}
+		}
+	}
+
+	SECTION( "sub-areas" )
+	{
+		const Area srcArea( 10, 20, 250, 180 ), dstArea( 5, 5, 100, 60 );
+		Surface32f srcFloat( src );
+		Surface32f expected( 120, 80, true ), result( 120, 80, true );
+		ip::fill( &expected, ColorAf::zero() );
+		ip::fill( &result, ColorAf::zero() );
+
+		ip::ResizePlan32f( srcFloat.getSize(), srcArea, expected.getSize(), dstArea, FilterTriangle(), 1 ).resize( srcFloat, &expected );
+		ip::ResizePlan32f( srcFloat.getSize(), srcArea, result.getSize(), dstArea, FilterTriangle(), 4 ).resize( srcFloat, &result );
+		REQUIRE( samePixels( result, expected ) );
+	}
+}
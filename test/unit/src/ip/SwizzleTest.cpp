@@ -0,0 +1,132 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Swizzle.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Rand.h"
+
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+// Compares ip::swizzleRow() against a per-element reference for every combination of pixel sizes, several maps and widths
+template<typename SD, typename TD>
+void testSwizzleRow()
+{
+	Rand rnd( 1234 );
+	const int32_t maxWidth = 53;
+	std::vector<SD> src( maxWidth * 4 );
+	for( auto &v : src )
+		// include out of range floats, which are clamped when converting to integers
+		v = randomValue<SD>( rnd, -0.1f, 1.1f );
+
+	bool equal = true;
+	for( uint8_t srcInc = 1; srcInc <= 4; ++srcInc ) {
+		for( uint8_t dstInc = 1; dstInc <= 4; ++dstInc ) {
+			for( int mapIdx = 0; mapIdx < 8; ++mapIdx ) {
+				ip::SwizzleMap map( srcInc, dstInc, -1, -1, -1, -1 );
+				for( int j = 0; j < dstInc; ++j )
+					map.mIndex[j] = (int8_t)( ( mapIdx == 0 ) ? -1 : (int)rnd.nextUint( srcInc + 1 ) - 1 );
+				for( int32_t width : { 0, 1, 5, 6, 16, 17, 31, maxWidth } ) {
+					// a guard element past the end of the row must not be written
+					std::vector<TD> dst( width * dstInc + 1, (TD)7 );
+					ip::swizzleRow( src.data(), dst.data(), width, map );
+					for( int32_t x = 0; x < width; ++x ) {
+						for( int j = 0; j < dstInc; ++j ) {
+							const TD expected = ( map.mIndex[j] >= 0 ) ? CHANTRAIT<TD>::convert( src[x * srcInc + map.mIndex[j]] ) : CHANTRAIT<TD>::max();
+							equal = equal && ( dst[x * dstInc + j] == expected );
+						}
+					}
+					equal = equal && ( dst[width * dstInc] == (TD)7 );
+				}
+			}
+		}
+	}
+
+	REQUIRE( equal );
+}
+
+// Copies between all pairs of channel orders and checks every channel
+template<typename T>
+void testCopyFromChannelOrders()
+{
+	const int orders[] = { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR, SurfaceChannelOrder::RGBX,
+						   SurfaceChannelOrder::BGRX, SurfaceChannelOrder::XRGB, SurfaceChannelOrder::XBGR, SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR };
+	bool equal = true;
+	for( int srcOrder : orders ) {
+		SurfaceT<T> src = makeNoiseSurface<T>( 37, 9, srcOrder, 4321, -0.1f, 1.1f );
+		for( int dstOrder : orders ) {
+			SurfaceT<T> dst( 37, 9, SurfaceChannelOrder( dstOrder ).hasAlpha(), dstOrder );
+			dst.copyFrom( src, Area( 3, 2, 37, 9 ), ivec2( -3, -2 ) );
+			for( int32_t y = 0; y < 7; ++y ) {
+				for( int32_t x = 0; x < 34; ++x ) {
+					const T *s = src.getData( ivec2( x + 3, y + 2 ) );
+					const T *d = dst.getData( ivec2( x, y ) );
+					equal = equal && d[dst.getRedOffset()] == s[src.getRedOffset()] && d[dst.getGreenOffset()] == s[src.getGreenOffset()] && d[dst.getBlueOffset()] == s[src.getBlueOffset()];
+					if( dst.hasAlpha() )
+						equal = equal && d[dst.getAlphaOffset()] == ( src.hasAlpha() ? s[src.getAlphaOffset()] : CHANTRAIT<T>::max() );
+				}
+			}
+		}
+	}
+
+	REQUIRE( equal );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Swizzle" )
+{
+	SECTION( "swizzleRow matches reference" )
+	{
+		testSwizzleRow<uint8_t,uint8_t>();
+		testSwizzleRow<uint8_t,uint16_t>();
+		testSwizzleRow<uint8_t,float>();
+		testSwizzleRow<uint16_t,uint8_t>();
+		testSwizzleRow<float,uint8_t>();
+		testSwizzleRow<uint16_t,uint16_t>();
+		testSwizzleRow<float,float>();
+	}
+
+	SECTION( "Surface copyFrom across channel orders" )
+	{
+		testCopyFromChannelOrders<uint8_t>();
+		testCopyFromChannelOrders<uint16_t>();
+		testCopyFromChannelOrders<float>();
+	}
+
+	SECTION( "ImageSource conversions" )
+	{
+		Surface8u src = makeNoiseSurface<uint8_t>( 41, 7, SurfaceChannelOrder::BGRA );
+		Surface32f converted( (ImageSourceRef)src, SurfaceConstraintsDefault(), true );
+		Surface8u roundTrip( (ImageSourceRef)converted, SurfaceConstraintsDefault(), true );
+		REQUIRE( converted.getChannelOrder() == SurfaceChannelOrder::RGBA );
+		bool equal = true;
+		for( int32_t y = 0; y < src.getHeight(); ++y ) {
+			for( int32_t x = 0; x < src.getWidth(); ++x ) {
+				const ColorA8u s = src.getPixel( ivec2( x, y ) );
+				const ColorAf c = converted.getPixel( ivec2( x, y ) );
+				equal = equal && c.r == s.r / 255.0f && c.g == s.g / 255.0f && c.b == s.b / 255.0f && c.a == s.a / 255.0f;
+				// 8u -> 32f -> 8u truncates, so allow one step below
+				const ColorA8u r = roundTrip.getPixel( ivec2( x, y ) );
+				equal = equal && std::abs( r.r - s.r ) <= 1 && std::abs( r.g - s.g ) <= 1 && std::abs( r.b - s.b ) <= 1 && std::abs( r.a - s.a ) <= 1;
+			}
+		}
+		REQUIRE( equal );
+
+		// an RGB source fills the alpha of an RGBA target
+		Surface8u rgb = makeNoiseSurface<uint8_t>( 23, 5, SurfaceChannelOrder::BGR );
+		Surface16u rgba( (ImageSourceRef)rgb, SurfaceConstraintsDefault(), true );
+		REQUIRE( rgba.getPixel( ivec2( 22, 4 ) ).a == 65535 );
+		REQUIRE( rgba.getPixel( ivec2( 22, 4 ) ).g == rgb.getPixel( ivec2( 22, 4 ) ).g * 257 );
+
+		// gray sources are broadcast to red, green and blue
+		Channel8u gray( 19, 3 );
+		for( int32_t x = 0; x < 19; ++x )
+			gray.setValue( ivec2( x, 1 ), (uint8_t)( x * 13 ) );
+		Surface8u fromGray( (ImageSourceRef)gray, SurfaceConstraintsDefault(), false );
+		REQUIRE( fromGray.getPixel( ivec2( 17, 1 ) ) == ColorA8u( 221, 221, 221, 255 ) );
+	}
+}
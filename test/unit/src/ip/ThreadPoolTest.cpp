@@ -0,0 +1,96 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Hdr.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Threshold.h"
+
+#include <algorithm>
+#include <atomic>
+
+using namespace ci;
+
+namespace {
+
+// runs op on a copy of image serially and on another copy with a ThreadPool, and returns whether the results match
+template<typename IMAGET, typename OP>
+bool matchesSerial( const IMAGET &image, const ip::ThreadPoolRef &threadPool, OP op )
+{
+	IMAGET serial = image.clone();
+	ip::setThreadPool( nullptr );
+	op( &serial );
+
+	IMAGET parallel = image.clone();
+	ip::setThreadPool( threadPool );
+	op( &parallel );
+	ip::setThreadPool( nullptr );
+
+	return imagesEqual( serial, parallel );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/ThreadPool" )
+{
+	auto threadPool = ip::ThreadPool::create( 4 );
+
+	SECTION( "parallelFor visits every index once" )
+	{
+		std::vector<int> visits( 1000, 0 );
+		threadPool->parallelFor( visits.size(), 7, [&]( size_t begin, size_t end ) {
+			for( size_t i = begin; i < end; ++i )
+				visits[i]++;
+		} );
+
+		REQUIRE( std::count( visits.begin(), visits.end(), 1 ) == 1000 );
+	}
+
+	SECTION( "parallelFor nests" )
+	{
+		std::atomic<int> sum( 0 );
+		threadPool->parallelFor( 8, 1, [&]( size_t, size_t ) {
+			threadPool->parallelFor( 100, 10, [&]( size_t begin, size_t end ) {
+				sum += (int)( end - begin );
+			} );
+		} );
+
+		REQUIRE( sum == 800 );
+	}
+
+	SECTION( "parallelFor rethrows" )
+	{
+		REQUIRE_THROWS( threadPool->parallelFor( 100, 1, [&]( size_t begin, size_t ) {
+			if( begin == 42 )
+				throw std::runtime_error( "band failed" );
+		} ) );
+	}
+
+	SECTION( "ip:: operations match serial execution" )
+	{
+		Surface8u surface8u = makeNoiseSurface<uint8_t>( 517, 311 );
+		Surface32f surface32f = makeNoiseSurface<float>( 517, 311, SurfaceChannelOrder::RGBA, 4321, 0.0f, 4.0f );
+
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::fill( s, ColorA8u( 1, 2, 3, 4 ), Area( 13, 17, 400, 300 ) ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::flipVertical( s ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::flipHorizontal( s ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::grayscale( s->clone(), s ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::threshold( s, (uint8_t)100 ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::premultiply( s ); ip::unpremultiply( s ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::edgeDetectSobel( s->clone(), s ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, []( Surface8u *s ) { ip::stackBlur( s, 9 ); } ) );
+		REQUIRE( matchesSerial( surface8u, threadPool, [&]( Surface8u *s ) { ip::blend( s, surface8u, Area( 0, 0, 300, 200 ), ivec2( 50, 60 ) ); } ) );
+		REQUIRE( matchesSerial( surface32f, threadPool, []( Surface32f *s ) { ip::hdrNormalize( s ); } ) );
+		REQUIRE( matchesSerial( surface32f, threadPool, []( Surface32f *s ) { ip::premultiply( s ); ip::unpremultiply( s ); } ) );
+
+		Channel8u channel8u( surface8u.getChannelGreen().clone() );
+		REQUIRE( matchesSerial( channel8u, threadPool, []( Channel8u *c ) { ip::adaptiveThreshold( c, 15, 0.1f ); } ) );
+		Channel32f channel32f( surface32f.getChannelRed().clone() );
+		REQUIRE( matchesSerial( channel32f, threadPool, []( Channel32f *c ) { ip::hdrNormalize( c ); } ) );
+	}
+}
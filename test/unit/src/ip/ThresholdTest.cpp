@@ -0,0 +1,113 @@
+#include "catch.hpp"
+#include "cinder/ip/Threshold.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Rand.h"
+
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+const SurfaceChannelOrder kChannelOrders[] = { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR,
+												SurfaceChannelOrder::RGBX, SurfaceChannelOrder::XBGR, SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR };
+
+template<typename T>
+T randomValue( Rand &rnd )
+{
+	return (T)rnd.nextUint( CHANTRAIT<T>::max() + 1 );
+}
+
+template<>
+float randomValue<float>( Rand &rnd )
+{
+	return rnd.nextFloat( -0.5f, 1.5f );
+}
+
+// Compares ip::thresholdRow() against a per-element reference for every channel order, in place and not, around thresholds of either sign
+template<typename T>
+void testThresholdRow( const std::vector<T> &values )
+{
+	Rand rnd( 3141 );
+	bool equal = true;
+	for( const SurfaceChannelOrder &order : kChannelOrders ) {
+		const uint8_t inc = order.getPixelInc();
+		for( T value : values ) {
+			for( int32_t width : { 0, 1, 3, 4, 5, 15, 16, 17, 31, 53 } ) {
+				for( bool inPlace : { false, true } ) {
+					std::vector<T> src( width * inc );
+					for( auto &v : src )
+						v = ( rnd.nextUint( 8 ) == 0 ) ? value : randomValue<T>( rnd );
+					// a guard element past the end of the row must not be written
+					std::vector<T> dst( width * inc + 1, (T)7 );
+					if( inPlace )
+						std::copy( src.begin(), src.end(), dst.begin() );
+					const std::vector<T> before = dst;
+					ip::thresholdRow( inPlace ? dst.data() : src.data(), dst.data(), width, order, value );
+
+					for( int32_t e = 0; e < width * inc; ++e ) {
+						const uint8_t j = e % inc;
+						const bool isColor = j == order.getRedOffset() || j == order.getGreenOffset() || j == order.getBlueOffset();
+						const T expected = isColor ? ( ( src[e] > value ) ? CHANTRAIT<T>::max() : 0 ) : before[e];
+						equal = equal && ( dst[e] == expected );
+					}
+					equal = equal && ( dst[width * inc] == (T)7 );
+				}
+			}
+		}
+	}
+
+	REQUIRE( equal );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::Threshold" )
+{
+	SECTION( "thresholdRow matches the scalar comparison for every channel order" )
+	{
+		// 127 and 128 straddle the sign bit the SSE2 comparison works around
+		testThresholdRow<uint8_t>( { 0, 1, 127, 128, 200, 255 } );
+		testThresholdRow<uint16_t>( { 0, 32767, 32768, 65535 } );
+		testThresholdRow<float>( { -0.25f, 0.0f, 0.5f, 1.0f } );
+	}
+
+	SECTION( "Surfaces and Channels match the scalar comparison" )
+	{
+		Rand rnd( 2 );
+		Surface8u src( 71, 6, true, SurfaceChannelOrder::BGRA );
+		Channel8u srcChannel( 71, 6 );
+		for( int32_t y = 0; y < src.getHeight(); ++y ) {
+			for( int32_t x = 0; x < src.getWidth(); ++x ) {
+				src.setPixel( ivec2( x, y ), ColorA8u( rnd.nextUint( 256 ), rnd.nextUint( 256 ), rnd.nextUint( 256 ), rnd.nextUint( 256 ) ) );
+				srcChannel.setValue( ivec2( x, y ), (uint8_t)rnd.nextUint( 256 ) );
+			}
+		}
+
+		// the same and a different channel order, and in place within an Area
+		Surface8u sameOrder( 71, 6, true, SurfaceChannelOrder::BGRA ), otherOrder( 71, 6, true, SurfaceChannelOrder::ARGB ), inPlace = src.clone();
+		const uint8_t value = 100;
+		ip::threshold( src, value, &sameOrder );
+		ip::threshold( src, value, &otherOrder );
+		const Area area( 3, 1, 60, 5 );
+		ip::threshold( &inPlace, value, area );
+		Channel8u dstChannel( 71, 6 );
+		ip::threshold( srcChannel, value, &dstChannel );
+
+		auto thresholded = [=]( uint8_t v ) { return uint8_t( ( v > value ) ? 255 : 0 ); };
+		bool equal = true;
+		for( int32_t y = 0; y < src.getHeight(); ++y ) {
+			for( int32_t x = 0; x < src.getWidth(); ++x ) {
+				const ivec2 pos( x, y );
+				const ColorA8u c = src.getPixel( pos );
+				const ColorA8u expected( thresholded( c.r ), thresholded( c.g ), thresholded( c.b ), c.a );
+				const ColorA8u a = sameOrder.getPixel( pos ), b = otherOrder.getPixel( pos );
+				equal = equal && a.r == expected.r && a.g == expected.g && a.b == expected.b;
+				equal = equal && b.r == expected.r && b.g == expected.g && b.b == expected.b;
+				equal = equal && inPlace.getPixel( pos ) == ( area.contains( pos ) ? expected : c );
+				equal = equal && dstChannel.getValue( pos ) == thresholded( srcChannel.getValue( pos ) );
+			}
+		}
+		REQUIRE( equal );
+	}
+}
@@ -0,0 +1,107 @@
+#include "catch.hpp"
+#include "utils.h"
+#include "cinder/ip/Trim.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/ThreadPool.h"
+#include "cinder/Rand.h"
+
+#include <limits>
+
+using namespace ci;
+
+namespace {
+
+// The bounding box of every pixel of \a bounds with a non-zero alpha, tested one at a time
+template<typename T>
+Area referenceArea( const SurfaceT<T> &surface, const Area &bounds )
+{
+	int32_t x1 = bounds.getX2(), y1 = bounds.getY2(), x2 = bounds.getX1(), y2 = bounds.getY1();
+	for( int32_t y = bounds.getY1(); y < bounds.getY2(); ++y ) {
+		for( int32_t x = bounds.getX1(); x < bounds.getX2(); ++x ) {
+			if( *surface.getDataAlpha( ivec2( x, y ) ) ) {
+				x1 = std::min( x1, x );
+				y1 = std::min( y1, y );
+				x2 = std::max( x2, x + 1 );
+				y2 = std::max( y2, y + 1 );
+			}
+		}
+	}
+	return ( x1 < x2 ) ? Area( x1, y1, x2, y2 ) : Area( bounds.getX2(), bounds.getY2(), bounds.getX2(), bounds.getY2() );
+}
+
+template<typename T>
+void testFindNonTransparentArea()
+{
+	Rand rnd( 808 );
+	bool equal = true;
+	for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR } ) {
+		for( int i = 0; i < 200; ++i ) {
+			const int32_t width = 1 + rnd.nextInt( 70 ), height = 1 + rnd.nextInt( 20 );
+			const int32_t x1 = rnd.nextInt( width ), y1 = rnd.nextInt( height );
+			// some sprites are entirely transparent, others have a single opaque pixel or row
+			const Area content( x1, y1, x1 + rnd.nextInt( width - x1 + 1 ), y1 + rnd.nextInt( height - y1 + 1 ) );
+			const SurfaceT<T> sprite = makeSprite<T>( rnd, width, height, content, order );
+			equal = equal && ip::findNonTransparentArea( sprite, sprite.getBounds() ) == referenceArea( sprite, sprite.getBounds() );
+
+			const Area bounds( rnd.nextInt( width ), rnd.nextInt( height ), width - rnd.nextInt( width / 2 + 1 ), height + 5 );
+			equal = equal && ip::findNonTransparentArea( sprite, bounds ) == referenceArea( sprite, bounds.getClipBy( sprite.getBounds() ) );
+		}
+	}
+
+	REQUIRE( equal );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::Trim" )
+{
+	SECTION( "findNonTransparentArea matches a per-pixel search" )
+	{
+		testFindNonTransparentArea<uint8_t>();
+		testFindNonTransparentArea<float>();
+	}
+
+	SECTION( "Negative zero alpha is transparent and NaN is not" )
+	{
+		Surface32f surface( 40, 3, true );
+		ip::fill( &surface, ColorAf( 1, 1, 1, -0.0f ) );
+		REQUIRE( ip::findNonTransparentArea( surface, surface.getBounds() ) == Area( 40, 3, 40, 3 ) );
+		surface.setPixel( ivec2( 21, 1 ), ColorAf( 0, 0, 0, std::numeric_limits<float>::quiet_NaN() ) );
+		REQUIRE( ip::findNonTransparentArea( surface, surface.getBounds() ) == Area( 21, 1, 22, 2 ) );
+	}
+
+	SECTION( "A Surface without alpha isn't trimmed" )
+	{
+		Surface8u surface( 10, 10, false );
+		REQUIRE( ip::findNonTransparentArea( surface, Area( 2, 3, 20, 8 ) ) == Area( 2, 3, 10, 8 ) );
+	}
+
+	SECTION( "Batches match single Surfaces, with or without a ThreadPool" )
+	{
+		Rand rnd( 99 );
+		std::vector<Surface8u> sprites;
+		std::vector<Area> expected;
+		for( int i = 0; i < 64; ++i ) {
+			sprites.push_back( makeSprite<uint8_t>( rnd, 48, 40, Area( rnd.nextInt( 20 ), rnd.nextInt( 20 ), 24 + rnd.nextInt( 24 ), 20 + rnd.nextInt( 20 ) ), SurfaceChannelOrder::RGBA ) );
+			expected.push_back( referenceArea( sprites.back(), sprites.back().getBounds() ) );
+		}
+
+		for( size_t numThreads : { 0, 3 } ) {
+			ip::setThreadPool( numThreads ? ip::ThreadPool::create( numThreads ) : nullptr );
+			REQUIRE( ip::findNonTransparentAreas( sprites ) == expected );
+
+			std::vector<Area> areas;
+			const std::vector<Surface8u> trimmed = ip::trimTransparent( sprites, &areas );
+			REQUIRE( areas == expected );
+			bool equal = trimmed.size() == sprites.size();
+			for( size_t i = 0; i < trimmed.size() && equal; ++i ) {
+				equal = trimmed[i].getSize() == areas[i].getSize();
+				for( int32_t y = 0; y < areas[i].getHeight(); ++y )
+					for( int32_t x = 0; x < areas[i].getWidth(); ++x )
+						equal = equal && trimmed[i].getPixel( ivec2( x, y ) ) == sprites[i].getPixel( areas[i].getUL() + ivec2( x, y ) );
+			}
+			REQUIRE( equal );
+		}
+		ip::setThreadPool( nullptr );
+	}
+}
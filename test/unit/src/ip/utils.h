@@ -0,0 +1,154 @@
+#pragma once
+
+#include "cinder/Area.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Channel.h"
+#include "cinder/Rand.h"
+#include "cinder/Surface.h"
+
+#include <cstring>
+
+// A value over the whole range of T, or over [floatMin, floatMax) for float, which may reach outside of [0, 1]
+template<typename T>
+inline T randomValue( ci::Rand &rnd, float /*floatMin*/ = 0.0f, float /*floatMax*/ = 1.0f )
+{
+	return (T)rnd.nextUint( ci::CHANTRAIT<T>::max() + 1 );
+}
+
+template<>
+inline float randomValue<float>( ci::Rand &rnd, float floatMin, float floatMax )
+{
+	return rnd.nextFloat( floatMin, floatMax );
+}
+
+// A Surface of randomValue()s; alpha is only written when \a channelOrder has it
+template<typename T>
+inline ci::SurfaceT<T> makeNoiseSurface( int32_t width, int32_t height, const ci::SurfaceChannelOrder &channelOrder = ci::SurfaceChannelOrder::RGBA, uint32_t seed = 1234, float floatMin = 0.0f, float floatMax = 1.0f )
+{
+	ci::Rand rnd( seed );
+	ci::SurfaceT<T> result( width, height, channelOrder.hasAlpha(), channelOrder );
+	auto iter = result.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = randomValue<T>( rnd, floatMin, floatMax );
+			iter.g() = randomValue<T>( rnd, floatMin, floatMax );
+			iter.b() = randomValue<T>( rnd, floatMin, floatMax );
+			if( channelOrder.hasAlpha() )
+				iter.a() = randomValue<T>( rnd, floatMin, floatMax );
+		}
+	}
+
+	return result;
+}
+
+template<typename T>
+inline ci::ChannelT<T> makeNoiseChannel( int32_t width, int32_t height, uint32_t seed = 1234 )
+{
+	ci::Rand rnd( seed );
+	ci::ChannelT<T> result( width, height );
+	auto iter = result.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() )
+			iter.v() = randomValue<T>( rnd );
+	}
+
+	return result;
+}
+
+// Noise over gradients, so that an encoder's filters have something to gain and the data doesn't compress away
+template<typename T>
+inline ci::SurfaceT<T> makeGradientSurface( int32_t width, int32_t height, const ci::SurfaceChannelOrder &channelOrder, uint32_t seed = 17 )
+{
+	ci::Rand rnd( seed );
+	ci::SurfaceT<T> result( width, height, channelOrder.hasAlpha(), channelOrder );
+	const uint32_t scale = ci::CHANTRAIT<T>::max() / 255;
+	auto iter = result.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = T( ( iter.x() + rnd.nextUint( 8 ) ) % 256 * scale );
+			iter.g() = T( ( iter.y() * 3 ) % 256 * scale + rnd.nextUint( scale ) );
+			iter.b() = T( rnd.nextUint( 256 ) * scale );
+			if( channelOrder.hasAlpha() )
+				iter.a() = T( ( iter.x() + iter.y() ) % 256 * scale );
+		}
+	}
+
+	return result;
+}
+
+// A transparent Surface with a few opaque pixels scattered inside \a content
+template<typename T>
+inline ci::SurfaceT<T> makeSprite( ci::Rand &rnd, int32_t width, int32_t height, const ci::Area &content, const ci::SurfaceChannelOrder &channelOrder )
+{
+	ci::SurfaceT<T> result( width, height, true, channelOrder );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			T *pixel = result.getData( ci::ivec2( x, y ) );
+			// colors under zero alpha don't count
+			pixel[result.getRedOffset()] = pixel[result.getGreenOffset()] = pixel[result.getBlueOffset()] = ci::CHANTRAIT<T>::max();
+			pixel[result.getAlphaOffset()] = 0;
+		}
+	}
+	if( content.getWidth() > 0 && content.getHeight() > 0 ) {
+		for( int i = 0; i < 3; ++i ) {
+			const ci::ivec2 pos( content.getX1() + rnd.nextInt( content.getWidth() ), content.getY1() + rnd.nextInt( content.getHeight() ) );
+			*result.getDataAlpha( pos ) = ci::CHANTRAIT<T>::max();
+		}
+	}
+
+	return result;
+}
+
+// Whether \a a and \a b share their size, channel order and premultiplication, and every pixel's bytes
+template<typename T>
+inline bool imagesEqual( const ci::SurfaceT<T> &a, const ci::SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || !( a.getChannelOrder() == b.getChannelOrder() ) || a.isPremultiplied() != b.isPremultiplied() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ci::ivec2( 0, y ) ), b.getData( ci::ivec2( 0, y ) ), a.getWidth() * a.getPixelInc() * sizeof(T) ) != 0 )
+			return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+inline bool imagesEqual( const ci::ChannelT<T> &a, const ci::ChannelT<T> &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getValue( ci::ivec2( x, y ) ) != b.getValue( ci::ivec2( x, y ) ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Whether every pixel of \a a matches the one at the same offset within \a bArea of \a b, whatever their channel orders
+template<typename T>
+inline bool samePixels( const ci::SurfaceT<T> &a, const ci::SurfaceT<T> &b, const ci::Area &bArea )
+{
+	if( a.getSize() != bArea.getSize() || a.hasAlpha() != b.hasAlpha() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getPixel( ci::ivec2( x, y ) ) != b.getPixel( bArea.getUL() + ci::ivec2( x, y ) ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename T>
+inline bool samePixels( const ci::SurfaceT<T> &a, const ci::SurfaceT<T> &b )
+{
+	return samePixels( a, b, b.getBounds() );
+}